@@ -10,5 +10,15 @@
 
 #define FrameRate  60
 
+//the simulated time covered by one world update, in seconds. 0 makes the
+//simulation clocks follow the real time
+#define Sim_Time_Step  (1.0f/FrameRate)
+
+//the number of frames the profilers of the worlds keep for their summaries
+#define Profiler_History_Frames  300
+
+//number of threads used to update the vehicles, 0 = one per hardware thread
+#define Worker_Thread_Num  0
+
 #endif 
 
@@ -0,0 +1,199 @@
+//-----------------------------------------------------------------------------
+//
+//  Name:   Bench_CellSpacePartition.cpp
+//
+//  Desc:   compares the full cell scan (calculateNeighborsByScan) with the
+//          cell range query (calculateNeighbors, forEachNeighbor and the
+//          const calculateNeighbors into a caller owned vector) of
+//          CellSpacePartition at 1k/10k/100k entities.
+//
+//          The space is divided so that each cell holds about 4 entities on
+//          average and the query radius is one cell wide, the same ratio the
+//          vehicle demo uses.
+//
+//          It also times updateEntity for the list and vector cell storage
+//          with every entity jumping a random distance of up to one cell
+//          each frame, so a large share of the updates cross a cell border.
+//
+//          g++ -O2 -std=c++11 -I.. Bench_CellSpacePartition.cpp ../common/2D/Vector2D.cpp
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <vector>
+#include <cmath>
+
+#include "common/misc/CellSpacePartition.h"
+
+
+//a minimal entity, the partition only needs getPos(), and the vector
+//storage the cell slot
+class BenchEntity
+{
+public:
+    BenchEntity(Vector2D pos):m_vPos(pos), m_iCellSlot(-1){}
+    Vector2D getPos()const{return m_vPos;}
+    void setPos(Vector2D pos){m_vPos = pos;}
+    int getCellSlot()const{return m_iCellSlot;}
+    void setCellSlot(int slot){m_iCellSlot = slot;}
+private:
+    Vector2D m_vPos;
+    int m_iCellSlot;
+};
+
+struct CountNeighbors
+{
+    int count;
+    CountNeighbors():count(0){}
+    void operator()(BenchEntity* const&){++count;}
+};
+
+static double elapsedNs(std::chrono::steady_clock::time_point start, int ops)
+{
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    return (double)ns / ops;
+}
+
+static void runBench(int numEntities, int numQueries)
+{
+    const float spaceSize = 1000.0f;
+
+    //about 4 entities per cell
+    int cellsPerSide = (int)std::sqrt(numEntities / 4.0f);
+    if (cellsPerSide < 1) cellsPerSide = 1;
+
+    float radius = spaceSize / cellsPerSide;
+
+    Vector2D size(spaceSize, spaceSize);
+    CellSpacePartition<BenchEntity*> cellSpace(size, cellsPerSide, cellsPerSide, numEntities+1);
+
+    RandSeed(1);
+    std::vector<BenchEntity*> entities;
+    for (int i=0; i<numEntities; ++i)
+    {
+        BenchEntity* ent = new BenchEntity(Vector2D(spaceSize * RandFloat_0_1(), spaceSize * RandFloat_0_1()));
+        entities.push_back(ent);
+        cellSpace.addEntity(ent);
+    }
+
+    std::vector<Vector2D> queries;
+    for (int q=0; q<numQueries; ++q)
+    {
+        queries.push_back(Vector2D(spaceSize * RandFloat_0_1(), spaceSize * RandFloat_0_1()));
+    }
+
+    //full scan of every cell
+    long scanFound = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int q=0; q<numQueries; ++q)
+    {
+        cellSpace.calculateNeighborsByScan(queries[q], radius);
+        for (cellSpace.begin(); !cellSpace.end(); cellSpace.next()) ++scanFound;
+    }
+    double scanNs = elapsedNs(start, numQueries);
+
+    //range of cells
+    long rangeFound = 0;
+    start = std::chrono::steady_clock::now();
+    for (int q=0; q<numQueries; ++q)
+    {
+        cellSpace.calculateNeighbors(queries[q], radius);
+        for (cellSpace.begin(); !cellSpace.end(); cellSpace.next()) ++rangeFound;
+    }
+    double rangeNs = elapsedNs(start, numQueries);
+
+    //range of cells through the visitor
+    long visitFound = 0;
+    start = std::chrono::steady_clock::now();
+    for (int q=0; q<numQueries; ++q)
+    {
+        visitFound += cellSpace.forEachNeighbor(queries[q], radius, CountNeighbors()).count;
+    }
+    double visitNs = elapsedNs(start, numQueries);
+
+    //range of cells into a caller owned vector
+    long bufferFound = 0;
+    std::vector<BenchEntity*> neighbors;
+    start = std::chrono::steady_clock::now();
+    for (int q=0; q<numQueries; ++q)
+    {
+        bufferFound += cellSpace.calculateNeighbors(queries[q], radius, neighbors);
+    }
+    double bufferNs = elapsedNs(start, numQueries);
+
+    std::printf("%8d entities %5dx%-5d cells | scan %10.1f ns/query | range %8.1f ns/query | visitor %8.1f ns/query | buffer %8.1f ns/query | %s\n",
+                numEntities, cellsPerSide, cellsPerSide, scanNs, rangeNs, visitNs, bufferNs,
+                (scanFound == rangeFound && rangeFound == visitFound && visitFound == bufferFound) ? "ok" : "MISMATCH");
+
+    for (unsigned int i=0; i<entities.size(); ++i)
+    {
+        delete entities[i];
+    }
+}
+
+template <template <class> class storage>
+static double runUpdateBench(int numEntities, int numFrames)
+{
+    const float spaceSize = 1000.0f;
+
+    int cellsPerSide = (int)std::sqrt(numEntities / 4.0f);
+    if (cellsPerSide < 1) cellsPerSide = 1;
+
+    float cellSize = spaceSize / cellsPerSide;
+
+    Vector2D size(spaceSize, spaceSize);
+    CellSpacePartition<BenchEntity*, storage> cellSpace(size, cellsPerSide, cellsPerSide, numEntities+1);
+
+    RandSeed(2);
+    std::vector<BenchEntity*> entities;
+    for (int i=0; i<numEntities; ++i)
+    {
+        BenchEntity* ent = new BenchEntity(Vector2D(spaceSize * RandFloat_0_1(), spaceSize * RandFloat_0_1()));
+        entities.push_back(ent);
+        cellSpace.addEntity(ent);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int f=0; f<numFrames; ++f)
+    {
+        for (unsigned int i=0; i<entities.size(); ++i)
+        {
+            Vector2D oldPos = entities[i]->getPos();
+            Vector2D newPos = oldPos + Vector2D(RandFloat_minus1_1(), RandFloat_minus1_1()) * cellSize;
+
+            //keep it inside the space
+            clamp(newPos.x, 0.0f, spaceSize - 1.0f);
+            clamp(newPos.y, 0.0f, spaceSize - 1.0f);
+
+            entities[i]->setPos(newPos);
+            cellSpace.updateEntity(entities[i], oldPos);
+        }
+    }
+    double ns = elapsedNs(start, numFrames * numEntities);
+
+    for (unsigned int i=0; i<entities.size(); ++i)
+    {
+        delete entities[i];
+    }
+
+    return ns;
+}
+
+int main()
+{
+    runBench(1000, 20000);
+    runBench(10000, 20000);
+    runBench(100000, 2000);
+
+    int counts[] = {1000, 10000, 100000};
+    for (int c=0; c<3; ++c)
+    {
+        int frames = 1000000 / counts[c];
+        double listNs = runUpdateBench<CellStorage_List>(counts[c], frames);
+        double vecNs  = runUpdateBench<CellStorage_Vector>(counts[c], frames);
+
+        std::printf("%8d entities | updateEntity list %8.1f ns/op | vector %8.1f ns/op\n", counts[c], listNs, vecNs);
+    }
+
+    return 0;
+}
@@ -0,0 +1,1422 @@
+//-----------------------------------------------------------------------------
+//
+//  Name:   Bench_HotPaths.cpp
+//
+//  Desc:   times the hot paths of the ai-engine and reports ns/op and the
+//          number of heap allocations per op, so a change to any of them can
+//          be compared against the numbers from before it:
+//
+//          - Graph_SearchAStar, Graph_SearchAStar_TS, Graph_SearchDijkstra
+//            and Graph_SearchDijkstras_TS between random pairs of nodes, on
+//            a SparseGraph and on the same graph frozen (FrozenGraph),
+//            and A* and Dijkstra with each of the open lists
+//          - the hierarchical search (ClusterGraph) over the frozen graph
+//            in 10x10 clusters, to the first part of the path and to the
+//            whole path, and building the cluster graph
+//          - PathManager::updateSearches with a queue of 32 requests, half
+//            A* and half hierarchical, limited by search cycles and by time
+//          - CellSpacePartition::calculateNeighbors at 1 to 64 entities per
+//            cell
+//          - SteeringBehavior::calculate of the flocking vehicles in each
+//            summing mode
+//          - moving all the vehicles of the world one frame, one Vehicle at
+//            a time and through the VehicleKinematics arrays
+//          - FuzzyModule::deFuzzify with max_av and centroid, using the
+//            rocket launcher's desirability rules
+//          - doWallsObstructLineSegment over a wall vector and a WallGrid
+//          - EntityManager::getEntityByID, and creating and destroying
+//            entities
+//          - MessageDispatcher sending delayed messages and delivering them,
+//            and messages sent from a parallel job and delivered after it
+//          - a full update of the vehicle world, of the soccer pitch and of
+//            the Raven world with 8, 32 and 128 bots
+//
+//          No Raven maps ship with the tree, so the searches run on grid
+//          navgraphs of about the size of the Raven maps (and larger) with
+//          blocks of nodes taken out where walls would be. The Raven world
+//          is timed on a map made the same way, written to a file for
+//          Raven_Map::loadMap to read and deleted afterwards.
+//
+//          Every benchmark uses a fixed seed, so two runs do the same work.
+//          Pass a name (or part of one) to run only the matching benchmarks.
+//
+//          cmake --build build --target ai_engine_bench && build/ai_engine_bench [filter]
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <new>
+#include <atomic>
+#include <thread>
+#include <fstream>
+
+#include "GameConfig.h"
+#include "common/misc/CellSpacePartition.h"
+#include "common/misc/WorkerPool.h"
+#include "common/graph/SparseGraph.h"
+#include "common/graph/FrozenGraph.h"
+#include "common/graph/GraphNodeTypes.h"
+#include "common/graph/GraphEdgeTypes.h"
+#include "common/graph/HandyGraphFunctions.h"
+#include "common/navigation/GraphAlgorithms.h"
+#include "common/navigation/GraphAlgorithms_TimeSliced.h"
+#include "common/navigation/AStarHeuristicPolicies.h"
+#include "common/navigation/SearchTerminationPolicies.h"
+#include "common/navigation/ClusterGraph.h"
+#include "common/navigation/PathManager.h"
+#include "common/navigation/AsyncPathManager.h"
+#include "common/fuzzy/FuzzyModule.h"
+#include "common/game/Wall.h"
+#include "common/game/EntityManager.h"
+#include "common/game/WorldContext.h"
+#include "common/2D/WallGrid.h"
+#include "common/2D/WallIntersectionTests.h"
+#include "game_vehicle/GameWorldVehicle.h"
+#include "game_vehicle/Vehicle.h"
+#include "game_vehicle/SteeringBehaviors.h"
+#include "game_vehicle/VehicleKinematics.h"
+#include "game_soccer/SoccerPitch.h"
+#include "game_raven/GameWorldRaven.h"
+#include "game_raven/misc/ParaConfigRaven.h"
+
+
+//-----------------------------------------------------------------------------
+//
+//  every allocation of the program goes through these, so the number made
+//  while a benchmark runs can be read from g_NumAllocs.
+//
+//  GCC pairs free() with its own operator new rather than these and warns
+//  about a mismatch once they are inlined into a delete, so the warning is
+//  turned off for them
+//-----------------------------------------------------------------------------
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+static std::atomic<long long> g_NumAllocs(0);
+
+void* operator new(std::size_t size)
+{
+    ++g_NumAllocs;
+
+    void* p = std::malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+
+    return p;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+
+//only the benchmarks whose name contains this are run
+static const char* g_Filter = NULL;
+
+//the results are added to this so the work can't be optimized away
+static volatile float g_Sink = 0;
+
+static bool isSelected(const std::string& name)
+{
+    return !g_Filter || name.find(g_Filter) != std::string::npos;
+}
+
+//------------------------------- measure -------------------------------------
+//
+//  calls op(i) for i in [0, numOps) and prints the time and the number of
+//  allocations per call. op is called once for every i before the timing
+//  starts, so caches and lazily grown buffers are warm
+//-----------------------------------------------------------------------------
+template <class operation>
+static void measure(const std::string& name, operation& op, int numOps)
+{
+    if (!isSelected(name)) return;
+
+    for (int i=0; i<numOps; ++i) op(i);
+
+    long long allocsBefore = g_NumAllocs;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (int i=0; i<numOps; ++i) op(i);
+
+    long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    long long allocs = g_NumAllocs - allocsBefore;
+
+    std::printf("%-52s %14.1f ns/op %10.2f allocs/op\n", name.c_str(), (double)ns / numOps, (double)allocs / numOps);
+}
+
+static std::string withCount(const char* name, int count)
+{
+    char buffer[128];
+    std::sprintf(buffer, name, count);
+    return buffer;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  graph searches
+//
+///////////////////////////////////////////////////////////////////////////////
+typedef SparseGraph<NavGraphNode<>, NavGraphEdge> BenchGraph;
+typedef FrozenGraph<NavGraphNode<>, NavGraphEdge> BenchFrozenGraph;
+
+//------------------------------ createNavGraph -------------------------------
+//
+//  a cellsPerSide*cellsPerSide grid over a 500x500 map (the size of the Raven
+//  maps) with about a fifth of the nodes removed in rectangular blocks, like
+//  the walls of a map do
+//-----------------------------------------------------------------------------
+static void createNavGraph(BenchGraph& graph, int cellsPerSide)
+{
+    createGrid(graph, 500, 500, cellsPerSide, cellsPerSide);
+
+    int numToRemove = graph.getNumNodes() / 5;
+    while (numToRemove > 0)
+    {
+        int w = RandIntInRange(1, cellsPerSide/8 + 1);
+        int h = RandIntInRange(1, cellsPerSide/8 + 1);
+        int x = RandIntInRange(0, cellsPerSide - w);
+        int y = RandIntInRange(0, cellsPerSide - h);
+
+        for (int row=y; row<y+h; ++row)
+        {
+            for (int col=x; col<x+w; ++col)
+            {
+                int node = row*cellsPerSide + col;
+                if (graph.isNodePresent(node))
+                {
+                    graph.removeNode(node);
+                    --numToRemove;
+                }
+            }
+        }
+    }
+}
+
+//picks numPairs random pairs of nodes still in the graph
+static std::vector<std::pair<int, int> > createSearchPairs(const BenchGraph& graph, int numPairs)
+{
+    std::vector<int> nodes;
+    for (int n=0; n<graph.getNumNodes(); ++n)
+    {
+        if (graph.isNodePresent(n)) nodes.push_back(n);
+    }
+
+    std::vector<std::pair<int, int> > pairs;
+    for (int p=0; p<numPairs; ++p)
+    {
+        pairs.push_back(std::make_pair(nodes[RandIntInRange(0, (int)nodes.size()-1)], nodes[RandIntInRange(0, (int)nodes.size()-1)]));
+    }
+
+    return pairs;
+}
+
+template <class graph_type, class open_list = SearchOpenList>
+class AStarOp
+{
+public:
+    AStarOp(const graph_type& graph, const std::vector<std::pair<int, int> >& pairs):m_Graph(graph), m_Pairs(pairs){}
+
+    void operator()(int i)
+    {
+        const std::pair<int, int>& p = m_Pairs[i % m_Pairs.size()];
+        Graph_SearchAStar<graph_type, Heuristic_Euclid, open_list> search(m_Graph, p.first, p.second);
+        g_Sink += search.getCostToTarget();
+    }
+
+private:
+    const graph_type& m_Graph;
+    const std::vector<std::pair<int, int> >& m_Pairs;
+};
+
+template <class graph_type>
+class AStarTimeSlicedOp
+{
+public:
+    AStarTimeSlicedOp(const graph_type& graph, const std::vector<std::pair<int, int> >& pairs):m_Graph(graph), m_Pairs(pairs){}
+
+    void operator()(int i)
+    {
+        const std::pair<int, int>& p = m_Pairs[i % m_Pairs.size()];
+        Graph_SearchAStar_TS<graph_type, Heuristic_Euclid> search(m_Graph, p.first, p.second);
+        while (search.cycleOnce() == search_incomplete);
+        g_Sink += search.getCostToTarget();
+    }
+
+private:
+    const graph_type& m_Graph;
+    const std::vector<std::pair<int, int> >& m_Pairs;
+};
+
+template <class graph_type, class open_list = SearchOpenList>
+class DijkstraOp
+{
+public:
+    DijkstraOp(const graph_type& graph, const std::vector<std::pair<int, int> >& pairs):m_Graph(graph), m_Pairs(pairs){}
+
+    void operator()(int i)
+    {
+        const std::pair<int, int>& p = m_Pairs[i % m_Pairs.size()];
+        Graph_SearchDijkstra<graph_type, open_list> search(m_Graph, p.first, p.second);
+        g_Sink += search.getCostToTarget();
+    }
+
+private:
+    const graph_type& m_Graph;
+    const std::vector<std::pair<int, int> >& m_Pairs;
+};
+
+template <class graph_type>
+class DijkstraTimeSlicedOp
+{
+public:
+    DijkstraTimeSlicedOp(const graph_type& graph, const std::vector<std::pair<int, int> >& pairs):m_Graph(graph), m_Pairs(pairs){}
+
+    void operator()(int i)
+    {
+        const std::pair<int, int>& p = m_Pairs[i % m_Pairs.size()];
+        Graph_SearchDijkstras_TS<graph_type, FindNodeIndex> search(m_Graph, p.first, p.second);
+        while (search.cycleOnce() == search_incomplete);
+        g_Sink += search.getCostToTarget();
+    }
+
+private:
+    const graph_type& m_Graph;
+    const std::vector<std::pair<int, int> >& m_Pairs;
+};
+
+//---------------------------- createClusters ---------------------------------
+//
+//  the clusters of the nodes of a graph made by createNavGraph, the cells of
+//  a 10x10 grid over the map like the cell space partition of a Raven map
+//-----------------------------------------------------------------------------
+static std::vector<int> createClusters(const BenchFrozenGraph& graph)
+{
+    std::vector<int> clusterOfNode(graph.getNumNodes(), 0);
+
+    for (int n=0; n<graph.getNumNodes(); ++n)
+    {
+        if (!graph.isNodePresent(n)) continue;
+
+        Vector2D pos = graph.getNode(n).getPos();
+
+        int x = std::min((int)(pos.x / 50.0f), 9);
+        int y = std::min((int)(pos.y / 50.0f), 9);
+
+        clusterOfNode[n] = y*10 + x;
+    }
+
+    return clusterOfNode;
+}
+
+//plans with the cluster graph and refines the first part of the path, or
+//all of it if bWholePath
+class HierarchicalOp
+{
+public:
+    HierarchicalOp(const ClusterGraph<BenchFrozenGraph>& clusters,
+                   const std::vector<std::pair<int, int> >& pairs,
+                   bool bWholePath):m_Clusters(clusters), m_Pairs(pairs), m_bWholePath(bWholePath){}
+
+    void operator()(int i)
+    {
+        const std::pair<int, int>& p = m_Pairs[i % m_Pairs.size()];
+        Graph_SearchHierarchical_TS<BenchFrozenGraph> search(m_Clusters, p.first, p.second);
+        while (search.cycleOnce() == search_incomplete);
+        g_Sink += search.getCostToTarget();
+
+        if (m_bWholePath)
+        {
+            g_Sink += (float)search.getPathAsPathEdges().size();
+        }
+        else
+        {
+            g_Sink += (float)search.getNextPathSegment().size();
+        }
+    }
+
+private:
+    const ClusterGraph<BenchFrozenGraph>& m_Clusters;
+    const std::vector<std::pair<int, int> >& m_Pairs;
+    bool m_bWholePath;
+};
+
+class BuildClustersOp
+{
+public:
+    BuildClustersOp(const BenchFrozenGraph& graph):m_Graph(graph), m_ClusterOfNode(createClusters(graph)){}
+
+    void operator()(int)
+    {
+        ClusterGraph<BenchFrozenGraph> clusters(m_Graph, m_ClusterOfNode);
+        g_Sink += (float)clusters.getNumEntrances();
+    }
+
+private:
+    const BenchFrozenGraph& m_Graph;
+    std::vector<int> m_ClusterOfNode;
+};
+
+static void benchGraphSearches()
+{
+    int sizes[] = {32, 64, 128};
+
+    for (int s=0; s<3; ++s)
+    {
+        RandSeed(1);
+
+        BenchGraph graph(false);
+        createNavGraph(graph, sizes[s]);
+
+        std::vector<std::pair<int, int> > pairs = createSearchPairs(graph, 64);
+
+        int numOps = 20000 / sizes[s];
+
+        AStarOp<BenchGraph> aStar(graph, pairs);
+        measure(withCount("search/astar/%d_nodes", graph.getNumActiveNodes()), aStar, numOps);
+
+        AStarTimeSlicedOp<BenchGraph> aStarTS(graph, pairs);
+        measure(withCount("search/astar_ts/%d_nodes", graph.getNumActiveNodes()), aStarTS, numOps);
+
+        DijkstraOp<BenchGraph> dijkstra(graph, pairs);
+        measure(withCount("search/dijkstra/%d_nodes", graph.getNumActiveNodes()), dijkstra, numOps);
+
+        DijkstraTimeSlicedOp<BenchGraph> dijkstraTS(graph, pairs);
+        measure(withCount("search/dijkstra_ts/%d_nodes", graph.getNumActiveNodes()), dijkstraTS, numOps);
+
+        //the same searches on the graph frozen
+        BenchFrozenGraph frozen(graph);
+
+        AStarOp<BenchFrozenGraph> aStarFrozen(frozen, pairs);
+        measure(withCount("search/astar_frozen/%d_nodes", frozen.getNumActiveNodes()), aStarFrozen, numOps);
+
+        AStarTimeSlicedOp<BenchFrozenGraph> aStarTSFrozen(frozen, pairs);
+        measure(withCount("search/astar_ts_frozen/%d_nodes", frozen.getNumActiveNodes()), aStarTSFrozen, numOps);
+
+        DijkstraOp<BenchFrozenGraph> dijkstraFrozen(frozen, pairs);
+        measure(withCount("search/dijkstra_frozen/%d_nodes", frozen.getNumActiveNodes()), dijkstraFrozen, numOps);
+
+        DijkstraTimeSlicedOp<BenchFrozenGraph> dijkstraTSFrozen(frozen, pairs);
+        measure(withCount("search/dijkstra_ts_frozen/%d_nodes", frozen.getNumActiveNodes()), dijkstraTSFrozen, numOps);
+
+        //and with each of the open lists
+        AStarOp<BenchFrozenGraph, indexedPriorityQLow<float> > aStarBinary(frozen, pairs);
+        measure(withCount("search/open_list/astar_binary/%d_nodes", frozen.getNumActiveNodes()), aStarBinary, numOps);
+
+        AStarOp<BenchFrozenGraph, indexedDaryPriorityQLow<float> > aStar4ary(frozen, pairs);
+        measure(withCount("search/open_list/astar_4ary/%d_nodes", frozen.getNumActiveNodes()), aStar4ary, numOps);
+
+        AStarOp<BenchFrozenGraph, indexedPairingPriorityQLow<float> > aStarPairing(frozen, pairs);
+        measure(withCount("search/open_list/astar_pairing/%d_nodes", frozen.getNumActiveNodes()), aStarPairing, numOps);
+
+        AStarOp<BenchFrozenGraph, radixPriorityQLow> aStarRadix(frozen, pairs);
+        measure(withCount("search/open_list/astar_radix/%d_nodes", frozen.getNumActiveNodes()), aStarRadix, numOps);
+
+        DijkstraOp<BenchFrozenGraph, indexedPriorityQLow<float> > dijkstraBinary(frozen, pairs);
+        measure(withCount("search/open_list/dijkstra_binary/%d_nodes", frozen.getNumActiveNodes()), dijkstraBinary, numOps);
+
+        DijkstraOp<BenchFrozenGraph, indexedDaryPriorityQLow<float> > dijkstra4ary(frozen, pairs);
+        measure(withCount("search/open_list/dijkstra_4ary/%d_nodes", frozen.getNumActiveNodes()), dijkstra4ary, numOps);
+
+        DijkstraOp<BenchFrozenGraph, indexedPairingPriorityQLow<float> > dijkstraPairing(frozen, pairs);
+        measure(withCount("search/open_list/dijkstra_pairing/%d_nodes", frozen.getNumActiveNodes()), dijkstraPairing, numOps);
+
+        DijkstraOp<BenchFrozenGraph, radixPriorityQLow> dijkstraRadix(frozen, pairs);
+        measure(withCount("search/open_list/dijkstra_radix/%d_nodes", frozen.getNumActiveNodes()), dijkstraRadix, numOps);
+
+        //and hierarchically, compare with search/astar_frozen
+        ClusterGraph<BenchFrozenGraph> clusters(frozen, createClusters(frozen));
+
+        HierarchicalOp hierarchicalFirst(clusters, pairs, false);
+        measure(withCount("search/hierarchical/first_segment/%d_nodes", frozen.getNumActiveNodes()), hierarchicalFirst, numOps);
+
+        HierarchicalOp hierarchicalWhole(clusters, pairs, true);
+        measure(withCount("search/hierarchical/whole_path/%d_nodes", frozen.getNumActiveNodes()), hierarchicalWhole, numOps);
+
+        BuildClustersOp buildClusters(frozen);
+        measure(withCount("search/hierarchical/build/%d_nodes", frozen.getNumActiveNodes()), buildClusters, 10);
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  path manager
+//
+///////////////////////////////////////////////////////////////////////////////
+
+//plans paths between the pairs one after another, with A* or hierarchically
+class BenchPlanner
+{
+public:
+    typedef BenchFrozenGraph::EdgeType EdgeType;
+    typedef Graph_SearchTimeSliced<EdgeType> Search;
+
+    BenchPlanner(const ClusterGraph<BenchFrozenGraph>& clusters,
+                 const std::vector<std::pair<int, int> >& pairs,
+                 int firstPair,
+                 bool bHierarchical):m_Clusters(clusters),
+                                     m_Pairs(pairs),
+                                     m_iNextPair(firstPair),
+                                     m_bHierarchical(bHierarchical),
+                                     m_pSearch(NULL),
+                                     m_bFinished(true)
+    {}
+
+    ~BenchPlanner(){delete m_pSearch;}
+
+    void startSearch()
+    {
+        delete m_pSearch;
+
+        const std::pair<int, int>& p = m_Pairs[m_iNextPair++ % m_Pairs.size()];
+
+        if (m_bHierarchical)
+        {
+            m_pSearch = new Graph_SearchHierarchical_TS<BenchFrozenGraph>(m_Clusters, p.first, p.second);
+        }
+        else
+        {
+            m_pSearch = new Graph_SearchAStar_TS<BenchFrozenGraph, Heuristic_Euclid>(m_Clusters.getGraph(), p.first, p.second);
+        }
+
+        m_bFinished = false;
+    }
+
+    int cycleOnce()
+    {
+        int result = m_pSearch->cycleOnce();
+
+        m_bFinished = (result != search_incomplete);
+
+        return result;
+    }
+
+    //the asynchronous path manager hands the search back with this
+    void searchFinished(int){m_bFinished = true;}
+
+    Search* getSearch(){return m_pSearch;}
+
+    bool isFinished()const{return m_bFinished;}
+
+private:
+    const ClusterGraph<BenchFrozenGraph>& m_Clusters;
+    const std::vector<std::pair<int, int> >& m_Pairs;
+    int m_iNextPair;
+    bool m_bHierarchical;
+    Search* m_pSearch;
+    bool m_bFinished;
+};
+
+//one update of the path manager. Planners whose searches finished start
+//new ones, so the queue stays full
+class PathManagerOp
+{
+public:
+    PathManagerOp(PathManager<BenchPlanner>& manager,
+                  std::vector<BenchPlanner*>& planners):m_Manager(manager), m_Planners(planners){}
+
+    void operator()(int)
+    {
+        for (unsigned int p=0; p<m_Planners.size(); ++p)
+        {
+            if (m_Planners[p]->isFinished())
+            {
+                m_Planners[p]->startSearch();
+                m_Manager.registerPlan(m_Planners[p], (float)(p % 4));
+            }
+        }
+
+        m_Manager.updateSearches();
+
+        g_Sink += (float)m_Manager.getNumActiveSearches();
+    }
+
+private:
+    PathManager<BenchPlanner>& m_Manager;
+    std::vector<BenchPlanner*>& m_Planners;
+};
+
+//plans a path for every planner, on the game thread with the path manager
+//or on threads of their own with the asynchronous one, and waits for them
+//all to be found
+class PlanAllOp
+{
+public:
+    PlanAllOp(std::vector<BenchPlanner*>& planners,
+              AsyncPathManager<BenchPlanner>* pAsync):m_Planners(planners), m_pAsync(pAsync), m_Manager(1000000){}
+
+    void operator()(int)
+    {
+        for (unsigned int p=0; p<m_Planners.size(); ++p)
+        {
+            m_Planners[p]->startSearch();
+
+            if (m_pAsync) m_pAsync->registerPlan(m_Planners[p], m_Planners[p]->getSearch());
+            else          m_Manager.registerPlan(m_Planners[p]);
+        }
+
+        if (m_pAsync)
+        {
+            while (m_pAsync->getNumActiveSearches() > 0)
+            {
+                std::this_thread::yield();
+                m_pAsync->deliverResults();
+            }
+        }
+        else
+        {
+            while (m_Manager.getNumActiveSearches() > 0) m_Manager.updateSearches();
+        }
+    }
+
+private:
+    std::vector<BenchPlanner*>& m_Planners;
+    AsyncPathManager<BenchPlanner>* m_pAsync;
+    PathManager<BenchPlanner> m_Manager;
+};
+
+static void benchPathManager()
+{
+    RandSeed(2);
+
+    BenchGraph graph(false);
+    createNavGraph(graph, 128);
+
+    BenchFrozenGraph frozen(graph);
+    ClusterGraph<BenchFrozenGraph> clusters(frozen, createClusters(frozen));
+
+    std::vector<std::pair<int, int> > pairs = createSearchPairs(graph, 256);
+
+    const int numPlanners = 32;
+
+    std::vector<BenchPlanner*> planners;
+    for (int p=0; p<numPlanners; ++p)
+    {
+        planners.push_back(new BenchPlanner(clusters, pairs, p*8, (p % 2) == 1));
+    }
+
+    //1000 cycles an update, as Raven did before it had a time budget
+    {
+        PathManager<BenchPlanner> manager(1000);
+        PathManagerOp update(manager, planners);
+        measure(withCount("path_manager/update/%d_requests_1000_cycles", numPlanners), update, 500);
+
+        for (int p=0; p<numPlanners; ++p) manager.unRegisterPlan(planners[p]);
+    }
+
+    //200us an update
+    {
+        PathManager<BenchPlanner> manager(1000000, 200.0f);
+        PathManagerOp update(manager, planners);
+        std::string name = withCount("path_manager/update/%d_requests_200us", numPlanners);
+        measure(name, update, 500);
+
+        const PathManagerStats& stats = manager.getStats();
+        if (isSelected(name)) std::printf("    %d paths, latency mean %.1f max %d updates, update max %.0fus\n",
+                    stats.numCompleted, stats.getMeanLatencyUpdates(), stats.maxLatencyUpdates, stats.maxUpdateUs);
+
+        for (int p=0; p<numPlanners; ++p) manager.unRegisterPlan(planners[p]);
+    }
+
+    for (int p=0; p<numPlanners; ++p) delete planners[p];
+    planners.clear();
+
+    //enough paths for 64 bots, all at once
+    const int numPaths = 64;
+
+    for (int p=0; p<numPaths; ++p)
+    {
+        planners.push_back(new BenchPlanner(clusters, pairs, p*4, false));
+    }
+
+    PlanAllOp gameThread(planners, NULL);
+    measure(withCount("path_manager/plan_all/%d_paths/game_thread", numPaths), gameThread, 20);
+
+    //1, 2, 4... threads and then one per spare hardware thread
+    int maxThreads = (std::max)((int)std::thread::hardware_concurrency() - 1, 1);
+
+    std::vector<int> numThreads;
+    for (int t=1; t<maxThreads; t*=2) numThreads.push_back(t);
+    numThreads.push_back(maxThreads);
+
+    for (unsigned int t=0; t<numThreads.size(); ++t)
+    {
+        AsyncPathManager<BenchPlanner> async(numThreads[t]);
+        PlanAllOp threads(planners, &async);
+
+        char name[64];
+        std::sprintf(name, "path_manager/plan_all/%d_paths/%d_threads", numPaths, numThreads[t]);
+        measure(name, threads, 20);
+    }
+
+    for (int p=0; p<numPaths; ++p) delete planners[p];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  cell space partition
+//
+///////////////////////////////////////////////////////////////////////////////
+
+//a minimal entity, the partition only needs getPos()
+class BenchEntity
+{
+public:
+    BenchEntity(Vector2D pos):m_vPos(pos){}
+    Vector2D getPos()const{return m_vPos;}
+private:
+    Vector2D m_vPos;
+};
+
+class NeighborsOp
+{
+public:
+    NeighborsOp(CellSpacePartition<BenchEntity*>& cellSpace,
+                const std::vector<Vector2D>& queries,
+                float radius):m_CellSpace(cellSpace), m_Queries(queries), m_dRadius(radius){}
+
+    void operator()(int i)
+    {
+        m_CellSpace.calculateNeighbors(m_Queries[i % m_Queries.size()], m_dRadius);
+
+        int found = 0;
+        for (m_CellSpace.begin(); !m_CellSpace.end(); m_CellSpace.next()) ++found;
+
+        g_Sink += (float)found;
+    }
+
+private:
+    CellSpacePartition<BenchEntity*>& m_CellSpace;
+    const std::vector<Vector2D>& m_Queries;
+    float m_dRadius;
+};
+
+static void benchCellSpace()
+{
+    const float spaceSize = 1000.0f;
+    const int numEntities = 10000;
+
+    int densities[] = {1, 4, 16, 64};
+
+    for (int d=0; d<4; ++d)
+    {
+        RandSeed(2);
+
+        int cellsPerSide = (int)std::sqrt((float)numEntities / densities[d]);
+
+        Vector2D size(spaceSize, spaceSize);
+        CellSpacePartition<BenchEntity*> cellSpace(size, cellsPerSide, cellsPerSide, numEntities+1);
+
+        std::vector<BenchEntity*> entities;
+        for (int i=0; i<numEntities; ++i)
+        {
+            entities.push_back(new BenchEntity(Vector2D(spaceSize * RandFloat_0_1(), spaceSize * RandFloat_0_1())));
+            cellSpace.addEntity(entities.back());
+        }
+
+        std::vector<Vector2D> queries;
+        for (int q=0; q<1024; ++q)
+        {
+            queries.push_back(Vector2D(spaceSize * RandFloat_0_1(), spaceSize * RandFloat_0_1()));
+        }
+
+        //the query radius is one cell wide
+        NeighborsOp neighbors(cellSpace, queries, spaceSize / cellsPerSide);
+        measure(withCount("cellspace/calculateNeighbors/%d_per_cell", densities[d]), neighbors, 20000);
+
+        for (unsigned int i=0; i<entities.size(); ++i)
+        {
+            delete entities[i];
+        }
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  steering
+//
+///////////////////////////////////////////////////////////////////////////////
+class SteeringOp
+{
+public:
+    SteeringOp(const std::vector<Vehicle*>& vehicles):m_Vehicles(vehicles){}
+
+    void operator()(int i)
+    {
+        g_Sink += m_Vehicles[i % m_Vehicles.size()]->getSteering()->calculate().x;
+    }
+
+private:
+    const std::vector<Vehicle*>& m_Vehicles;
+};
+
+static void benchSteering()
+{
+    const char* names[] = {"weighted_average", "prioritized", "dithered", "prioritized_fused"};
+    SteeringBehavior::summing_method methods[] = {SteeringBehavior::weighted_average,
+                                                  SteeringBehavior::prioritized,
+                                                  SteeringBehavior::dithered,
+                                                  SteeringBehavior::prioritized_fused};
+
+    for (int m=0; m<4; ++m)
+    {
+        GameWorldVehicle* pWorld = GameWorldVehicle::create(Win_Width, Win_Height, true, 3);
+
+        const std::vector<Vehicle*>& vehicles = pWorld->getVehicles();
+        for (unsigned int v=0; v<vehicles.size(); ++v)
+        {
+            vehicles[v]->getSteering()->SetSummingMethod(methods[m]);
+        }
+
+        //let the flock form before timing it
+        for (int f=0; f<60; ++f) pWorld->update(Sim_Time_Step);
+
+        SteeringOp steering(vehicles);
+        measure(std::string("steering/calculate/") + names[m], steering, 50000);
+
+        delete pWorld;
+    }
+}
+
+//moves each vehicle on its own, as Vehicle::update does
+class IntegrateOp
+{
+public:
+    IntegrateOp(const std::vector<Vehicle*>& vehicles):m_Vehicles(vehicles){}
+
+    void operator()(int)
+    {
+        for (unsigned int v=0; v<m_Vehicles.size(); ++v)
+        {
+            m_Vehicles[v]->integrate(Sim_Time_Step);
+        }
+    }
+
+private:
+    const std::vector<Vehicle*>& m_Vehicles;
+};
+
+//copies the vehicles into the arrays, moves them all and copies them back,
+//as GameWorldVehicle::update does
+class KinematicsOp
+{
+public:
+    KinematicsOp(const std::vector<Vehicle*>& vehicles):m_Vehicles(vehicles){}
+
+    void operator()(int)
+    {
+        int numVehicles = (int)m_Vehicles.size();
+
+        m_Kinematics.resize(numVehicles);
+        m_Kinematics.load(m_Vehicles, 0, numVehicles);
+        m_Kinematics.integrate(0, numVehicles, Sim_Time_Step, Win_Width, Win_Height);
+        m_Kinematics.store(m_Vehicles, 0, numVehicles);
+    }
+
+private:
+    const std::vector<Vehicle*>& m_Vehicles;
+    VehicleKinematics m_Kinematics;
+};
+
+static void benchIntegration()
+{
+    GameWorldVehicle* pWorld = GameWorldVehicle::create(Win_Width, Win_Height, true, 3);
+
+    //the steering forces integrated are the ones of the last update
+    for (int f=0; f<60; ++f) pWorld->update(Sim_Time_Step);
+
+    const std::vector<Vehicle*>& vehicles = pWorld->getVehicles();
+
+    IntegrateOp perVehicle(vehicles);
+    measure(withCount("vehicle/integrate/per_vehicle/%d_vehicles", (int)vehicles.size()), perVehicle, 20000);
+
+    KinematicsOp arrays(vehicles);
+    measure(withCount("vehicle/integrate/kinematics/%d_vehicles", (int)vehicles.size()), arrays, 20000);
+
+    delete pWorld;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  fuzzy logic
+//
+///////////////////////////////////////////////////////////////////////////////
+
+//the desirability rules of the rocket launcher
+static void initializeFuzzyModule(FuzzyModule& fm)
+{
+    FuzzyVariable& DistToTarget = fm.createFLV("DistToTarget");
+
+    FzSet Target_Close = DistToTarget.addLeftShoulderSet("Target_Close",0,25,150);
+    FzSet Target_Medium = DistToTarget.addTriangularSet("Target_Medium",25,150,300);
+    FzSet Target_Far = DistToTarget.addRightShoulderSet("Target_Far",150,300,1000);
+
+    FuzzyVariable& Desirability = fm.createFLV("Desirability");
+    FzSet VeryDesirable = Desirability.addRightShoulderSet("VeryDesirable", 50, 75, 100);
+    FzSet Desirable = Desirability.addTriangularSet("Desirable", 25, 50, 75);
+    FzSet Undesirable = Desirability.addLeftShoulderSet("Undesirable", 0, 25, 50);
+
+    FuzzyVariable& AmmoStatus = fm.createFLV("AmmoStatus");
+    FzSet Ammo_Loads = AmmoStatus.addRightShoulderSet("Ammo_Loads", 10, 30, 100);
+    FzSet Ammo_Okay = AmmoStatus.addTriangularSet("Ammo_Okay", 0, 10, 30);
+    FzSet Ammo_Low = AmmoStatus.addTriangularSet("Ammo_Low", 0, 0, 10);
+
+    FzSet* distances[] = {&Target_Close, &Target_Medium, &Target_Far};
+    FzSet* ammo[] = {&Ammo_Loads, &Ammo_Okay, &Ammo_Low};
+    FzSet* results[3][3] = {{&Undesirable, &Undesirable, &Undesirable},
+                            {&VeryDesirable, &VeryDesirable, &Desirable},
+                            {&Desirable, &Undesirable, &Undesirable}};
+
+    for (int d=0; d<3; ++d)
+    {
+        for (int a=0; a<3; ++a)
+        {
+            FzAND antecedent(*distances[d], *ammo[a]);
+            fm.addRule(antecedent, *results[d][a]);
+        }
+    }
+}
+
+class DeFuzzifyOp
+{
+public:
+    DeFuzzifyOp(FuzzyModule& fm, FuzzyModule::DefuzzifyMethod method):m_FuzzyModule(fm), m_Method(method){}
+
+    void operator()(int i)
+    {
+        m_FuzzyModule.fuzzify("DistToTarget", (float)(i % 500));
+        m_FuzzyModule.fuzzify("AmmoStatus", (float)(i % 50));
+
+        g_Sink += m_FuzzyModule.deFuzzify("Desirability", m_Method);
+    }
+
+private:
+    FuzzyModule& m_FuzzyModule;
+    FuzzyModule::DefuzzifyMethod m_Method;
+};
+
+static void benchFuzzy()
+{
+    FuzzyModule fm;
+    initializeFuzzyModule(fm);
+
+    DeFuzzifyOp maxAv(fm, FuzzyModule::max_av);
+    measure("fuzzy/deFuzzify/max_av", maxAv, 200000);
+
+    DeFuzzifyOp centroid(fm, FuzzyModule::centroid);
+    measure("fuzzy/deFuzzify/centroid", centroid, 200000);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  wall intersection
+//
+///////////////////////////////////////////////////////////////////////////////
+template <class walls_type>
+class ObstructOp
+{
+public:
+    ObstructOp(const walls_type& walls, const std::vector<Vector2D>& segments):m_Walls(walls), m_Segments(segments){}
+
+    void operator()(int i)
+    {
+        int s = (i % (m_Segments.size()/2)) * 2;
+        g_Sink += doWallsObstructLineSegment(m_Segments[s], m_Segments[s+1], m_Walls) ? 1.0f : 0.0f;
+    }
+
+private:
+    const walls_type& m_Walls;
+    const std::vector<Vector2D>& m_Segments;
+};
+
+static void benchWalls()
+{
+    const float mapSize = 1000.0f;
+
+    int counts[] = {64, 256, 1024};
+
+    for (int c=0; c<3; ++c)
+    {
+        RandSeed(4);
+
+        //short walls scattered over the map, and segments about as long as
+        //a line of sight between two bots
+        std::vector<Wall*> walls;
+        for (int w=0; w<counts[c]; ++w)
+        {
+            Vector2D from(mapSize * RandFloat_0_1(), mapSize * RandFloat_0_1());
+            Vector2D to = from + Vector2D(RandFloat_minus1_1(), RandFloat_minus1_1()) * 40.0f;
+            walls.push_back(new Wall(from, to));
+        }
+
+        std::vector<Vector2D> segments;
+        for (int s=0; s<1024; ++s)
+        {
+            Vector2D from(mapSize * RandFloat_0_1(), mapSize * RandFloat_0_1());
+            segments.push_back(from);
+            segments.push_back(from + Vector2D(RandFloat_minus1_1(), RandFloat_minus1_1()) * 200.0f);
+        }
+
+        WallGrid grid;
+        grid.build(walls, 32, 32);
+
+        ObstructOp<std::vector<Wall*> > vectorOp(walls, segments);
+        measure(withCount("walls/doWallsObstructLineSegment/vector/%d_walls", counts[c]), vectorOp, 100000);
+
+        ObstructOp<WallGrid> gridOp(grid, segments);
+        measure(withCount("walls/doWallsObstructLineSegment/grid/%d_walls", counts[c]), gridOp, 100000);
+
+        for (unsigned int w=0; w<walls.size(); ++w)
+        {
+            delete walls[w];
+        }
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  entity registry
+//
+///////////////////////////////////////////////////////////////////////////////
+class EntityLookupOp
+{
+public:
+    EntityLookupOp(const std::vector<int>& ids):m_IDs(ids){}
+
+    void operator()(int i)
+    {
+        BaseEntity* pEntity = EntityManager::instance()->getEntityByID(m_IDs[i % m_IDs.size()]);
+        g_Sink += pEntity ? pEntity->getPos().x : 1.0f;
+    }
+
+private:
+    const std::vector<int>& m_IDs;
+};
+
+//replaces a random entity with a new one
+class EntityChurnOp
+{
+public:
+    EntityChurnOp(std::vector<BaseEntity*>& entities):m_Entities(entities){}
+
+    void operator()(int)
+    {
+        int e = RandIntInRange(0, (int)m_Entities.size()-1);
+        delete m_Entities[e];
+        m_Entities[e] = new BaseEntity();
+    }
+
+private:
+    std::vector<BaseEntity*>& m_Entities;
+};
+
+static void benchEntities()
+{
+    RandSeed(6);
+
+    const int sizes[] = {100, 1000, 10000};
+
+    for (int s=0; s<3; ++s)
+    {
+        std::vector<BaseEntity*> entities;
+        for (int e=0; e<sizes[s]; ++e) entities.push_back(new BaseEntity());
+
+        //every other lookup is for an entity that has gone
+        std::vector<int> ids;
+        for (int l=0; l<4096; ++l)
+        {
+            BaseEntity* pEntity = entities[RandIntInRange(0, (int)entities.size()-1)];
+            ids.push_back(pEntity->getID());
+            if (l % 2)
+            {
+                BaseEntity* pDead = new BaseEntity();
+                ids.push_back(pDead->getID());
+                delete pDead;
+            }
+        }
+
+        EntityLookupOp lookup(ids);
+        measure(withCount("entity/getEntityByID/%d", sizes[s]), lookup, 200000);
+
+        EntityChurnOp churn(entities);
+        measure(withCount("entity/create_destroy/%d", sizes[s]), churn, 20000);
+
+        for (unsigned int e=0; e<entities.size(); ++e) delete entities[e];
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  delayed messages
+//
+///////////////////////////////////////////////////////////////////////////////
+class MessageCounter : public BaseEntity
+{
+public:
+    bool handleMessage(const Telegram& msg)
+    {
+        g_Sink += (float)msg.m_msgId;
+        return true;
+    }
+};
+
+//sends a message with a delay of up to maxDelay seconds to a random
+//entity, and every msgsPerTick messages ticks the clock and delivers the
+//messages that are due
+class DelayedMessageOp
+{
+public:
+    DelayedMessageOp(WorldContext& context,
+                     const std::vector<MessageCounter*>& entities,
+                     float maxDelay,
+                     int msgsPerTick):m_Context(context),
+                                      m_Entities(entities),
+                                      m_dMaxDelay(maxDelay),
+                                      m_iMsgsPerTick(msgsPerTick)
+    {}
+
+    void operator()(int i)
+    {
+        int receiver = m_Entities[RandIntInRange(0, (int)m_Entities.size()-1)]->getID();
+
+        m_Context.getDispatcher().dispatchMsg(RandFloat_0_1() * m_dMaxDelay, SENDER_ID_IRRELEVANT, receiver, i & 15, NO_ADDITIONAL_INFO);
+
+        if (i % m_iMsgsPerTick == 0)
+        {
+            m_Context.getClock().tick();
+            m_Context.getDispatcher().dispatchMsgDelay();
+        }
+    }
+
+private:
+    WorldContext& m_Context;
+    const std::vector<MessageCounter*>& m_Entities;
+    float m_dMaxDelay;
+    int m_iMsgsPerTick;
+};
+
+//every entity sends a message to another one, on the threads of the pool
+class SendJob : public ParallelJob
+{
+public:
+    SendJob(MessageDispatcher& dispatcher,
+            const std::vector<MessageCounter*>& entities,
+            const std::vector<int>& receivers):m_Dispatcher(dispatcher),
+                                               m_Entities(entities),
+                                               m_Receivers(receivers)
+    {}
+
+    void process(int begin, int end)
+    {
+        for (int i=begin; i<end; ++i)
+        {
+            m_Dispatcher.dispatchMsg(SEND_MSG_IMMEDIATELY, m_Entities[i]->getID(), m_Receivers[i], i & 15, i);
+        }
+    }
+
+private:
+    MessageDispatcher& m_Dispatcher;
+    const std::vector<MessageCounter*>& m_Entities;
+    const std::vector<int>& m_Receivers;
+};
+
+//one tick of SendJob, with the messages deferred and delivered after it or
+//(on one thread only) delivered as they are sent
+class DeferredMessageOp
+{
+public:
+    DeferredMessageOp(MessageDispatcher& dispatcher,
+                      WorkerPool& workers,
+                      SendJob& job,
+                      int numSenders,
+                      bool defer):m_Dispatcher(dispatcher),
+                                  m_Workers(workers),
+                                  m_Job(job),
+                                  m_iNumSenders(numSenders),
+                                  m_bDefer(defer)
+    {}
+
+    void operator()(int)
+    {
+        if (m_bDefer) m_Dispatcher.beginDeferring();
+
+        m_Workers.run(m_Job, m_iNumSenders, 64);
+
+        if (m_bDefer) m_Dispatcher.deliverDeferredMsgs();
+    }
+
+private:
+    MessageDispatcher& m_Dispatcher;
+    WorkerPool& m_Workers;
+    SendJob& m_Job;
+    int m_iNumSenders;
+    bool m_bDefer;
+};
+
+static void benchMessages()
+{
+    WorldContext context(Sim_Time_Step, 7);
+    context.makeCurrent();
+
+    std::vector<MessageCounter*> entities;
+    for (int e=0; e<256; ++e) entities.push_back(new MessageCounter());
+
+    const float delays[] = {0.5f, 5.0f, 60.0f};
+
+    for (int d=0; d<3; ++d)
+    {
+        DelayedMessageOp send(context, entities, delays[d], 16);
+
+        char name[64];
+        std::sprintf(name, "message/delayed/up_to_%gs", delays[d]);
+        measure(name, send, 200000);
+    }
+
+    for (unsigned int e=0; e<entities.size(); ++e) delete entities[e];
+    entities.clear();
+
+    const int numSenders = 4096;
+
+    for (int e=0; e<numSenders; ++e) entities.push_back(new MessageCounter());
+
+    std::vector<int> receivers;
+    for (int e=0; e<numSenders; ++e)
+    {
+        receivers.push_back(entities[RandIntInRange(0, numSenders-1)]->getID());
+    }
+
+    SendJob job(context.getDispatcher(), entities, receivers);
+
+    WorkerPool serial(1);
+    DeferredMessageOp immediate(context.getDispatcher(), serial, job, numSenders, false);
+    measure(withCount("message/immediate/%d_per_tick", numSenders), immediate, 2000);
+
+    DeferredMessageOp deferredSerial(context.getDispatcher(), serial, job, numSenders, true);
+    measure(withCount("message/deferred/%d_per_tick/1_thread", numSenders), deferredSerial, 2000);
+
+    WorkerPool workers(Worker_Thread_Num);
+    if (workers.getNumThreads() > 1)
+    {
+        DeferredMessageOp deferred(context.getDispatcher(), workers, job, numSenders, true);
+
+        char name[64];
+        std::sprintf(name, "message/deferred/%d_per_tick/%d_threads", numSenders, workers.getNumThreads());
+        measure(name, deferred, 2000);
+    }
+
+    for (unsigned int e=0; e<entities.size(); ++e) delete entities[e];
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  world updates
+//
+///////////////////////////////////////////////////////////////////////////////
+template <class world_type>
+class WorldUpdateOp
+{
+public:
+    WorldUpdateOp(world_type* pWorld):m_pWorld(pWorld){}
+
+    void operator()(int)
+    {
+        m_pWorld->update(Sim_Time_Step);
+    }
+
+private:
+    world_type* m_pWorld;
+};
+
+//the Raven world's update takes no time step
+class RavenUpdateOp
+{
+public:
+    RavenUpdateOp(GameWorldRaven* pWorld):m_pWorld(pWorld){}
+
+    void operator()(int)
+    {
+        m_pWorld->update();
+    }
+
+private:
+    GameWorldRaven* m_pWorld;
+};
+
+//------------------------------ writeRavenMap --------------------------------
+//
+//  writes a Raven map file of a 25x25 grid navgraph over 500x500 with
+//  walled blocks taken out of it, walls around the edge, a spawn point at
+//  every tenth node and a few health and weapon givers
+//-----------------------------------------------------------------------------
+static bool writeRavenMap(const char* FileName)
+{
+    const int   cellsPerSide = 25;
+    const float cellSize     = 500.0f / cellsPerSide;
+
+    BenchGraph graph(false);
+    createGrid(graph, 500, 500, cellsPerSide, cellsPerSide);
+
+    std::vector<Vector2D> walls;
+
+    for (int block=0; block<12; ++block)
+    {
+        int w = RandIntInRange(1, 3);
+        int h = RandIntInRange(1, 3);
+        int x = RandIntInRange(1, cellsPerSide - w - 1);
+        int y = RandIntInRange(1, cellsPerSide - h - 1);
+
+        for (int row=y; row<y+h; ++row)
+        {
+            for (int col=x; col<x+w; ++col)
+            {
+                int node = row*cellsPerSide + col;
+                if (graph.isNodePresent(node)) graph.removeNode(node);
+            }
+        }
+
+        Vector2D topLeft(x*cellSize, y*cellSize);
+        Vector2D botRight((x+w)*cellSize, (y+h)*cellSize);
+
+        walls.push_back(topLeft);                        walls.push_back(Vector2D(botRight.x, topLeft.y));
+        walls.push_back(Vector2D(botRight.x, topLeft.y)); walls.push_back(botRight);
+        walls.push_back(botRight);                       walls.push_back(Vector2D(topLeft.x, botRight.y));
+        walls.push_back(Vector2D(topLeft.x, botRight.y)); walls.push_back(topLeft);
+    }
+
+    walls.push_back(Vector2D(1,1));     walls.push_back(Vector2D(499,1));
+    walls.push_back(Vector2D(499,1));   walls.push_back(Vector2D(499,499));
+    walls.push_back(Vector2D(499,499)); walls.push_back(Vector2D(1,499));
+    walls.push_back(Vector2D(1,499));   walls.push_back(Vector2D(1,1));
+
+    std::ofstream out(FileName);
+    if (!out) return false;
+
+    graph.save(out);
+
+    out << 500 << " " << 500 << std::endl;
+
+    for (unsigned int w=0; w<walls.size(); w+=2)
+    {
+        out << type_wall << " " << walls[w].x << " " << walls[w].y << " "
+            << walls[w+1].x << " " << walls[w+1].y << " 0 0" << std::endl;
+    }
+
+    int id = 0;
+    int numGivers = 0;
+    for (int n=0; n<graph.getNumNodes(); n+=10)
+    {
+        if (!graph.isNodePresent(n)) continue;
+
+        Vector2D pos = graph.getNode(n).getPos();
+
+        out << type_spawn_point << " 0 " << pos.x << " " << pos.y << " 0 0" << std::endl;
+
+        //a giver on every third spawn point, cycling through the types
+        if (n % 30 == 0)
+        {
+            const int types[] = {type_health, type_shotgun, type_rail_gun, type_rocket_launcher};
+            int type = types[numGivers++ % 4];
+
+            out << type << " " << id++ << " " << pos.x << " " << pos.y << " 7";
+            if (type == type_health) out << " 10";
+            out << " " << n << std::endl;
+        }
+    }
+
+    return true;
+}
+
+static void benchRaven()
+{
+    const char* mapFileName = "ai_engine_bench_raven.map";
+
+    if (!isSelected("world/raven/update")) return;
+
+    if (!writeRavenMap(mapFileName))
+    {
+        std::printf("unable to write %s, the Raven world is not timed\n", mapFileName);
+        return;
+    }
+
+    const int numBots[] = {8, 32, 128};
+    const int numUpdates[] = {1000, 500, 100};
+
+    for (int b=0; b<3; ++b)
+    {
+        GameWorldRaven* pRaven = new GameWorldRaven(5);
+        pRaven->loadMap(mapFileName);
+        pRaven->addBots(numBots[b] - pRaven->getNumBots());
+
+        //let them spawn and spread out before the timing
+        for (int u=0; u<100; ++u) pRaven->update();
+
+        RavenUpdateOp ravenUpdate(pRaven);
+        measure(withCount("world/raven/update/%d_bots", pRaven->getNumBots()), ravenUpdate, numUpdates[b]);
+
+        delete pRaven;
+    }
+
+    std::remove(mapFileName);
+}
+
+static void benchWorlds()
+{
+    GameWorldVehicle* pVehicles = GameWorldVehicle::create(Win_Width, Win_Height, true, 5);
+    WorldUpdateOp<GameWorldVehicle> vehicleUpdate(pVehicles);
+    measure(withCount("world/vehicle/update/%d_vehicles", (int)pVehicles->getVehicles().size()), vehicleUpdate, 1000);
+    delete pVehicles;
+
+    SoccerPitch* pPitch = SoccerPitch::create(Win_Width, Win_Height, 5);
+    WorldUpdateOp<SoccerPitch> pitchUpdate(pPitch);
+    measure("world/soccer/update", pitchUpdate, 2000);
+    delete pPitch;
+
+    benchRaven();
+}
+
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1) g_Filter = argv[1];
+
+    benchGraphSearches();
+    benchPathManager();
+    benchCellSpace();
+    benchSteering();
+    benchIntegration();
+    benchFuzzy();
+    benchWalls();
+    benchEntities();
+    benchMessages();
+    benchWorlds();
+
+    return 0;
+}
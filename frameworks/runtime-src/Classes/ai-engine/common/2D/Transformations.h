@@ -112,9 +112,9 @@ inline Vector2D PointToWorldSpace(const Vector2D &point,
 //
 //------------------------------------------------------------------------
 inline Vector2D PointToLocalSpace(const Vector2D &point,
-                             Vector2D &AgentHeading,
-                             Vector2D &AgentSide,
-                              Vector2D &AgentPosition)
+                             const Vector2D &AgentHeading,
+                             const Vector2D &AgentSide,
+                             const Vector2D &AgentPosition)
 {
 
     //make a copy of the point
@@ -0,0 +1,373 @@
+#ifndef WALL_GRID_H
+#define WALL_GRID_H
+//-----------------------------------------------------------------------------
+//
+//  Name:   WallGrid.h
+//
+//  Desc:   a uniform grid over a set of walls used to speed up the line of
+//          sight, ray and circle tests in WallIntersectionTests.h.
+//
+//          Each wall is listed in every cell its bounding box overlaps.
+//          Line segments walk the cells they cross in order (a DDA, see
+//          Amanatides & Woo) and only test the walls listed there. Circles
+//          test the cells overlapped by their bounding box.
+//
+//          The grid is static: it is built once from the walls' positions
+//          at the time. A wall may move later as long as it stays inside
+//          the cells it was built with (the doors in Raven do this: they
+//          only ever shrink along their closed position). Walls added
+//          after build are not seen by the grid.
+//
+//          The queries don't modify the grid so they may be run from
+//          several threads at once.
+//
+//-----------------------------------------------------------------------------
+#include <vector>
+#include <cmath>
+#include "common/2D/Vector2D.h"
+#include "common/2D/Geometry.h"
+#include "common/game/Wall.h"
+#include "common/misc/UtilsEx.h"
+
+
+class WallGrid
+{
+public:
+    WallGrid():m_iNumCellsX(0),
+               m_iNumCellsY(0),
+               m_dMinX(0),
+               m_dMinY(0),
+               m_dCellSizeX(1),
+               m_dCellSizeY(1)
+    {}
+
+    //builds the grid over the walls. The grid covers the bounding box of
+    //the walls divided into numCellsX*numCellsY cells
+    inline void build(const std::vector<Wall*>& walls, int numCellsX, int numCellsY);
+
+    //throws away the cells, queries then report no walls
+    void clear(){m_CellStart.clear(); m_CellWalls.clear(); m_iNumCellsX = m_iNumCellsY = 0;}
+
+    bool isEmpty()const{return m_CellWalls.empty();}
+
+    //returns true if the segment AB crosses any wall
+    inline bool doWallsObstructLineSegment(Vector2D A, Vector2D B)const;
+
+    //finds the intersection of AB with the walls which is closest to A. The
+    //distance from A and the point are stored in distance and ip. Returns
+    //false if AB doesn't hit a wall
+    inline bool findClosestPointOfIntersection(Vector2D A, Vector2D B, float& distance, Vector2D& ip)const;
+
+    //returns true if any wall intersects the circle of radius r at p
+    inline bool doWallsIntersectCircle(Vector2D p, float r)const;
+
+private:
+    int cellIndex(int x, int y)const{return y*m_iNumCellsX + x;}
+
+    int cellX(float x)const{int c = (int)std::floor((x - m_dMinX) / m_dCellSizeX); clamp(c, 0, m_iNumCellsX-1); return c;}
+    int cellY(float y)const{int c = (int)std::floor((y - m_dMinY) / m_dCellSizeY); clamp(c, 0, m_iNumCellsY-1); return c;}
+
+    //clips the segment A + (B-A)*t, t in [0,1] to the grid bounds. Returns
+    //false if it misses the grid completely
+    inline bool clipSegment(Vector2D A, Vector2D B, float& tEnter, float& tExit)const;
+
+    //walks the cells crossed by AB in order from A to B calling
+    //v(cell, tCellExit), where tCellExit is the segment parameter at which
+    //AB leaves the cell. The walk stops when v returns true
+    template <class visitor>
+    inline void traverseSegment(Vector2D A, Vector2D B, visitor& v)const;
+
+    //the visitors used by the two segment queries
+    struct ObstructVisitor;
+    struct ClosestVisitor;
+
+    //the walls of cell i are m_CellWalls[m_CellStart[i]] to m_CellWalls[m_CellStart[i+1]-1]
+    std::vector<int> m_CellStart;
+    std::vector<Wall*> m_CellWalls;
+
+    int m_iNumCellsX;
+    int m_iNumCellsY;
+
+    //the corner and the cell size of the grid
+    float m_dMinX;
+    float m_dMinY;
+    float m_dCellSizeX;
+    float m_dCellSizeY;
+};
+
+
+//------------------------------- build ---------------------------------------
+//-----------------------------------------------------------------------------
+void WallGrid::build(const std::vector<Wall*>& walls, int numCellsX, int numCellsY)
+{
+    clear();
+
+    if (walls.empty()) return;
+
+    //find the bounding box of all the walls. It is grown a little so
+    //nothing lies exactly on the border
+    float minX = FloatMax, minY = FloatMax, maxX = -FloatMax, maxY = -FloatMax;
+    for (unsigned int w=0; w<walls.size(); ++w)
+    {
+        minX = (std::min)(minX, (std::min)(walls[w]->from().x, walls[w]->to().x));
+        minY = (std::min)(minY, (std::min)(walls[w]->from().y, walls[w]->to().y));
+        maxX = (std::max)(maxX, (std::max)(walls[w]->from().x, walls[w]->to().x));
+        maxY = (std::max)(maxY, (std::max)(walls[w]->from().y, walls[w]->to().y));
+    }
+    minX -= 1; minY -= 1;
+    maxX += 1; maxY += 1;
+
+    m_iNumCellsX = (std::max)(numCellsX, 1);
+    m_iNumCellsY = (std::max)(numCellsY, 1);
+    m_dMinX = minX;
+    m_dMinY = minY;
+    m_dCellSizeX = (maxX - minX) / m_iNumCellsX;
+    m_dCellSizeY = (maxY - minY) / m_iNumCellsY;
+
+    //first count the walls of every cell, then fill them in
+    m_CellStart.assign(m_iNumCellsX*m_iNumCellsY + 1, 0);
+
+    for (unsigned int w=0; w<walls.size(); ++w)
+    {
+        int x0 = cellX((std::min)(walls[w]->from().x, walls[w]->to().x));
+        int x1 = cellX((std::max)(walls[w]->from().x, walls[w]->to().x));
+        int y0 = cellY((std::min)(walls[w]->from().y, walls[w]->to().y));
+        int y1 = cellY((std::max)(walls[w]->from().y, walls[w]->to().y));
+
+        for (int y=y0; y<=y1; ++y)
+        {
+            for (int x=x0; x<=x1; ++x)
+            {
+                ++m_CellStart[cellIndex(x, y) + 1];
+            }
+        }
+    }
+
+    for (unsigned int c=1; c<m_CellStart.size(); ++c)
+    {
+        m_CellStart[c] += m_CellStart[c-1];
+    }
+
+    m_CellWalls.resize(m_CellStart.back());
+    std::vector<int> next(m_CellStart.begin(), m_CellStart.end()-1);
+
+    for (unsigned int w=0; w<walls.size(); ++w)
+    {
+        int x0 = cellX((std::min)(walls[w]->from().x, walls[w]->to().x));
+        int x1 = cellX((std::max)(walls[w]->from().x, walls[w]->to().x));
+        int y0 = cellY((std::min)(walls[w]->from().y, walls[w]->to().y));
+        int y1 = cellY((std::max)(walls[w]->from().y, walls[w]->to().y));
+
+        for (int y=y0; y<=y1; ++y)
+        {
+            for (int x=x0; x<=x1; ++x)
+            {
+                m_CellWalls[next[cellIndex(x, y)]++] = walls[w];
+            }
+        }
+    }
+}
+
+//---------------------------- clipSegment ------------------------------------
+//
+//  Liang-Barsky clip of the segment against the grid bounds
+//-----------------------------------------------------------------------------
+bool WallGrid::clipSegment(Vector2D A, Vector2D B, float& tEnter, float& tExit)const
+{
+    float d[2]   = {B.x - A.x, B.y - A.y};
+    float p[2]   = {A.x, A.y};
+    float lo[2]  = {m_dMinX, m_dMinY};
+    float hi[2]  = {m_dMinX + m_dCellSizeX*m_iNumCellsX, m_dMinY + m_dCellSizeY*m_iNumCellsY};
+
+    tEnter = 0;
+    tExit = 1;
+
+    for (int axis=0; axis<2; ++axis)
+    {
+        if (d[axis] == 0)
+        {
+            if (p[axis] < lo[axis] || p[axis] > hi[axis]) return false;
+            continue;
+        }
+
+        float t0 = (lo[axis] - p[axis]) / d[axis];
+        float t1 = (hi[axis] - p[axis]) / d[axis];
+        if (t0 > t1) std::swap(t0, t1);
+
+        tEnter = (std::max)(tEnter, t0);
+        tExit = (std::min)(tExit, t1);
+
+        if (tEnter > tExit) return false;
+    }
+
+    return true;
+}
+
+//---------------------------- traverseSegment --------------------------------
+//
+//  the cells are walked with a DDA: tMaxX/tMaxY are the segment parameters
+//  of the next cell border in x and y, and the walk always steps over the
+//  nearer one
+//-----------------------------------------------------------------------------
+template <class visitor>
+void WallGrid::traverseSegment(Vector2D A, Vector2D B, visitor& v)const
+{
+    float tEnter, tExit;
+    if (isEmpty() || !clipSegment(A, B, tEnter, tExit)) return;
+
+    float dx = B.x - A.x;
+    float dy = B.y - A.y;
+
+    //the cell the clipped segment starts in
+    int x = cellX(A.x + dx*tEnter);
+    int y = cellY(A.y + dy*tEnter);
+
+    int stepX = (dx > 0) ? 1 : -1;
+    int stepY = (dy > 0) ? 1 : -1;
+    float tDeltaX = (dx != 0) ? m_dCellSizeX / std::fabs(dx) : FloatMax;
+    float tDeltaY = (dy != 0) ? m_dCellSizeY / std::fabs(dy) : FloatMax;
+    float tMaxX = (dx != 0) ? (m_dMinX + (x + (dx > 0 ? 1 : 0))*m_dCellSizeX - A.x) / dx : FloatMax;
+    float tMaxY = (dy != 0) ? (m_dMinY + (y + (dy > 0 ? 1 : 0))*m_dCellSizeY - A.y) / dy : FloatMax;
+
+    for (;;)
+    {
+        float tCellExit = (std::min)(tMaxX, tMaxY);
+
+        if (v(cellIndex(x, y), tCellExit)) return;
+
+        //the segment ends in this cell
+        if (tCellExit >= tExit) return;
+
+        if (tMaxX < tMaxY)
+        {
+            x += stepX;
+            tMaxX += tDeltaX;
+        }
+        else
+        {
+            y += stepY;
+            tMaxY += tDeltaY;
+        }
+
+        if (x < 0 || x >= m_iNumCellsX || y < 0 || y >= m_iNumCellsY) return;
+    }
+}
+
+//--------------------------- doWallsObstructLineSegment ----------------------
+//-----------------------------------------------------------------------------
+struct WallGrid::ObstructVisitor
+{
+    const WallGrid& grid;
+    Vector2D A, B;
+    bool obstructed;
+
+    ObstructVisitor(const WallGrid& g, Vector2D a, Vector2D b):grid(g), A(a), B(b), obstructed(false){}
+
+    bool operator()(int cell, float /*tCellExit*/)
+    {
+        for (int i=grid.m_CellStart[cell]; i<grid.m_CellStart[cell+1]; ++i)
+        {
+            if (lineIntersection2D(A, B, grid.m_CellWalls[i]->from(), grid.m_CellWalls[i]->to()))
+            {
+                obstructed = true;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+bool WallGrid::doWallsObstructLineSegment(Vector2D A, Vector2D B)const
+{
+    ObstructVisitor v(*this, A, B);
+
+    traverseSegment(A, B, v);
+
+    return v.obstructed;
+}
+
+//------------------------ findClosestPointOfIntersection ---------------------
+//
+//  a wall is listed in the cell holding its intersection point, so once the
+//  closest hit so far lies before the end of the current cell no later
+//  cell can do better
+//-----------------------------------------------------------------------------
+struct WallGrid::ClosestVisitor
+{
+    const WallGrid& grid;
+    Vector2D A, B;
+    float length;
+    float distance;
+    Vector2D ip;
+
+    ClosestVisitor(const WallGrid& g, Vector2D a, Vector2D b):grid(g), A(a), B(b), 
+                                                             length(Vec2Distance(a, b)),
+                                                             distance(FloatMax){}
+
+    bool operator()(int cell, float tCellExit)
+    {
+        for (int i=grid.m_CellStart[cell]; i<grid.m_CellStart[cell+1]; ++i)
+        {
+            float dist = 0.0;
+            Vector2D point;
+
+            if (lineIntersection2D(A, B, grid.m_CellWalls[i]->from(), grid.m_CellWalls[i]->to(), dist, point))
+            {
+                if (dist < distance)
+                {
+                    distance = dist;
+                    ip = point;
+                }
+            }
+        }
+
+        return distance < tCellExit*length;
+    }
+};
+
+bool WallGrid::findClosestPointOfIntersection(Vector2D A, Vector2D B, float& distance, Vector2D& ip)const
+{
+    ClosestVisitor v(*this, A, B);
+
+    traverseSegment(A, B, v);
+
+    distance = v.distance;
+    if (distance < FloatMax)
+    {
+        ip = v.ip;
+        return true;
+    }
+
+    return false;
+}
+
+//----------------------------- doWallsIntersectCircle ------------------------
+//-----------------------------------------------------------------------------
+bool WallGrid::doWallsIntersectCircle(Vector2D p, float r)const
+{
+    if (isEmpty()) return false;
+
+    int x0 = cellX(p.x - r);
+    int x1 = cellX(p.x + r);
+    int y0 = cellY(p.y - r);
+    int y1 = cellY(p.y + r);
+
+    for (int y=y0; y<=y1; ++y)
+    {
+        for (int x=x0; x<=x1; ++x)
+        {
+            int cell = cellIndex(x, y);
+            for (int i=m_CellStart[cell]; i<m_CellStart[cell+1]; ++i)
+            {
+                if (lineSegmentCircleIntersection(m_CellWalls[i]->from(), m_CellWalls[i]->to(), p, r))
+                {
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+#endif
@@ -4,10 +4,14 @@
 //
 //
 //  Desc:   a few functions for testing line segments against containers of walls
+//
+//          Each test also has a version taking a WallGrid, which only looks
+//          at the walls near the segment or circle instead of all of them
 //-----------------------------------------------------------------------------
 
 #include "Vector2D.h"
 #include "common/game/Wall.h"
+#include "common/2D/WallGrid.h"
 
 
 //----------------------- doWallsObstructLineSegment --------------------------
@@ -20,7 +24,7 @@ template <class ContWall>
 inline bool doWallsObstructLineSegment(Vector2D from,Vector2D to, const ContWall& walls)
 {
     //test against the walls
-    ContWall::const_iterator curWall = walls.begin();
+    typename ContWall::const_iterator curWall = walls.begin();
 
     for (curWall; curWall != walls.end(); ++curWall)
     {
@@ -34,6 +38,11 @@ inline bool doWallsObstructLineSegment(Vector2D from,Vector2D to, const ContWall
     return false;
 }
 
+inline bool doWallsObstructLineSegment(Vector2D from, Vector2D to, const WallGrid& walls)
+{
+    return walls.doWallsObstructLineSegment(from, to);
+}
+
 
 //----------------------- doWallsObstructCylinderSides -------------------------
 //
@@ -90,7 +99,7 @@ inline bool findClosestPointOfIntersectionWithWalls(Vector2D A,
 {
     distance = FloatMax;
 
-    ContWall::const_iterator curWall = walls.begin();
+    typename ContWall::const_iterator curWall = walls.begin();
     for (curWall; curWall != walls.end(); ++curWall)
     {
         float dist = 0.0;
@@ -111,6 +120,15 @@ inline bool findClosestPointOfIntersectionWithWalls(Vector2D A,
     return false;
 }
 
+inline bool findClosestPointOfIntersectionWithWalls(Vector2D A,
+                                                    Vector2D B,
+                                                    float& distance,
+                                                    Vector2D& ip,
+                                                    const WallGrid& walls)
+{
+    return walls.findClosestPointOfIntersection(A, B, distance, ip);
+}
+
 //------------------------ doWallsIntersectCircle -----------------------------
 //
 //  returns true if any walls intersect the circle of radius at point p
@@ -119,7 +137,7 @@ template <class ContWall>
 inline bool doWallsIntersectCircle(const ContWall& walls, Vector2D p, float r)
 {
     //test against the walls
-    ContWall::const_iterator curWall = walls.begin();
+    typename ContWall::const_iterator curWall = walls.begin();
     
     for (curWall; curWall != walls.end(); ++curWall)
     {
@@ -133,4 +151,8 @@ inline bool doWallsIntersectCircle(const ContWall& walls, Vector2D p, float r)
     return false;
 }
 
+inline bool doWallsIntersectCircle(const WallGrid& walls, Vector2D p, float r)
+{
+    return walls.doWallsIntersectCircle(p, r);
+}
 
@@ -6,6 +6,9 @@
 //
 //  Desc:   abstract base class to define an interface for a state
 //
+//          The states are singletons shared by every world, and by the
+//          threads the worlds run on, so a state must not have any data.
+//          Everything it works on belongs to the entity passed in.
 //
 //------------------------------------------------------------------------
 struct Telegram;
@@ -21,7 +21,7 @@ FuzzyModule::~FuzzyModule()
 }
 
 //----------------------------- addRule ---------------------------------------
-void FuzzyModule::addRule(FuzzyTerm& antecedent, FuzzyTerm& consequence)
+void FuzzyModule::addRule(const FuzzyTerm& antecedent, const FuzzyTerm& consequence)
 {
     m_Rules.push_back(new FuzzyRule(antecedent, consequence));
 }
@@ -58,7 +58,7 @@ public:
     FuzzyVariable& createFLV(const std::string& VarName);
 
     //adds a rule to the module
-    void addRule(FuzzyTerm& antecedent, FuzzyTerm& consequence);
+    void addRule(const FuzzyTerm& antecedent, const FuzzyTerm& consequence);
 
     //this method calls the fuzzify method of the named FLV 
     inline void fuzzify(const std::string& NameOfFLV, float val);
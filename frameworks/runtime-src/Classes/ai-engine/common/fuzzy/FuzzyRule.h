@@ -13,9 +13,9 @@
 //          
 //-----------------------------------------------------------------------------
 #include <vector>
-#include "Fuzzy/FuzzySet.h"
-#include "fuzzy/FuzzyOperators.h"
-#include "misc/utils.h"
+#include "common/fuzzy/FuzzySet.h"
+#include "common/fuzzy/FuzzyOperators.h"
+#include "common/misc/UtilsEx.h"
 
 
 class FuzzyRule
@@ -10,7 +10,7 @@
 //          the midpoint.
 //-----------------------------------------------------------------------------
 #include "common/fuzzy/FuzzySet.h"
-#include "misc/utils.h"
+#include "common/misc/UtilsEx.h"
 
 
 
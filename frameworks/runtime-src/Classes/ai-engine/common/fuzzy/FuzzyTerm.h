@@ -24,7 +24,7 @@ public:
     virtual void clearDOM()=0;
 
     //method for updating the DOM of a consequent when a rule fires
-    virtual void orWithDOM(double val)=0;
+    virtual void orWithDOM(float val)=0;
 };
 
 
@@ -1,6 +1,6 @@
-#include "fuzzyvariable.h"
-#include "fuzzyoperators.h"
-#include "FuzzySet_triangle.h"
+#include "FuzzyVariable.h"
+#include "FuzzyOperators.h"
+#include "FuzzySet_Triangle.h"
 #include "FuzzySet_LeftShoulder.h"
 #include "FuzzySet_RightShoulder.h"
 #include "FuzzySet_Singleton.h"
@@ -1,25 +1,20 @@
 
 #include "BaseEntity.h"
-#include "EngineInterface.h"
-#include "EntityManager.h"
+#include "engineinterface.h"
+#include "WorldContext.h"
 
-int BaseEntity::m_totalID = 0;
-
-
-BaseEntity::BaseEntity(): m_tag(false), m_dSize(Vector2D(0, 0)),m_radius(0)
+BaseEntity::BaseEntity(): m_pContext(WorldContext::getCurrent()), m_id(-1), m_tag(false), m_dSize(Vector2D(0, 0)),m_radius(0)
 {
-    m_id = m_totalID;
-    m_totalID++;
-
     m_vPosition.x = 0.0f;
     m_vPosition.y = 0.0f;
 
-    EntityManager::instance()->addEntity(this);
+    //this gives the entity its ID
+    m_pContext->getEntityManager().addEntity(this);
 }
 
 BaseEntity::~BaseEntity()
 {
-    EntityManager::instance()->removeEntity(this);
+    m_pContext->getEntityManager().removeEntity(this);
 }
 
 void BaseEntity::setPos(Vector2D pos)
@@ -7,6 +7,8 @@
 #include <algorithm>
 
 struct Telegram;
+class EntityManager;
+class WorldContext;
 class BaseEntity
 {
 public:
@@ -19,7 +21,13 @@ public:
 
     virtual bool handleMessage(const Telegram& msg){return false;}
       
+    //the handle the EntityManager gave this entity. It goes stale when
+    //the entity is destroyed
     int getID() const{return m_id;}
+
+    //the context of the world the entity was created in. The entity is
+    //registered with its entity manager
+    WorldContext* getContext()const{return m_pContext;}
     
     void setPos(Vector2D pos);
     Vector2D getPos()const {return m_vPosition;}
@@ -42,10 +50,12 @@ protected:
     Vector2D m_dSize;
     float m_radius;
 private:
+    friend class EntityManager;
+
+    WorldContext* m_pContext;
     int m_id;
     int m_type;
     bool m_tag;
-    static int m_totalID;
     
 };
 #endif 
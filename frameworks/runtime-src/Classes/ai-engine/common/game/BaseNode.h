@@ -1,14 +1,20 @@
 
 #ifndef BASENODE_H
 #define BASENODE_H 
+#ifdef AI_HEADLESS
+#include "engineinterface_null.h"
+typedef Node EngineNode;
+#else
 #include "cocos2d.h"
+typedef cocos2d::Node EngineNode;
+#endif
 
-class BaseNode:public cocos2d::Node 
+class BaseNode:public EngineNode 
 {
 public:
     BaseNode() {}
     ~BaseNode() {}
-    void onEnter() {Node::onEnter();}
+    void onEnter() {EngineNode::onEnter();}
 };
 #endif
 
@@ -5,62 +5,194 @@
 //
 //  Name:   EntityManager.h
 //
-//  Desc:   Singleton class to handle the  management of Entities.          
+//  Desc:   Class to handle the  management of the Entities of one world.
+//          Each world has its own, in its WorldContext.
 //
+//          The entities are kept in a slot map. The ID of an entity is a
+//          handle made of the index of its slot and the generation of that
+//          slot, which goes up every time an entity leaves the slot. So an
+//          ID is looked up in constant time, and an ID kept after its
+//          entity has gone (in a delayed telegram say) is recognised as
+//          stale and finds nothing, even once the slot holds a new entity.
+//
+//          The entities themselves are also kept packed in a vector for
+//          iterating over them.
 //
 //------------------------------------------------------------------------
-#include <map>
+#include <vector>
 #include <cassert>
+#include <cstddef>
+#include "BaseEntity.h"
 
 
-class BaseEntity;
-
 class EntityManager
 {
 public:
-    static EntityManager* instance()
+    //the low IndexBits of an ID are the slot index, the bits above them
+    //the generation. Generations wrap around after 2^GenerationBits
+    //entities have used the same slot
+    enum
     {
-        static EntityManager instance;
+        IndexBits      = 20,
+        GenerationBits = 11,
+        IndexMask      = (1 << IndexBits) - 1,
+        GenerationMask = (1 << GenerationBits) - 1,
+        MaxEntities    = 1 << IndexBits
+    };
 
-        return &instance;
-    }
-    
-    void addEntity(BaseEntity* pEntity) 
+    EntityManager(){}
+
+    //returns the entity manager of the current world
+    static EntityManager* instance();
+
+    //gives the entity an ID and registers it. Entities register themselves
+    //when they are created, so this only does something for an entity that
+    //was dropped by reset, which gets a new ID
+    inline void addEntity(BaseEntity* pEntity);
+
+    inline void removeEntity(BaseEntity* pEntity);
+
+    //returns a pointer to the entity with the ID given as a parameter, or
+    //NULL if there is no such entity (anymore)
+    BaseEntity* getEntityByID(int id) const
     {
-        m_EntityMap.insert(std::make_pair(pEntity->getID(), pEntity));
+        if (id < 0) return NULL;
+
+        unsigned int index = id & IndexMask;
+
+        if (index >= m_Slots.size() || m_Slots[index].generation != getGeneration(id))
+        {
+            return NULL;
+        }
+
+        return m_Slots[index].pEntity;
     }
-    
-    void removeEntity(BaseEntity* pEntity)
+
+    //returns true if the ID is that of a registered entity
+    bool isValidID(int id)const{return getEntityByID(id) != NULL;}
+
+    //the registered entities, packed. The order changes when an entity
+    //is removed
+    const std::vector<BaseEntity*>& getEntities()const{return m_Entities;}
+
+    int getNumEntities()const{return (int)m_Entities.size();}
+
+    //drops all the entities. Their IDs become stale
+    inline void reset();
+
+    static int getIndex(int id){return id & IndexMask;}
+    static unsigned int getGeneration(int id){return (id >> IndexBits) & GenerationMask;}
+
+private:
+    struct Slot
+    {
+        //NULL when the slot is free
+        BaseEntity* pEntity;
+
+        unsigned int generation;
+
+        //where the entity is in m_Entities
+        int packedIndex;
+    };
+
+    std::vector<Slot> m_Slots;
+
+    //the indices of the free slots
+    std::vector<int> m_FreeSlots;
+
+    std::vector<BaseEntity*> m_Entities;
+
+    static int makeID(int index, unsigned int generation)
     {
-        m_EntityMap.erase(m_EntityMap.find(pEntity->getID()));
+        return (int)((generation & GenerationMask) << IndexBits) | index;
     }
 
-    //returns a pointer to the entity with the ID given as a parameter
-    BaseEntity* getEntityByID(int id) const
+    //removes the entity in the slot and moves the slot on a generation
+    inline void freeSlot(int index);
+
+    EntityManager(const EntityManager&);
+    EntityManager& operator=(const EntityManager&);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+//------------------------------ addEntity -------------------------------
+//------------------------------------------------------------------------
+inline void EntityManager::addEntity(BaseEntity* pEntity)
+{
+    if (getEntityByID(pEntity->getID()) == pEntity) return;
+
+    int index;
+
+    if (!m_FreeSlots.empty())
+    {
+        index = m_FreeSlots.back();
+        m_FreeSlots.pop_back();
+    }
+    else
     {
-        //find the entity
-        EntityMap::const_iterator ent = m_EntityMap.find(id);
+        assert ((m_Slots.size() < MaxEntities) && "<EntityManager::addEntity>: too many entities");
 
-        //assert that the entity is a member of the map
-        assert ( (ent !=  m_EntityMap.end()) && "<EntityManager::getEntityByID>: invalid ID");
-        
-        return ent->second;    
+        Slot slot;
+        slot.pEntity = NULL;
+        slot.generation = 0;
+        slot.packedIndex = -1;
+
+        m_Slots.push_back(slot);
+        index = (int)m_Slots.size()-1;
     }
-  
-    //clears all entities from the entity map
-    void reset(){m_EntityMap.clear();}
 
+    Slot& slot = m_Slots[index];
+    slot.pEntity = pEntity;
+    slot.packedIndex = (int)m_Entities.size();
 
-private:
-    EntityManager(){}
-    
-    typedef std::map<int, BaseEntity*> EntityMap;
+    m_Entities.push_back(pEntity);
 
-    //to facilitate quick lookup the entities are stored in a std::map, in which
-    //pointers to entities are cross referenced by their identifying number
-    EntityMap m_EntityMap;
-  
-};
+    pEntity->m_id = makeID(index, slot.generation);
+}
+
+//----------------------------- removeEntity -----------------------------
+//------------------------------------------------------------------------
+inline void EntityManager::removeEntity(BaseEntity* pEntity)
+{
+    if (getEntityByID(pEntity->getID()) == pEntity)
+    {
+        freeSlot(getIndex(pEntity->getID()));
+    }
+}
+
+//------------------------------- freeSlot -------------------------------
+//
+//  the last entity in m_Entities is moved into the gap
+//------------------------------------------------------------------------
+inline void EntityManager::freeSlot(int index)
+{
+    Slot& slot = m_Slots[index];
+
+    BaseEntity* pLast = m_Entities.back();
+    m_Entities[slot.packedIndex] = pLast;
+    m_Slots[getIndex(pLast->getID())].packedIndex = slot.packedIndex;
+    m_Entities.pop_back();
+
+    slot.pEntity = NULL;
+    slot.packedIndex = -1;
+    slot.generation = (slot.generation + 1) & GenerationMask;
+
+    m_FreeSlots.push_back(index);
+}
+
+//-------------------------------- reset ---------------------------------
+//------------------------------------------------------------------------
+inline void EntityManager::reset()
+{
+    for (unsigned int s=0; s<m_Slots.size(); ++s)
+    {
+        if (m_Slots[s].pEntity)
+        {
+            freeSlot(s);
+        }
+    }
+}
 
 
 
@@ -68,4 +200,4 @@ private:
 
 
 
-#endif
\ No newline at end of file
+#endif
@@ -3,7 +3,7 @@
 #define MOVING_ENTITY_H 
 
 #include "BaseEntity.h"
-#include "EngineInterface.h"
+#include "engineinterface.h"
 #include "common/misc/UtilsEx.h"
 #include "common/2D/Matrix2D.h"
 
@@ -2,20 +2,22 @@
 #define WALL_H
 
 #include "common/game/BaseEntity.h"
-#include "common/game/EngineInterface.h"
+#include "common/game/engineinterface.h"
 
 class Wall:public BaseEntity
 {
 public:
     Wall(Vector2D A, Vector2D B):m_vA(A), m_vB(B),m_ui(nullptr)
     {
-        Vector2D temp = Vec2Normalize(m_vB - m_vA);
-        m_vN.x = -temp.y;
-        m_vN.y = temp.x;
+        calculateNormal();
     }
 
     Vector2D from() const  {return m_vA;}
+    void setFrom(Vector2D v){m_vA = v; calculateNormal();}
+
     Vector2D to()const {return m_vB;}
+    void setTo(Vector2D v){m_vB = v; calculateNormal();}
+
     Vector2D normal() const {return m_vN;}
     Vector2D center() {return (m_vA+m_vB)/2.0;}
 
@@ -44,6 +46,13 @@ public:
         }
     }
 private:
+    void calculateNormal()
+    {
+        Vector2D temp = Vec2Normalize(m_vB - m_vA);
+        m_vN.x = -temp.y;
+        m_vN.y = temp.x;
+    }
+
     Vector2D m_vA;
     Vector2D m_vB;
     Vector2D m_vN;
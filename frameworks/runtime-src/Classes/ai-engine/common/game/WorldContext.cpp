@@ -0,0 +1,52 @@
+#include "WorldContext.h"
+
+
+WorldContext::WorldContext(float timeStep, unsigned int seed):m_Clock(timeStep),
+                                                              m_Dispatcher(m_EntityManager, m_Clock),
+                                                              m_iSeed(seed),
+                                                              m_iRandState(RandState(seed))
+{}
+
+WorldContext::~WorldContext()
+{
+    if (current() == this)
+    {
+        current() = NULL;
+        currentRandState() = &threadRandState();
+    }
+}
+
+void WorldContext::makeCurrent()
+{
+    current() = this;
+    m_Clock.makeCurrent();
+    currentRandState() = &m_iRandState;
+}
+
+//------------------------------ getCurrent ------------------------------
+//
+//  the default context of a thread is not made current, so without a
+//  world SimClock::now() reads the real time and the random numbers come
+//  from the thread's own state
+//------------------------------------------------------------------------
+WorldContext* WorldContext::getCurrent()
+{
+    WorldContext* pContext = current();
+
+    if (pContext) return pContext;
+
+    static thread_local WorldContext defaultContext(0, 0);
+
+    return &defaultContext;
+}
+
+WorldContext*& WorldContext::current()
+{
+    static thread_local WorldContext* pCurrent = NULL;
+    return pCurrent;
+}
+
+EntityManager* EntityManager::instance()
+{
+    return &WorldContext::getCurrent()->getEntityManager();
+}
@@ -0,0 +1,74 @@
+#ifndef WORLD_CONTEXT_H
+#define WORLD_CONTEXT_H
+//------------------------------------------------------------------------
+//
+//  Name:   WorldContext.h
+//
+//  Desc:   the state a world shares with its entities: the entity manager,
+//          the message dispatcher, the simulation clock and the state of
+//          the random numbers. Each world owns one, so any number of
+//          worlds can run in one process, each on its own thread.
+//
+//          A world makes its context current on the thread that updates
+//          it (makeCurrent) before it creates, updates or destroys its
+//          entities. EntityManager::instance(), MessageDispatcher::instance(),
+//          SimClock::now() and RandFloat_0_1() etc. then refer to that
+//          context. An entity keeps the context it was created in, see
+//          BaseEntity::getContext.
+//
+//          A thread that has no current context uses a default one of its
+//          own, so code that runs without a world works as before.
+//
+//------------------------------------------------------------------------
+#include "common/game/EntityManager.h"
+#include "common/message/MessageDispatcher.h"
+#include "common/misc/SimClock.h"
+#include "common/misc/UtilsEx.h"
+
+
+class WorldContext
+{
+public:
+    //timeStep is the time step of the clock in seconds, seed seeds the
+    //random numbers
+    WorldContext(float timeStep, unsigned int seed);
+
+    ~WorldContext();
+
+    //makes this the context of the calling thread, together with its clock
+    //and random numbers
+    void makeCurrent();
+
+    //the context of the calling thread
+    static WorldContext* getCurrent();
+
+    EntityManager&     getEntityManager(){return m_EntityManager;}
+    MessageDispatcher& getDispatcher(){return m_Dispatcher;}
+    SimClock&          getClock(){return m_Clock;}
+    const SimClock&    getClock()const{return m_Clock;}
+
+    void seed(unsigned int seed){m_iSeed = seed; m_iRandState = RandState(seed);}
+
+    //the seed the random numbers were last seeded with. Entities that keep
+    //their own random state mix it into theirs
+    unsigned int getSeed()const{return m_iSeed;}
+
+private:
+    EntityManager     m_EntityManager;
+    SimClock          m_Clock;
+    MessageDispatcher m_Dispatcher;
+
+    unsigned int      m_iSeed;
+
+    //the state RandFloat_0_1() etc. draw from while this is current
+    unsigned int      m_iRandState;
+
+    static WorldContext*& current();
+
+    WorldContext(const WorldContext&);
+    WorldContext& operator=(const WorldContext&);
+};
+
+
+
+#endif
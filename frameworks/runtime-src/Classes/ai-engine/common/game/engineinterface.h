@@ -5,6 +5,12 @@
 #include "common/2D/Vector2D.h"
 #include "BaseEntity.h"
 
+//a headless build (no renderer, see CMakeLists.txt) uses the functions of
+//the null backend instead of the cocos2d ones below
+#ifdef AI_HEADLESS
+#include "engineinterface_null.h"
+#else
+
 #include "cocos2d.h"
 #include "2d/CCDrawNode.h"
 using namespace cocos2d;
@@ -163,5 +169,7 @@ inline Vector2D getNodeSize(T *node)
 
 
 
+#endif //AI_HEADLESS
+
 #endif 
 
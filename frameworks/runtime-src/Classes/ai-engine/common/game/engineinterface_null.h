@@ -0,0 +1,190 @@
+#ifndef ENGINEINTERFACE_NULL_H
+#define ENGINEINTERFACE_NULL_H
+//------------------------------------------------------------------------
+//
+//  Name:   engineinterface_null.h
+//
+//  Desc:   the render backend used when AI_HEADLESS is defined. It has the
+//          same functions as the cocos2d one in engineinterface.h, but
+//          nothing is drawn, no images are loaded and no update is
+//          scheduled. Whoever owns a headless world calls its update.
+//
+//          Node only keeps the parent/child links. As with cocos2d a node
+//          is deleted with its parent, or when it is removed from it.
+//
+//------------------------------------------------------------------------
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include "common/2D/Vector2D.h"
+
+
+class Node
+{
+public:
+    Node():m_pParent(NULL), m_iTag(-1){}
+
+    virtual ~Node()
+    {
+        for (unsigned int i=0; i<m_Children.size(); ++i)
+        {
+            m_Children[i]->m_pParent = NULL;
+            delete m_Children[i];
+        }
+    }
+
+    virtual void onEnter(){}
+    virtual void update(float){}
+
+    void addChild(Node* pChild)
+    {
+        if (pChild->m_pParent) pChild->detach();
+
+        pChild->m_pParent = this;
+        m_Children.push_back(pChild);
+    }
+
+    //removes the node from its parent (if it has one) and deletes it
+    void removeFromParent()
+    {
+        if (m_pParent) detach();
+
+        delete this;
+    }
+
+    Node* getChildByTag(int tag)const
+    {
+        for (unsigned int i=0; i<m_Children.size(); ++i)
+        {
+            if (m_Children[i]->m_iTag == tag) return m_Children[i];
+        }
+
+        return NULL;
+    }
+
+    void setTag(int tag){m_iTag = tag;}
+
+    void setPosition(Vector2D pos){m_vPos = pos;}
+    Vector2D getPosition()const{return m_vPos;}
+
+    void setAnchorPoint(Vector2D){}
+
+    void scheduleUpdate(){}
+
+    Vector2D getContentSize()const{return Vector2D(0,0);}
+
+private:
+    Node* m_pParent;
+    std::vector<Node*> m_Children;
+
+    int m_iTag;
+    Vector2D m_vPos;
+
+    void detach()
+    {
+        std::vector<Node*>& siblings = m_pParent->m_Children;
+        siblings.erase(std::remove(siblings.begin(), siblings.end(), this), siblings.end());
+        m_pParent = NULL;
+    }
+
+    Node(const Node&);
+    Node& operator=(const Node&);
+};
+
+//images are never loaded so no sprite is ever returned
+class Sprite : public Node {};
+
+
+typedef Node* pNode;
+
+inline double getCurTime()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//there is no scene
+inline Node *getUINode()
+{
+    return NULL;
+}
+
+inline Node* getNewNode()
+{
+    return new Node();
+}
+
+template<class T>
+inline void addChildToNode(T *node, Node *child)
+{
+    Node* pNode = dynamic_cast<Node *>(node);
+
+    if (pNode)
+    {
+        pNode->addChild(child);
+    }
+    else
+    {
+        delete child;
+    }
+}
+
+//the node stays alive until it is removed with removeChild
+template<class T>
+inline void addChildToUI(T *){}
+
+template<class T>
+inline void removeChild(T *child)
+{
+    if (child)
+    {
+        child->removeFromParent();
+    }
+}
+
+template<class T>
+inline void setNodePos(T *node, Vector2D worldPos)
+{
+    Node* pNode = dynamic_cast<Node *>(node);
+
+    if (pNode) pNode->setPosition(worldPos);
+}
+
+template<class T>
+inline Sprite *loadImgToNode(T *, const char *)
+{
+    return NULL;
+}
+
+template<class T>
+inline Sprite *loadImgToNode(T *, const char *, int, Vector2D, Vector2D)
+{
+    return NULL;
+}
+
+template<class T>
+inline void setNodeAnchorPoint( T *, const Vector2D &){}
+
+template<class T>
+inline void setNodeAnchorPoint( T *node, int tag, const Vector2D &ap){}
+
+template<class T>
+void showString(T *, int, const std::string &, Vector2D){}
+
+template<class T>
+inline void drawLine(T *, const Vector2D &, const Vector2D &){}
+
+template<class T>
+inline void drawCircle(T *, const Vector2D &, float){}
+
+template<class T>
+inline void enableScheduleUpdate(T *){}
+
+template<class T>
+inline Vector2D getNodeSize(T *)
+{
+    return Vector2D(0,0);
+}
+
+
+#endif
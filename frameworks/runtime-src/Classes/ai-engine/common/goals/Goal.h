@@ -6,6 +6,7 @@
 //
 //  Desc:   Base goal class.
 //-----------------------------------------------------------------------------
+#include <stdexcept>
 
 struct Telegram;
 
@@ -67,7 +67,7 @@ public:
 template <class entity_type>
 void GoalComposite<entity_type>::removeAllSubgoals()
 {
-    for (SubgoalList::iterator it = m_SubGoals.begin(); it != m_SubGoals.end();++it)
+    for (typename SubgoalList::iterator it = m_SubGoals.begin(); it != m_SubGoals.end();++it)
     {  
         (*it)->terminate();
         
@@ -103,16 +103,16 @@ int GoalComposite<entity_type>::processSubgoals()
         //reports 'completed' *and* the subgoal list contains additional goals.When
         //this is the case, to ensure the parent keeps processing its subgoal list
         //we must return the 'active' status.
-        if (StatusOfSubGoals == completed && m_SubGoals.size() > 1)
+        if (StatusOfSubGoals == Goal<entity_type>::completed && m_SubGoals.size() > 1)
         {
-            return active;
+            return Goal<entity_type>::active;
         }
 
         return StatusOfSubGoals;
     }
     else //no more subgoals to process - return 'completed'
     {
-        return completed;
+        return Goal<entity_type>::completed;
     }
 }
 
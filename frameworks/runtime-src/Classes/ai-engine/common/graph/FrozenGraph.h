@@ -0,0 +1,291 @@
+#ifndef FROZENGRAPH_H
+#define FROZENGRAPH_H
+#pragma warning (disable:4786)
+//------------------------------------------------------------------------
+//
+//  Name:   FrozenGraph.h
+//
+//  Desc:   a read only copy of a SparseGraph for searching, in compressed
+//          sparse row form. The edges of all the nodes are kept in one
+//          array, those of node n at the indices getFirstEdge(n) to
+//          getEndEdge(n)-1, so going through the edges of a node reads
+//          consecutive memory instead of following the links of a list.
+//          The node each edge leads to and its cost are also kept in
+//          arrays of their own, which is all a search reads of most edges.
+//
+//          Nodes and edges can't be added or removed. The costs of edges
+//          can be changed (for doors and the like). A navgraph is built as
+//          a SparseGraph and frozen once it is complete; build it again
+//          after changing the SparseGraph.
+//
+//          It has the const interface of SparseGraph, so the searches in
+//          GraphAlgorithms.h and GraphAlgorithms_TimeSliced.h and the
+//          functions in HandyGraphFunctions.h work with either.
+//
+//------------------------------------------------------------------------
+#include <vector>
+#include <cassert>
+
+#include "SparseGraph.h"
+#include "common/navigation/SearchWorkspaceRegistry.h"
+
+
+template <class node_type, class edge_type>
+class FrozenGraph
+{
+public:
+    typedef edge_type EdgeType;
+    typedef node_type NodeType;
+
+    typedef SparseGraph<node_type, edge_type> SourceGraph;
+
+    FrozenGraph():m_bDigraph(false), m_iNumActiveNodes(0)
+    {
+        m_Offsets.push_back(0);
+    }
+
+    explicit FrozenGraph(const SourceGraph& graph){build(graph);}
+
+    //the search workspaces pooled for this graph are dropped
+    ~FrozenGraph(){SearchWorkspaceRegistry::retire(this);}
+
+    //copies graph into this one, replacing whatever was here
+    void build(const SourceGraph& graph);
+
+    const NodeType& getNode(int idx)const
+    {
+        assert( (idx < (int)m_Nodes.size()) && (idx >=0) && "<FrozenGraph::getNode>: invalid index");
+        return m_Nodes[idx];
+    }
+
+    //non const version, for the extra info of the nodes
+    NodeType& getNode(int idx)
+    {
+        assert( (idx < (int)m_Nodes.size()) && (idx >=0) && "<FrozenGraph::getNode>: invalid index");
+        return m_Nodes[idx];
+    }
+
+    const EdgeType& getEdge(int from, int to)const;
+
+    //sets the cost of an edge
+    void setEdgeCost(int from, int to, float cost);
+
+    int getNumNodes()const{return (int)m_Nodes.size();}
+    int getNumActiveNodes()const{return m_iNumActiveNodes;}
+    int getNumEdges()const{return (int)m_Edges.size();}
+
+    bool isDigraph()const{return m_bDigraph;}
+    bool isEmpty()const{return m_Nodes.empty();}
+
+    bool isNodePresent(int nd)const
+    {
+        return (nd >= 0) && (nd < (int)m_Nodes.size()) && (m_Nodes[nd].getIndex() != -1);
+    }
+
+    bool isEdgePresent(int from, int to)const{return findEdge(from, to) != -1;}
+
+    //the edges leaving node are those with the indices getFirstEdge(node)
+    //to getEndEdge(node)-1
+    int getFirstEdge(int node)const{return m_Offsets[node];}
+    int getEndEdge(int node)const{return m_Offsets[node+1];}
+
+    int getEdgeTo(int edge)const{return m_EdgeTo[edge];}
+    float getEdgeCost(int edge)const{return m_EdgeCost[edge];}
+
+
+    //const class used to iterate through all the edges connected to a
+    //specific node
+    class ConstEdgeIterator
+    {
+    private:
+        const FrozenGraph<node_type, edge_type>& G;
+
+        int curEdge;
+
+        const int firstEdge;
+        const int endEdge;
+
+    public:
+        ConstEdgeIterator(const FrozenGraph<node_type, edge_type>& graph, int node):G(graph),
+                                                                                  curEdge(graph.m_Offsets[node]),
+                                                                                  firstEdge(graph.m_Offsets[node]),
+                                                                                  endEdge(graph.m_Offsets[node+1])
+        {}
+
+        const EdgeType* begin()
+        {
+            curEdge = firstEdge;
+
+            if (end()) return NULL;
+
+            return &G.m_Edges[curEdge];
+        }
+
+        const EdgeType* next()
+        {
+            ++curEdge;
+
+            if (end()) return NULL;
+
+            return &G.m_Edges[curEdge];
+        }
+
+        //return true if we are at the end of the edge list
+        bool end()const{return curEdge == endEdge;}
+
+        //the node the current edge leads to and its cost
+        int to()const{return G.m_EdgeTo[curEdge];}
+        float cost()const{return G.m_EdgeCost[curEdge];}
+    };
+
+    friend class ConstEdgeIterator;
+
+
+    //const class used to iterate through the nodes in the graph, skipping
+    //the ones that have been removed
+    class ConstNodeIterator
+    {
+    private:
+        const FrozenGraph<node_type, edge_type>& G;
+
+        int curNode;
+
+        void skipInvalidNodes()
+        {
+            while (!end() && G.m_Nodes[curNode].getIndex() == -1) ++curNode;
+        }
+
+    public:
+        ConstNodeIterator(const FrozenGraph<node_type, edge_type>& graph):G(graph), curNode(0){}
+
+        const node_type* begin()
+        {
+            curNode = 0;
+
+            skipInvalidNodes();
+
+            if (end()) return NULL;
+
+            return &G.m_Nodes[curNode];
+        }
+
+        const node_type* next()
+        {
+            ++curNode;
+
+            skipInvalidNodes();
+
+            if (end()) return NULL;
+
+            return &G.m_Nodes[curNode];
+        }
+
+        bool end()const{return curNode == (int)G.m_Nodes.size();}
+    };
+
+    friend class ConstNodeIterator;
+
+private:
+    std::vector<node_type> m_Nodes;
+
+    //the edges of node n are m_Edges[m_Offsets[n]] to m_Edges[m_Offsets[n+1]-1].
+    //There is one more offset than there are nodes
+    std::vector<int> m_Offsets;
+
+    std::vector<edge_type> m_Edges;
+
+    //the to and cost of m_Edges, packed
+    std::vector<int> m_EdgeTo;
+    std::vector<float> m_EdgeCost;
+
+    bool m_bDigraph;
+
+    int m_iNumActiveNodes;
+
+    //the index of the edge from from to to, -1 if there is none
+    int findEdge(int from, int to)const;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+//------------------------------- build ----------------------------------
+//------------------------------------------------------------------------
+template <class node_type, class edge_type>
+void FrozenGraph<node_type, edge_type>::build(const SourceGraph& graph)
+{
+    m_bDigraph = graph.isDigraph();
+    m_iNumActiveNodes = 0;
+
+    m_Nodes.clear();
+    m_Offsets.clear();
+    m_Edges.clear();
+    m_EdgeTo.clear();
+    m_EdgeCost.clear();
+
+    m_Nodes.reserve(graph.getNumNodes());
+    m_Offsets.reserve(graph.getNumNodes()+1);
+    m_Edges.reserve(graph.getNumEdges());
+    m_EdgeTo.reserve(graph.getNumEdges());
+    m_EdgeCost.reserve(graph.getNumEdges());
+
+    for (int n=0; n<graph.getNumNodes(); ++n)
+    {
+        m_Nodes.push_back(graph.getNode(n));
+        m_Offsets.push_back((int)m_Edges.size());
+
+        if (m_Nodes.back().getIndex() != -1) ++m_iNumActiveNodes;
+
+        typename SourceGraph::ConstEdgeIterator EdgeItr(graph, n);
+        for (const EdgeType* pE=EdgeItr.begin(); !EdgeItr.end(); pE=EdgeItr.next())
+        {
+            m_Edges.push_back(*pE);
+            m_EdgeTo.push_back(pE->to());
+            m_EdgeCost.push_back(pE->cost());
+        }
+    }
+
+    m_Offsets.push_back((int)m_Edges.size());
+}
+
+//------------------------------ findEdge --------------------------------
+//------------------------------------------------------------------------
+template <class node_type, class edge_type>
+int FrozenGraph<node_type, edge_type>::findEdge(int from, int to)const
+{
+    if (!isNodePresent(from)) return -1;
+
+    for (int e=m_Offsets[from]; e<m_Offsets[from+1]; ++e)
+    {
+        if (m_EdgeTo[e] == to) return e;
+    }
+
+    return -1;
+}
+
+//------------------------------ getEdge ---------------------------------
+//------------------------------------------------------------------------
+template <class node_type, class edge_type>
+const edge_type& FrozenGraph<node_type, edge_type>::getEdge(int from, int to)const
+{
+    int e = findEdge(from, to);
+
+    assert ((e != -1) && "<FrozenGraph::getEdge>: edge does not exist");
+
+    return m_Edges[e];
+}
+
+//---------------------------- setEdgeCost -------------------------------
+//------------------------------------------------------------------------
+template <class node_type, class edge_type>
+void FrozenGraph<node_type, edge_type>::setEdgeCost(int from, int to, float cost)
+{
+    int e = findEdge(from, to);
+
+    assert ((e != -1) && "<FrozenGraph::setEdgeCost>: edge does not exist");
+
+    m_Edges[e].setCost(cost);
+    m_EdgeCost[e] = cost;
+}
+
+
+#endif
@@ -9,6 +9,7 @@
 //          
 //          An edge has an associated cost.
 //-----------------------------------------------------------------------------
+#include <fstream>
 
 
 
@@ -37,6 +38,13 @@ public:
     {
     }
 
+    //reads an edge written by operator<<
+    GraphEdge(std::ifstream& stream)
+    {
+        char buffer[50];
+        stream >> buffer >> m_iFrom >> buffer >> m_iTo >> buffer >> m_dCost;
+    }
+
     virtual ~GraphEdge(){}
 
     int from()const{return m_iFrom;}
@@ -60,6 +68,12 @@ public:
     {
         return !(*this == rhs);
     }
+
+    friend std::ostream& operator<<(std::ostream& os, const GraphEdge& e)
+    {
+        os << "From: " << e.m_iFrom << " To: " << e.m_iTo << " Cost: " << e.m_dCost << std::endl;
+        return os;
+    }
 };
 
 
@@ -98,11 +112,26 @@ public:
     {
     } 
 
+    //reads an edge written by operator<<
+    NavGraphEdge(std::ifstream& stream)
+    {
+        char buffer[50];
+        stream >> buffer >> m_iFrom >> buffer >> m_iTo >> buffer >> m_dCost;
+        stream >> buffer >> m_iFlags >> buffer >> m_intersectingEntityID;
+    }
+
     int  getFlags()const{return m_iFlags;}
     void setFlags(int flags){m_iFlags = flags;}
   
     int  getIntersectingEntityID()const{return m_intersectingEntityID;}
     void setIIntersectingEntityID(int id){m_intersectingEntityID = id;} 
+
+    friend std::ostream& operator<<(std::ostream& os, const NavGraphEdge& e)
+    {
+        os << "From: " << e.m_iFrom << " To: " << e.m_iTo << " Cost: " << e.m_dCost
+           << " Flags: " << e.m_iFlags << " ID: " << e.m_intersectingEntityID << std::endl;
+        return os;
+    }
 };
 
 
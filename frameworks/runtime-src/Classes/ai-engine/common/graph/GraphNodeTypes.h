@@ -8,6 +8,7 @@
 //  Desc:   Node classes to be used with graphs
 //-----------------------------------------------------------------------------
 #include <list>
+#include <fstream>
 #include "common/2D/Vector2D.h"
 
 
@@ -23,10 +24,18 @@ public:
     GraphNode():m_iIndex(-1){}
     GraphNode(int idx):m_iIndex(idx){}
 
+    //reads a node written by operator<<
+    GraphNode(std::ifstream& stream){char buffer[50]; stream >> buffer >> m_iIndex;}
+
     virtual ~GraphNode(){}
 
     int getIndex()const{return m_iIndex;}
     void setIndex(int NewIndex){m_iIndex = NewIndex;}
+
+    friend std::ostream& operator<<(std::ostream& os, const GraphNode& n)
+    {
+        os << "Index: " << n.m_iIndex << std::endl; return os;
+    }
 };   
 
 
@@ -62,6 +71,13 @@ public:
     {
     }
 
+    //reads a node written by operator<<
+    NavGraphNode(std::ifstream& stream):m_ExtraInfo(extra_info())
+    {
+        char buffer[50];
+        stream >> buffer >> m_iIndex >> buffer >> m_vPosition.x >> buffer >> m_vPosition.y;
+    }
+
     virtual ~NavGraphNode(){}
 
     Vector2D getPos()const{return m_vPosition;}
@@ -69,6 +85,12 @@ public:
 
     extra_info getExtraInfo()const{return m_ExtraInfo;}
     void setExtraInfo(extra_info info){m_ExtraInfo = info;}
+
+    friend std::ostream& operator<<(std::ostream& os, const NavGraphNode& n)
+    {
+        os << "Index: " << n.m_iIndex << " PosX: " << n.m_vPosition.x << " PosY: " << n.m_vPosition.y << std::endl;
+        return os;
+    }
 };
 
 
@@ -11,6 +11,7 @@
 //          with the SparseGraph class
 //-----------------------------------------------------------------------------
 #include "../misc/UtilsEx.h"
+#include "../misc/WorkerPool.h"
 #include "../navigation/GraphAlgorithms.h"
 #include "../navigation/AStarHeuristicPolicies.h"
 
@@ -20,7 +21,7 @@
 //
 //  returns true if x,y is a valid position in the map
 //------------------------------------------------------------------------
-bool isValidNeighbour(int x, int y, int NumCellsX, int NumCellsY)
+inline bool isValidNeighbour(int x, int y, int NumCellsX, int NumCellsY)
 {
     return !((x < 0) || (x >= NumCellsX) || (y < 0) || (y >= NumCellsY));
 }
@@ -57,14 +58,14 @@ void addAllNeighboursToGridNode(graph_type& graph,
                 float dist = PosNode.distance(PosNeighbour);
 
                 //this neighbour is okay so it can be added
-                graph_type::EdgeType NewEdge(row*NumCellsX+col, nodeY*NumCellsX+nodeX, dist);
+                typename graph_type::EdgeType NewEdge(row*NumCellsX+col, nodeY*NumCellsX+nodeX, dist);
                 graph.addEdge(NewEdge);
 
                 //if graph is not a diagraph then an edge needs to be added going
                 //in the other direction
                 if (!graph.isDigraph())
                 {
-                    graph_type::EdgeType NewEdge(nodeY*NumCellsX+nodeX, row*NumCellsX+col, dist);
+                    typename graph_type::EdgeType NewEdge(nodeY*NumCellsX+nodeX, row*NumCellsX+col, dist);
                     graph.addEdge(NewEdge);
                 }
             }
@@ -131,8 +132,8 @@ void weightNavGraphNodeEdges(graph_type& graph, int node, float weight)
     assert(node < graph.getNumNodes());
 
     //set the cost for each edge
-    graph_type::ConstEdgeIterator ConstEdgeItr(graph, node);
-    for (const graph_type::EdgeType* pE=ConstEdgeItr.begin();!ConstEdgeItr.end();pE=ConstEdgeItr.next())
+    typename graph_type::ConstEdgeIterator ConstEdgeItr(graph, node);
+    for (const typename graph_type::EdgeType* pE=ConstEdgeItr.begin();!ConstEdgeItr.end();pE=ConstEdgeItr.next())
     {
         //calculate the distance between nodes
         float dist = Vec2Distance(graph.getNode(pE->from()).getPos(), graph.getNode(pE->to()).getPos());
@@ -149,13 +150,66 @@ void weightNavGraphNodeEdges(graph_type& graph, int node, float weight)
 }
 
 
+//----------------------- AllPairsTableJob ------------------------------------
+//
+//  fills in the rows of the shortest path table for a range of source
+//  nodes. Each source only writes its own row so the rows can be shared out
+//  between threads
+//-----------------------------------------------------------------------------
+template <class graph_type>
+class AllPairsTableJob : public ParallelJob
+{
+public:
+    AllPairsTableJob(const graph_type& G, std::vector<std::vector<int> >& table):m_Graph(G), m_Table(table){}
+
+    void process(int begin, int end)
+    {
+        for (int source=begin; source<end; ++source)
+        {
+            //calculate the SPT for this node
+            Graph_SearchDijkstra<graph_type> search(m_Graph, source);
+
+            std::vector<const typename graph_type::EdgeType*> spt = search.getSPT();
+
+            std::vector<int>& row = m_Table[source];
+
+            //work backwards through the SPT from each target to find the
+            //first node on the path from the source
+            for (int target = 0; target<m_Graph.getNumNodes(); ++target)
+            {
+                if (source == target)
+                {
+                    row[target] = target;
+                }
+                else
+                {
+                    int nd = target;
+
+                    while ((spt[nd] != 0) && (spt[nd]->from() != source))
+                    {
+                        nd = spt[nd]->from();
+                    }
+
+                    if (spt[nd] != 0) row[target] = nd;
+                }
+            }//next target node
+        }//next source node
+    }
+
+private:
+    const graph_type& m_Graph;
+    std::vector<std::vector<int> >& m_Table;
+};
+
 //----------------------- createAllPairsTable ---------------------------------
 //
 // creates a lookup table encoding the shortest path info between each node
-// in a graph to every other
+// in a graph to every other. Table[a][b] is the next node to go to from a
+// to get to b, or -1 if there is no path. The sources are shared out between
+// the threads of pWorkers if it isn't NULL
 //-----------------------------------------------------------------------------
 template <class graph_type>
-std::vector<std::vector<int> > createAllPairsTable(const graph_type& G)
+std::vector<std::vector<int> > createAllPairsTable(const graph_type& G, WorkerPool* pWorkers = NULL)
 {
     enum {no_path = -1};
   
@@ -163,68 +217,78 @@ std::vector<std::vector<int> > createAllPairsTable(const graph_type& G)
 
     std::vector<std::vector<int> > ShortestPaths(G.getNumNodes(), row);
 
-    for (int source=0; source<G.getNumNodes(); ++source)
+    AllPairsTableJob<graph_type> job(G, ShortestPaths);
+
+    if (pWorkers)
+    {
+        pWorkers->run(job, G.getNumNodes(), 1);
+    }
+    else
     {
-        //calculate the SPT for this node
-        Graph_SearchDijkstra<graph_type> search(G, source);
+        job.process(0, G.getNumNodes());
+    }
+
+    return ShortestPaths;
+}
 
-        std::vector<const graph_type::EdgeType*> spt = search.getSPT();
 
-        //now we have the SPT it's easy to work backwards through it to find
-        //the shortest paths from each node to this source node
-        for (int target = 0; target<G.getNumNodes(); ++target)
+//----------------------- AllPairsCostsJob ------------------------------------
+//
+//  fills in the rows of the cost table for a range of source nodes
+//-----------------------------------------------------------------------------
+template <class graph_type>
+class AllPairsCostsJob : public ParallelJob
+{
+public:
+    AllPairsCostsJob(const graph_type& G, std::vector<std::vector<float> >& table):m_Graph(G), m_Table(table){}
+
+    void process(int begin, int end)
+    {
+        for (int source=begin; source<end; ++source)
         {
-            //if the source node is the same as the target just set to target
-            if (source == target)
-            {
-                ShortestPaths[source][target] = target;
-            }
-            else
-            {
-                int nd = target;
+            //do the search
+            Graph_SearchDijkstra<graph_type> search(m_Graph, source);
 
-                while ((nd != source) && (spt[nd] != 0))
+            //iterate through every node in the graph and grab the cost to travel to
+            //that node
+            for (int target = 0; target<m_Graph.getNumNodes(); ++target)
+            {
+                if (source != target)
                 {
-                ShortestPaths[spt[nd]->from][target]= nd;
-
-                nd = spt[nd]->from;
+                    m_Table[source][target]= search.getCostToNode(target);
                 }
-            }
-        }//next target node
-    }//next source node
-
-    return ShortestPaths;
-}
+            }//next target node
+        }//next source node
+    }
 
+private:
+    const graph_type& m_Graph;
+    std::vector<std::vector<float> >& m_Table;
+};
 
 //----------------------- createAllPairsCostsTable -------------------------------
 //
 //  creates a lookup table of the cost associated from traveling from one
-//  node to every other
+//  node to every other. The sources are shared out between the threads of
+//  pWorkers if it isn't NULL
 //-----------------------------------------------------------------------------
 template <class graph_type>
-std::vector<std::vector<float> > createAllPairsCostsTable(const graph_type& G)
+std::vector<std::vector<float> > createAllPairsCostsTable(const graph_type& G, WorkerPool* pWorkers = NULL)
 {
     //create a two dimensional vector
     std::vector<float> row(G.getNumNodes(), 0.0);
     std::vector<std::vector<float> > PathCosts(G.getNumNodes(), row);
 
-    for (int source=0; source<G.getNumNodes(); ++source)
-    {
-        //do the search
-        Graph_SearchDijkstra<graph_type> search(G, source);
+    AllPairsCostsJob<graph_type> job(G, PathCosts);
 
-        //iterate through every node in the graph and grab the cost to travel to
-        //that node
-        for (int target = 0; target<G.getNumNodes(); ++target)
-        {
-            if (source != target)
-            {
-                PathCosts[source][target]= search.getCostToNode(target);
-            }
-        }//next target node
-
-    }//next source node
+    if (pWorkers)
+    {
+        pWorkers->run(job, G.getNumNodes(), 1);
+    }
+    else
+    {
+        job.process(0, G.getNumNodes());
+    }
 
     return PathCosts;
 }
@@ -242,12 +306,12 @@ float calculateAverageGraphEdgeLength(const graph_type& G)
     float TotalLength = 0;
     int NumEdgesCounted = 0;
 
-    graph_type::ConstNodeIterator NodeItr(G);
-    const graph_type::NodeType* pN;
+    typename graph_type::ConstNodeIterator NodeItr(G);
+    const typename graph_type::NodeType* pN;
     for (pN = NodeItr.begin(); !NodeItr.end(); pN=NodeItr.next())
     {
-        graph_type::ConstEdgeIterator EdgeItr(G, pN->Index());
-        for (const graph_type::EdgeType* pE = EdgeItr.begin(); !EdgeItr.end(); pE=EdgeItr.next())
+        typename graph_type::ConstEdgeIterator EdgeItr(G, pN->getIndex());
+        for (const typename graph_type::EdgeType* pE = EdgeItr.begin(); !EdgeItr.end(); pE=EdgeItr.next())
         {
             //increment edge counter
             ++NumEdgesCounted;
@@ -267,16 +331,16 @@ float calculateAverageGraphEdgeLength(const graph_type& G)
 template <class graph_type>
 float GetCostliestGraphEdge(const graph_type& G)
 {
-    float greatest = MinDouble;
+    float greatest = -FloatMax;
 
-    graph_type::ConstNodeIterator NodeItr(G);
-    const graph_type::NodeType* pN;
+    typename graph_type::ConstNodeIterator NodeItr(G);
+    const typename graph_type::NodeType* pN;
     for (pN = NodeItr.begin(); !NodeItr.end(); pN=NodeItr.next())
     {
-        graph_type::ConstEdgeIterator EdgeItr(G, pN->Index());
-        for (const graph_type::EdgeType* pE = EdgeItr.begin(); !EdgeItr.end(); pE=EdgeItr.next())
+        typename graph_type::ConstEdgeIterator EdgeItr(G, pN->getIndex());
+        for (const typename graph_type::EdgeType* pE = EdgeItr.begin(); !EdgeItr.end(); pE=EdgeItr.next())
         {
-            if (pE->Cost() > greatest)greatest = pE->getCost();
+            if (pE->cost() > greatest)greatest = pE->cost();
         }
     }
 
@@ -13,9 +13,11 @@
 #include <list>
 #include <cassert>
 #include <string>
+#include <fstream>
 
 #include "common/2D/Vector2D.h"
 #include "common/misc/UtilsEx.h" 
+#include "common/navigation/SearchWorkspaceRegistry.h"
 
 
 
@@ -60,6 +62,9 @@ public:
     //ctor
     SparseGraph(bool digraph): m_iNextNodeIndex(0), m_bDigraph(digraph){}
 
+    //the search workspaces pooled for this graph are dropped
+    ~SparseGraph(){SearchWorkspaceRegistry::retire(this);}
+
     //returns the node at the given index
     const NodeType& getNode(int idx)const;
 
@@ -104,7 +109,7 @@ public:
     {
         int count = 0;
 
-        for (unsigned int n=0; n<m_Nodes.size(); ++n) if (m_Nodes[n].Index() != -1) ++count;
+        for (unsigned int n=0; n<m_Nodes.size(); ++n) if (m_Nodes[n].getIndex() != -1) ++count;
 
         return count;
     }
@@ -114,7 +119,7 @@ public:
     {
         int tot = 0;
 
-        for (EdgeListVector::const_iterator curEdge = m_Edges.begin(); curEdge != m_Edges.end(); ++curEdge)
+        for (typename EdgeListVector::const_iterator curEdge = m_Edges.begin(); curEdge != m_Edges.end(); ++curEdge)
         {
             tot += curEdge->size();
         }
@@ -153,7 +158,7 @@ public:
 
     void removeEdges()
     {
-        for (EdgeListVector::iterator it = m_Edges.begin(); it != m_Edges.end(); ++it)
+        for (typename EdgeListVector::iterator it = m_Edges.begin(); it != m_Edges.end(); ++it)
         {
             it->clear();
         }
@@ -255,6 +260,12 @@ public:
         {
             return (curEdge == G.m_Edges[NodeIndex].end());
         }
+
+        //the node the current edge leads to and its cost. The searches read
+        //these through the iterator, which lets a FrozenGraph serve them
+        //from its packed arrays
+        int to()const{return curEdge->to();}
+        float cost()const{return curEdge->cost();}
     };
 
     friend class ConstEdgeIterator;
@@ -274,9 +285,9 @@ public:
         //iterator as a parameter and assigns the next valid element to it.
         void getNextValidNode(typename NodeVector::iterator& it)
         {
-            if ( curNode == G.m_Nodes.end() || it->Index() != -1) return;
+            if ( curNode == G.m_Nodes.end() || it->getIndex() != -1) return;
 
-            while ( (it->Index() == -1) )
+            while ( (it->getIndex() == -1) )
             {
                 ++it;
 
@@ -336,9 +347,9 @@ public:
         //iterator as a parameter and assigns the next valid element to it.
         void getNextValidNode(typename NodeVector::const_iterator& it)
         {
-            if ( curNode == G.m_Nodes.end() || it->Index() != -1) return;
+            if ( curNode == G.m_Nodes.end() || it->getIndex() != -1) return;
 
-            while ( (it->Index() == -1) )
+            while ( (it->getIndex() == -1) )
             {
                 ++it;
 
@@ -398,7 +409,7 @@ public:
 template <class node_type, class edge_type>
 bool SparseGraph<node_type, edge_type>::isNodePresent(int nd)const
 {
-    if ((nd >= (int)m_Nodes.size() || (m_Nodes[nd].Index() == -1)))
+    if ((nd >= (int)m_Nodes.size() || (m_Nodes[nd].getIndex() == -1)))
     {
         return false;
     }
@@ -415,7 +426,7 @@ bool SparseGraph<node_type, edge_type>::isEdgePresent(int from, int to)const
 {
     if (isNodePresent(from) && isNodePresent(from))
     {
-        for (EdgeList::const_iterator curEdge = m_Edges[from].begin(); curEdge != m_Edges[from].end(); ++curEdge)
+        for (typename EdgeList::const_iterator curEdge = m_Edges[from].begin(); curEdge != m_Edges[from].end(); ++curEdge)
         {
             if (curEdge->to() == to) return true;
         }
@@ -454,13 +465,13 @@ node_type&  SparseGraph<node_type, edge_type>::getNode(int idx)
 template <class node_type, class edge_type>
 const edge_type& SparseGraph<node_type, edge_type>::getEdge(int from, int to)const
 {
-    assert( (from < m_Nodes.size()) &&(from >=0) && m_Nodes[from].Index() != -1 &&
+    assert( (from < m_Nodes.size()) &&(from >=0) && m_Nodes[from].getIndex() != -1 &&
                 "<SparseGraph::GetEdge>: invalid 'from' index");
 
-    assert( (to < m_Nodes.size()) && (to >=0) && m_Nodes[to].Index() != -1 &&
+    assert( (to < m_Nodes.size()) && (to >=0) && m_Nodes[to].getIndex() != -1 &&
                 "<SparseGraph::GetEdge>: invalid 'to' index");
 
-    for (EdgeList::const_iterator curEdge = m_Edges[from].begin(); curEdge != m_Edges[from].end(); ++curEdge)
+    for (typename EdgeList::const_iterator curEdge = m_Edges[from].begin(); curEdge != m_Edges[from].end(); ++curEdge)
     {
         if (curEdge->to() == to) return *curEdge;
     }
@@ -472,13 +483,13 @@ const edge_type& SparseGraph<node_type, edge_type>::getEdge(int from, int to)con
 template <class node_type, class edge_type>
 edge_type& SparseGraph<node_type, edge_type>::getEdge(int from, int to)
 {
-    assert( (from < m_Nodes.size()) && (from >=0) && m_Nodes[from].Index() != -1 &&
+    assert( (from < m_Nodes.size()) && (from >=0) && m_Nodes[from].getIndex() != -1 &&
                 "<SparseGraph::GetEdge>: invalid 'from' index");
 
-    assert( (to < m_Nodes.size()) && (to >=0) && m_Nodes[to].Index() != -1 &&
+    assert( (to < m_Nodes.size()) && (to >=0) && m_Nodes[to].getIndex() != -1 &&
                 "<SparseGraph::GetEdge>: invalid 'to' index");
 
-    for (EdgeList::iterator curEdge = m_Edges[from].begin(); curEdge != m_Edges[from].end(); ++curEdge)
+    for (typename EdgeList::iterator curEdge = m_Edges[from].begin(); curEdge != m_Edges[from].end(); ++curEdge)
     {
         if (curEdge->to() == to) return *curEdge;
     }
@@ -501,7 +512,7 @@ void SparseGraph<node_type, edge_type>::addEdge(EdgeType edge)
                 "<SparseGraph::AddEdge>: invalid node index");
 
     //make sure both nodes are active before adding the edge
-    if ( (m_Nodes[edge.to()].Index() != -1) &&  (m_Nodes[edge.from()].Index() != -1))
+    if ( (m_Nodes[edge.to()].getIndex() != -1) &&  (m_Nodes[edge.from()].getIndex() != -1))
     {
         //add the edge, first making sure it is unique
         if (isUniqueEdge(edge.from(), edge.to()))
@@ -535,7 +546,7 @@ void SparseGraph<node_type, edge_type>::removeEdge(int from, int to)
     assert ( (from < (int)m_Nodes.size()) && (to < (int)m_Nodes.size()) &&
                 "<SparseGraph::RemoveEdge>:invalid node index");
 
-    EdgeList::iterator curEdge;
+    typename EdgeList::iterator curEdge;
   
     if (!m_bDigraph)
     {
@@ -562,14 +573,14 @@ void SparseGraph<node_type, edge_type>::removeEdge(int from, int to)
 template <class node_type, class edge_type>
 int SparseGraph<node_type, edge_type>::addNode(node_type node)
 {
-    if (node.Index() < (int)m_Nodes.size())
+    if (node.getIndex() < (int)m_Nodes.size())
     {
         //make sure the client is not trying to add a node with the same ID as
         //a currently active node
-        assert (m_Nodes[node.Index()].Index() == -1 &&
+        assert (m_Nodes[node.getIndex()].getIndex() == -1 &&
                      "<SparseGraph::AddNode>: Attempting to add a node with a duplicate ID");
 
-        m_Nodes[node.Index()] = node;
+        m_Nodes[node.getIndex()] = node;
 
         return m_iNextNodeIndex;
     }
@@ -577,7 +588,7 @@ int SparseGraph<node_type, edge_type>::addNode(node_type node)
     else
     {
         //make sure the new node has been indexed correctly
-        assert (node.Index() == m_iNextNodeIndex && "<SparseGraph::AddNode>:invalid index");
+        assert (node.getIndex() == m_iNextNodeIndex && "<SparseGraph::AddNode>:invalid index");
 
         m_Nodes.push_back(node);
         m_Edges.push_back(EdgeList());
@@ -594,12 +605,12 @@ int SparseGraph<node_type, edge_type>::addNode(node_type node)
 template <class node_type, class edge_type>
 void SparseGraph<node_type, edge_type>::cullInvalidEdges()
 {
-    for (EdgeListVector::iterator curEdgeList = m_Edges.begin(); curEdgeList != m_Edges.end(); ++curEdgeList)
+    for (typename EdgeListVector::iterator curEdgeList = m_Edges.begin(); curEdgeList != m_Edges.end(); ++curEdgeList)
     {
-        for (EdgeList::iterator curEdge = (*curEdgeList).begin(); curEdge != (*curEdgeList).end(); ++curEdge)
+        for (typename EdgeList::iterator curEdge = (*curEdgeList).begin(); curEdge != (*curEdgeList).end(); ++curEdge)
         {
-            if (m_Nodes[curEdge->to()].Index() == -1 || 
-            m_Nodes[curEdge->from()].Index() == -1)
+            if (m_Nodes[curEdge->to()].getIndex() == -1 || 
+            m_Nodes[curEdge->from()].getIndex() == -1)
             {
                 curEdge = (*curEdgeList).erase(curEdge);
             }
@@ -625,9 +636,9 @@ void SparseGraph<node_type, edge_type>::removeNode(int node)
     if (!m_bDigraph)
     {    
         //visit each neighbour and erase any edges leading to this node
-        for (EdgeList::iterator curEdge = m_Edges[node].begin(); curEdge != m_Edges[node].end(); ++curEdge)
+        for (typename EdgeList::iterator curEdge = m_Edges[node].begin(); curEdge != m_Edges[node].end(); ++curEdge)
         {
-            for (EdgeList::iterator curE = m_Edges[curEdge->to()].begin(); curE != m_Edges[curEdge->to()].end(); ++curE)
+            for (typename EdgeList::iterator curE = m_Edges[curEdge->to()].begin(); curE != m_Edges[curEdge->to()].end(); ++curE)
             {
                 if (curE->to() == node)
                 {
@@ -659,7 +670,7 @@ void SparseGraph<node_type, edge_type>::setEdgeCost(int from, int to, float NewC
                 "<SparseGraph::SetEdgeCost>: invalid index");
 
     //visit each neighbour and erase any edges leading to this node
-    for (EdgeList::iterator curEdge = m_Edges[from].begin(); curEdge != m_Edges[from].end(); ++curEdge)
+    for (typename EdgeList::iterator curEdge = m_Edges[from].begin(); curEdge != m_Edges[from].end(); ++curEdge)
     {
         if (curEdge->to() == to)
         {
@@ -677,7 +688,7 @@ void SparseGraph<node_type, edge_type>::setEdgeCost(int from, int to, float NewC
 template <class node_type, class edge_type>
 bool SparseGraph<node_type, edge_type>::isUniqueEdge(int from, int to)const
 {
-    for (EdgeList::const_iterator curEdge = m_Edges[from].begin();curEdge != m_Edges[from].end(); ++curEdge)
+    for (typename EdgeList::const_iterator curEdge = m_Edges[from].begin();curEdge != m_Edges[from].end(); ++curEdge)
     {
         if (curEdge->to() == to)
         {
@@ -714,20 +725,20 @@ bool SparseGraph<node_type, edge_type>::save(std::ofstream& stream)const
     stream << m_Nodes.size() << std::endl;
 
     //iterate through the graph nodes and save them
-    NodeVector::const_iterator curNode = m_Nodes.begin();
+    typename NodeVector::const_iterator curNode = m_Nodes.begin();
     for (curNode; curNode!=m_Nodes.end(); ++curNode)
     {
         stream << *curNode;
     }
 
     //save the number of edges
-    stream << NumEdges() << std::endl;
+    stream << getNumEdges() << std::endl;
 
 
     //iterate through the edges and save them
     for (unsigned int nodeIdx = 0; nodeIdx < m_Nodes.size(); ++nodeIdx)
     {
-        for (EdgeList::const_iterator curEdge = m_Edges[nodeIdx].begin();
+        for (typename EdgeList::const_iterator curEdge = m_Edges[nodeIdx].begin();
                 curEdge!=m_Edges[nodeIdx].end(); ++curEdge)
         {
             stream << *curEdge;
@@ -774,7 +785,7 @@ bool SparseGraph<node_type, edge_type>::load(std::ifstream& stream)
         //when editing graphs it's possible to end up with a situation where some
         //of the nodes have been invalidated (their id's set to -1). Therefore
         //when a node of index -1 is encountered, it must still be added.
-        if (NewNode.Index() != -1)
+        if (NewNode.getIndex() != -1)
         {
             addNode(NewNode);
         }
@@ -1,16 +1,16 @@
 
+#include <algorithm>
+#include <cmath>
+
 #include "MessageDispatcher.h"
 #include "common/game/BaseEntity.h"
 #include "common/game/EntityManager.h"
+#include "common/game/WorldContext.h"
 #include "common/misc/LogDebug.h"
 
-using std::set;
-
 MessageDispatcher* MessageDispatcher::instance()
 {
-    static MessageDispatcher instance; 
-
-    return &instance;
+    return &WorldContext::getCurrent()->getDispatcher();
 }
 
 //----------------------------- Dispatch ---------------------------------
@@ -30,60 +30,211 @@ void MessageDispatcher::execute(BaseEntity* pReceiver, const Telegram& telegram)
 //  routes the message to the correct agent (if no delay) or stores
 //  in the message queue to be dispatched at the correct time
 //------------------------------------------------------------------------
-void MessageDispatcher::dispatchMsg(float delay,
+int MessageDispatcher::dispatchMsg(float delay,
                                                                int sender,
                                                                int receiver,
                                                                int msg,
-                                                               void* extraInfo)
+                                                               const TelegramInfo& extraInfo)
 {
+    //the receiver is looked up when the message is delivered, the entities
+    //can't be touched now
+    if (m_bDeferring)
+    {
+        Telegram telegram(sender, receiver, msg, extraInfo);
+        telegram.m_dispatchTick = dueTick(delay);
+
+        m_Deferred.push(telegram);
+
+        return NO_PENDING_MSG;
+    }
+
     //get a pointer to the receiver
-    BaseEntity* pReceiver = EntityManager::instance()->getEntityByID(receiver);
+    BaseEntity* pReceiver = m_Entities.getEntityByID(receiver);
 
     //make sure the receiver is valid
     if (pReceiver == NULL)
     {
         AILOG("Warning! No Receiver with ID of  %d found", receiver);
-        return;
+        return NO_PENDING_MSG;
     }
     
     //create the telegram
-    Telegram telegram(delay, sender, receiver, msg, extraInfo);
+    Telegram telegram(sender, receiver, msg, extraInfo);
+    telegram.m_dispatchTick = m_Clock.getTick();
   
     //if there is no delay, route telegram immediately                       
     if (delay <= 0.0)                                                        
     {
         //send the telegram to the recipient
         execute(pReceiver, telegram);
+
+        return NO_PENDING_MSG;
     }
-    else //calculate the time when the telegram should be dispatched
+
+    //calculate the tick when the telegram should be dispatched
+    telegram.m_dispatchTick = dueTick(delay);
+
+    int pending = m_delayWheel.find(telegram.m_dispatchTick, telegram);
+    if (pending != NO_PENDING_MSG) return pending;
+
+    return m_delayWheel.schedule(telegram.m_dispatchTick, telegram);
+}
+
+//------------------------------- dueTick --------------------------------
+//
+//  a delayed message goes out on the first tick at least delay seconds
+//  from now. Without a tick length to go by it goes out on the next tick
+//------------------------------------------------------------------------
+unsigned int MessageDispatcher::dueTick(float delay)const
+{
+    if (delay <= 0.0) return m_Clock.getTick();
+
+    float tickLength = m_Clock.getTickLength();
+    if (tickLength <= 0) return m_Clock.getTick() + 1;
+
+    //a delay of a whole number of ticks goes out on that tick, not the one after
+    unsigned int ticks = (unsigned int)std::ceil(delay / tickLength);
+
+    return m_Clock.getTick() + std::max(ticks, 1u);
+}
+
+//------------------------------------------------------------------------
+//
+//  orders the due telegrams by receiver, and those for one receiver in
+//  the order they were sent
+//------------------------------------------------------------------------
+class DueTelegramOrder
+{
+public:
+    bool operator()(const TimingWheel<Telegram>::Due& a, const TimingWheel<Telegram>::Due& b)const
     {
-        m_delayQueue.push(telegram);
+        if (a.item.m_receiver != b.item.m_receiver) return a.item.m_receiver < b.item.m_receiver;
+        if (a.tick != b.tick) return a.tick < b.tick;
+        return a.seq < b.seq;
     }
-}
+};
 
 //---------------------- DispatchDelayedMessages -------------------------
 //
-//  This function dispatches any telegrams with a timestamp that has
-//  expired. Any dispatched telegrams are removed from the queue
+//  This function dispatches any telegrams whose tick has come, each
+//  receiver getting all of its telegrams in one go. Telegrams whose
+//  receiver has been removed since they were sent are dropped. The
+//  receiver is looked up for every telegram, as a message can remove
+//  the entity it is sent to
 //------------------------------------------------------------------------
 void MessageDispatcher::dispatchMsgDelay()
 { 
-    std::chrono::steady_clock::time_point curTime = std::chrono::steady_clock::now();
-    
-    while (m_delayQueue.size() > 0)
+    m_delayWheel.advance(m_Clock.getTick(), m_Due);
+
+    if (m_Due.empty()) return;
+
+    std::sort(m_Due.begin(), m_Due.end(), DueTelegramOrder());
+
+    for (unsigned int t=0; t<m_Due.size(); ++t)
     {
-        auto iter = m_delayQueue.top();
-        if (iter.m_dispatchTime < curTime )
+        const Telegram& telegram = m_Due[t].item;
+
+        BaseEntity* pReceiver = m_Entities.getEntityByID(telegram.m_receiver);
+        if (pReceiver)
         {
-            BaseEntity* pReceiver = EntityManager::instance()->getEntityByID(iter.m_receiver);
-            execute(pReceiver, iter);
-            m_delayQueue.pop();
+            execute(pReceiver, telegram);
         }
-        else 
+        else
         {
-            break;
+            AILOG("Warning! Dropped a delayed message for the removed entity %d", telegram.m_receiver);
         }
     }
+
+    m_Due.clear();
 }
 
+//------------------------- sortBySlot -----------------------------------
+//
+//  a stable counting sort of the keys in from into to, by the slot index
+//  of the entity ID in the field id. An ID of -1 (no sender) goes first.
+//  The slot indices are dense, so this is linear where a comparison sort
+//  of the random receivers was the bulk of the delivery
+//------------------------------------------------------------------------
+template <class key_type>
+static void sortBySlot(const std::vector<key_type>& from,
+                       std::vector<key_type>&       to,
+                       int key_type::*              id,
+                       std::vector<unsigned int>&   counts)
+{
+    counts.clear();
+
+    for (unsigned int k=0; k<from.size(); ++k)
+    {
+        unsigned int bucket = (from[k].*id < 0) ? 0 : EntityManager::getIndex(from[k].*id) + 1;
+        if (bucket >= counts.size()) counts.resize(bucket+1, 0);
+        ++counts[bucket];
+    }
+
+    //turn the counts into the position of each bucket's first key
+    unsigned int first = 0;
+    for (unsigned int b=0; b<counts.size(); ++b)
+    {
+        unsigned int count = counts[b];
+        counts[b] = first;
+        first += count;
+    }
+
+    to.resize(from.size());
+
+    for (unsigned int k=0; k<from.size(); ++k)
+    {
+        unsigned int bucket = (from[k].*id < 0) ? 0 : EntityManager::getIndex(from[k].*id) + 1;
+        to[counts[bucket]++] = from[k];
+    }
+}
+
+//------------------------- deliverDeferredMsgs --------------------------
+//
+//  see description in header. The keys are sorted by sender and then,
+//  keeping that order, by receiver. The messages the receivers send while
+//  handling these are delivered as usual
+//------------------------------------------------------------------------
+void MessageDispatcher::deliverDeferredMsgs()
+{
+    m_bDeferring = false;
+
+    m_Deferred.drain(m_DeferredMsgs);
 
+    if (m_DeferredMsgs.empty()) return;
+
+    for (unsigned int t=0; t<m_DeferredMsgs.size(); ++t)
+    {
+        DeferredKey key = {m_DeferredMsgs[t].m_receiver, m_DeferredMsgs[t].m_sender, t};
+        m_DeferredOrder.push_back(key);
+    }
+
+    sortBySlot(m_DeferredOrder, m_DeferredSorted, &DeferredKey::sender, m_DeferredCounts);
+    sortBySlot(m_DeferredSorted, m_DeferredOrder, &DeferredKey::receiver, m_DeferredCounts);
+
+    for (unsigned int t=0; t<m_DeferredOrder.size(); ++t)
+    {
+        const Telegram& telegram = m_DeferredMsgs[m_DeferredOrder[t].index];
+
+        BaseEntity* pReceiver = m_Entities.getEntityByID(telegram.m_receiver);
+        if (pReceiver == NULL)
+        {
+            AILOG("Warning! No Receiver with ID of  %d found", telegram.m_receiver);
+            continue;
+        }
+
+        if (telegram.m_dispatchTick != m_Clock.getTick())
+        {
+            if (m_delayWheel.find(telegram.m_dispatchTick, telegram) == NO_PENDING_MSG)
+            {
+                m_delayWheel.schedule(telegram.m_dispatchTick, telegram);
+            }
+        }
+        else
+        {
+            execute(pReceiver, telegram);
+        }
+    }
+
+    m_DeferredOrder.clear();
+    m_DeferredMsgs.clear();
+}
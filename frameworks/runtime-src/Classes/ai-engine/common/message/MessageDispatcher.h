@@ -6,39 +6,102 @@
 //  Name:   MessageDispatcher.h
 //
 //  Desc:   A message dispatcher. Manages messages of the type Telegram.
-//          Instantiated as a singleton.
+//          Each world has its own, in its WorldContext, which delivers
+//          the messages to the entities of that world.
+//
+//          Delayed messages are kept in a timing wheel keyed by the tick
+//          of the world's clock, and are delivered by dispatchMsgDelay
+//          on the tick they fall due.
+//
+//          A message sent without a delay is normally handled before
+//          dispatchMsg returns. When entities are updated on several threads
+//          at once that would have one thread change an entity another is
+//          updating. So for such a phase the dispatcher can be switched to
+//          deferring (beginDeferring): dispatchMsg may then be called from
+//          any number of threads and only queues the message, and
+//          deliverDeferredMsgs hands them out on one thread once the phase
+//          is over. The threads must use the dispatcher of the entities'
+//          context (BaseEntity::getContext), not instance().
 //
 //
 //------------------------------------------------------------------------
+#include <vector>
+
 #include "common/message/Telegram.h"
+#include "common/misc/TimingWheel.h"
+#include "common/misc/MultiProducerQueue.h"
 
 
 class BaseEntity;
+class EntityManager;
 
 //to make code easier to read
 const float SEND_MSG_IMMEDIATELY = 0.0f;
-const int NO_ADDITIONAL_INFO   = 0;
+const TelegramInfo NO_ADDITIONAL_INFO;
 const int SENDER_ID_IRRELEVANT = -1;
 
+//what dispatchMsg returns for a message it delivered immediately
+const int NO_PENDING_MSG = -1;
+
 
 class MessageDispatcher
 {
 public:
+    //the receivers are looked up in entities, delays are counted in ticks
+    //of clock
+    MessageDispatcher(EntityManager& entities, const SimClock& clock):m_Entities(entities),
+                                                                      m_Clock(clock),
+                                                                      m_bDeferring(false),
+                                                                      m_delayWheel(clock.getTick())
+    {}
+
+    //returns the dispatcher of the current world
     static MessageDispatcher* instance();
 
     //send a message to another agent. Receiving agent is referenced by ID.
-    void dispatchMsg(float delay,
+    //A delayed message is delivered on the first tick at least delay
+    //seconds from now. Returns a handle to cancel it with, or
+    //NO_PENDING_MSG if the message was delivered immediately. If the same
+    //message is already pending for that tick it isn't sent twice, the
+    //handle of the pending one is returned. extraInfo is copied into the
+    //telegram, see TelegramInfo.
+    //While deferring the message is queued and NO_PENDING_MSG returned, so
+    //a delayed message sent then can't be cancelled
+    int dispatchMsg(float delay,
                                        int sender,
                                        int receiver,
                                        int msg,
-                                       void* extraInfo);
+                                       const TelegramInfo& extraInfo = TelegramInfo());
 
-    //send out any delayed messages. This method is called each time through   
+    //removes a delayed message that hasn't been delivered yet. Returns
+    //false if it has been delivered or cancelled already
+    bool cancelMsg(int handle){return m_delayWheel.cancel(handle);}
+
+    //send out the delayed messages due on the ticks since the last call,
+    //grouped by receiver. This method is called each time through   
     //the main game loop.
     void dispatchMsgDelay();
 
+    int getNumPendingMsgs()const{return m_delayWheel.getNumPending();}
+
+    //queue the messages sent from now on instead of delivering them, until
+    //deliverDeferredMsgs is called. Call it between the phases, not while
+    //messages are being sent
+    void beginDeferring(){m_bDeferring = true;}
+
+    bool isDeferring()const{return m_bDeferring;}
+
+    //stops deferring and delivers the queued messages on the calling
+    //thread. Those for a receiver are delivered together, ordered by
+    //sender, and those of a sender in the order it sent them. So how the
+    //senders were split among the threads makes no difference. Delayed
+    //messages go into the timing wheel
+    void deliverDeferredMsgs();
+
 private:  
-    MessageDispatcher(){}
+    EntityManager& m_Entities;
+
+    const SimClock& m_Clock;
 
     //copy ctor and assignment should be private
     MessageDispatcher(const MessageDispatcher&);
@@ -48,11 +111,38 @@ private:
     //This method calls the message handling member function of the receiving
     //entity, pReceiver, with the newly created telegram
     void execute(BaseEntity* pReceiver, const Telegram& msg);
+
+    //the tick a message sent now with the delay falls due on
+    unsigned int dueTick(float delay)const;
+
+    //set between the phases only, so read by the sending threads without
+    //any locking
+    bool m_bDeferring;
+
+    //the messages sent while deferring
+    MultiProducerQueue<Telegram> m_Deferred;
+
+    //a message of m_DeferredMsgs, by its index, with what it is sorted by
+    struct DeferredKey
+    {
+        int receiver;
+        int sender;
+        unsigned int index;
+    };
+
+    //the messages being delivered by deliverDeferredMsgs and their order.
+    //Kept to reuse their memory
+    std::vector<Telegram> m_DeferredMsgs;
+    std::vector<DeferredKey> m_DeferredOrder;
+    std::vector<DeferredKey> m_DeferredSorted;
+    std::vector<unsigned int> m_DeferredCounts;
     
-    //a std::priority_queue is used as the container for the delayed messages
-    //because of the benefit of automatic sorting and avoidance
-    //of duplicates. Messages are sorted by their dispatch time.
-    std::priority_queue<Telegram> m_delayQueue;    
+    //the delayed messages by the tick they are due on
+    TimingWheel<Telegram> m_delayWheel;
+
+    //the messages being delivered by dispatchMsgDelay. Kept to reuse its
+    //memory
+    std::vector<TimingWheel<Telegram>::Due> m_Due;
     
 };
 
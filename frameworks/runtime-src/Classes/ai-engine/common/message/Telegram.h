@@ -12,9 +12,110 @@
 //------------------------------------------------------------------------
 #include <iostream>
 #include <math.h>
-#include <chrono>
+#include <new>
+#include <cstring>
+#include <cassert>
+#include "common/misc/SimClock.h"
+#include "common/2D/Vector2D.h"
 #include <queue>
 
+
+//an entity carried by a telegram. Entities are passed by their ID, which
+//the receiver looks up in the EntityManager. The lookup finds nothing if
+//the entity has gone in the meantime
+struct EntityHandle
+{
+    int id;
+
+    EntityHandle():id(-1){}
+    explicit EntityHandle(int entityID):id(entityID){}
+};
+
+//gives each type a telegram can carry a tag of its own. To send another
+//type specialize this for it with a new value. The type must be plain data
+//(nothing a copy of its bytes would break) of at most
+//TelegramInfo::MaxSize bytes
+template <class T> struct TelegramInfoTag;
+
+template <> struct TelegramInfoTag<int>          {enum {value = 1};};
+template <> struct TelegramInfoTag<float>        {enum {value = 2};};
+template <> struct TelegramInfoTag<Vector2D>     {enum {value = 3};};
+template <> struct TelegramInfoTag<EntityHandle> {enum {value = 4};};
+
+
+//------------------------------------------------------------------------
+//
+//  the additional information that may accompany a message. The value is
+//  copied into the telegram together with the tag of its type, so a
+//  telegram doesn't point into the sender and can be kept, copied and
+//  delivered later (or on another thread) as it is. Reading it as another
+//  type than it was sent with asserts
+//------------------------------------------------------------------------
+class TelegramInfo
+{
+public:
+    enum {MaxSize = 16};
+
+    //no information
+    TelegramInfo():m_iTag(0)
+    {
+        std::memset(m_Data, 0, MaxSize);
+    }
+
+    template <class T>
+    TelegramInfo(const T& value):m_iTag(TelegramInfoTag<T>::value)
+    {
+        static_assert(sizeof(T) <= MaxSize, "<TelegramInfo>: type too large for a telegram");
+
+        //unused bytes are zero so two telegrams can be compared bytewise
+        std::memset(m_Data, 0, MaxSize);
+        new (m_Data) T(value);
+    }
+
+    bool isEmpty()const{return m_iTag == 0;}
+
+    template <class T>
+    bool is()const{return m_iTag == TelegramInfoTag<T>::value;}
+
+    template <class T>
+    const T& get()const
+    {
+        assert (is<T>() && "<TelegramInfo::get>: the telegram carries another type");
+        return *reinterpret_cast<const T*>(m_Data);
+    }
+
+    bool operator==(const TelegramInfo& rhs)const
+    {
+        return m_iTag == rhs.m_iTag && std::memcmp(m_Data, rhs.m_Data, MaxSize) == 0;
+    }
+
+    unsigned int hashValue()const
+    {
+        unsigned int words[MaxSize/sizeof(unsigned int)];
+        std::memcpy(words, m_Data, MaxSize);
+
+        unsigned int h = (unsigned int)m_iTag;
+        for (int w=0; w<MaxSize/(int)sizeof(unsigned int); ++w)
+        {
+            h = (h ^ words[w]) * 16777619u;
+        }
+        return h;
+    }
+
+private:
+    union
+    {
+        unsigned char m_Data[MaxSize];
+
+        //aligns m_Data for anything it may hold
+        double        m_dAlign;
+        void*         m_pAlign;
+    };
+
+    int m_iTag;
+};
+
+
 struct Telegram
 {
     //the entity that sent this telegram
@@ -27,57 +128,44 @@ struct Telegram
     //"MessageTypes.h"
     int m_msgId;
 
-    //messages can be dispatched immediately or delayed for a specified amount
-    //of time. If a delay is necessary this field is stamped with the time 
-    //the message should be dispatched.
-    std::chrono::steady_clock::time_point m_dispatchTime;
+    //messages can be dispatched immediately or delayed for a number of
+    //ticks of the simulation clock. This is the tick the message is (or
+    //was) delivered on
+    unsigned int m_dispatchTick;
 
     //any additional information that may accompany the message
-    void* m_extraInfo;
+    TelegramInfo m_extraInfo;
 
-    Telegram(float delay,
-           int sender,
+    Telegram(int sender,
            int receiver,
            int msg,
-           void* info = NULL): m_sender(sender),
+           const TelegramInfo& info = TelegramInfo()): m_sender(sender),
                                          m_receiver(receiver),
                                          m_msgId(msg),
+                                         m_dispatchTick(0),
                                          m_extraInfo(info)
-    {
-        if (delay >= 0.0)
-        {
-            m_dispatchTime = std::chrono::steady_clock::now() + std::chrono::milliseconds((int)(delay*1000));
-        }
-    }
-
-    //for std::priority_queue customize sort , by hlb
-    friend bool operator<(const Telegram &a,const Telegram &b)
-    {
-        return a.m_dispatchTime > b.m_dispatchTime;  
-    }    
+    {}
 };
 
-//typedef std::priority_queue<Telegram> PriorityQueue; //STL queue
-
-
-//these telegrams will be stored in a priority queue. Therefore the >
-//operator needs to be overloaded so that the PQ can sort the telegrams
-//by time priority. Note how the times must be smaller than
-//SmallestDelay apart before two Telegrams are considered unique.
 
+//two telegrams are the same if they carry the same message between the
+//same entities on the same tick. The dispatcher sends only one of them
 inline bool operator==(const Telegram& t1, const Telegram& t2)
 {
-    auto dt = std::chrono::duration_cast<std::chrono::milliseconds>(t1.m_dispatchTime - t2.m_dispatchTime).count();
-    return ( std::abs(dt) < 250 && (t1.m_sender == t2.m_sender) && 
-        (t1.m_receiver == t2.m_receiver) && (t1.m_msgId == t2.m_msgId));
+    return (t1.m_dispatchTick == t2.m_dispatchTick) && 
+           (t1.m_sender == t2.m_sender) && 
+           (t1.m_receiver == t2.m_receiver) && 
+           (t1.m_msgId == t2.m_msgId) &&
+           (t1.m_extraInfo == t2.m_extraInfo);
 }
 
-//handy helper function for dereferencing the ExtraInfo field of the Telegram 
-//to the required type.
-template <class T>
-inline T dereferenceToType(void* p)
+//for the timing wheel of the dispatcher, see operator==
+inline unsigned int hashValue(const Telegram& t)
 {
-    return *(T*)(p);
+    unsigned int h = (unsigned int)t.m_receiver * 2654435761u;
+    h ^= (unsigned int)t.m_sender * 40503u + (unsigned int)t.m_msgId;
+    h ^= t.m_extraInfo.hashValue() * 97u;
+    return h;
 }
 
 
@@ -10,26 +10,118 @@
 //          between cells, the Update method should be called each update-cycle
 //          to sychronize the entity and the cell space it occupies
 //
+//          Queries only visit the block of cells covered by the query box, so
+//          their cost depends on the radius and not on the total cell count.
+//          forEachNeighbor can be used instead of the begin/next/end interface
+//          when the caller doesn't want to go through the shared neighbor buffer
+//
+//          begin/next/end read a neighbor vector owned by the partition, so
+//          only one query can be in flight at a time. The const queries
+//          (forEachNeighbor and calculateNeighbors with a caller supplied
+//          vector) don't modify the partition and may be run from several
+//          threads at once, as long as no entity is added, removed or
+//          updated while they run.
+//
+//          How each cell stores its members is chosen by the storage policy
+//          (see CellStorage_List and CellStorage_Vector below)
+//
 //-----------------------------------------------------------------------------
 #pragma warning (disable:4786)
 
 #include <vector>
 #include <list>
+#include <cmath>
+#include <cassert>
 
 #include "common/2D/Vector2D.h"
 #include "common/2D/InvertedAABBox2D.h"
+#include "common/misc/UtilsEx.h"
 
 
 
 //------------------------------------------------------------------------
 //
-//  defines a cell containing a list of pointers to entities
+//  storage policies for the members of a cell. A policy defines the
+//  container type and how entities are added to and removed from it.
 //------------------------------------------------------------------------
+
+//the original storage. Every add allocates a list node and remove walks
+//the whole list
 template <class entity>
+struct CellStorage_List
+{
+    typedef std::list<entity> Container;
+
+    static void reserve(Container&, int){}
+
+    static void add(Container& members, const entity& ent)
+    {
+        members.push_back(ent);
+    }
+
+    static void remove(Container& members, const entity& ent)
+    {
+        members.remove(ent);
+    }
+};
+
+//members are kept in a vector which never gives its memory back, so once
+//the cells have grown to their working size moving between cells doesn't
+//allocate. Each entity keeps its slot in the members of its cell, so
+//removal is O(1): the entity is swapped with the last member, whose slot
+//is updated, and popped. The order of the members in a cell is not
+//preserved.
+//
+//the entities must have the methods int getCellSlot() and
+//setCellSlot(int), the slot being -1 when the entity is in no cell
+template <class entity>
+struct CellStorage_Vector
+{
+    typedef std::vector<entity> Container;
+
+    static void reserve(Container& members, int num)
+    {
+        members.reserve(num);
+    }
+
+    static void add(Container& members, const entity& ent)
+    {
+        ent->setCellSlot((int)members.size());
+        members.push_back(ent);
+    }
+
+    static void remove(Container& members, const entity& ent)
+    {
+        int slot = ent->getCellSlot();
+
+        //not in this cell
+        if (slot < 0 || slot >= (int)members.size() || members[slot] != ent) return;
+
+        int last = (int)members.size() - 1;
+
+        if (slot != last)
+        {
+            members[slot] = members[last];
+            members[slot]->setCellSlot(slot);
+        }
+
+        members.pop_back();
+
+        ent->setCellSlot(-1);
+    }
+};
+
+//------------------------------------------------------------------------
+//
+//  defines a cell containing a list of pointers to entities
+//------------------------------------------------------------------------
+template <class entity, template <class> class storage = CellStorage_List>
 struct Cell
 {
+    typedef typename storage<entity>::Container Container;
+
     //all the entities inhabiting this cell
-    std::list<entity> members;
+    Container members;
 
     //the cell's bounding box (it's inverted because the Window's default
     //co-ordinate system has a y axis that increases as it descends)
@@ -44,10 +136,13 @@ struct Cell
 //  the subdivision class
 ///////////////////////////////////////////////////////////////////////////////
 
-template <class entity>
+template <class entity, template <class> class storage = CellStorage_List>
 class CellSpacePartition
 {
 public:
+    typedef Cell<entity, storage> CellType;
+    typedef typename CellType::Container Container;
+
     CellSpacePartition(Vector2D& spaceSize,
                                          int cellsNumX,       //number of cells horizontally
                                          int cellsNumY,       //number of cells vertically
@@ -64,6 +159,19 @@ public:
     //the neighbor vector. After you have called this method use the begin, 
     //next and end methods to iterate through the vector.
     inline void calculateNeighbors(Vector2D targetPos, float radius);
+
+    //const version of the above. The neighbors are written into the caller's
+    //vector (which is cleared first) and the number found is returned
+    inline int calculateNeighbors(Vector2D targetPos, float radius, std::vector<entity>& neighbors)const;
+
+    //same as above but tests the bounding box of every cell in the space
+    //against the query box. Kept for comparison with the cell range query
+    inline void calculateNeighborsByScan(Vector2D targetPos, float radius);
+
+    //calls v(ent) for every entity within radius of targetPos without 
+    //touching the neighbor vector. Returns the visitor (like std::for_each)
+    template <class visitor>
+    inline visitor forEachNeighbor(Vector2D targetPos, float radius, visitor v)const;
     
     //clear the cells of entities
     void clearCells();
@@ -76,12 +184,18 @@ public:
 
     //returns true if the end of the vector is found (a zero value marks the end)
     inline bool end(){return (m_curNeighbor == m_neighbors.end()) || (*m_curNeighbor == 0);}   
+
+    //the index of the cell a position is in
+    int positionToIndex(const Vector2D& pos)const;
   
 private:
-    int positionToIndex(const Vector2D& pos)const;
+
+    //calculates the range of cell coordinates overlapped by the square of
+    //half size radius centered on targetPos. The range is clamped to the space
+    void getCellRange(Vector2D targetPos, float radius, int& xMin, int& yMin, int& xMax, int& yMax)const;
         
     //the required amount of cells in the space
-    std::vector<Cell<entity>> m_Cells;
+    std::vector<CellType> m_Cells;
 
     //this is used to store any valid neighbors when an agent searches its neighboring space
     std::vector<entity> m_neighbors;
@@ -112,15 +226,15 @@ private:
 
 //----------------------------- ctor ---------------------------------------
 //--------------------------------------------------------------------------
-template<class entity>
-CellSpacePartition<entity>::CellSpacePartition(Vector2D& spaceSize,
+template<class entity, template <class> class storage>
+CellSpacePartition<entity, storage>::CellSpacePartition(Vector2D& spaceSize,
                                          int cellsNumX,       //number of cells horizontally
                                          int cellsNumY,       //number of cells vertically
                                          int maxEntitys):  //maximum number of entities to partition
+                              m_neighbors(maxEntitys, entity()),
                               m_spaceSize(spaceSize),
                               m_cellsNUmX(cellsNumX),
-                              m_cellsNUmY(cellsNumY),
-                              m_neighbors(maxEntitys, entity())
+                              m_cellsNUmY(cellsNumY)
 {
     //calculate bounds of each cell
     m_cellSize.x = spaceSize.x /cellsNumX;
@@ -136,9 +250,16 @@ CellSpacePartition<entity>::CellSpacePartition(Vector2D& spaceSize,
             right = left + m_cellSize.x;
             top   = i * m_cellSize.y;
             bot   = top + m_cellSize.y;
-            m_Cells.push_back(Cell<entity>(Vector2D(left, top), Vector2D(right, bot)));
+            m_Cells.push_back(CellType(Vector2D(left, top), Vector2D(right, bot)));
         }
     }
+
+    //give every cell room for twice the average occupancy up front
+    int perCell = 2 * maxEntitys / (int)m_Cells.size() + 1;
+    for (unsigned int c=0; c<m_Cells.size(); ++c)
+    {
+        storage<entity>::reserve(m_Cells[c].members, perCell);
+    }
 }
 
 
@@ -146,21 +267,21 @@ CellSpacePartition<entity>::CellSpacePartition(Vector2D& spaceSize,
 //----------------------- AddEntity --------------------------------------
 //  Used to add the entitys to the data structure
 //------------------------------------------------------------------------
-template<class entity>
-inline void CellSpacePartition<entity>::addEntity(const entity& ent)
+template<class entity, template <class> class storage>
+inline void CellSpacePartition<entity, storage>::addEntity(const entity& ent)
 { 
     int idx = positionToIndex(ent->getPos());
-    m_Cells[idx].members.push_back(ent);
+    storage<entity>::add(m_Cells[idx].members, ent);
 }
 
 //----------------------- AddEntity --------------------------------------
 //  Used to add the entitys to the data structure
 //------------------------------------------------------------------------
-template<class entity>
-inline void CellSpacePartition<entity>::removeEntity(entity& ent)
+template<class entity, template <class> class storage>
+inline void CellSpacePartition<entity, storage>::removeEntity(entity& ent)
 { 
     int idx = positionToIndex(ent->getPos());
-    m_Cells[idx].members.remove(ent);
+    storage<entity>::remove(m_Cells[idx].members, ent);
 }
 
 //----------------------- UpdateEntity -----------------------------------
@@ -168,8 +289,8 @@ inline void CellSpacePartition<entity>::removeEntity(entity& ent)
 //  Checks to see if an entity has moved cells. If so the data structure
 //  is updated accordingly
 //------------------------------------------------------------------------
-template<class entity>
-inline void CellSpacePartition<entity>::updateEntity(const entity&  ent, Vector2D prePos)
+template<class entity, template <class> class storage>
+inline void CellSpacePartition<entity, storage>::updateEntity(const entity&  ent, Vector2D prePos)
 {
     //if the index for the old pos and the new pos are not equal then
     //the entity has moved to another cell.
@@ -180,8 +301,8 @@ inline void CellSpacePartition<entity>::updateEntity(const entity&  ent, Vector2
 
     //the entity has moved into another cell so delete from current cell
     //and add to new one
-    m_Cells[OldIdx].members.remove(ent);
-    m_Cells[NewIdx].members.push_back(ent);
+    storage<entity>::remove(m_Cells[OldIdx].members, ent);
+    storage<entity>::add(m_Cells[NewIdx].members, ent);
 }
 
 
@@ -193,11 +314,80 @@ inline void CellSpacePartition<entity>::updateEntity(const entity&  ent, Vector2
 //  within the target's neighborhood region. If they are they are added to
 //  neighbor list
 //------------------------------------------------------------------------
+template<class entity, template <class> class storage>
+void CellSpacePartition<entity, storage>::calculateNeighbors(Vector2D targetPos, float radius)
+{
+    //create an iterator and set it to the beginning of the neighbor vector
+    typename std::vector<entity>::iterator curNbor = m_neighbors.begin();
+
+    float radiusSq = radius*radius;
+
+    //only the cells covered by the query box can contain neighbors
+    int xMin, yMin, xMax, yMax;
+    getCellRange(targetPos, radius, xMin, yMin, xMax, yMax);
+
+    for (int y=yMin; y<=yMax; ++y)
+    {
+        for (int x=xMin; x<=xMax; ++x)
+        {
+            const CellType& curCell = m_Cells[y*m_cellsNUmX + x];
+
+            //add any entities found within query radius to the neighbor list
+            typename Container::const_iterator it = curCell.members.begin();
+            for (; it!=curCell.members.end(); ++it)
+            { 
+                if (Vec2DistanceSq((*it)->getPos(), targetPos) < radiusSq)
+                {
+                    assert(curNbor+1 != m_neighbors.end() && "<CellSpacePartition::calculateNeighbors>: too many neighbors");
+                    *curNbor++ = *it;
+                }
+            }
+        }
+    }//next cell
+
+    //mark the end of the list with a zero.
+    *curNbor = 0;
+}
+
+//----------------------- CalculateNeighbors ----------------------------
+//
+//  reentrant version of the above. Nothing inside the partition is written
+//  so any number of callers can query at the same time with their own
+//  neighbor vectors
+//------------------------------------------------------------------------
 template<class entity>
-void CellSpacePartition<entity>::calculateNeighbors(Vector2D targetPos, float radius)
+struct NeighborInserter
+{
+    std::vector<entity>* neighbors;
+
+    NeighborInserter(std::vector<entity>* nbors):neighbors(nbors){}
+
+    void operator()(const entity& ent){neighbors->push_back(ent);}
+};
+
+template<class entity, template <class> class storage>
+inline int CellSpacePartition<entity, storage>::calculateNeighbors(Vector2D targetPos, 
+                                                                   float radius, 
+                                                                   std::vector<entity>& neighbors)const
+{
+    neighbors.clear();
+
+    forEachNeighbor(targetPos, radius, NeighborInserter<entity>(&neighbors));
+
+    return (int)neighbors.size();
+}
+
+//----------------------- calculateNeighborsByScan ----------------------
+//
+//  the original query. Iterates through every cell and tests to see if its
+//  bounding box overlaps with the query box. The cost of this is O(cells)
+//  however small the radius is
+//------------------------------------------------------------------------
+template<class entity, template <class> class storage>
+void CellSpacePartition<entity, storage>::calculateNeighborsByScan(Vector2D targetPos, float radius)
 {
     //create an iterator and set it to the beginning of the neighbor vector
-    std::vector<entity>::iterator curNbor = m_neighbors.begin();
+    typename std::vector<entity>::iterator curNbor = m_neighbors.begin();
   
     //create the query box that is the bounding box of the target's query area
     InvertedAABBox2D QueryBox(targetPos - Vector2D(radius, radius), targetPos + Vector2D(radius, radius));
@@ -205,14 +395,14 @@ void CellSpacePartition<entity>::calculateNeighbors(Vector2D targetPos, float ra
     //iterate through each cell and test to see if its bounding box overlaps
     //with the query box. If it does and it also contains entities then
     //make further proximity tests.
-    std::vector<Cell<entity> >::iterator curCell; 
+    typename std::vector<CellType>::iterator curCell; 
     for (curCell=m_Cells.begin(); curCell!=m_Cells.end(); ++curCell)
     {
         //test to see if this cell contains members and if it overlaps the query box
         if (curCell->BBox.isOverlappedWith(QueryBox) && !curCell->members.empty())
         {
             //add any entities found within query radius to the neighbor list
-            std::list<entity>::iterator it = curCell->members.begin();
+            typename Container::iterator it = curCell->members.begin();
             for (it; it!=curCell->members.end(); ++it)
             { 
                 if (Vec2DistanceSq((*it)->getPos(), targetPos) < radius*radius)
@@ -227,11 +417,44 @@ void CellSpacePartition<entity>::calculateNeighbors(Vector2D targetPos, float ra
     *curNbor = 0;
 }
 
+//----------------------- forEachNeighbor -------------------------------
+//
+//  visits the same cells as calculateNeighbors but hands each neighbor
+//  straight to the visitor instead of storing it in m_neighbors
+//------------------------------------------------------------------------
+template<class entity, template <class> class storage>
+template<class visitor>
+inline visitor CellSpacePartition<entity, storage>::forEachNeighbor(Vector2D targetPos, float radius, visitor v)const
+{
+    float radiusSq = radius*radius;
+
+    int xMin, yMin, xMax, yMax;
+    getCellRange(targetPos, radius, xMin, yMin, xMax, yMax);
 
-template<class entity>
-void CellSpacePartition<entity>::clearCells()
+    for (int y=yMin; y<=yMax; ++y)
+    {
+        for (int x=xMin; x<=xMax; ++x)
+        {
+            const CellType& curCell = m_Cells[y*m_cellsNUmX + x];
+
+            typename Container::const_iterator it = curCell.members.begin();
+            for (; it!=curCell.members.end(); ++it)
+            { 
+                if (Vec2DistanceSq((*it)->getPos(), targetPos) < radiusSq)
+                {
+                    v(*it);
+                }
+            }
+        }
+    }
+
+    return v;
+}
+
+template<class entity, template <class> class storage>
+void CellSpacePartition<entity, storage>::clearCells()
 {
-    std::vector<Cell<entity>>::iterator it = m_Cells.begin();
+    typename std::vector<CellType>::iterator it = m_Cells.begin();
 
     for (it; it!=m_Cells.end(); ++it)
     {
@@ -244,8 +467,8 @@ void CellSpacePartition<entity>::clearCells()
 //  Given a 2D vector representing a position within the game world, this
 //  method calculates an index into its appropriate cell
 //------------------------------------------------------------------------
-template<class entity>
-inline int CellSpacePartition<entity>::positionToIndex(const Vector2D& pos)const
+template<class entity, template <class> class storage>
+inline int CellSpacePartition<entity, storage>::positionToIndex(const Vector2D& pos)const
 {
     int idx = (int)(m_cellsNUmX * pos.x / m_spaceSize.x) + 
             ((int)((m_cellsNUmY) * pos.y / m_spaceSize.y) * m_cellsNUmX);
@@ -260,5 +483,25 @@ inline int CellSpacePartition<entity>::positionToIndex(const Vector2D& pos)const
     return idx; 
 }
 
+//--------------------- getCellRange -------------------------------------
+//  converts the query box of a neighbor search into the first and last
+//  cell coordinates it overlaps on each axis
+//------------------------------------------------------------------------
+template<class entity, template <class> class storage>
+inline void CellSpacePartition<entity, storage>::getCellRange(Vector2D targetPos, float radius, 
+                                                                     int& xMin, int& yMin, int& xMax, int& yMax)const
+{
+    xMin = (int)std::floor((targetPos.x - radius) / m_cellSize.x);
+    yMin = (int)std::floor((targetPos.y - radius) / m_cellSize.y);
+    xMax = (int)std::floor((targetPos.x + radius) / m_cellSize.x);
+    yMax = (int)std::floor((targetPos.y + radius) / m_cellSize.y);
+
+    //anything outside the space is held by the border cells
+    clamp(xMin, 0, m_cellsNUmX-1);
+    clamp(xMax, 0, m_cellsNUmX-1);
+    clamp(yMin, 0, m_cellsNUmY-1);
+    clamp(yMax, 0, m_cellsNUmY-1);
+}
+
 
 #endif
\ No newline at end of file
@@ -0,0 +1,159 @@
+#ifndef MULTI_PRODUCER_QUEUE_H
+#define MULTI_PRODUCER_QUEUE_H
+//-----------------------------------------------------------------------------
+//
+//  Name:   MultiProducerQueue.h
+//
+//  Desc:   a lock-free queue any number of threads can push onto at once,
+//          emptied by one thread once they are done (multi-producer, single
+//          consumer). Used to collect what the threads of a parallel job
+//          produce and deal with it after the job has run.
+//
+//          The items are kept in a chain of blocks of BlockSize items. A
+//          push takes a place in the last block with one atomic add, and
+//          only when that block is full does it link in the next block with
+//          a compare-and-swap. The blocks are kept when the queue is drained,
+//          so once the chain has grown to what a phase needs pushing doesn't
+//          allocate any more.
+//
+//          The items pushed by one thread are drained in the order that
+//          thread pushed them. How the items of different threads interleave
+//          depends on the timing of the threads.
+//
+//          drain must not run while a thread is pushing. The end of the
+//          parallel job (WorkerPool::run returning say) separates the two.
+//
+//-----------------------------------------------------------------------------
+#include <vector>
+#include <atomic>
+#include <new>
+#include <algorithm>
+#include <type_traits>
+
+
+template <class T>
+class MultiProducerQueue
+{
+public:
+    enum {BlockSize = 256};
+
+    inline MultiProducerQueue();
+    inline ~MultiProducerQueue();
+
+    //can be called from any number of threads at once
+    inline void push(const T& item);
+
+    //appends the items to out and empties the queue. Not thread safe, see
+    //above
+    inline void drain(std::vector<T>& out);
+
+    bool empty()const{return m_pHead->count.load(std::memory_order_relaxed) == 0;}
+
+private:
+    struct Block
+    {
+        //the number of places taken. Goes over BlockSize when threads find
+        //the block full
+        std::atomic<unsigned int> count;
+
+        std::atomic<Block*> next;
+
+        typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type items[BlockSize];
+
+        Block():count(0), next(nullptr){}
+
+        T* item(unsigned int i){return reinterpret_cast<T*>(&items[i]);}
+    };
+
+    Block* m_pHead;
+
+    //the block items are pushed onto
+    std::atomic<Block*> m_pTail;
+
+    MultiProducerQueue(const MultiProducerQueue&);
+    MultiProducerQueue& operator=(const MultiProducerQueue&);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <class T>
+MultiProducerQueue<T>::MultiProducerQueue():m_pHead(new Block()),
+                                            m_pTail(m_pHead)
+{}
+
+template <class T>
+MultiProducerQueue<T>::~MultiProducerQueue()
+{
+    std::vector<T> rest;
+    drain(rest);
+
+    while (m_pHead)
+    {
+        Block* pNext = m_pHead->next.load(std::memory_order_relaxed);
+        delete m_pHead;
+        m_pHead = pNext;
+    }
+}
+
+//--------------------------------- push --------------------------------------
+//-----------------------------------------------------------------------------
+template <class T>
+void MultiProducerQueue<T>::push(const T& item)
+{
+    for (;;)
+    {
+        Block* pBlock = m_pTail.load(std::memory_order_acquire);
+
+        unsigned int i = pBlock->count.fetch_add(1, std::memory_order_relaxed);
+        if (i < BlockSize)
+        {
+            new (pBlock->item(i)) T(item);
+            return;
+        }
+
+        //the block is full. Move on to the next one, linking in a new one
+        //if there is none yet. Of the threads trying to link one in only
+        //the first succeeds, the others use the block it linked
+        Block* pNext = pBlock->next.load(std::memory_order_acquire);
+        if (pNext == nullptr)
+        {
+            Block* pNew = new Block();
+            if (pBlock->next.compare_exchange_strong(pNext, pNew, std::memory_order_acq_rel))
+            {
+                pNext = pNew;
+            }
+            else
+            {
+                delete pNew;
+            }
+        }
+
+        m_pTail.compare_exchange_strong(pBlock, pNext, std::memory_order_acq_rel);
+    }
+}
+
+//--------------------------------- drain -------------------------------------
+//-----------------------------------------------------------------------------
+template <class T>
+void MultiProducerQueue<T>::drain(std::vector<T>& out)
+{
+    for (Block* pBlock = m_pHead; pBlock; pBlock = pBlock->next.load(std::memory_order_relaxed))
+    {
+        unsigned int n = (std::min)(pBlock->count.load(std::memory_order_relaxed), (unsigned int)BlockSize);
+
+        for (unsigned int i=0; i<n; ++i)
+        {
+            T* pItem = pBlock->item(i);
+            out.push_back(*pItem);
+            pItem->~T();
+        }
+
+        pBlock->count.store(0, std::memory_order_relaxed);
+    }
+
+    m_pTail.store(m_pHead, std::memory_order_relaxed);
+}
+
+
+
+#endif
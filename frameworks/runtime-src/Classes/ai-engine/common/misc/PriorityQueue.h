@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <cassert>
+#include <cstring>
 
 //----------------------- swap -------------------------------------------
 //  used to swap two values
@@ -333,8 +334,8 @@ public:
     //you must pass the constructor a reference to the std::vector the PQ
     //will be indexing into and the maximum size of the queue.
     indexedPriorityQLow(std::vector<KeyType>& keys,int MaxSize):m_vecKeys(keys),
-                                                                                                                m_iMaxSize(MaxSize),
-                                                                                                                m_iSize(0)
+                                                                                                                m_iSize(0),
+                                                                                                                m_iMaxSize(MaxSize)
     {
         m_Heap.assign(MaxSize+1, 0);
         m_invHeap.assign(MaxSize+1, 0);
@@ -342,6 +343,19 @@ public:
 
     bool isEmpty()const{return (m_iSize==0);}
 
+    //empties the queue, keeping its storage
+    void clear(){m_iSize = 0;}
+
+    //makes room for indices up to MaxSize-1. Only grows the storage
+    void reserve(int MaxSize)
+    {
+        if (MaxSize <= m_iMaxSize) return;
+
+        m_iMaxSize = MaxSize;
+        m_Heap.resize(MaxSize+1, 0);
+        m_invHeap.resize(MaxSize+1, 0);
+    }
+
     //to insert an item into the queue it gets added to the end of the heap
     //and then the heap is reordered from the bottom up.
     void insert(const int idx)
@@ -375,4 +389,503 @@ public:
         reorderUpwards(m_invHeap[idx]);
     }
 };
-#endif
\ No newline at end of file
+
+
+//-------------------- indexedDaryPriorityQLow ---------------------------
+//
+//  the same interface as indexedPriorityQLow, but the heap has D children
+//  per node (4 by default). That makes it half as deep as a binary heap,
+//  and as the children of a node sit next to each other a pop compares
+//  more keys but touches fewer cache lines. Each place in the heap keeps
+//  a copy of its key, so reordering doesn't read the key vector.
+//
+//  changePriority moves an item up or down, whichever way its key has
+//  changed.
+//------------------------------------------------------------------------
+template<class KeyType, int D = 4>
+class indexedDaryPriorityQLow
+{
+private:
+    struct Entry
+    {
+        KeyType key;
+        int     idx;
+    };
+
+    std::vector<KeyType>& m_vecKeys;
+
+    //the heap, from index 0
+    std::vector<Entry> m_Heap;
+
+    //the place of each item in the heap
+    std::vector<int> m_invHeap;
+
+    int m_iSize, m_iMaxSize;
+
+    void place(int pos, const Entry& e)
+    {
+        m_Heap[pos] = e;
+        m_invHeap[e.idx] = pos;
+    }
+
+    //moves the entry at pos up until its parent is no larger. Returns
+    //false if it didn't move
+    bool reorderUpwards(int pos)
+    {
+        Entry e = m_Heap[pos];
+        int start = pos;
+
+        while (pos > 0)
+        {
+            int parent = (pos-1) / D;
+
+            if (!(e.key < m_Heap[parent].key)) break;
+
+            place(pos, m_Heap[parent]);
+            pos = parent;
+        }
+
+        place(pos, e);
+
+        return pos != start;
+    }
+
+    //moves the entry at pos down until none of its children is smaller
+    void reorderDownwards(int pos)
+    {
+        Entry e = m_Heap[pos];
+
+        for (;;)
+        {
+            int first = pos*D + 1;
+            if (first >= m_iSize) break;
+
+            int last = (first+D < m_iSize) ? first+D : m_iSize;
+
+            //find the smallest child
+            int child = first;
+            for (int c=first+1; c<last; ++c)
+            {
+                if (m_Heap[c].key < m_Heap[child].key) child = c;
+            }
+
+            if (!(m_Heap[child].key < e.key)) break;
+
+            place(pos, m_Heap[child]);
+            pos = child;
+        }
+
+        place(pos, e);
+    }
+
+public:
+    indexedDaryPriorityQLow(std::vector<KeyType>& keys, int MaxSize):m_vecKeys(keys),
+                                                                     m_iSize(0),
+                                                                     m_iMaxSize(MaxSize)
+    {
+        m_Heap.resize(MaxSize);
+        m_invHeap.assign(MaxSize, 0);
+    }
+
+    bool isEmpty()const{return (m_iSize==0);}
+
+    //empties the queue, keeping its storage
+    void clear(){m_iSize = 0;}
+
+    //makes room for indices up to MaxSize-1. Only grows the storage
+    void reserve(int MaxSize)
+    {
+        if (MaxSize <= m_iMaxSize) return;
+
+        m_iMaxSize = MaxSize;
+        m_Heap.resize(MaxSize);
+        m_invHeap.resize(MaxSize, 0);
+    }
+
+    void insert(const int idx)
+    {
+        assert (m_iSize+1 <= m_iMaxSize);
+
+        Entry e = {m_vecKeys[idx], idx};
+        place(m_iSize, e);
+
+        reorderUpwards(m_iSize++);
+    }
+
+    //the last entry takes the place of the first and sinks down
+    int pop()
+    {
+        int idx = m_Heap[0].idx;
+
+        if (--m_iSize > 0)
+        {
+            place(0, m_Heap[m_iSize]);
+            reorderDownwards(0);
+        }
+
+        return idx;
+    }
+
+    void changePriority(const int idx)
+    {
+        int pos = m_invHeap[idx];
+
+        m_Heap[pos].key = m_vecKeys[idx];
+
+        if (!reorderUpwards(pos)) reorderDownwards(pos);
+    }
+};
+
+
+//-------------------- indexedPairingPriorityQLow ------------------------
+//
+//  the same interface as indexedPriorityQLow, kept as a pairing heap: a
+//  tree in which every node is no larger than its children. Inserting an
+//  item, or lowering its key, links it to the root in O(1). A pop does
+//  the work, merging the children of the root pairwise from left to
+//  right and then the pairs from right to left.
+//
+//  The tree is held in arrays indexed by item: the first child, the next
+//  sibling and the previous sibling (the parent for a first child) of
+//  each one, and a copy of its key.
+//------------------------------------------------------------------------
+template<class KeyType>
+class indexedPairingPriorityQLow
+{
+private:
+    std::vector<KeyType>& m_vecKeys;
+
+    std::vector<KeyType> m_Key;
+    std::vector<int>     m_Child;
+    std::vector<int>     m_Next;
+    std::vector<int>     m_Prev;
+
+    int m_iRoot;
+
+    int m_iMaxSize;
+
+    //the trees merged by the first pass of a pop
+    std::vector<int> m_Pairs;
+
+    //makes the root with the larger key the first child of the other one.
+    //Both must be roots without siblings. Returns the new root
+    int link(int a, int b)
+    {
+        if (m_Key[b] < m_Key[a])
+        {
+            int temp = a; a = b; b = temp;
+        }
+
+        m_Next[b] = m_Child[a];
+        if (m_Child[a] != -1) m_Prev[m_Child[a]] = b;
+        m_Prev[b] = a;
+        m_Child[a] = b;
+
+        return a;
+    }
+
+    int meld(int a, int b)
+    {
+        if (a == -1) return b;
+        if (b == -1) return a;
+
+        return link(a, b);
+    }
+
+    //takes idx and its subtree out of the tree
+    void cut(int idx)
+    {
+        int prev = m_Prev[idx];
+
+        if (m_Child[prev] == idx) m_Child[prev] = m_Next[idx];
+        else                      m_Next[prev] = m_Next[idx];
+
+        if (m_Next[idx] != -1) m_Prev[m_Next[idx]] = prev;
+
+        m_Prev[idx] = m_Next[idx] = -1;
+    }
+
+    //merges the list of siblings starting with first into one tree and
+    //returns its root
+    int mergePairs(int first)
+    {
+        if (first == -1) return -1;
+
+        m_Pairs.clear();
+
+        int a = first;
+        while (a != -1)
+        {
+            int b = m_Next[a];
+
+            m_Prev[a] = m_Next[a] = -1;
+
+            if (b == -1)
+            {
+                m_Pairs.push_back(a);
+                break;
+            }
+
+            int next = m_Next[b];
+            m_Prev[b] = m_Next[b] = -1;
+
+            m_Pairs.push_back(link(a, b));
+
+            a = next;
+        }
+
+        int root = m_Pairs.back();
+        for (int p=(int)m_Pairs.size()-2; p>=0; --p)
+        {
+            root = link(m_Pairs[p], root);
+        }
+
+        return root;
+    }
+
+public:
+    indexedPairingPriorityQLow(std::vector<KeyType>& keys, int MaxSize):m_vecKeys(keys),
+                                                                        m_iRoot(-1),
+                                                                        m_iMaxSize(0)
+    {
+        reserve(MaxSize);
+    }
+
+    bool isEmpty()const{return (m_iRoot==-1);}
+
+    //empties the queue, keeping its storage
+    void clear(){m_iRoot = -1;}
+
+    //makes room for indices up to MaxSize-1. Only grows the storage
+    void reserve(int MaxSize)
+    {
+        if (MaxSize <= m_iMaxSize) return;
+
+        m_iMaxSize = MaxSize;
+        m_Key.resize(MaxSize);
+        m_Child.resize(MaxSize, -1);
+        m_Next.resize(MaxSize, -1);
+        m_Prev.resize(MaxSize, -1);
+    }
+
+    void insert(const int idx)
+    {
+        assert ((idx >= 0) && (idx < m_iMaxSize));
+
+        m_Key[idx] = m_vecKeys[idx];
+        m_Child[idx] = m_Next[idx] = m_Prev[idx] = -1;
+
+        m_iRoot = meld(m_iRoot, idx);
+    }
+
+    int pop()
+    {
+        int idx = m_iRoot;
+
+        m_iRoot = mergePairs(m_Child[idx]);
+        m_Child[idx] = -1;
+
+        return idx;
+    }
+
+    //a lower key only needs the item's subtree moved to the root. For a
+    //higher one the item leaves the tree, its children are merged back in
+    //and it is inserted again
+    void changePriority(const int idx)
+    {
+        KeyType key = m_vecKeys[idx];
+
+        if (!(m_Key[idx] < key))
+        {
+            m_Key[idx] = key;
+
+            if (idx != m_iRoot)
+            {
+                cut(idx);
+                m_iRoot = link(m_iRoot, idx);
+            }
+
+            return;
+        }
+
+        if (idx == m_iRoot) m_iRoot = -1;
+        else                cut(idx);
+
+        int children = mergePairs(m_Child[idx]);
+        m_Child[idx] = -1;
+
+        m_Key[idx] = key;
+
+        m_iRoot = meld(meld(m_iRoot, children), idx);
+    }
+};
+
+
+//----------------------- radixPriorityQLow ------------------------------
+//
+//  the same interface as indexedPriorityQLow for float keys, kept as a
+//  radix heap. It only works for monotone keys: no key inserted may be
+//  lower than the last one popped, which holds for Dijkstra and for A*
+//  with a consistent heuristic (such as Heuristic_Euclid on a navgraph
+//  whose edges cost at least their length).
+//
+//  The bits of a float that is not negative order the same way as the
+//  float, so the keys are used as 32 bit integers without scaling or
+//  losing any precision. An item is kept in bucket b when the highest bit
+//  in which its key differs from the last key popped is bit b-1 (bucket 0
+//  when it is equal). When bucket 0 is empty a pop finds the smallest key
+//  in the first bucket with items, makes that the last key and spreads
+//  the bucket over the buckets below it. Each item moves down at most 32
+//  times, and most items never get near the front of the queue at all.
+//
+//  A key a little below the last one, from rounding say, is treated as
+//  equal to it.
+//------------------------------------------------------------------------
+class radixPriorityQLow
+{
+private:
+    enum {NumBuckets = 33};
+
+    std::vector<float>& m_vecKeys;
+
+    std::vector<int> m_Buckets[NumBuckets];
+
+    //the bucket of each item, its place in the bucket and its key as an
+    //integer
+    std::vector<int>          m_Bucket;
+    std::vector<int>          m_Pos;
+    std::vector<unsigned int> m_Key;
+
+    unsigned int m_iLast;
+
+    int m_iSize, m_iMaxSize;
+
+    static unsigned int keyBits(float key)
+    {
+        if (!(key > 0.0f)) return 0;
+
+        unsigned int bits;
+        memcpy(&bits, &key, sizeof(bits));
+        return bits;
+    }
+
+    int bucketFor(unsigned int key)const
+    {
+        if (key <= m_iLast) return 0;
+
+        unsigned int diff = key ^ m_iLast;
+
+        int bucket = 1;
+        if (diff >> 16) {diff >>= 16; bucket += 16;}
+        if (diff >> 8)  {diff >>= 8;  bucket += 8;}
+        if (diff >> 4)  {diff >>= 4;  bucket += 4;}
+        if (diff >> 2)  {diff >>= 2;  bucket += 2;}
+        if (diff >> 1)  {bucket += 1;}
+
+        return bucket;
+    }
+
+    void add(int idx, int bucket)
+    {
+        m_Bucket[idx] = bucket;
+        m_Pos[idx] = (int)m_Buckets[bucket].size();
+        m_Buckets[bucket].push_back(idx);
+    }
+
+    void remove(int idx)
+    {
+        std::vector<int>& bucket = m_Buckets[m_Bucket[idx]];
+
+        int moved = bucket.back();
+        bucket[m_Pos[idx]] = moved;
+        m_Pos[moved] = m_Pos[idx];
+        bucket.pop_back();
+    }
+
+public:
+    radixPriorityQLow(std::vector<float>& keys, int MaxSize):m_vecKeys(keys),
+                                                             m_iLast(0),
+                                                             m_iSize(0),
+                                                             m_iMaxSize(0)
+    {
+        reserve(MaxSize);
+    }
+
+    bool isEmpty()const{return (m_iSize==0);}
+
+    //empties the queue, keeping its storage
+    void clear()
+    {
+        for (int b=0; b<NumBuckets; ++b) m_Buckets[b].clear();
+
+        m_iLast = 0;
+        m_iSize = 0;
+    }
+
+    //makes room for indices up to MaxSize-1. Only grows the storage
+    void reserve(int MaxSize)
+    {
+        if (MaxSize <= m_iMaxSize) return;
+
+        m_iMaxSize = MaxSize;
+        m_Bucket.resize(MaxSize, 0);
+        m_Pos.resize(MaxSize, 0);
+        m_Key.resize(MaxSize, 0);
+    }
+
+    void insert(const int idx)
+    {
+        assert ((idx >= 0) && (idx < m_iMaxSize));
+
+        m_Key[idx] = keyBits(m_vecKeys[idx]);
+        add(idx, bucketFor(m_Key[idx]));
+
+        ++m_iSize;
+    }
+
+    int pop()
+    {
+        assert (m_iSize > 0);
+
+        if (m_Buckets[0].empty())
+        {
+            int b = 1;
+            while (m_Buckets[b].empty()) ++b;
+
+            std::vector<int>& bucket = m_Buckets[b];
+
+            unsigned int smallest = m_Key[bucket[0]];
+            for (unsigned int i=1; i<bucket.size(); ++i)
+            {
+                if (m_Key[bucket[i]] < smallest) smallest = m_Key[bucket[i]];
+            }
+
+            m_iLast = smallest;
+
+            //every item of the bucket now belongs in a lower one
+            for (unsigned int i=0; i<bucket.size(); ++i)
+            {
+                add(bucket[i], bucketFor(m_Key[bucket[i]]));
+            }
+
+            bucket.clear();
+        }
+
+        int idx = m_Buckets[0].back();
+        m_Buckets[0].pop_back();
+
+        --m_iSize;
+
+        return idx;
+    }
+
+    void changePriority(const int idx)
+    {
+        remove(idx);
+
+        m_Key[idx] = keyBits(m_vecKeys[idx]);
+        add(idx, bucketFor(m_Key[idx]));
+    }
+};
+
+#endif
@@ -0,0 +1,505 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+//------------------------------------------------------------------------
+//
+//  Name:   Profiler.h
+//
+//  Desc:   a hierarchical frame profiler. A world owns one and brackets its
+//          update with beginFrame/endFrame. Inside, AIPROFILE("name") times
+//          the rest of the enclosing block as a scope nested in whichever
+//          scope is open around it, so the frame breaks down into a tree of
+//          subsystems. Put a scope inside the isReady block of a Regulator
+//          and it shows how long that regulated update takes and how often
+//          it runs.
+//
+//          For every scope the time and the number of calls in each of the
+//          last historyFrames frames are kept, from which getSummary gives
+//          the min/avg/p99/max time per frame. startTrace records every
+//          scope as an event until stopTrace, and writeChromeTrace saves
+//          those in the Chrome trace event format (chrome://tracing or
+//          ui.perfetto.dev).
+//
+//          Scopes are timed in real time, not simulated time. They report
+//          to the profiler made current on their thread with makeCurrent,
+//          so only the thread running the world update is profiled, not
+//          the worker threads. Defining AI_NO_PROFILER compiles the scopes
+//          away.
+//
+//------------------------------------------------------------------------
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstddef>
+#include <chrono>
+#include <fstream>
+#include <ostream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+
+
+class Profiler
+{
+public:
+    //the time one scope took per frame over the frames in the history
+    struct ScopeSummary
+    {
+        const char* name;
+
+        //0 for the frame itself, 1 for the scopes directly inside it ...
+        int depth;
+
+        float minMs;
+        float avgMs;
+        float p99Ms;
+        float maxMs;
+
+        float callsPerFrame;
+    };
+
+    explicit Profiler(int historyFrames);
+
+    ~Profiler()
+    {
+        if (current() == this) current() = NULL;
+    }
+
+    //makes this the profiler the scopes on this thread report to
+    void makeCurrent(){current() = this;}
+
+    static Profiler* getCurrent(){return current();}
+
+    //a disabled profiler records nothing from the next beginFrame on
+    void setEnabled(bool enabled){m_bEnabled = enabled;}
+    bool isEnabled()const{return m_bEnabled;}
+
+    //true between beginFrame and endFrame of an enabled profiler
+    bool isRecording()const{return m_bRecording;}
+
+    inline void beginFrame();
+    inline void endFrame();
+
+    //scopes must be closed in the reverse order they were opened. Use
+    //AIPROFILE rather than calling these directly
+    inline void beginScope(const char* name);
+    inline void endScope();
+
+    //records an event for each scope until stopTrace or until maxEvents
+    //have been recorded. Starting a trace throws away the last one
+    inline void startTrace(int maxEvents);
+    void stopTrace(){m_bTracing = false;}
+    bool isTracing()const{return m_bTracing;}
+
+    //writes the events of the last trace as Chrome trace event JSON
+    inline bool writeChromeTrace(const std::string& fileName)const;
+
+    //the scopes in tree order, each followed by the scopes inside it
+    inline std::vector<ScopeSummary> getSummary()const;
+
+    //writes getSummary as a table, the scope names indented by depth
+    inline void writeSummary(std::ostream& os)const;
+
+    //the number of frames the summary is taken over
+    int getNumFramesInHistory()const{return std::min(m_iNumFrames, m_iHistoryFrames);}
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Node
+    {
+        const char* name;
+        int parent;
+        int depth;
+        std::vector<int> children;
+
+        //the totals of the frame being recorded
+        long long frameNs;
+        int frameCalls;
+
+        //the totals of the last m_iHistoryFrames frames, indexed by frame
+        //number modulo m_iHistoryFrames
+        std::vector<float> historyMs;
+        std::vector<int> historyCalls;
+    };
+
+    struct OpenScope
+    {
+        int node;
+        Clock::time_point start;
+    };
+
+    struct TraceEvent
+    {
+        int node;
+        long long startNs;
+        long long durationNs;
+    };
+
+    //node 0 is the frame, every other node is a scope
+    std::vector<Node> m_Nodes;
+
+    std::vector<OpenScope> m_OpenScopes;
+
+    int m_iHistoryFrames;
+
+    //the number of frames recorded so far
+    int m_iNumFrames;
+
+    bool m_bEnabled;
+    bool m_bRecording;
+
+    bool m_bTracing;
+    std::size_t m_iMaxTraceEvents;
+    std::vector<TraceEvent> m_Trace;
+
+    //the trace event times are relative to this
+    Clock::time_point m_TraceStart;
+
+    //returns the node of the scope called name inside parent, adding it
+    //if this is the first time it is seen there
+    inline int getChild(int parent, const char* name);
+
+    inline void openScope(int node);
+    inline void closeScope();
+
+    static Profiler*& current()
+    {
+        static thread_local Profiler* pCurrent = NULL;
+        return pCurrent;
+    }
+
+    Profiler(const Profiler&);
+    Profiler& operator=(const Profiler&);
+};
+
+
+//------------------------------------------------------------------------
+//
+//  times the block it is declared in with the current profiler
+//------------------------------------------------------------------------
+class ProfileScope
+{
+public:
+    explicit ProfileScope(const char* name):m_pProfiler(Profiler::getCurrent())
+    {
+        if (m_pProfiler && m_pProfiler->isRecording())
+        {
+            m_pProfiler->beginScope(name);
+        }
+        else
+        {
+            m_pProfiler = NULL;
+        }
+    }
+
+    ~ProfileScope()
+    {
+        if (m_pProfiler) m_pProfiler->endScope();
+    }
+
+private:
+    Profiler* m_pProfiler;
+
+    ProfileScope(const ProfileScope&);
+    ProfileScope& operator=(const ProfileScope&);
+};
+
+#ifdef AI_NO_PROFILER
+#define AIPROFILE(name)  do {} while (0)
+#else
+#define AIPROFILE_JOIN(a, b) a##b
+#define AIPROFILE_NAME(line) AIPROFILE_JOIN(profileScope, line)
+#define AIPROFILE(name)  ProfileScope AIPROFILE_NAME(__LINE__)(name)
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+//------------------------------- ctor -----------------------------------
+//------------------------------------------------------------------------
+inline Profiler::Profiler(int historyFrames):m_iHistoryFrames(std::max(historyFrames, 1)),
+                                             m_iNumFrames(0),
+                                             m_bEnabled(true),
+                                             m_bRecording(false),
+                                             m_bTracing(false),
+                                             m_iMaxTraceEvents(0)
+{
+    Node frame;
+    frame.name = "frame";
+    frame.parent = -1;
+    frame.depth = 0;
+    frame.frameNs = 0;
+    frame.frameCalls = 0;
+    frame.historyMs.assign(m_iHistoryFrames, 0.0f);
+    frame.historyCalls.assign(m_iHistoryFrames, 0);
+
+    m_Nodes.push_back(frame);
+}
+
+//----------------------------- getChild ---------------------------------
+//
+//  the names are nearly always the same string literal, so the pointers
+//  are compared before the strings
+//------------------------------------------------------------------------
+inline int Profiler::getChild(int parent, const char* name)
+{
+    const std::vector<int>& children = m_Nodes[parent].children;
+
+    for (unsigned int c=0; c<children.size(); ++c)
+    {
+        const char* childName = m_Nodes[children[c]].name;
+
+        if (childName == name || std::strcmp(childName, name) == 0)
+        {
+            return children[c];
+        }
+    }
+
+    Node node;
+    node.name = name;
+    node.parent = parent;
+    node.depth = m_Nodes[parent].depth + 1;
+    node.frameNs = 0;
+    node.frameCalls = 0;
+    node.historyMs.assign(m_iHistoryFrames, 0.0f);
+    node.historyCalls.assign(m_iHistoryFrames, 0);
+
+    m_Nodes.push_back(node);
+    m_Nodes[parent].children.push_back((int)m_Nodes.size()-1);
+
+    return (int)m_Nodes.size()-1;
+}
+
+//-------------------------- openScope/closeScope ------------------------
+//------------------------------------------------------------------------
+inline void Profiler::openScope(int node)
+{
+    OpenScope scope;
+    scope.node = node;
+    scope.start = Clock::now();
+
+    m_OpenScopes.push_back(scope);
+}
+
+inline void Profiler::closeScope()
+{
+    const OpenScope& scope = m_OpenScopes.back();
+
+    Clock::time_point end = Clock::now();
+    long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - scope.start).count();
+
+    Node& node = m_Nodes[scope.node];
+    node.frameNs += ns;
+    ++node.frameCalls;
+
+    if (m_bTracing)
+    {
+        if (m_Trace.size() < m_iMaxTraceEvents)
+        {
+            TraceEvent event;
+            event.node = scope.node;
+            event.startNs = std::chrono::duration_cast<std::chrono::nanoseconds>(scope.start - m_TraceStart).count();
+            event.durationNs = ns;
+
+            m_Trace.push_back(event);
+        }
+        else
+        {
+            m_bTracing = false;
+        }
+    }
+
+    m_OpenScopes.pop_back();
+}
+
+//------------------------------ beginFrame ------------------------------
+//------------------------------------------------------------------------
+inline void Profiler::beginFrame()
+{
+    m_bRecording = m_bEnabled;
+
+    if (m_bRecording)
+    {
+        m_OpenScopes.clear();
+        openScope(0);
+    }
+}
+
+//------------------------------- endFrame -------------------------------
+//
+//  moves the totals of the frame into the history
+//------------------------------------------------------------------------
+inline void Profiler::endFrame()
+{
+    if (!m_bRecording) return;
+
+    //any scope still open belongs to this frame
+    while (!m_OpenScopes.empty())
+    {
+        closeScope();
+    }
+
+    int slot = m_iNumFrames % m_iHistoryFrames;
+
+    for (unsigned int n=0; n<m_Nodes.size(); ++n)
+    {
+        Node& node = m_Nodes[n];
+
+        node.historyMs[slot] = node.frameNs / 1000000.0f;
+        node.historyCalls[slot] = node.frameCalls;
+
+        node.frameNs = 0;
+        node.frameCalls = 0;
+    }
+
+    ++m_iNumFrames;
+    m_bRecording = false;
+}
+
+//------------------------------ beginScope ------------------------------
+//------------------------------------------------------------------------
+inline void Profiler::beginScope(const char* name)
+{
+    int parent = m_OpenScopes.empty() ? 0 : m_OpenScopes.back().node;
+
+    openScope(getChild(parent, name));
+}
+
+//------------------------------- endScope -------------------------------
+//------------------------------------------------------------------------
+inline void Profiler::endScope()
+{
+    //the frame itself is only closed by endFrame
+    if (m_OpenScopes.size() > 1)
+    {
+        closeScope();
+    }
+}
+
+//------------------------------ startTrace ------------------------------
+//------------------------------------------------------------------------
+inline void Profiler::startTrace(int maxEvents)
+{
+    m_Trace.clear();
+    m_Trace.reserve(maxEvents);
+
+    m_iMaxTraceEvents = maxEvents;
+    m_TraceStart = Clock::now();
+    m_bTracing = true;
+}
+
+//--------------------------- writeChromeTrace ---------------------------
+//
+//  each scope is written as a complete ("X") event, the times are in
+//  microseconds
+//------------------------------------------------------------------------
+inline bool Profiler::writeChromeTrace(const std::string& fileName)const
+{
+    std::ofstream out(fileName.c_str());
+    if (!out) return false;
+
+    out << "{\"traceEvents\":[";
+
+    out << std::fixed << std::setprecision(3);
+
+    for (unsigned int e=0; e<m_Trace.size(); ++e)
+    {
+        const TraceEvent& event = m_Trace[e];
+
+        if (e > 0) out << ",";
+
+        out << "\n{\"name\":\"" << m_Nodes[event.node].name << "\""
+            << ",\"cat\":\"ai\",\"ph\":\"X\",\"pid\":1,\"tid\":1"
+            << ",\"ts\":" << event.startNs / 1000.0
+            << ",\"dur\":" << event.durationNs / 1000.0 << "}";
+    }
+
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    return !out.fail();
+}
+
+//------------------------------ getSummary ------------------------------
+//------------------------------------------------------------------------
+inline std::vector<Profiler::ScopeSummary> Profiler::getSummary()const
+{
+    std::vector<ScopeSummary> summary;
+
+    int numFrames = getNumFramesInHistory();
+    if (numFrames == 0) return summary;
+
+    //the nodes are visited depth first
+    std::vector<int> stack(1, 0);
+    std::vector<float> times;
+
+    while (!stack.empty())
+    {
+        const Node& node = m_Nodes[stack.back()];
+        stack.pop_back();
+
+        for (int c=(int)node.children.size()-1; c>=0; --c)
+        {
+            stack.push_back(node.children[c]);
+        }
+
+        times.assign(node.historyMs.begin(), node.historyMs.begin() + numFrames);
+
+        float total = 0;
+        int calls = 0;
+        for (int f=0; f<numFrames; ++f)
+        {
+            total += times[f];
+            calls += node.historyCalls[f];
+        }
+
+        ScopeSummary scope;
+        scope.name = node.name;
+        scope.depth = node.depth;
+        scope.minMs = *std::min_element(times.begin(), times.end());
+        scope.maxMs = *std::max_element(times.begin(), times.end());
+        scope.avgMs = total / numFrames;
+        scope.callsPerFrame = (float)calls / numFrames;
+
+        //the smallest time at least 99% of the frames are within
+        int p99 = (int)std::ceil(numFrames * 0.99f) - 1;
+        std::nth_element(times.begin(), times.begin() + p99, times.end());
+        scope.p99Ms = times[p99];
+
+        summary.push_back(scope);
+    }
+
+    return summary;
+}
+
+//----------------------------- writeSummary -----------------------------
+//------------------------------------------------------------------------
+inline void Profiler::writeSummary(std::ostream& os)const
+{
+    std::vector<ScopeSummary> summary = getSummary();
+
+    os << "over the last " << getNumFramesInHistory() << " frames (ms per frame)\n";
+    os << std::left << std::setw(40) << "scope"
+       << std::right << std::setw(10) << "min"
+       << std::setw(10) << "avg"
+       << std::setw(10) << "p99"
+       << std::setw(10) << "max"
+       << std::setw(12) << "calls" << "\n";
+
+    os << std::fixed << std::setprecision(3);
+
+    for (unsigned int s=0; s<summary.size(); ++s)
+    {
+        const ScopeSummary& scope = summary[s];
+
+        os << std::left << std::setw(40) << (std::string(scope.depth*2, ' ') + scope.name)
+           << std::right << std::setw(10) << scope.minMs
+           << std::setw(10) << scope.avgMs
+           << std::setw(10) << scope.p99Ms
+           << std::setw(10) << scope.maxMs
+           << std::setw(12) << std::setprecision(1) << scope.callsPerFrame << std::setprecision(3) << "\n";
+    }
+}
+
+
+
+#endif
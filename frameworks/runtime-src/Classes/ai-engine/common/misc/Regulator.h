@@ -1,6 +1,6 @@
 #ifndef REGULATOR
 #define REGULATOR
-#include <chrono>
+#include "common/misc/SimClock.h"
 #include "common/misc/UtilsEx.h"
 //------------------------------------------------------------------------
 //  Name:   Regulator.h
@@ -32,7 +32,7 @@ public:
             m_updatePeriod = 0;
         }
 
-        m_nextUpdateTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(m_updatePeriod+1);        
+        m_nextUpdateTime = SimClock::now() + std::chrono::milliseconds(m_updatePeriod+1);        
     }
 
     //returns true if the current time exceeds m_nextUpdateTime
@@ -48,7 +48,7 @@ public:
         if (m_updatePeriod < 0) 
             return false;
 
-        auto curTime = std::chrono::steady_clock::now();
+        auto curTime = SimClock::now();
         if (curTime >= m_nextUpdateTime)
         {
             m_nextUpdateTime = curTime + std::chrono::milliseconds(m_updatePeriod); 
@@ -63,7 +63,7 @@ private:
     int m_updatePeriod;
     
     //the next time the regulator allows code flow
-    std::chrono::steady_clock::time_point m_nextUpdateTime;
+    SimClock::time_point m_nextUpdateTime;
 };
 
 
@@ -0,0 +1,115 @@
+#ifndef SIM_CLOCK_H
+#define SIM_CLOCK_H
+//------------------------------------------------------------------------
+//
+//  Name:   SimClock.h
+//
+//  Desc:   the simulation clock. A world owns one and ticks it once per
+//          update, moving simulated time on by a fixed time step. With a
+//          fixed step the simulation runs the same whether it is stepped
+//          by the renderer at the frame rate or as fast as the CPU allows.
+//
+//          SimClock has the interface of a std::chrono clock, so anything
+//          that timed itself with std::chrono::steady_clock can use
+//          SimClock::now() and SimClock::time_point instead. now() reads
+//          the clock made current on the calling thread with makeCurrent.
+//          If there is none it reads the real time.
+//
+//          A clock with a time step of 0 follows the real time.
+//
+//------------------------------------------------------------------------
+#include <chrono>
+#include <cstddef>
+
+
+class SimClock
+{
+public:
+    //the std::chrono clock interface
+    typedef std::chrono::steady_clock::duration duration;
+    typedef duration::rep rep;
+    typedef duration::period period;
+    typedef std::chrono::time_point<SimClock> time_point;
+    static const bool is_steady = true;
+
+    //returns the time of the current clock
+    static time_point now()
+    {
+        SimClock* pClock = current();
+
+        return pClock ? pClock->m_Time : realNow();
+    }
+
+    //timeStep is the length of a tick in seconds
+    explicit SimClock(float timeStep):m_dTimeStep(timeStep),
+                                      m_dTickLength(timeStep),
+                                      m_iTick(0),
+                                      m_Time(realNow()),
+                                      m_LastRealTime(m_Time)
+    {}
+
+    ~SimClock()
+    {
+        if (current() == this) current() = NULL;
+    }
+
+    //moves the time on by one time step, or by the real time since the
+    //last tick if the time step is 0
+    void tick()
+    {
+        ++m_iTick;
+
+        if (m_dTimeStep > 0)
+        {
+            m_Time += std::chrono::duration_cast<duration>(std::chrono::duration<float>(m_dTimeStep));
+        }
+        else
+        {
+            time_point realTime = realNow();
+            m_Time += realTime - m_LastRealTime;
+            m_dTickLength = std::chrono::duration<float>(realTime - m_LastRealTime).count();
+            m_LastRealTime = realTime;
+        }
+    }
+
+    //makes this the clock read by now() on this thread
+    void makeCurrent(){current() = this;}
+
+    unsigned int getTick()const{return m_iTick;}
+    float getTimeStep()const{return m_dTimeStep;}
+
+    //the length of the last tick in seconds. The time step, or the real
+    //time it took if the clock follows the real time
+    float getTickLength()const{return m_dTickLength;}
+    time_point getTime()const{return m_Time;}
+
+private:
+    float m_dTimeStep;
+    float m_dTickLength;
+
+    //the number of ticks so far
+    unsigned int m_iTick;
+
+    time_point m_Time;
+
+    //the real time of the last tick, used when following the real time
+    time_point m_LastRealTime;
+
+    static time_point realNow()
+    {
+        return time_point(std::chrono::steady_clock::now().time_since_epoch());
+    }
+
+    static SimClock*& current()
+    {
+        static thread_local SimClock* pCurrent = NULL;
+        return pCurrent;
+    }
+
+    SimClock(const SimClock&);
+    SimClock& operator=(const SimClock&);
+};
+
+
+
+#endif
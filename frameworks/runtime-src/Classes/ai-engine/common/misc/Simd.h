@@ -0,0 +1,30 @@
+#ifndef SIMD_H
+#define SIMD_H
+//------------------------------------------------------------------------
+//
+//  Name:   Simd.h
+//
+//  Desc:   defines AI_SIMD_SSE2 and includes the SSE2 intrinsics when the
+//          target has them. Code using them must keep a plain C++ version
+//          for the other targets.
+//
+//------------------------------------------------------------------------
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AI_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef AI_SIMD_SSE2
+//returns the sum of the four floats in v
+inline float SimdHorizontalSum(__m128 v)
+{
+    __m128 shuf = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(v, shuf);
+    shuf = _mm_movehl_ps(shuf, sums);
+    sums = _mm_add_ss(sums, shuf);
+    return _mm_cvtss_f32(sums);
+}
+#endif
+
+#endif
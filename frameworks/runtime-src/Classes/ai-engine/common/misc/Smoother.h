@@ -37,7 +37,7 @@ public:
         //now to calculate the average of the history list
         T sum = m_ZeroValue;
 
-        std::vector<T>::iterator it = m_History.begin();
+        typename std::vector<T>::iterator it = m_History.begin();
 
         for (it; it != m_History.end(); ++it)
         {
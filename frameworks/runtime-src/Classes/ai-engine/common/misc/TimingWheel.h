@@ -0,0 +1,383 @@
+#ifndef TIMING_WHEEL_H
+#define TIMING_WHEEL_H
+//-----------------------------------------------------------------------------
+//
+//  Name:   TimingWheel.h
+//
+//  Desc:   a hierarchical timing wheel. Holds items that fall due at a given
+//          tick and hands them out when the wheel is advanced to that tick.
+//
+//          There are NumLevels wheels of SlotsPerLevel slots. A slot of
+//          level 0 holds the items due on one tick, a slot of level 1 those
+//          due in SlotsPerLevel ticks and so on. An item goes into the
+//          lowest level that reaches its tick, which is O(1). When level 0
+//          has gone round once the next slot of level 1 is emptied into
+//          level 0, and the same one level up, so every item is moved at
+//          most NumLevels times before it falls due.
+//
+//          The items are kept in a pool of nodes linked into the slots by
+//          index, so once the pool has grown scheduling doesn't allocate.
+//          schedule returns a handle, made of the node index and a
+//          generation like the entity IDs, that can cancel the item until
+//          it has been handed out.
+//
+//          The pending items are also hashed by their tick and value, so
+//          find is O(1) too. T needs an operator== and a function
+//          unsigned int hashValue(const T&).
+//
+//-----------------------------------------------------------------------------
+#include <vector>
+#include <cassert>
+
+
+template <class T>
+class TimingWheel
+{
+public:
+    enum
+    {
+        SlotBits      = 6,
+        SlotsPerLevel = 1 << SlotBits,
+        SlotMask      = SlotsPerLevel - 1,
+        NumLevels     = 4,
+
+        IndexBits     = 20,
+        IndexMask     = (1 << IndexBits) - 1,
+        GenerationMask = (1 << 11) - 1
+    };
+
+    //an item handed out by advance. seq numbers the items in the order
+    //they were scheduled
+    struct Due
+    {
+        T item;
+        unsigned int tick;
+        unsigned int seq;
+    };
+
+    //tick is the tick the wheel is at. Items can be scheduled from tick+1
+    explicit TimingWheel(unsigned int tick = 0);
+
+    //returns a handle to the item
+    int schedule(unsigned int tick, const T& item);
+
+    //returns the handle of a pending item equal to item (compared with
+    //operator==) due on tick, or -1 if there is none
+    int find(unsigned int tick, const T& item)const;
+
+    //removes the item if it is still pending. Returns false if it isn't
+    bool cancel(int handle);
+
+    //moves the wheel on to tick and appends the items that fall due on
+    //the way to due
+    void advance(unsigned int tick, std::vector<Due>& due);
+
+    unsigned int getTick()const{return m_iTick;}
+    int getNumPending()const{return m_iNumPending;}
+
+private:
+    struct Node
+    {
+        T item;
+        unsigned int tick;
+        unsigned int seq;
+        unsigned int generation;
+
+        //the slot the node is linked into, -1 if it is free
+        int slot;
+        int prev;
+        int next;
+
+        //the next node in the same hash bucket
+        int hashNext;
+    };
+
+    std::vector<Node> m_Nodes;
+
+    //the first node of each hash bucket. The number of buckets is a power
+    //of 2 and at least the number of pending items
+    std::vector<int> m_Buckets;
+
+    //the first free node, linked through next
+    int m_iFreeNode;
+
+    int m_Head[NumLevels*SlotsPerLevel];
+    int m_Tail[NumLevels*SlotsPerLevel];
+
+    unsigned int m_iTick;
+    unsigned int m_iNextSeq;
+    int m_iNumPending;
+
+    int slotFor(unsigned int tick)const;
+
+    void link(int node, int slot);
+    void unlink(int node);
+    void freeNode(int node);
+
+    //re-inserts the items of a slot of level 1 or above
+    void cascade(int level);
+
+    unsigned int bucketOf(unsigned int tick, const T& item)const
+    {
+        return (hashValue(item) ^ (tick * 2654435761u)) & (unsigned int)(m_Buckets.size()-1);
+    }
+
+    void addToBucket(int node);
+    void removeFromBucket(int node);
+    void rehash(unsigned int numBuckets);
+
+    int handleOf(int node)const
+    {
+        return (int)((m_Nodes[node].generation & GenerationMask) << IndexBits) | node;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <class T>
+TimingWheel<T>::TimingWheel(unsigned int tick):m_iFreeNode(-1),
+                                               m_iTick(tick),
+                                               m_iNextSeq(0),
+                                               m_iNumPending(0)
+{
+    for (int s=0; s<NumLevels*SlotsPerLevel; ++s)
+    {
+        m_Head[s] = m_Tail[s] = -1;
+    }
+}
+
+//------------------------------- slotFor -------------------------------------
+//
+//  the slot of the lowest level that reaches tick
+//-----------------------------------------------------------------------------
+template <class T>
+int TimingWheel<T>::slotFor(unsigned int tick)const
+{
+    unsigned int delta = tick - m_iTick;
+
+    int level = 0;
+    while (level < NumLevels-1 && delta >= (1u << (SlotBits*(level+1))))
+    {
+        ++level;
+    }
+
+    return level*SlotsPerLevel + ((tick >> (SlotBits*level)) & SlotMask);
+}
+
+//------------------------------- schedule ------------------------------------
+//-----------------------------------------------------------------------------
+template <class T>
+int TimingWheel<T>::schedule(unsigned int tick, const T& item)
+{
+    //the items of the current tick have been handed out already
+    if ((int)(tick - m_iTick) <= 0) tick = m_iTick + 1;
+
+    int node;
+    if (m_iFreeNode != -1)
+    {
+        node = m_iFreeNode;
+        m_iFreeNode = m_Nodes[node].next;
+
+        Node& n = m_Nodes[node];
+        n.item = item;
+        n.tick = tick;
+        n.seq = m_iNextSeq++;
+    }
+    else
+    {
+        assert ((m_Nodes.size() < IndexMask) && "<TimingWheel::schedule>: too many items");
+
+        Node n = {item, tick, m_iNextSeq++, 0, -1, -1, -1, -1};
+        m_Nodes.push_back(n);
+        node = (int)m_Nodes.size()-1;
+    }
+
+    link(node, slotFor(tick));
+    ++m_iNumPending;
+
+    if (m_iNumPending > (int)m_Buckets.size())
+    {
+        rehash(m_Buckets.empty() ? (unsigned int)SlotsPerLevel : (unsigned int)m_Buckets.size()*2);
+    }
+    else
+    {
+        addToBucket(node);
+    }
+
+    return handleOf(node);
+}
+
+//--------------------------------- find --------------------------------------
+//-----------------------------------------------------------------------------
+template <class T>
+int TimingWheel<T>::find(unsigned int tick, const T& item)const
+{
+    if (m_Buckets.empty()) return -1;
+
+    for (int node = m_Buckets[bucketOf(tick, item)]; node != -1; node = m_Nodes[node].hashNext)
+    {
+        if (m_Nodes[node].tick == tick && m_Nodes[node].item == item)
+        {
+            return handleOf(node);
+        }
+    }
+
+    return -1;
+}
+
+//-------------------------------- cancel -------------------------------------
+//-----------------------------------------------------------------------------
+template <class T>
+bool TimingWheel<T>::cancel(int handle)
+{
+    if (handle < 0) return false;
+
+    int node = handle & IndexMask;
+
+    if (node >= (int)m_Nodes.size() ||
+        m_Nodes[node].slot == -1 ||
+        handleOf(node) != handle)
+    {
+        return false;
+    }
+
+    unlink(node);
+    freeNode(node);
+    --m_iNumPending;
+
+    return true;
+}
+
+//-------------------------------- advance ------------------------------------
+//-----------------------------------------------------------------------------
+template <class T>
+void TimingWheel<T>::advance(unsigned int tick, std::vector<Due>& due)
+{
+    while ((int)(tick - m_iTick) > 0)
+    {
+        ++m_iTick;
+
+        //when a level has gone round, bring down the next slot of the
+        //level above
+        for (int level=1; level<NumLevels; ++level)
+        {
+            if ((m_iTick >> (SlotBits*(level-1))) & SlotMask) break;
+
+            cascade(level);
+        }
+
+        int slot = m_iTick & SlotMask;
+
+        while (m_Head[slot] != -1)
+        {
+            int node = m_Head[slot];
+            Node& n = m_Nodes[node];
+
+            Due d = {n.item, n.tick, n.seq};
+            due.push_back(d);
+
+            unlink(node);
+            freeNode(node);
+            --m_iNumPending;
+        }
+    }
+}
+
+//-------------------------------- cascade ------------------------------------
+//-----------------------------------------------------------------------------
+template <class T>
+void TimingWheel<T>::cascade(int level)
+{
+    int slot = level*SlotsPerLevel + ((m_iTick >> (SlotBits*level)) & SlotMask);
+
+    //detach the list first, an item too far off for level 0 can go back
+    //into this very slot
+    int node = m_Head[slot];
+    m_Head[slot] = m_Tail[slot] = -1;
+
+    while (node != -1)
+    {
+        int next = m_Nodes[node].next;
+        link(node, slotFor(m_Nodes[node].tick));
+        node = next;
+    }
+}
+
+//---------------------------- link / unlink ----------------------------------
+//-----------------------------------------------------------------------------
+template <class T>
+void TimingWheel<T>::link(int node, int slot)
+{
+    Node& n = m_Nodes[node];
+    n.slot = slot;
+    n.prev = m_Tail[slot];
+    n.next = -1;
+
+    if (m_Tail[slot] != -1) m_Nodes[m_Tail[slot]].next = node;
+    else                    m_Head[slot] = node;
+
+    m_Tail[slot] = node;
+}
+
+template <class T>
+void TimingWheel<T>::unlink(int node)
+{
+    Node& n = m_Nodes[node];
+
+    if (n.prev != -1) m_Nodes[n.prev].next = n.next;
+    else              m_Head[n.slot] = n.next;
+
+    if (n.next != -1) m_Nodes[n.next].prev = n.prev;
+    else              m_Tail[n.slot] = n.prev;
+}
+
+template <class T>
+void TimingWheel<T>::freeNode(int node)
+{
+    removeFromBucket(node);
+
+    Node& n = m_Nodes[node];
+    n.slot = -1;
+    n.generation = (n.generation + 1) & GenerationMask;
+    n.next = m_iFreeNode;
+    m_iFreeNode = node;
+}
+
+//------------------------------ hash buckets ---------------------------------
+//-----------------------------------------------------------------------------
+template <class T>
+void TimingWheel<T>::addToBucket(int node)
+{
+    unsigned int bucket = bucketOf(m_Nodes[node].tick, m_Nodes[node].item);
+
+    m_Nodes[node].hashNext = m_Buckets[bucket];
+    m_Buckets[bucket] = node;
+}
+
+template <class T>
+void TimingWheel<T>::removeFromBucket(int node)
+{
+    int* pLink = &m_Buckets[bucketOf(m_Nodes[node].tick, m_Nodes[node].item)];
+
+    while (*pLink != node)
+    {
+        pLink = &m_Nodes[*pLink].hashNext;
+    }
+
+    *pLink = m_Nodes[node].hashNext;
+}
+
+template <class T>
+void TimingWheel<T>::rehash(unsigned int numBuckets)
+{
+    m_Buckets.assign(numBuckets, -1);
+
+    for (int node=0; node<(int)m_Nodes.size(); ++node)
+    {
+        if (m_Nodes[node].slot != -1) addToBucket(node);
+    }
+}
+
+
+
+#endif
@@ -2,10 +2,12 @@
 #define UTILS_EX_H 
 
 #include <cstdlib>
+#include <cmath>
 #include <sstream>
 #include <string>
 #include <iomanip>
 #include <cassert>
+#include <limits>
 
 #ifndef _PI_
 #define _PI_ (3.14159f)
@@ -19,34 +21,82 @@ const float FloatMin = (std::numeric_limits<float>::min)();
 
 
 /**
- * Returns a random float between -1 and 1.
- * It can be seeded using std::srand(seed);
+ * The random numbers are drawn from a xorshift32 state. The functions that
+ * take a state draw from a state owned by the caller: each owner gets its
+ * own repeatable sequence, which doesn't depend on what other code calls in
+ * between, and different owners can use them from different threads. The
+ * ones without draw from currentRandState().
  */
-inline float RandFloat_minus1_1() 
+inline unsigned int RandNext(unsigned int& state)
 {
-    // FIXME: using the new c++11 random engine generator
-    // without a proper way to set a seed is not useful.
-    // Resorting to the old random method since it can
-    // be seeded using std::srand()
-    return ((std::rand() / (float)RAND_MAX) * 2) -1;
+    assert(state != 0 && "<RandNext>: state is 0");
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
 
-//    return cocos2d::random(-1.f, 1.f);
-};
+//turns any seed into a valid (non 0) state
+inline unsigned int RandState(unsigned int seed)
+{
+    return (seed + 1) * 2654435761u | 1;
+}
 
+//the state of one of many sequences made from the same seed, e.g. one per
+//entity of a world. The two are mixed so that nearby seeds and streams
+//still give unrelated sequences
+inline unsigned int RandState(unsigned int seed, unsigned int stream)
+{
+    unsigned int h = seed * 2654435761u + stream;
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    return RandState(h);
+}
 
-/**
- * Returns a random float between 0 and 1.
- * It can be seeded using std::srand(seed);
- */
-inline float RandFloat_0_1() 
+inline float RandFloat_0_1(unsigned int& state)
 {
-    // FIXME: using the new c++11 random engine generator
-    // without a proper way to set a seed is not useful.
-    // Resorting to the old random method since it can
-    // be seeded using std::srand()
-    return std::rand() / (float)RAND_MAX;
+    //use the top 24 bits so the result fits a float exactly
+    return (RandNext(state) >> 8) / (float)0xFFFFFF;
+}
 
-//    return cocos2d::random(0.f, 1.f);
+inline float RandFloat_minus1_1(unsigned int& state)
+{
+    return RandFloat_0_1(state) * 2 - 1;
+}
+
+//the state of this thread used when no world is current
+inline unsigned int& threadRandState()
+{
+    static thread_local unsigned int state = RandState(0);
+    return state;
+}
+
+//the state the functions below draw from. A WorldContext points this at
+//its own state when it is made current, so every world has its own
+//sequence and worlds on different threads don't share one
+inline unsigned int*& currentRandState()
+{
+    static thread_local unsigned int* pState = &threadRandState();
+    return pState;
+}
+
+//seeds the current state. Replaces std::srand
+inline void RandSeed(unsigned int seed)
+{
+    *currentRandState() = RandState(seed);
+}
+
+//returns a random float between -1 and 1
+inline float RandFloat_minus1_1() 
+{
+    return RandFloat_minus1_1(*currentRandState());
+};
+
+//returns a random float between 0 and 1
+inline float RandFloat_0_1() 
+{
+    return RandFloat_0_1(*currentRandState());
 };
 
 //returns a random bool
@@ -66,7 +116,7 @@ inline float RandFloatInRange(float x, float y)
 inline int RandIntInRange(int x, int y)
 {
     assert(y>=x && "<RandInt>: y is less than x");
-    return rand()%(y-x+1)+x;    
+    return RandNext(*currentRandState())%(y-x+1)+x;    
 }
 
 //compares two real numbers. Returns true if they are equal
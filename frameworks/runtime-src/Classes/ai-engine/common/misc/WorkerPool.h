@@ -0,0 +1,206 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+//-----------------------------------------------------------------------------
+//
+//  Name:   WorkerPool.h
+//
+//  Desc:   a fixed set of worker threads used to run data parallel jobs.
+//
+//          A job covers the items [0, numItems) and is handed out to the
+//          threads in chunks. The thread calling run works on the job too
+//          and run only returns once every item has been processed.
+//
+//          Which thread gets which chunk changes from run to run, so a job
+//          must only write data belonging to the items it is given. Done
+//          that way the result is the same for any number of threads.
+//
+//-----------------------------------------------------------------------------
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>
+
+
+//------------------------------------------------------------------------
+//
+//  derive from this and implement process to define the work done for
+//  the items begin to end-1
+//------------------------------------------------------------------------
+class ParallelJob
+{
+public:
+    virtual ~ParallelJob(){}
+
+    virtual void process(int begin, int end) = 0;
+};
+
+
+class WorkerPool
+{
+public:
+    //numThreads is the total number of threads working on a job, the
+    //calling thread included. 0 means one per hardware thread
+    inline WorkerPool(int numThreads);
+    inline ~WorkerPool();
+
+    int getNumThreads()const{return (int)m_Workers.size() + 1;}
+
+    //processes items [0, numItems) of the job in chunks of chunkSize
+    //and blocks until they are all done
+    inline void run(ParallelJob& job, int numItems, int chunkSize);
+
+private:
+    inline void workerLoop();
+
+    //takes chunks of the current job until there are none left
+    inline void processChunks();
+
+    std::vector<std::thread> m_Workers;
+
+    std::mutex m_Mutex;
+    std::condition_variable m_WorkReady;
+    std::condition_variable m_WorkDone;
+
+    //the job being run and how it is split up
+    ParallelJob* m_pJob;
+    int m_iNumItems;
+    int m_iChunkSize;
+
+    //the first item of the next chunk to hand out
+    std::atomic<int> m_iNextItem;
+
+    //increased for every job so the workers can tell a new job from the
+    //one they have just finished
+    unsigned int m_iGeneration;
+
+    //the number of workers still busy with the current job
+    int m_iBusyWorkers;
+
+    bool m_bQuit;
+
+    WorkerPool(const WorkerPool&);
+    WorkerPool& operator=(const WorkerPool&);
+};
+
+
+//----------------------------- ctor -------------------------------------
+//------------------------------------------------------------------------
+WorkerPool::WorkerPool(int numThreads):m_pJob(nullptr),
+                                       m_iNumItems(0),
+                                       m_iChunkSize(1),
+                                       m_iNextItem(0),
+                                       m_iGeneration(0),
+                                       m_iBusyWorkers(0),
+                                       m_bQuit(false)
+{
+    if (numThreads <= 0)
+    {
+        numThreads = (int)std::thread::hardware_concurrency();
+    }
+
+    for (int i=1; i<numThreads; ++i)
+    {
+        m_Workers.push_back(std::thread(&WorkerPool::workerLoop, this));
+    }
+}
+
+//----------------------------- dtor -------------------------------------
+//------------------------------------------------------------------------
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_bQuit = true;
+    }
+    m_WorkReady.notify_all();
+
+    for (unsigned int i=0; i<m_Workers.size(); ++i)
+    {
+        m_Workers[i].join();
+    }
+}
+
+//------------------------------- run ------------------------------------
+//------------------------------------------------------------------------
+void WorkerPool::run(ParallelJob& job, int numItems, int chunkSize)
+{
+    if (numItems <= 0) return;
+
+    chunkSize = (std::max)(chunkSize, 1);
+
+    //not worth waking anybody up
+    if (m_Workers.empty() || numItems <= chunkSize)
+    {
+        job.process(0, numItems);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_pJob = &job;
+        m_iNumItems = numItems;
+        m_iChunkSize = chunkSize;
+        m_iNextItem = 0;
+        m_iBusyWorkers = (int)m_Workers.size();
+        ++m_iGeneration;
+    }
+    m_WorkReady.notify_all();
+
+    processChunks();
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    while (m_iBusyWorkers > 0)
+    {
+        m_WorkDone.wait(lock);
+    }
+    m_pJob = nullptr;
+}
+
+//--------------------------- processChunks ------------------------------
+//------------------------------------------------------------------------
+void WorkerPool::processChunks()
+{
+    for (;;)
+    {
+        int begin = m_iNextItem.fetch_add(m_iChunkSize);
+        if (begin >= m_iNumItems) break;
+
+        m_pJob->process(begin, (std::min)(begin + m_iChunkSize, m_iNumItems));
+    }
+}
+
+//---------------------------- workerLoop --------------------------------
+//------------------------------------------------------------------------
+void WorkerPool::workerLoop()
+{
+    unsigned int lastGeneration = 0;
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            while (!m_bQuit && m_iGeneration == lastGeneration)
+            {
+                m_WorkReady.wait(lock);
+            }
+
+            if (m_bQuit) return;
+
+            lastGeneration = m_iGeneration;
+        }
+
+        processChunks();
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (--m_iBusyWorkers == 0)
+            {
+                m_WorkDone.notify_one();
+            }
+        }
+    }
+}
+
+#endif
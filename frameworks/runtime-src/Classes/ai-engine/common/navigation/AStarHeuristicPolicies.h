@@ -23,7 +23,7 @@ public:
     template <class graph_type>
     static float calculate(const graph_type& G, int nd1, int nd2)
     {
-        return Vec2Distance(G.getNode(nd1).pos(), G.getNode(nd2).pos());
+        return Vec2Distance(G.getNode(nd1).getPos(), G.getNode(nd2).getPos());
     }
 };
 
@@ -42,7 +42,7 @@ public:
     template <class graph_type>
     static float calculate(const graph_type& G, int nd1, int nd2)
     {
-        return Vec2Distance(G.getNode(nd1).pos(), G.getNode(nd2).pos()) * RandFloatInRange(0.9f, 1.1f);
+        return Vec2Distance(G.getNode(nd1).getPos(), G.getNode(nd2).getPos()) * RandFloatInRange(0.9f, 1.1f);
     }
 };
 
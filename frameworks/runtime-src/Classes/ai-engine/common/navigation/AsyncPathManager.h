@@ -0,0 +1,361 @@
+#ifndef ASYNC_PATH_MANAGER_H
+#define ASYNC_PATH_MANAGER_H
+#pragma warning (disable:4786)
+//-----------------------------------------------------------------------------
+//
+//  Name:   AsyncPathManager.h
+//
+//  Desc:   runs graph searches to completion on threads of their own, so
+//          planning paths takes time from spare cores instead of from the
+//          game's update. The other way to manage searches is the
+//          PathManager, which time-slices them on the game thread.
+//
+//          A planner hands its search over with registerPlan. The threads
+//          take the searches in the order they were registered and run
+//          each to the end. The results are kept until the game thread
+//          calls deliverResults, at a point of its update it chooses,
+//          which hands each search back to its planner by calling
+//          searchFinished(result) on it. So a planner only ever hears of
+//          its search on the game thread.
+//
+//          While the threads have it a search must only read data nothing
+//          changes, a frozen navgraph say, and its planner mustn't touch it.
+//          If the planner wants another path before the result comes back
+//          it unregisters the search, and the manager deletes it once no
+//          thread is using it.
+//
+//          Each search takes a workspace from the pool of the thread that
+//          creates it (see SearchWorkspace.h). A search that needs more
+//          as it runs takes them from the pool of the thread running it.
+//
+//          path_planner must have an EdgeType typedef and a method
+//          searchFinished(int result).
+//-----------------------------------------------------------------------------
+#include <vector>
+#include <deque>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+#include <cassert>
+
+#include "common/navigation/GraphAlgorithms_TimeSliced.h"
+#include "common/navigation/PathManager.h"
+
+
+template <class path_planner>
+class AsyncPathManager
+{
+public:
+    typedef Graph_SearchTimeSliced<typename path_planner::EdgeType> Search;
+
+    //numThreads is the number of threads the searches run on. 0 means one
+    //per hardware thread, less one for the game thread
+    inline AsyncPathManager(int numThreads);
+
+    //waits for the searches being run and deletes those not handed back
+    inline ~AsyncPathManager();
+
+    int getNumThreads()const{return (int)m_Threads.size();}
+
+    //hands pSearch over to the threads. It is given back to pPathPlanner
+    //by deliverResults once it has finished. If the planner already has a
+    //search with the manager that one is thrown away
+    inline void registerPlan(path_planner* pPathPlanner, Search* pSearch);
+
+    //throws away the search of a planner. Returns false if the manager
+    //doesn't have one, in which case it is still the planner's to delete
+    inline bool unRegisterPlan(path_planner* pPathPlanner);
+
+    //hands the searches that have finished since the last call back to
+    //their planners. Call it from the game thread only
+    inline void deliverResults();
+
+    //returns the number of searches not yet handed back
+    int getNumActiveSearches()const{return (int)m_Active.size();}
+
+    //the same stats as the PathManager's. An update is a call of
+    //deliverResults, and its time is the time taken to deliver the results
+    const PathManagerStats& getStats()const{return m_Stats;}
+    inline void resetStats();
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Job
+    {
+        path_planner* pPlanner;
+        Search* pSearch;
+
+        //told apart from other searches of the same planner by this
+        unsigned int ticket;
+
+        int result;
+
+        unsigned int updateRegistered;
+        Clock::time_point timeRegistered;
+    };
+
+    std::vector<std::thread> m_Threads;
+
+    //m_Pending, m_Done and m_bQuit are shared with the threads, the rest
+    //belongs to the game thread
+    std::mutex m_Mutex;
+    std::condition_variable m_WorkReady;
+
+    std::deque<Job> m_Pending;
+    std::vector<Job> m_Done;
+
+    bool m_bQuit;
+
+    //the ticket of the search each planner is waiting for
+    std::map<path_planner*, unsigned int> m_Active;
+
+    unsigned int m_iNextTicket;
+
+    unsigned int m_iNumUpdates;
+
+    //the results being delivered. Kept to reuse its memory
+    std::vector<Job> m_Delivering;
+
+    PathManagerStats m_Stats;
+
+    inline void threadLoop();
+
+    AsyncPathManager(const AsyncPathManager&);
+    AsyncPathManager& operator=(const AsyncPathManager&);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+//----------------------------- ctor -------------------------------------
+//------------------------------------------------------------------------
+template <class path_planner>
+AsyncPathManager<path_planner>::AsyncPathManager(int numThreads):m_bQuit(false),
+                                                                 m_iNextTicket(0),
+                                                                 m_iNumUpdates(0)
+{
+    if (numThreads <= 0)
+    {
+        numThreads = (std::max)((int)std::thread::hardware_concurrency() - 1, 1);
+    }
+
+    for (int i=0; i<numThreads; ++i)
+    {
+        m_Threads.push_back(std::thread(&AsyncPathManager::threadLoop, this));
+    }
+
+    resetStats();
+}
+
+//----------------------------- dtor -------------------------------------
+//------------------------------------------------------------------------
+template <class path_planner>
+AsyncPathManager<path_planner>::~AsyncPathManager()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_bQuit = true;
+    }
+    m_WorkReady.notify_all();
+
+    for (unsigned int i=0; i<m_Threads.size(); ++i)
+    {
+        m_Threads[i].join();
+    }
+
+    for (unsigned int i=0; i<m_Pending.size(); ++i)
+    {
+        delete m_Pending[i].pSearch;
+    }
+
+    for (unsigned int i=0; i<m_Done.size(); ++i)
+    {
+        delete m_Done[i].pSearch;
+    }
+}
+
+//---------------------------- threadLoop --------------------------------
+//------------------------------------------------------------------------
+template <class path_planner>
+void AsyncPathManager<path_planner>::threadLoop()
+{
+    for (;;)
+    {
+        Job job;
+
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            while (!m_bQuit && m_Pending.empty())
+            {
+                m_WorkReady.wait(lock);
+            }
+
+            if (m_bQuit) return;
+
+            job = m_Pending.front();
+            m_Pending.pop_front();
+        }
+
+        //no need to slice it up, nothing else runs on this thread
+        do
+        {
+            job.result = job.pSearch->cycleOnce();
+        }
+        while (job.result == search_incomplete);
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Done.push_back(job);
+        }
+    }
+}
+
+//---------------------------- registerPlan ------------------------------
+//------------------------------------------------------------------------
+template <class path_planner>
+void AsyncPathManager<path_planner>::registerPlan(path_planner* pPathPlanner, Search* pSearch)
+{
+    assert (pSearch && "<AsyncPathManager::registerPlan>: no search");
+
+    if (unRegisterPlan(pPathPlanner))
+    {
+        //counted as coalesced rather than cancelled
+        --m_Stats.numCancelled;
+        ++m_Stats.numCoalesced;
+    }
+
+    Job job;
+    job.pPlanner = pPathPlanner;
+    job.pSearch = pSearch;
+    job.ticket = ++m_iNextTicket;
+    job.result = search_incomplete;
+    job.updateRegistered = m_iNumUpdates;
+    job.timeRegistered = Clock::now();
+
+    m_Active[pPathPlanner] = job.ticket;
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Pending.push_back(job);
+    }
+    m_WorkReady.notify_one();
+
+    m_Stats.maxQueueDepth = (std::max)(m_Stats.maxQueueDepth, (int)m_Active.size());
+}
+
+//--------------------------- unRegisterPlan -----------------------------
+//
+//  a search no thread has started yet is deleted now. One being run, or
+//  waiting to be delivered, is left to deliverResults, which deletes the
+//  results of searches that are no longer wanted
+//------------------------------------------------------------------------
+template <class path_planner>
+bool AsyncPathManager<path_planner>::unRegisterPlan(path_planner* pPathPlanner)
+{
+    typename std::map<path_planner*, unsigned int>::iterator it = m_Active.find(pPathPlanner);
+
+    if (it == m_Active.end()) return false;
+
+    unsigned int ticket = it->second;
+
+    m_Active.erase(it);
+
+    ++m_Stats.numCancelled;
+
+    Search* pUnstarted = NULL;
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        for (typename std::deque<Job>::iterator job = m_Pending.begin(); job != m_Pending.end(); ++job)
+        {
+            if (job->ticket == ticket)
+            {
+                pUnstarted = job->pSearch;
+                m_Pending.erase(job);
+                break;
+            }
+        }
+    }
+
+    delete pUnstarted;
+
+    return true;
+}
+
+//--------------------------- deliverResults -----------------------------
+//------------------------------------------------------------------------
+template <class path_planner>
+void AsyncPathManager<path_planner>::deliverResults()
+{
+    Clock::time_point start = Clock::now();
+
+    ++m_iNumUpdates;
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Delivering.swap(m_Done);
+    }
+
+    for (unsigned int i=0; i<m_Delivering.size(); ++i)
+    {
+        Job& job = m_Delivering[i];
+
+        //the planner may have asked for another path, or gone, since
+        typename std::map<path_planner*, unsigned int>::iterator it = m_Active.find(job.pPlanner);
+
+        if (it == m_Active.end() || it->second != job.ticket)
+        {
+            delete job.pSearch;
+            continue;
+        }
+
+        m_Active.erase(it);
+
+        float latencyMs = std::chrono::duration<float, std::milli>(start - job.timeRegistered).count();
+        int latencyUpdates = (int)(m_iNumUpdates - job.updateRegistered);
+
+        ++m_Stats.numCompleted;
+        m_Stats.totalLatencyMs += latencyMs;
+        m_Stats.maxLatencyMs = (std::max)(m_Stats.maxLatencyMs, latencyMs);
+        m_Stats.totalLatencyUpdates += latencyUpdates;
+        m_Stats.maxLatencyUpdates = (std::max)(m_Stats.maxLatencyUpdates, latencyUpdates);
+
+        //the search is the planner's again. It may register a new one from
+        //here
+        job.pPlanner->searchFinished(job.result);
+    }
+
+    m_Delivering.clear();
+
+    float elapsedUs = std::chrono::duration<float, std::micro>(Clock::now() - start).count();
+
+    m_Stats.lastUpdateUs = elapsedUs;
+    m_Stats.maxUpdateUs = (std::max)(m_Stats.maxUpdateUs, elapsedUs);
+    m_Stats.queueDepth = (int)m_Active.size();
+}
+
+//----------------------------- resetStats -------------------------------
+//------------------------------------------------------------------------
+template <class path_planner>
+void AsyncPathManager<path_planner>::resetStats()
+{
+    m_Stats.queueDepth = (int)m_Active.size();
+    m_Stats.maxQueueDepth = m_Stats.queueDepth;
+    m_Stats.numCompleted = 0;
+    m_Stats.numCancelled = 0;
+    m_Stats.numCoalesced = 0;
+    m_Stats.cyclesLastUpdate = 0;
+    m_Stats.lastUpdateUs = 0.0f;
+    m_Stats.maxUpdateUs = 0.0f;
+    m_Stats.totalLatencyMs = 0.0f;
+    m_Stats.maxLatencyMs = 0.0f;
+    m_Stats.totalLatencyUpdates = 0;
+    m_Stats.maxLatencyUpdates = 0;
+}
+
+
+#endif
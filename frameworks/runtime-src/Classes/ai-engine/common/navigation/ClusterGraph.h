@@ -0,0 +1,771 @@
+#ifndef CLUSTER_GRAPH_H
+#define CLUSTER_GRAPH_H
+#pragma warning (disable:4786)
+//------------------------------------------------------------------------
+//
+//  Name:   ClusterGraph.h
+//
+//  Desc:   hierarchical path planning (HPA*) over a navgraph.
+//
+//          The nodes of the navgraph are divided into clusters (the cells
+//          of a CellSpacePartition say). Where edges cross from one
+//          cluster to the next the crossing edges are grouped into
+//          entrances, runs of crossings next to each other, and the middle
+//          crossing of each run becomes a pair of entrance nodes, one on
+//          each side. The entrance nodes of a cluster are joined to each
+//          other by edges costing the cheapest path between them inside
+//          the cluster, calculated once when the cluster graph is built.
+//
+//          A path from a to b is found by searching inside the clusters of
+//          a and b for the costs to their entrances and then running A*
+//          over the entrances, which is much smaller than the navgraph.
+//          That gives the waypoints of the path: a, the entrances it goes
+//          through and b. Each leg between two waypoints is either an edge
+//          of the navgraph or a path inside one cluster, which is found
+//          when it is needed (refine). If a and b are in the same cluster
+//          or in neighboring ones the path straight from a to b through
+//          those clusters is tried as well, then short paths don't go out
+//          of their way to an entrance.
+//
+//          The costs of the legs are exact, so the cost of a path is that
+//          of the path it refines to. The path may cost a little more than
+//          the best path through the navgraph, as it can only cross from
+//          cluster to cluster at the entrances.
+//
+//          The navgraph must not be a digraph, its nodes need positions
+//          (getPos) and its edges must cost at least their length. Build
+//          the cluster graph again after changing the navgraph.
+//
+//------------------------------------------------------------------------
+#include <vector>
+#include <list>
+#include <map>
+#include <set>
+#include <algorithm>
+#include <cassert>
+
+#include "common/2D/Vector2D.h"
+#include "common/misc/UtilsEx.h"
+#include "common/graph/SparseGraph.h"
+#include "common/graph/FrozenGraph.h"
+#include "common/graph/GraphNodeTypes.h"
+#include "common/graph/GraphEdgeTypes.h"
+#include "common/navigation/SearchWorkspace.h"
+#include "common/navigation/GraphAlgorithms_TimeSliced.h"
+#include "common/navigation/PathEdge.h"
+
+
+template <class graph_type>
+class ClusterGraph
+{
+public:
+    typedef typename graph_type::EdgeType Edge;
+
+    //the graph of the entrances
+    typedef FrozenGraph<NavGraphNode<>, GraphEdge> AbstractGraph;
+
+    ClusterGraph():m_pGraph(NULL), m_iNumClusters(0){}
+
+    //clusterOfNode holds the cluster of each node of G
+    ClusterGraph(const graph_type& G, const std::vector<int>& clusterOfNode):m_pGraph(NULL),
+                                                                              m_iNumClusters(0)
+    {
+        build(G, clusterOfNode);
+    }
+
+    void build(const graph_type& G, const std::vector<int>& clusterOfNode);
+
+    bool isEmpty()const{return m_pGraph == NULL;}
+
+    const graph_type& getGraph()const{return *m_pGraph;}
+    const AbstractGraph& getAbstractGraph()const{return m_AbstractGraph;}
+
+    int getNumClusters()const{return m_iNumClusters;}
+    int getCluster(int node)const{return m_ClusterOfNode[node];}
+
+    int getNumEntrances()const{return m_AbstractGraph.getNumNodes();}
+    int getEntranceNode(int entrance)const{return m_EntranceNode[entrance];}
+
+    //finds the cheapest path from source to target over the entrances and
+    //writes its waypoints, the nodes of the navgraph it goes through from
+    //source to target, into waypoints. Returns false if there is no path
+    bool findWaypoints(int source, int target, std::vector<int>& waypoints, float& cost)const;
+
+    //appends the edges of the leg between two consecutive waypoints to
+    //edges. Returns false if there is none
+    bool refine(int from, int to, std::vector<const Edge*>& edges)const;
+
+private:
+    typedef SearchWorkspace<Edge> Workspace;
+    typedef SearchWorkspace<GraphEdge> AbstractWorkspace;
+
+    //an edge between two clusters, a in the cluster with the lower index
+    struct Crossing
+    {
+        int a, b;
+    };
+
+    //the crossings between each pair of clusters
+    typedef std::map<std::pair<int, int>, std::vector<Crossing> > CrossingMap;
+
+    const graph_type* m_pGraph;
+
+    std::vector<int> m_ClusterOfNode;
+    int m_iNumClusters;
+
+    AbstractGraph m_AbstractGraph;
+
+    //the node of the navgraph of each entrance, and the entrance of each
+    //node (-1 for most)
+    std::vector<int> m_EntranceNode;
+    std::vector<int> m_EntranceOfNode;
+
+    //the entrances of cluster c are m_ClusterEntrances[m_ClusterFirst[c]]
+    //to m_ClusterEntrances[m_ClusterFirst[c+1]-1]
+    std::vector<int> m_ClusterFirst;
+    std::vector<int> m_ClusterEntrances;
+
+    //returns the entrance at node, adding one if there is none
+    int entranceAt(int node, SparseGraph<NavGraphNode<>, GraphEdge>& abstractGraph);
+
+    //picks the entrances among the crossings between two clusters
+    void addEntrances(const std::vector<Crossing>& crossings,
+                      SparseGraph<NavGraphNode<>, GraphEdge>& abstractGraph);
+
+    //the pairs of clusters joined by an edge, the lower index first
+    std::set<std::pair<int, int> > m_Neighbors;
+
+    bool areNeighbors(int c1, int c2)const
+    {
+        return m_Neighbors.count(c1 < c2 ? std::make_pair(c1, c2) : std::make_pair(c2, c1)) != 0;
+    }
+
+    //searches from source through the nodes of clusters c1 and c2 only,
+    //with Dijkstra if target is -1, else with A* towards target. The
+    //results are left in W, which must have been begun
+    void searchClusters(int source, int target, int c1, int c2, Workspace& W)const;
+
+    ClusterGraph(const ClusterGraph&);
+    ClusterGraph& operator=(const ClusterGraph&);
+};
+
+
+//------------------------ Graph_SearchHierarchical_TS ------------------------
+//
+//  plans a path with a ClusterGraph. The waypoints are all found in the
+//  first cycle. The legs between them are refined when they are asked for,
+//  with getNextPathSegment, so a bot can set off along the start of a
+//  long path before the rest of it has been worked out. getPathAsPathEdges
+//  refines the whole path at once.
+//
+//  getPathToTarget returns the waypoints.
+//-----------------------------------------------------------------------------
+template <class graph_type>
+class Graph_SearchHierarchical_TS : public Graph_SearchTimeSliced<typename graph_type::EdgeType>
+{
+private:
+    typedef typename graph_type::EdgeType Edge;
+
+public:
+    Graph_SearchHierarchical_TS(const ClusterGraph<graph_type>& clusters,
+                                int source,
+                                int target):Graph_SearchTimeSliced<Edge>(Graph_SearchTimeSliced<Edge>::AStar),
+                                            m_Clusters(clusters),
+                                            m_iSource(source),
+                                            m_iTarget(target),
+                                            m_iResult(search_incomplete),
+                                            m_fCost(0.0f),
+                                            m_iNextWaypoint(0)
+    {}
+
+    //finds the waypoints. Takes one cycle
+    int cycleOnce();
+
+    //the search doesn't keep a shortest path tree, this is empty
+    std::vector<const Edge*> getSPT()const{return std::vector<const Edge*>();}
+
+    float getCostToTarget()const{return m_fCost;}
+
+    std::list<int> getPathToTarget()const{return std::list<int>(m_Waypoints.begin(), m_Waypoints.end());}
+
+    std::list<PathEdge> getPathAsPathEdges()const;
+
+    //true while there are legs of the path that haven't been handed out by
+    //getNextPathSegment
+    bool isPathPartial()const{return m_iNextWaypoint+1 < (int)m_Waypoints.size();}
+
+    //refines the next part of the path: the next leg, and the one after it
+    //as well if the next leg only crosses into another cluster
+    std::list<PathEdge> getNextPathSegment();
+
+private:
+    const ClusterGraph<graph_type>& m_Clusters;
+
+    int m_iSource;
+    int m_iTarget;
+
+    int m_iResult;
+
+    float m_fCost;
+
+    std::vector<int> m_Waypoints;
+
+    //the waypoint the next segment starts from
+    int m_iNextWaypoint;
+
+    //appends the leg from waypoint w to w+1 to path
+    void appendLeg(int w, std::list<PathEdge>& path)const;
+
+    Graph_SearchHierarchical_TS(const Graph_SearchHierarchical_TS&);
+    Graph_SearchHierarchical_TS& operator=(const Graph_SearchHierarchical_TS&);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------- build --------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void ClusterGraph<graph_type>::build(const graph_type& G, const std::vector<int>& clusterOfNode)
+{
+    assert (!G.isDigraph() && "<ClusterGraph::build>: the graph must not be a digraph");
+    assert ((int)clusterOfNode.size() == G.getNumNodes() && "<ClusterGraph::build>: a cluster is needed for every node");
+
+    m_pGraph = &G;
+    m_ClusterOfNode = clusterOfNode;
+
+    m_iNumClusters = 0;
+    for (unsigned int n=0; n<clusterOfNode.size(); ++n)
+    {
+        if (clusterOfNode[n] >= m_iNumClusters) m_iNumClusters = clusterOfNode[n]+1;
+    }
+
+    m_EntranceNode.clear();
+    m_EntranceOfNode.assign(G.getNumNodes(), -1);
+    m_Neighbors.clear();
+
+    SparseGraph<NavGraphNode<>, GraphEdge> abstractGraph(false);
+
+    //find the edges that cross from one cluster to another, each once
+    CrossingMap crossings;
+
+    typename graph_type::ConstNodeIterator NodeItr(G);
+    for (const typename graph_type::NodeType* pN=NodeItr.begin(); !NodeItr.end(); pN=NodeItr.next())
+    {
+        int a = pN->getIndex();
+
+        typename graph_type::ConstEdgeIterator EdgeItr(G, a);
+        for (EdgeItr.begin(); !EdgeItr.end(); EdgeItr.next())
+        {
+            int b = EdgeItr.to();
+
+            if (m_ClusterOfNode[a] < m_ClusterOfNode[b])
+            {
+                Crossing c = {a, b};
+                crossings[std::make_pair(m_ClusterOfNode[a], m_ClusterOfNode[b])].push_back(c);
+            }
+        }
+    }
+
+    //pick the entrances between each pair of neighboring clusters
+    for (typename CrossingMap::const_iterator it = crossings.begin(); it != crossings.end(); ++it)
+    {
+        m_Neighbors.insert(it->first);
+
+        addEntrances(it->second, abstractGraph);
+    }
+
+    //list the entrances of each cluster
+    m_ClusterFirst.assign(m_iNumClusters+1, 0);
+    for (unsigned int e=0; e<m_EntranceNode.size(); ++e)
+    {
+        ++m_ClusterFirst[m_ClusterOfNode[m_EntranceNode[e]]+1];
+    }
+    for (int c=0; c<m_iNumClusters; ++c)
+    {
+        m_ClusterFirst[c+1] += m_ClusterFirst[c];
+    }
+
+    m_ClusterEntrances.resize(m_EntranceNode.size());
+    std::vector<int> next(m_ClusterFirst.begin(), m_ClusterFirst.end()-1);
+    for (unsigned int e=0; e<m_EntranceNode.size(); ++e)
+    {
+        m_ClusterEntrances[next[m_ClusterOfNode[m_EntranceNode[e]]]++] = e;
+    }
+
+    //join the entrances of each cluster with the costs of the paths between
+    //them inside the cluster
+    Workspace* pW = Workspace::acquire(&G, G.getNumNodes());
+
+    for (int c=0; c<m_iNumClusters; ++c)
+    {
+        for (int i=m_ClusterFirst[c]; i<m_ClusterFirst[c+1]; ++i)
+        {
+            int from = m_ClusterEntrances[i];
+
+            pW->begin(G.getNumNodes());
+            searchClusters(m_EntranceNode[from], -1, c, c, *pW);
+
+            for (int j=i+1; j<m_ClusterFirst[c+1]; ++j)
+            {
+                int to = m_ClusterEntrances[j];
+
+                if (pW->isReached(m_EntranceNode[to]))
+                {
+                    abstractGraph.addEdge(GraphEdge(from, to, pW->getCost(m_EntranceNode[to])));
+                }
+            }
+        }
+    }
+
+    Workspace::release(pW);
+
+    m_AbstractGraph.build(abstractGraph);
+}
+
+//------------------------------ entranceAt -----------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+int ClusterGraph<graph_type>::entranceAt(int node, SparseGraph<NavGraphNode<>, GraphEdge>& abstractGraph)
+{
+    if (m_EntranceOfNode[node] == -1)
+    {
+        int entrance = abstractGraph.addNode(NavGraphNode<>(abstractGraph.getNextFreeNodeIndex(),
+                                                            m_pGraph->getNode(node).getPos()));
+
+        m_EntranceOfNode[node] = entrance;
+        m_EntranceNode.push_back(node);
+    }
+
+    return m_EntranceOfNode[node];
+}
+
+//----------------------------- addEntrances ----------------------------------
+//
+//  two crossings are in the same run if on both sides of the border their
+//  nodes are the same or joined by an edge, so from any crossing of a run
+//  the one picked as the entrance can be reached without leaving either
+//  cluster. The runs are found with a small union-find, there are only a
+//  handful of crossings between two clusters
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void ClusterGraph<graph_type>::addEntrances(const std::vector<Crossing>& crossings,
+                                            SparseGraph<NavGraphNode<>, GraphEdge>& abstractGraph)
+{
+    const graph_type& G = *m_pGraph;
+
+    int num = (int)crossings.size();
+
+    std::vector<int> run(num);
+    for (int i=0; i<num; ++i) run[i] = i;
+
+    for (int i=0; i<num; ++i)
+    {
+        const Crossing& ci = crossings[i];
+
+        for (int j=i+1; j<num; ++j)
+        {
+            const Crossing& cj = crossings[j];
+
+            if ((ci.a == cj.a || G.isEdgePresent(ci.a, cj.a)) &&
+                (ci.b == cj.b || G.isEdgePresent(ci.b, cj.b)))
+            {
+                int ri = i; while (run[ri] != ri) ri = run[ri];
+                int rj = j; while (run[rj] != rj) rj = run[rj];
+
+                if (ri < rj) run[rj] = ri; else if (rj < ri) run[ri] = rj;
+            }
+        }
+    }
+
+    //the crossings of a run have the lowest index of the run as their root
+    for (int r=0; r<num; ++r)
+    {
+        int root = r; while (run[root] != root) root = run[root];
+        if (root != r) continue;
+
+        //find the middle of the run, and the crossing closest to it
+        Vector2D mid;
+        int count = 0;
+        for (int i=r; i<num; ++i)
+        {
+            int ri = i; while (run[ri] != ri) ri = run[ri];
+            if (ri != r) continue;
+
+            const Crossing& c = crossings[i];
+            mid += (G.getNode(c.a).getPos() + G.getNode(c.b).getPos()) * 0.5f;
+            ++count;
+        }
+        mid /= (float)count;
+
+        int best = -1;
+        float bestDist = FloatMax;
+        for (int i=r; i<num; ++i)
+        {
+            int ri = i; while (run[ri] != ri) ri = run[ri];
+            if (ri != r) continue;
+
+            const Crossing& c = crossings[i];
+            float dist = Vec2DistanceSq(mid, (G.getNode(c.a).getPos() + G.getNode(c.b).getPos()) * 0.5f);
+
+            if (dist < bestDist)
+            {
+                bestDist = dist;
+                best = i;
+            }
+        }
+
+        const Crossing& c = crossings[best];
+
+        int from = entranceAt(c.a, abstractGraph);
+        int to   = entranceAt(c.b, abstractGraph);
+
+        abstractGraph.addEdge(GraphEdge(from, to, G.getEdge(c.a, c.b).cost()));
+    }
+}
+
+//---------------------------- searchClusters ---------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void ClusterGraph<graph_type>::searchClusters(int source, int target, int c1, int c2, Workspace& W)const
+{
+    const graph_type& G = *m_pGraph;
+
+    Vector2D TargetPos;
+    if (target != -1) TargetPos = G.getNode(target).getPos();
+
+    typename Workspace::Queue& pq = W.getQueue();
+
+    W.reach(source, 0.0f, 0.0f, NULL);
+    pq.insert(source);
+
+    while (!pq.isEmpty())
+    {
+        int NextClosestNode = pq.pop();
+
+        W.addToTree(NextClosestNode);
+
+        if (NextClosestNode == target) return;
+
+        float CostToThisNode = W.getGCost(NextClosestNode);
+
+        typename graph_type::ConstEdgeIterator ConstEdgeItr(G, NextClosestNode);
+        for (const Edge* pE=ConstEdgeItr.begin(); !ConstEdgeItr.end(); pE=ConstEdgeItr.next())
+        {
+            int to = ConstEdgeItr.to();
+
+            //stay inside the clusters
+            if (m_ClusterOfNode[to] != c1 && m_ClusterOfNode[to] != c2) continue;
+
+            float GCost = CostToThisNode + ConstEdgeItr.cost();
+            float HCost = (target == -1) ? 0.0f : Vec2Distance(G.getNode(to).getPos(), TargetPos);
+
+            if (!W.isReached(to))
+            {
+                W.reach(to, GCost, GCost + HCost, pE);
+
+                pq.insert(to);
+            }
+            else if ((GCost < W.getGCost(to)) && (W.getTreeEdgeOfReached(to)==NULL))
+            {
+                W.improve(to, GCost, GCost + HCost, pE);
+
+                pq.changePriority(to);
+            }
+        }
+    }
+}
+
+//----------------------------- findWaypoints ---------------------------------
+//
+//  source and target are joined to the entrances of their clusters by the
+//  costs of the paths inside the clusters, and to each other as well if
+//  they share a cluster. A* then runs over the entrances with the target
+//  added as one more node, reached from the entrances of its cluster.
+//-----------------------------------------------------------------------------
+template <class graph_type>
+bool ClusterGraph<graph_type>::findWaypoints(int source, int target, std::vector<int>& waypoints, float& cost)const
+{
+    const graph_type& G = *m_pGraph;
+
+    waypoints.clear();
+
+    int SourceCluster = m_ClusterOfNode[source];
+    int TargetCluster = m_ClusterOfNode[target];
+
+    //the costs from source to the entrances of its cluster, and from those
+    //of the target's cluster to the target
+    std::vector<float> SourceCosts(m_ClusterFirst[SourceCluster+1] - m_ClusterFirst[SourceCluster], -1.0f);
+    std::vector<float> TargetCosts(m_ClusterFirst[TargetCluster+1] - m_ClusterFirst[TargetCluster], -1.0f);
+
+    float DirectCost = -1.0f;
+
+    Workspace* pW = Workspace::acquire(&G, G.getNumNodes());
+
+    searchClusters(source, -1, SourceCluster, SourceCluster, *pW);
+
+    for (unsigned int i=0; i<SourceCosts.size(); ++i)
+    {
+        int node = m_EntranceNode[m_ClusterEntrances[m_ClusterFirst[SourceCluster]+i]];
+        if (pW->isReached(node)) SourceCosts[i] = pW->getCost(node);
+    }
+
+    if (SourceCluster == TargetCluster && pW->isReached(target))
+    {
+        DirectCost = pW->getCost(target);
+    }
+
+    //the graph is not a digraph, so the costs from the target are those to it
+    pW->begin(G.getNumNodes());
+    searchClusters(target, -1, TargetCluster, TargetCluster, *pW);
+
+    for (unsigned int i=0; i<TargetCosts.size(); ++i)
+    {
+        int node = m_EntranceNode[m_ClusterEntrances[m_ClusterFirst[TargetCluster]+i]];
+        if (pW->isReached(node)) TargetCosts[i] = pW->getCost(node);
+    }
+
+    //the path straight through both clusters, when they are neighbors
+    if (areNeighbors(SourceCluster, TargetCluster))
+    {
+        pW->begin(G.getNumNodes());
+        searchClusters(source, target, SourceCluster, TargetCluster, *pW);
+
+        if (pW->isReached(target)) DirectCost = pW->getCost(target);
+    }
+
+    Workspace::release(pW);
+
+    //A* over the entrances. The target is node Goal of the search
+    const int Goal = m_AbstractGraph.getNumNodes();
+    Vector2D TargetPos = G.getNode(target).getPos();
+
+    AbstractWorkspace* pA = AbstractWorkspace::acquire(&m_AbstractGraph, Goal+1);
+    typename AbstractWorkspace::Queue& pq = pA->getQueue();
+
+    //the entrance the best path found to the target comes from, -1 if it is
+    //the path inside the shared cluster
+    int GoalVia = -1;
+
+    if (DirectCost >= 0.0f)
+    {
+        pA->reach(Goal, DirectCost, DirectCost, NULL);
+        pq.insert(Goal);
+    }
+
+    for (unsigned int i=0; i<SourceCosts.size(); ++i)
+    {
+        if (SourceCosts[i] < 0.0f) continue;
+
+        int e = m_ClusterEntrances[m_ClusterFirst[SourceCluster]+i];
+        float HCost = Vec2Distance(m_AbstractGraph.getNode(e).getPos(), TargetPos);
+
+        pA->reach(e, SourceCosts[i], SourceCosts[i] + HCost, NULL);
+        pq.insert(e);
+    }
+
+    bool bFound = false;
+
+    while (!pq.isEmpty())
+    {
+        int NextClosestNode = pq.pop();
+
+        pA->addToTree(NextClosestNode);
+
+        if (NextClosestNode == Goal)
+        {
+            bFound = true;
+            break;
+        }
+
+        float CostToThisNode = pA->getGCost(NextClosestNode);
+
+        //the entrances of the target's cluster lead on to the target
+        if (m_ClusterOfNode[m_EntranceNode[NextClosestNode]] == TargetCluster)
+        {
+            float ToTarget = TargetCosts[std::find(m_ClusterEntrances.begin() + m_ClusterFirst[TargetCluster],
+                                                   m_ClusterEntrances.begin() + m_ClusterFirst[TargetCluster+1],
+                                                   NextClosestNode) - (m_ClusterEntrances.begin() + m_ClusterFirst[TargetCluster])];
+
+            if (ToTarget >= 0.0f)
+            {
+                float GCost = CostToThisNode + ToTarget;
+
+                if (!pA->isReached(Goal))
+                {
+                    pA->reach(Goal, GCost, GCost, NULL);
+                    pq.insert(Goal);
+                    GoalVia = NextClosestNode;
+                }
+                else if (GCost < pA->getGCost(Goal))
+                {
+                    pA->improve(Goal, GCost, GCost, NULL);
+                    pq.changePriority(Goal);
+                    GoalVia = NextClosestNode;
+                }
+            }
+        }
+
+        AbstractGraph::ConstEdgeIterator ConstEdgeItr(m_AbstractGraph, NextClosestNode);
+        for (const GraphEdge* pE=ConstEdgeItr.begin(); !ConstEdgeItr.end(); pE=ConstEdgeItr.next())
+        {
+            int to = ConstEdgeItr.to();
+
+            float GCost = CostToThisNode + ConstEdgeItr.cost();
+            float HCost = Vec2Distance(m_AbstractGraph.getNode(to).getPos(), TargetPos);
+
+            if (!pA->isReached(to))
+            {
+                pA->reach(to, GCost, GCost + HCost, pE);
+
+                pq.insert(to);
+            }
+            else if ((GCost < pA->getGCost(to)) && (pA->getTreeEdgeOfReached(to)==NULL))
+            {
+                pA->improve(to, GCost, GCost + HCost, pE);
+
+                pq.changePriority(to);
+            }
+        }
+    }
+
+    if (bFound)
+    {
+        cost = pA->getGCost(Goal);
+
+        //work back from the target to the entrance the path started from
+        waypoints.push_back(target);
+
+        for (int e = GoalVia; e != -1; )
+        {
+            if (m_EntranceNode[e] != waypoints.back()) waypoints.push_back(m_EntranceNode[e]);
+
+            const GraphEdge* pE = pA->getTreeEdge(e);
+            e = pE ? pE->from() : -1;
+        }
+
+        if (waypoints.back() != source) waypoints.push_back(source);
+
+        std::reverse(waypoints.begin(), waypoints.end());
+    }
+
+    AbstractWorkspace::release(pA);
+
+    return bFound;
+}
+
+//-------------------------------- refine -------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+bool ClusterGraph<graph_type>::refine(int from, int to, std::vector<const Edge*>& edges)const
+{
+    const graph_type& G = *m_pGraph;
+
+    if (from == to) return true;
+
+    int FromCluster = m_ClusterOfNode[from];
+    int ToCluster   = m_ClusterOfNode[to];
+
+    //a leg from one entrance to the entrance across the border is the edge
+    //between them
+    if (FromCluster != ToCluster &&
+        m_EntranceOfNode[from] != -1 && m_EntranceOfNode[to] != -1 &&
+        G.isEdgePresent(from, to))
+    {
+        edges.push_back(&G.getEdge(from, to));
+
+        return true;
+    }
+
+    //any other leg is inside a cluster, or straight through two neighbors
+    Workspace* pW = Workspace::acquire(&G, G.getNumNodes());
+
+    searchClusters(from, to, FromCluster, ToCluster, *pW);
+
+    bool bFound = pW->isReached(to);
+
+    if (bFound)
+    {
+        std::vector<const Edge*> path;
+
+        for (int nd = to; nd != from; nd = pW->getTreeEdge(nd)->from())
+        {
+            path.push_back(pW->getTreeEdge(nd));
+        }
+
+        edges.insert(edges.end(), path.rbegin(), path.rend());
+    }
+
+    Workspace::release(pW);
+
+    return bFound;
+}
+
+//------------------------------ cycleOnce ------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+int Graph_SearchHierarchical_TS<graph_type>::cycleOnce()
+{
+    if (m_iResult == search_incomplete)
+    {
+        m_iResult = m_Clusters.findWaypoints(m_iSource, m_iTarget, m_Waypoints, m_fCost) ? target_found : target_not_found;
+    }
+
+    return m_iResult;
+}
+
+//------------------------------ appendLeg ------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void Graph_SearchHierarchical_TS<graph_type>::appendLeg(int w, std::list<PathEdge>& path)const
+{
+    const graph_type& G = m_Clusters.getGraph();
+
+    std::vector<const Edge*> edges;
+    m_Clusters.refine(m_Waypoints[w], m_Waypoints[w+1], edges);
+
+    for (unsigned int e=0; e<edges.size(); ++e)
+    {
+        path.push_back(PathEdge(G.getNode(edges[e]->from()).getPos(),
+                                G.getNode(edges[e]->to()).getPos(),
+                                edges[e]->getFlags(),
+                                edges[e]->getIntersectingEntityID()));
+    }
+}
+
+//-------------------------- getPathAsPathEdges -------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+std::list<PathEdge> Graph_SearchHierarchical_TS<graph_type>::getPathAsPathEdges()const
+{
+    std::list<PathEdge> path;
+
+    for (int w=0; w+1<(int)m_Waypoints.size(); ++w)
+    {
+        appendLeg(w, path);
+    }
+
+    return path;
+}
+
+//-------------------------- getNextPathSegment -------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+std::list<PathEdge> Graph_SearchHierarchical_TS<graph_type>::getNextPathSegment()
+{
+    std::list<PathEdge> path;
+
+    while (isPathPartial())
+    {
+        int w = m_iNextWaypoint++;
+
+        appendLeg(w, path);
+
+        //a leg inside a cluster is a segment of its own
+        if (m_Clusters.getCluster(m_Waypoints[w]) == m_Clusters.getCluster(m_Waypoints[w+1])) break;
+    }
+
+    return path;
+}
+
+
+#endif
@@ -11,7 +11,11 @@
 //          by Robert Sedgewick in his book "Algorithms in C++")
 //
 //          Any graphs passed to these functions must conform to the
-//          same interface used by the SparseGraph
+//          same interface used by the SparseGraph (FrozenGraph does)
+//
+//          The last template parameter of Graph_SearchDijkstra and
+//          Graph_SearchAStar is the open list, SearchOpenList unless
+//          another of the indexed queues in PriorityQueue.h is given.
 //          
 //
 //------------------------------------------------------------------------
@@ -22,6 +26,7 @@
 
 #include "../graph/SparseGraph.h"
 #include "../misc/PriorityQueue.h"
+#include "SearchWorkspace.h"
 
 
 //----------------------------- Graph_SearchDFS -------------------------------
@@ -135,7 +140,7 @@ bool Graph_SearchDFS<graph_type>::search()
         //push the edges leading from the node this edge points to onto
         //the stack (provided the edge does not point to a previously 
         //visited node)
-        graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, Next->to());
+        typename graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, Next->to());
 
         for (const Edge* pE=ConstEdgeItr.begin(); !ConstEdgeItr.end(); pE=ConstEdgeItr.next())
         {
@@ -283,7 +288,7 @@ bool Graph_SearchBFS<graph_type>::search()
 
         //push the edges leading from the node at the end of this edge 
         //onto the queue
-        graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, Next->to());
+        typename graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, Next->to());
 
         for (const Edge* pE=ConstEdgeItr.begin();!ConstEdgeItr.end(); pE=ConstEdgeItr.next())
         {
@@ -342,53 +347,48 @@ std::list<int> Graph_SearchBFS<graph_type>::getPathToTarget()const
 //  
 //  float NewCost = m_CostToThisNode[best] + pE->Cost;
 //------------------------------------------------------------------------
-template <class graph_type>
+template <class graph_type, class open_list = SearchOpenList>
 class Graph_SearchDijkstra
 {
 private:
     //create a typedef for the edge type used by the graph
     typedef typename graph_type::EdgeType Edge;
+    typedef SearchWorkspace<Edge, open_list> Workspace;
   
     const graph_type& m_Graph;
 
-    //this vector contains the edges that comprise the shortest path tree -
-    //a directed subtree of the graph that encapsulates the best paths from 
-    //every node on the SPT to the source node.
-    std::vector<const Edge*> m_ShortestPathTree;
-
-    //this is indexed into by node index and holds the total cost of the best
-    //path found so far to the given node. For example, m_CostToThisNode[5]
-    //will hold the total cost of all the edges that comprise the best path
-    //to node 5, found so far in the search (if node 5 is present and has 
-    //been visited)
-    std::vector<float> m_CostToThisNode; 
-
-    //this is an indexed (by node) vector of 'parent' edges leading to nodes 
-    //connected to the SPT but that have not been added to the SPT yet. This is
-    //a little like the stack or queue used in BST and DST searches.
-    std::vector<const Edge*> m_SearchFrontier;
+    //holds, for each node, the total cost of the best path found so far to
+    //it, the 'parent' edge of the nodes on the frontier (connected to the
+    //SPT but not added to it yet) and the edges that comprise the shortest
+    //path tree - a directed subtree of the graph that encapsulates the best
+    //paths from every node on the SPT to the source node. Dijkstra has no
+    //heuristic, so the G and F costs of a node are the same.
+    Workspace* m_pWork;
 
     int m_iSource;
     int m_iTarget;
 
     void search();  
+
+    Graph_SearchDijkstra(const Graph_SearchDijkstra&);
+    Graph_SearchDijkstra& operator=(const Graph_SearchDijkstra&);
     
 public:
     Graph_SearchDijkstra(const graph_type& graph, int source, int target = -1):m_Graph(graph),
-                                                               m_ShortestPathTree(graph.getNumNodes()),                              
-                                                               m_SearchFrontier(graph.getNumNodes()),
-                                                               m_CostToThisNode(graph.getNumNodes()),
+                                                               m_pWork(Workspace::acquire(&graph, graph.getNumNodes())),
                                                                m_iSource(source),
                                                                m_iTarget(target)
     {                                           
         search();     
     }
+
+    ~Graph_SearchDijkstra(){Workspace::release(m_pWork);}
  
     //returns the vector of edges that defines the SPT. If a target was given
     //in the constructor then this will be an SPT comprising of all the nodes
     //examined before the target was found, else it will contain all the nodes
     //in the graph.
-    std::vector<const Edge*> getSPT()const{return m_ShortestPathTree;}
+    std::vector<const Edge*> getSPT()const{return m_pWork->getSPT();}
 
     //returns a vector of node indexes that comprise the shortest path
     //from the source to the target. It calculates the path by working
@@ -396,29 +396,32 @@ public:
     std::list<int> getPathToTarget()const;
 
     //returns the total cost to the target
-    float getCostToTarget()const{return m_CostToThisNode[m_iTarget];}
+    float getCostToTarget()const{return m_pWork->getCost(m_iTarget);}
 
     //returns the total cost to the given node
-    float getCostToNode(unsigned int nd)const{return m_CostToThisNode[nd];}
+    float getCostToNode(unsigned int nd)const{return m_pWork->getCost(nd);}
 
 };
 
 
 //-----------------------------------------------------------------------------
-template <class graph_type>
-void Graph_SearchDijkstra<graph_type>::search()
+template <class graph_type, class open_list>
+void Graph_SearchDijkstra<graph_type, open_list>::search()
 {
-    //create an indexed priority queue that sorts smallest to largest
+    Workspace& W = *m_pWork;
+
+    //the workspace's indexed priority queue sorts smallest to largest
     //(front to back).Note that the maximum number of elements the iPQ
     //may contain is N. This is because no node can be represented on the 
     //queue more than once.
-    indexedPriorityQLow<float> pq(m_CostToThisNode, m_Graph.getNumNodes());
+    typename Workspace::Queue& pq = W.getQueue();
 
     //put the source node on the queue
+    W.reach(m_iSource, 0.0f, 0.0f, NULL);
     pq.insert(m_iSource);
 
     //while the queue is not empty
-    while(!pq.empty())
+    while(!pq.isEmpty())
     {
         //get lowest cost node from the queue. Don't forget, the return value
         //is a *node index*, not the node itself. This node is the node not already
@@ -426,31 +429,33 @@ void Graph_SearchDijkstra<graph_type>::search()
         int NextClosestNode = pq.pop();
 
         //move this edge from the frontier to the shortest path tree
-        m_ShortestPathTree[NextClosestNode] = m_SearchFrontier[NextClosestNode];
+        W.addToTree(NextClosestNode);
 
         //if the target has been found exit
         if (NextClosestNode == m_iTarget) return;
 
+        float CostToThisNode = W.getGCost(NextClosestNode);
+
         //now to relax the edges.
-        graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, NextClosestNode);
+        typename graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, NextClosestNode);
 
         //for each edge connected to the next closest node
         for (const Edge* pE=ConstEdgeItr.begin(); !ConstEdgeItr.end(); pE=ConstEdgeItr.next())
         {
+            int to = ConstEdgeItr.to();
+
             //the total cost to the node this edge points to is the cost to the
             //current node plus the cost of the edge connecting them.
-            float NewCost = m_CostToThisNode[NextClosestNode] + pE->getCost();
+            float NewCost = CostToThisNode + ConstEdgeItr.cost();
 
             //if this edge has never been on the frontier make a note of the cost
             //to get to the node it points to, then add the edge to the frontier
             //and the destination node to the PQ.
-            if (m_SearchFrontier[pE->to()] == 0)
+            if (!W.isReached(to))
             {
-                m_CostToThisNode[pE->to()] = NewCost;
-
-                pq.insert(pE->to());
+                W.reach(to, NewCost, NewCost, pE);
 
-                m_SearchFrontier[pE->to()] = pE;
+                pq.insert(to);
             }
 
             //else test to see if the cost to reach the destination node via the
@@ -458,23 +463,21 @@ void Graph_SearchDijkstra<graph_type>::search()
             //this path is cheaper, we assign the new cost to the destination
             //node, update its entry in the PQ to reflect the change and add the
             //edge to the frontier
-            else if ( (NewCost < m_CostToThisNode[pE->to()]) && (m_ShortestPathTree[pE->to()] == 0) )
+            else if ( (NewCost < W.getGCost(to)) && (W.getTreeEdgeOfReached(to) == 0) )
             {
-                m_CostToThisNode[pE->to()] = NewCost;
+                W.improve(to, NewCost, NewCost, pE);
 
                 //because the cost is less than it was previously, the PQ must be
                 //re-sorted to account for this.
-                pq.ChangePriority(pE->to());
-
-                m_SearchFrontier[pE->to()] = pE;
+                pq.changePriority(to);
             }
         }
     }
 }
 
 //-----------------------------------------------------------------------------
-template <class graph_type>
-std::list<int> Graph_SearchDijkstra<graph_type>::getPathToTarget()const
+template <class graph_type, class open_list>
+std::list<int> Graph_SearchDijkstra<graph_type, open_list>::getPathToTarget()const
 {
     std::list<int> path;
 
@@ -485,9 +488,9 @@ std::list<int> Graph_SearchDijkstra<graph_type>::getPathToTarget()const
 
     path.push_front(nd);
 
-    while ((nd != m_iSource) && (m_ShortestPathTree[nd] != 0))
+    while ((nd != m_iSource) && (m_pWork->getTreeEdge(nd) != 0))
     {
-        nd = m_ShortestPathTree[nd]->from();
+        nd = m_pWork->getTreeEdge(nd)->from();
 
         path.push_front(nd);
     }
@@ -502,124 +505,122 @@ std::list<int> Graph_SearchDijkstra<graph_type>::getPathToTarget()const
 //
 //  This search is more commonly known as A* (pronounced Ay-Star)
 //-----------------------------------------------------------------------------
-template <class graph_type, class heuristic>
+template <class graph_type, class heuristic, class open_list = SearchOpenList>
 class Graph_SearchAStar
 {
 private:
     //create a typedef for the edge type used by the graph
     typedef typename graph_type::EdgeType Edge;
+    typedef SearchWorkspace<Edge, open_list> Workspace;
 
 
     const graph_type& m_Graph;
 
-    //indexed into my node. Contains the 'real' accumulative cost to that node
-    std::vector<float> m_GCosts; 
-
-    //indexed into by node. Contains the cost from adding m_GCosts[n] to
-    //the heuristic cost from n to the target node. This is the vector the
-    //iPQ indexes into.
-    std::vector<float> m_FCosts;
-
-    std::vector<const Edge*> m_ShortestPathTree;
-    std::vector<const Edge*> m_SearchFrontier;
+    //holds, for each node, the 'real' accumulative cost to that node (G),
+    //G plus the heuristic cost from the node to the target (F, which the
+    //iPQ is ordered by) and its frontier and SPT edges
+    Workspace* m_pWork;
 
     int m_iSource;
     int m_iTarget;
 
     //the A* search algorithm
     void search();
+
+    Graph_SearchAStar(const Graph_SearchAStar&);
+    Graph_SearchAStar& operator=(const Graph_SearchAStar&);
     
 public:
-    Graph_SearchAStar(graph_type &graph, int source, int target):m_Graph(graph),
-                                              m_ShortestPathTree(graph.getNumNodes()),                              
-                                              m_SearchFrontier(graph.getNumNodes()),
-                                              m_GCosts(graph.getNumNodes(), 0.0),
-                                              m_FCosts(graph.getNumNodes(), 0.0),
+    Graph_SearchAStar(const graph_type& graph, int source, int target):m_Graph(graph),
+                                              m_pWork(Workspace::acquire(&graph, graph.getNumNodes())),
                                               m_iSource(source),
                                               m_iTarget(target)
     {
         search();   
     }
+
+    ~Graph_SearchAStar(){Workspace::release(m_pWork);}
  
     //returns the vector of edges that the algorithm has examined
-    std::vector<const Edge*> getSPT()const{return m_ShortestPathTree;}
+    std::vector<const Edge*> getSPT()const{return m_pWork->getSPT();}
 
     //returns a vector of node indexes that comprise the shortest path
     //from the source to the target
     std::list<int> getPathToTarget()const;
 
     //returns the total cost to the target
-    float getCostToTarget()const{return m_GCosts[m_iTarget];}
+    float getCostToTarget()const{return m_pWork->getCost(m_iTarget);}
 
 };
 
 //-----------------------------------------------------------------------------
-template <class graph_type, class heuristic>
-void Graph_SearchAStar<graph_type, heuristic>::search()
+template <class graph_type, class heuristic, class open_list>
+void Graph_SearchAStar<graph_type, heuristic, open_list>::search()
 {
-    //create an indexed priority queue of nodes. The nodes with the
+    Workspace& W = *m_pWork;
+
+    //the workspace's indexed priority queue of nodes. The nodes with the
     //lowest overall F cost (G+H) are positioned at the front.
-    indexedPriorityQLow<float> pq(m_FCosts, m_Graph.getNumNodes());
+    typename Workspace::Queue& pq = W.getQueue();
 
     //put the source node on the queue
+    W.reach(m_iSource, 0.0f, 0.0f, NULL);
     pq.insert(m_iSource);
 
     //while the queue is not empty
-    while(!pq.empty())
+    while(!pq.isEmpty())
     {
         //get lowest cost node from the queue
         int NextClosestNode = pq.pop();
 
         //move this node from the frontier to the spanning tree
-        m_ShortestPathTree[NextClosestNode] = m_SearchFrontier[NextClosestNode];
+        W.addToTree(NextClosestNode);
 
         //if the target has been found exit
         if (NextClosestNode == m_iTarget) return;
 
+        float CostToThisNode = W.getGCost(NextClosestNode);
+
         //now to test all the edges attached to this node
-        graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, NextClosestNode);
+        typename graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, NextClosestNode);
 
         for (const Edge* pE=ConstEdgeItr.begin();
         !ConstEdgeItr.end(); 
         pE=ConstEdgeItr.next())
         {
+            int to = ConstEdgeItr.to();
+
             //calculate the heuristic cost from this node to the target (H)                       
-            float HCost = heuristic::Calculate(m_Graph, m_iTarget, pE->to()); 
+            float HCost = heuristic::calculate(m_Graph, m_iTarget, to); 
 
             //calculate the 'real' cost to this node from the source (G)
-            float GCost = m_GCosts[NextClosestNode] + pE->getCost();
+            float GCost = CostToThisNode + ConstEdgeItr.cost();
 
             //if the node has not been added to the frontier, add it and update
             //the G and F costs
-            if (m_SearchFrontier[pE->to()] == NULL)
+            if (!W.isReached(to))
             {
-                m_FCosts[pE->to()] = GCost + HCost;
-                m_GCosts[pE->to()] = GCost;
+                W.reach(to, GCost, GCost + HCost, pE);
 
-                pq.insert(pE->to());
-
-                m_SearchFrontier[pE->to()] = pE;
+                pq.insert(to);
             }
 
             //if this node is already on the frontier but the cost to get here
             //is cheaper than has been found previously, update the node
             //costs and frontier accordingly.
-            else if ((GCost < m_GCosts[pE->to()]) && (m_ShortestPathTree[pE->to()]==NULL))
+            else if ((GCost < W.getGCost(to)) && (W.getTreeEdgeOfReached(to)==NULL))
             {
-                m_FCosts[pE->to()] = GCost + HCost;
-                m_GCosts[pE->to()] = GCost;
-
-                pq.ChangePriority(pE->to());
+                W.improve(to, GCost, GCost + HCost, pE);
 
-                m_SearchFrontier[pE->to()] = pE;
+                pq.changePriority(to);
             }
         }
     }
 }
 
 //-----------------------------------------------------------------------------
-template <class graph_type, class heuristic>
-std::list<int> Graph_SearchAStar<graph_type, heuristic>::getPathToTarget()const
+template <class graph_type, class heuristic, class open_list>
+std::list<int> Graph_SearchAStar<graph_type, heuristic, open_list>::getPathToTarget()const
 {
     std::list<int> path;
 
@@ -630,9 +631,9 @@ std::list<int> Graph_SearchAStar<graph_type, heuristic>::getPathToTarget()const
 
     path.push_front(nd);
     
-    while ((nd != m_iSource) && (m_ShortestPathTree[nd] != 0))
+    while ((nd != m_iSource) && (m_pWork->getTreeEdge(nd) != 0))
     {
-        nd = m_ShortestPathTree[nd]->from();
+        nd = m_pWork->getTreeEdge(nd)->from();
 
         path.push_front(nd);
     }
@@ -673,7 +674,7 @@ private:
         pq.insert(source);
 
         //while the queue is not empty
-        while(!pq.empty())
+        while(!pq.isEmpty())
         {
             //get lowest cost edge from the queue
             int best = pq.pop();
@@ -682,7 +683,7 @@ private:
             m_SpanningTree[best] = m_Fringe[best];
 
             //now to test the edges attached to this node
-            graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, best);
+            typename graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, best);
 
             for (const Edge* pE=ConstEdgeItr.beg(); !ConstEdgeItr.end(); pE=ConstEdgeItr.nxt())
             {
@@ -701,7 +702,7 @@ private:
                 {
                     m_CostToThisNode[pE->to()] = Priority;
 
-                    pq.ChangePriority(pE->to());
+                    pq.changePriority(pE->to());
 
                     m_Fringe[pE->to()] = pE;
                 }
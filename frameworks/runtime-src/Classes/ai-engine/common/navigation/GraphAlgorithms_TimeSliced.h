@@ -10,6 +10,14 @@
 //
 //          Any graphs passed to these functions must conform to the
 //          same interface used by the SparseGraph
+//
+//          A search holds a SearchWorkspace from the pool from when it is
+//          created until it is destroyed, so delete searches that are done
+//          with rather than keeping them around.
+//
+//          The last template parameter of the searches is the open list,
+//          SearchOpenList unless another of the indexed queues in
+//          PriorityQueue.h is given.
 //          
 //
 //------------------------------------------------------------------------
@@ -19,6 +27,7 @@
 #include <stack>
 
 #include "common/misc/PriorityQueue.h"
+#include "common/navigation/SearchWorkspace.h"
 #include "common/navigation/SearchTerminationPolicies.h"
 #include "common/navigation/PathEdge.h"
 
@@ -79,7 +88,7 @@ private:
 //
 //  a A* class that enables a search to be completed over multiple update-steps
 //-----------------------------------------------------------------------------
-template <class graph_type, class heuristic>
+template <class graph_type, class heuristic, class open_list = SearchOpenList>
 class Graph_SearchAStar_TS : public Graph_SearchTimeSliced<typename graph_type::EdgeType>
 {
 private:
@@ -87,47 +96,38 @@ private:
     typedef typename graph_type::EdgeType Edge;
     typedef typename graph_type::NodeType Node;
 
+    typedef SearchWorkspace<Edge, open_list> Workspace;
+
 private:
     const graph_type& m_Graph;
 
-    //indexed into my node. Contains the 'real' accumulative cost to that node
-    std::vector<float> m_GCosts; 
-
-    //indexed into by node. Contains the cost from adding m_GCosts[n] to
-    //the heuristic cost from n to the target node. This is the vector the
-    //iPQ indexes into.
-    std::vector<float> m_FCosts;
-
-    std::vector<const Edge*> m_ShortestPathTree;
-    std::vector<const Edge*> m_SearchFrontier;
+    //holds, for each node, the 'real' accumulative cost to that node (G),
+    //G plus the heuristic cost from the node to the target (F) and its
+    //frontier and SPT edges, and the indexed priority queue of nodes. The
+    //nodes with the lowest overall F cost (G+H) are positioned at the front.
+    Workspace* m_pWork;
 
     int m_iSource;
     int m_iTarget;
 
-    //create an indexed priority queue of nodes. The nodes with the
-    //lowest overall F cost (G+H) are positioned at the front.
-    indexedPriorityQLow<float>* m_pPQ;
+    Graph_SearchAStar_TS(const Graph_SearchAStar_TS&);
+    Graph_SearchAStar_TS& operator=(const Graph_SearchAStar_TS&);
 
 public:
     Graph_SearchAStar_TS(const graph_type& G,
                                                     int source,
-                                                    int target):Graph_SearchTimeSliced<Edge>(AStar),
+                                                    int target):Graph_SearchTimeSliced<Edge>(Graph_SearchTimeSliced<Edge>::AStar),
                                                     m_Graph(G),
-                                                    m_ShortestPathTree(G.NumNodes()),                              
-                                                    m_SearchFrontier(G.NumNodes()),
-                                                    m_GCosts(G.NumNodes(), 0.0),
-                                                    m_FCosts(G.NumNodes(), 0.0),
+                                                    m_pWork(Workspace::acquire(&G, G.getNumNodes())),
                                                     m_iSource(source),
                                                     m_iTarget(target)
     { 
-        //create the PQ   
-        m_pPQ =new indexedPriorityQLow<float>(m_FCosts, m_Graph.NumNodes());
-
         //put the source node on the queue
-        m_pPQ->insert(m_iSource);
+        m_pWork->reach(m_iSource, 0.0f, 0.0f, NULL);
+        m_pWork->getQueue().insert(m_iSource);
     }
 
-    ~Graph_SearchAStar_TS(){delete m_pPQ;}
+    ~Graph_SearchAStar_TS(){Workspace::release(m_pWork);}
 
     //When called, this method pops the next node off the PQ and examines all
     //its edges. The method returns an enumerated value (target_found,
@@ -135,7 +135,7 @@ public:
     int cycleOnce();
 
     //returns the vector of edges that the algorithm has examined
-    std::vector<const Edge*> getSPT()const{return m_ShortestPathTree;}
+    std::vector<const Edge*> getSPT()const{return m_pWork->getSPT();}
 
     //returns a vector of node indexes that comprise the shortest path
     //from the source to the target
@@ -145,24 +145,27 @@ public:
     std::list<PathEdge> getPathAsPathEdges()const;
 
     //returns the total cost to the target
-    float getCostToTarget()const{return m_GCosts[m_iTarget];}
+    float getCostToTarget()const{return m_pWork->getCost(m_iTarget);}
 };
 
 //-----------------------------------------------------------------------------
-template <class graph_type, class heuristic>
-int Graph_SearchAStar_TS<graph_type, heuristic>::cycleOnce()
+template <class graph_type, class heuristic, class open_list>
+int Graph_SearchAStar_TS<graph_type, heuristic, open_list>::cycleOnce()
 {
+    Workspace& W = *m_pWork;
+    typename Workspace::Queue& pq = W.getQueue();
+
     //if the PQ is empty the target has not been found
-    if (m_pPQ->empty())
+    if (pq.isEmpty())
     {
         return target_not_found;
     }
 
     //get lowest cost node from the queue
-    int NextClosestNode = m_pPQ->pop();
+    int NextClosestNode = pq.pop();
 
     //put the node on the SPT
-    m_ShortestPathTree[NextClosestNode] = m_SearchFrontier[NextClosestNode];
+    W.addToTree(NextClosestNode);
 
     //if the target has been found exit
     if (NextClosestNode == m_iTarget)
@@ -170,39 +173,37 @@ int Graph_SearchAStar_TS<graph_type, heuristic>::cycleOnce()
         return target_found;
     }
 
+    float CostToThisNode = W.getGCost(NextClosestNode);
+
     //now to test all the edges attached to this node
-    graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, NextClosestNode);
+    typename graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, NextClosestNode);
     for (const Edge* pE=ConstEdgeItr.begin();!ConstEdgeItr.end();pE=ConstEdgeItr.next())
     {
+        int to = ConstEdgeItr.to();
+
         //calculate the heuristic cost from this node to the target (H)                       
-        float HCost = heuristic::calculate(m_Graph, m_iTarget, pE->to()); 
+        float HCost = heuristic::calculate(m_Graph, m_iTarget, to); 
 
         //calculate the 'real' cost to this node from the source (G)
-        float GCost = m_GCosts[NextClosestNode] + pE->cost();
+        float GCost = CostToThisNode + ConstEdgeItr.cost();
 
         //if the node has not been added to the frontier, add it and update
         //the G and F costs
-        if (m_SearchFrontier[pE->to()] == NULL)
+        if (!W.isReached(to))
         {
-            m_FCosts[pE->to()] = GCost + HCost;
-            m_GCosts[pE->to()] = GCost;
-
-            m_pPQ->insert(pE->to());
+            W.reach(to, GCost, GCost + HCost, pE);
 
-            m_SearchFrontier[pE->to()] = pE;
+            pq.insert(to);
         }
 
         //if this node is already on the frontier but the cost to get here
         //is cheaper than has been found previously, update the node
         //costs and frontier accordingly.
-        else if ((GCost < m_GCosts[pE->to()]) && (m_ShortestPathTree[pE->to()]==NULL))
+        else if ((GCost < W.getGCost(to)) && (W.getTreeEdgeOfReached(to)==NULL))
         {
-            m_FCosts[pE->to()] = GCost + HCost;
-            m_GCosts[pE->to()] = GCost;
+            W.improve(to, GCost, GCost + HCost, pE);
 
-            m_pPQ->ChangePriority(pE->to());
-
-            m_SearchFrontier[pE->to()] = pE;
+            pq.changePriority(to);
         }
     }
   
@@ -211,8 +212,8 @@ int Graph_SearchAStar_TS<graph_type, heuristic>::cycleOnce()
 }
 
 //-----------------------------------------------------------------------------
-template <class graph_type, class heuristic>
-std::list<int> Graph_SearchAStar_TS<graph_type, heuristic>::getPathToTarget()const
+template <class graph_type, class heuristic, class open_list>
+std::list<int> Graph_SearchAStar_TS<graph_type, heuristic, open_list>::getPathToTarget()const
 {
     std::list<int> path;
 
@@ -223,9 +224,9 @@ std::list<int> Graph_SearchAStar_TS<graph_type, heuristic>::getPathToTarget()con
 
     path.push_back(nd);
     
-    while ((nd != m_iSource) && (m_ShortestPathTree[nd] != 0))
+    while ((nd != m_iSource) && (m_pWork->getTreeEdge(nd) != 0))
     {
-        nd = m_ShortestPathTree[nd]->from();
+        nd = m_pWork->getTreeEdge(nd)->from();
 
         path.push_front(nd);
     }
@@ -238,8 +239,8 @@ std::list<int> Graph_SearchAStar_TS<graph_type, heuristic>::getPathToTarget()con
 //
 //  returns the path as a list of PathEdges
 //-----------------------------------------------------------------------------
-template <class graph_type, class heuristic>
-std::list<PathEdge> Graph_SearchAStar_TS<graph_type, heuristic>::getPathAsPathEdges()const
+template <class graph_type, class heuristic, class open_list>
+std::list<PathEdge> Graph_SearchAStar_TS<graph_type, heuristic, open_list>::getPathAsPathEdges()const
 {
     std::list<PathEdge> path;
 
@@ -248,14 +249,15 @@ std::list<PathEdge> Graph_SearchAStar_TS<graph_type, heuristic>::getPathAsPathEd
 
     int nd = m_iTarget;
     
-    while ((nd != m_iSource) && (m_ShortestPathTree[nd] != 0))
+    const Edge* pE;
+    while ((nd != m_iSource) && ((pE = m_pWork->getTreeEdge(nd)) != 0))
     {
-        path.push_front(PathEdge(  m_Graph.GetNode(m_ShortestPathTree[nd]->from()).pos(),
-                                                 m_Graph.GetNode(m_ShortestPathTree[nd]->to()).pos(),
-                                                 m_ShortestPathTree[nd]->flags(),
-                                                 m_ShortestPathTree[nd]->getIntersectingEntityID()));
+        path.push_front(PathEdge(  m_Graph.getNode(pE->from()).getPos(),
+                                                 m_Graph.getNode(pE->to()).getPos(),
+                                                 pE->getFlags(),
+                                                 pE->getIntersectingEntityID()));
 
-        nd = m_ShortestPathTree[nd]->from();
+        nd = pE->from();
     }
 
     return path;
@@ -266,7 +268,7 @@ std::list<PathEdge> Graph_SearchAStar_TS<graph_type, heuristic>::getPathAsPathEd
 //  Dijkstra's algorithm class modified to spread a search over multiple
 //  update-steps
 //-----------------------------------------------------------------------------
-template <class graph_type, class termination_condition>
+template <class graph_type, class termination_condition, class open_list = SearchOpenList>
 class Graph_SearchDijkstras_TS : public Graph_SearchTimeSliced<typename graph_type::EdgeType>
 {
 private:
@@ -274,47 +276,40 @@ private:
     typedef typename graph_type::EdgeType Edge;
     typedef typename graph_type::NodeType Node;
 
+    typedef SearchWorkspace<Edge, open_list> Workspace;
+
 private:
 
     const graph_type& m_Graph;
 
-    //indexed into my node. Contains the accumulative cost to that node
-    std::vector<float> m_CostToThisNode; 
-
-    std::vector<const Edge*> m_ShortestPathTree;
-    std::vector<const Edge*> m_SearchFrontier;
+    //holds, for each node, the accumulative cost to that node (as both its
+    //G and F cost) and its frontier and SPT edges, and the indexed priority
+    //queue of nodes. The nodes with the lowest cost are positioned at the
+    //front.
+    Workspace* m_pWork;
 
     int m_iSource;
     int m_iTarget;
 
-    //create an indexed priority queue of nodes. The nodes with the
-    //lowest overall F cost (G+H) are positioned at the front.
-    indexedPriorityQLow<float>* m_pPQ;
-
- 
+    Graph_SearchDijkstras_TS(const Graph_SearchDijkstras_TS&);
+    Graph_SearchDijkstras_TS& operator=(const Graph_SearchDijkstras_TS&);
 
 public:
     Graph_SearchDijkstras_TS(const graph_type&  G,
                                                         int source,
-                                                        int target):Graph_SearchTimeSliced<Edge>(Dijkstra),
+                                                        int target):Graph_SearchTimeSliced<Edge>(Graph_SearchTimeSliced<Edge>::Dijkstra),
                                                         m_Graph(G),
-                                                        m_ShortestPathTree(G.NumNodes()),                              
-                                                        m_SearchFrontier(G.NumNodes()),
-                                                        m_CostToThisNode(G.NumNodes(), 0.0),
+                                                        m_pWork(Workspace::acquire(&G, G.getNumNodes())),
                                                         m_iSource(source),
                                                         m_iTarget(target)
     { 
-        //create the PQ         ,
-        m_pPQ =new indexedPriorityQLow<float>(m_CostToThisNode, m_Graph.NumNodes());
-
         //put the source node on the queue
-        m_pPQ->insert(m_iSource);
+        m_pWork->reach(m_iSource, 0.0f, 0.0f, NULL);
+        m_pWork->getQueue().insert(m_iSource);
     }
 
-    //let the search class take care of tidying up memory (the wary amongst
-    //you may prefer to use std::auto_ptr or similar to replace the pointer
-    //to the termination condition)
-    ~Graph_SearchDijkstras_TS(){delete m_pPQ;}
+    //hands the workspace back to the pool
+    ~Graph_SearchDijkstras_TS(){Workspace::release(m_pWork);}
 
     //When called, this method pops the next node off the PQ and examines all
     //its edges. The method returns an enumerated value (target_found,
@@ -322,7 +317,7 @@ public:
     int cycleOnce();
 
     //returns the vector of edges that the algorithm has examined
-    std::vector<const Edge*> getSPT()const{return m_ShortestPathTree;}
+    std::vector<const Edge*> getSPT()const{return m_pWork->getSPT();}
 
     //returns a vector of node indexes that comprise the shortest path
     //from the source to the target
@@ -332,24 +327,27 @@ public:
     std::list<PathEdge> getPathAsPathEdges()const;
 
     //returns the total cost to the target
-    float getCostToTarget()const{return m_CostToThisNode[m_iTarget];}
+    float getCostToTarget()const{return m_pWork->getCost(m_iTarget);}
 };
 
 //-----------------------------------------------------------------------------
-template <class graph_type, class termination_condition>
-int Graph_SearchDijkstras_TS<graph_type, termination_condition>::cycleOnce()
+template <class graph_type, class termination_condition, class open_list>
+int Graph_SearchDijkstras_TS<graph_type, termination_condition, open_list>::cycleOnce()
 {
+    Workspace& W = *m_pWork;
+    typename Workspace::Queue& pq = W.getQueue();
+
     //if the PQ is empty the target has not been found
-    if (m_pPQ->empty())
+    if (pq.isEmpty())
     {
         return target_not_found;
     }
 
     //get lowest cost node from the queue
-    int NextClosestNode = m_pPQ->pop();
+    int NextClosestNode = pq.pop();
 
     //move this node from the frontier to the spanning tree
-    m_ShortestPathTree[NextClosestNode] = m_SearchFrontier[NextClosestNode];
+    W.addToTree(NextClosestNode);
 
     //if the target has been found exit
     if (termination_condition::isSatisfied(m_Graph, m_iTarget, NextClosestNode))
@@ -362,24 +360,26 @@ int Graph_SearchDijkstras_TS<graph_type, termination_condition>::cycleOnce()
         return target_found;
     }
 
+    float CostToThisNode = W.getGCost(NextClosestNode);
+
     //now to test all the edges attached to this node
-    graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, NextClosestNode);
+    typename graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, NextClosestNode);
     for (const Edge* pE=ConstEdgeItr.begin();!ConstEdgeItr.end();pE=ConstEdgeItr.next())
     {
+        int to = ConstEdgeItr.to();
+
         //the total cost to the node this edge points to is the cost to the
         //current node plus the cost of the edge connecting them.
-        float NewCost = m_CostToThisNode[NextClosestNode] + pE->cost();
+        float NewCost = CostToThisNode + ConstEdgeItr.cost();
 
         //if this edge has never been on the frontier make a note of the cost
         //to get to the node it points to, then add the edge to the frontier
         //and the destination node to the PQ.
-        if (m_SearchFrontier[pE->to()] == 0)
+        if (!W.isReached(to))
         {
-            m_CostToThisNode[pE->to()] = NewCost;
+            W.reach(to, NewCost, NewCost, pE);
 
-            m_pPQ->insert(pE->to());
-
-            m_SearchFrontier[pE->to()] = pE;
+            pq.insert(to);
         }
 
         //else test to see if the cost to reach the destination node via the
@@ -387,16 +387,14 @@ int Graph_SearchDijkstras_TS<graph_type, termination_condition>::cycleOnce()
         //this path is cheaper, we assign the new cost to the destination
         //node, update its entry in the PQ to reflect the change and add the
         //edge to the frontier
-        else if ( (NewCost < m_CostToThisNode[pE->to()]) &&
-        (m_ShortestPathTree[pE->to()] == 0) )
+        else if ( (NewCost < W.getGCost(to)) &&
+        (W.getTreeEdgeOfReached(to) == 0) )
         {
-            m_CostToThisNode[pE->to()] = NewCost;
+            W.improve(to, NewCost, NewCost, pE);
 
             //because the cost is less than it was previously, the PQ must be
             //re-sorted to account for this.
-            m_pPQ->ChangePriority(pE->to());
-
-            m_SearchFrontier[pE->to()] = pE;
+            pq.changePriority(to);
         }
     }
   
@@ -405,8 +403,8 @@ int Graph_SearchDijkstras_TS<graph_type, termination_condition>::cycleOnce()
 }
 
 //-----------------------------------------------------------------------------
-template <class graph_type, class termination_condition>
-std::list<int> Graph_SearchDijkstras_TS<graph_type, termination_condition>::getPathToTarget()const
+template <class graph_type, class termination_condition, class open_list>
+std::list<int> Graph_SearchDijkstras_TS<graph_type, termination_condition, open_list>::getPathToTarget()const
 {
     std::list<int> path;
 
@@ -417,9 +415,9 @@ std::list<int> Graph_SearchDijkstras_TS<graph_type, termination_condition>::getP
 
     path.push_back(nd);
 
-    while ((nd != m_iSource) && (m_ShortestPathTree[nd] != 0))
+    while ((nd != m_iSource) && (m_pWork->getTreeEdge(nd) != 0))
     {
-        nd = m_ShortestPathTree[nd]->from();
+        nd = m_pWork->getTreeEdge(nd)->from();
 
         path.push_front(nd);
     }
@@ -432,8 +430,8 @@ std::list<int> Graph_SearchDijkstras_TS<graph_type, termination_condition>::getP
 //
 //  returns the path as a list of PathEdges
 //-----------------------------------------------------------------------------
-template <class graph_type, class termination_condition>
-std::list<PathEdge> Graph_SearchDijkstras_TS<graph_type, termination_condition>::getPathAsPathEdges()const
+template <class graph_type, class termination_condition, class open_list>
+std::list<PathEdge> Graph_SearchDijkstras_TS<graph_type, termination_condition, open_list>::getPathAsPathEdges()const
 {
     std::list<PathEdge> path;
 
@@ -442,14 +440,15 @@ std::list<PathEdge> Graph_SearchDijkstras_TS<graph_type, termination_condition>:
 
     int nd = m_iTarget;
 
-    while ((nd != m_iSource) && (m_ShortestPathTree[nd] != 0))
+    const Edge* pE;
+    while ((nd != m_iSource) && ((pE = m_pWork->getTreeEdge(nd)) != 0))
     {
-        path.push_front(PathEdge( m_Graph.GetNode(m_ShortestPathTree[nd]->from()).pos(),
-                                                 m_Graph.GetNode(m_ShortestPathTree[nd]->to()).pos(),
-                                                 m_ShortestPathTree[nd]->flags(),
-                                                 m_ShortestPathTree[nd]->getIntersectingEntityID()));
+        path.push_front(PathEdge( m_Graph.getNode(pE->from()).getPos(),
+                                                 m_Graph.getNode(pE->to()).getPos(),
+                                                 pE->getFlags(),
+                                                 pE->getIntersectingEntityID()));
 
-        nd = m_ShortestPathTree[nd]->from();
+        nd = pE->from();
     }
 
     return path;
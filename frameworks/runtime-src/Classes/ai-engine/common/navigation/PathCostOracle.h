@@ -0,0 +1,508 @@
+#ifndef PATH_COST_ORACLE_H
+#define PATH_COST_ORACLE_H
+#pragma warning (disable:4786)
+//-----------------------------------------------------------------------------
+//
+//  Name:   PathCostOracle.h
+//
+//  Desc:   answers "what does it cost to travel from node a to node b" for a
+//          graph without a search per question. Three ways of storing the
+//          costs are given, each trading memory and load time for accuracy:
+//
+//          PathCostTable_Dense     - the exact N*N table, calculated up front
+//                                    in one contiguous block. Fast, but the
+//                                    memory grows with the square of the
+//                                    number of nodes.
+//
+//          PathCostTable_LazyRows  - exact costs. A row (the cost from one
+//                                    node to all the others) is calculated
+//                                    with Dijkstra the first time it is
+//                                    asked for and kept in a cache of a
+//                                    fixed number of rows. The least
+//                                    recently used row is thrown away when
+//                                    the cache is full.
+//
+//          PathCostTable_Landmarks - lower bounds from the triangle
+//                                    inequality (ALT). The cost from a few
+//                                    landmark nodes to every node is kept,
+//                                    which is enough to estimate the cost
+//                                    between any two nodes. Only valid for
+//                                    connected graphs that are not
+//                                    digraphs.
+//
+//          For nodes that can't reach each other the cost is 0, as it was
+//          with createAllPairsCostsTable.
+//
+//          The dense table can be written to a file and read back, so it
+//          only has to be calculated once per map. The file is tagged with a
+//          version and a hash of the map file it was calculated for and is
+//          ignored if either doesn't match. It is in the byte order of the
+//          machine that wrote it.
+//
+//          The graph must not change while an oracle built on it is in use.
+//-----------------------------------------------------------------------------
+#include <vector>
+#include <list>
+#include <mutex>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <string>
+#include <fstream>
+
+#include "GraphAlgorithms.h"
+#include "../misc/UtilsEx.h"
+#include "../misc/WorkerPool.h"
+
+
+//identifies a path cost file. Change the version whenever the layout of the
+//file or the way the costs are calculated changes
+const unsigned int PathCostFileTag = 0x54435050; //"PPCT"
+const unsigned int PathCostFileVersion = 1;
+
+//------------------------- calculateFileHash ---------------------------------
+//
+//  64 bit FNV-1a hash of the contents of a file, used to tell if a cost file
+//  was calculated for the map it is loaded with. Returns 0 if the file can't
+//  be read
+//-----------------------------------------------------------------------------
+inline unsigned long long calculateFileHash(const std::string& fileName)
+{
+    std::ifstream in(fileName.c_str(), std::ios::binary);
+    if (!in) return 0;
+
+    unsigned long long hash = 14695981039346656037ULL;
+
+    char buffer[4096];
+    while (in)
+    {
+        in.read(buffer, sizeof(buffer));
+
+        std::streamsize numRead = in.gcount();
+        for (std::streamsize i=0; i<numRead; ++i)
+        {
+            hash ^= (unsigned char)buffer[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    return hash;
+}
+
+
+class PathCostOracle
+{
+public:
+    virtual ~PathCostOracle(){}
+
+    //returns the cost to travel from nd1 to nd2
+    virtual float getCost(int nd1, int nd2) = 0;
+
+    //returns true if getCost gives the cost of the shortest path and false
+    //if it only gives an estimate that is never more than it
+    virtual bool isExact()const = 0;
+
+    //the number of bytes used by the costs
+    virtual size_t getMemoryUsage()const = 0;
+};
+
+
+//------------------------- PathCostTable_Dense -------------------------------
+//
+//  the cost from every node to every other, stored row by row in one block
+//-----------------------------------------------------------------------------
+template <class graph_type>
+class PathCostTable_Dense : public PathCostOracle
+{
+public:
+    //calculates the table for the graph. The sources are shared out between
+    //the threads of pWorkers if it isn't NULL
+    inline PathCostTable_Dense(const graph_type& G, WorkerPool* pWorkers = NULL);
+
+    //creates a table of zero costs, to be filled in by calculate or read
+    PathCostTable_Dense(int numNodes):m_iNumNodes(numNodes),
+                                      m_Costs((size_t)numNodes*numNodes, 0.0f){}
+
+    inline void calculate(const graph_type& G, WorkerPool* pWorkers);
+
+    //writes the table to a file, tagged with the hash of the map it was
+    //calculated for. Returns false if the file can't be written
+    inline bool write(const std::string& fileName, unsigned long long mapHash)const;
+
+    //reads a table written by write. Returns false, leaving the table as it
+    //is, if the file is missing, from another version, for another map or
+    //for a graph of a different size
+    inline bool read(const std::string& fileName, unsigned long long mapHash);
+
+    float getCost(int nd1, int nd2)
+    {
+        assert (nd1>=0 && nd1<m_iNumNodes && nd2>=0 && nd2<m_iNumNodes);
+
+        return m_Costs[(size_t)nd1*m_iNumNodes + nd2];
+    }
+
+    bool isExact()const{return true;}
+    size_t getMemoryUsage()const{return m_Costs.size() * sizeof(float);}
+
+    //the costs from nd to every node, m_iNumNodes of them
+    float* getRow(int nd){return &m_Costs[(size_t)nd*m_iNumNodes];}
+    int getNumNodes()const{return m_iNumNodes;}
+
+private:
+    class RowJob;
+
+    int m_iNumNodes;
+    std::vector<float> m_Costs;
+};
+
+//calculates the rows of a range of source nodes
+template <class graph_type>
+class PathCostTable_Dense<graph_type>::RowJob : public ParallelJob
+{
+public:
+    RowJob(PathCostTable_Dense<graph_type>& table, const graph_type& G):m_Table(table), m_Graph(G){}
+
+    void process(int begin, int end)
+    {
+        for (int source=begin; source<end; ++source)
+        {
+            Graph_SearchDijkstra<graph_type> search(m_Graph, source);
+
+            float* row = m_Table.getRow(source);
+            for (int target=0; target<m_Table.getNumNodes(); ++target)
+            {
+                row[target] = (source == target) ? 0.0f : search.getCostToNode(target);
+            }
+        }
+    }
+
+private:
+    PathCostTable_Dense<graph_type>& m_Table;
+    const graph_type& m_Graph;
+};
+
+template <class graph_type>
+PathCostTable_Dense<graph_type>::PathCostTable_Dense(const graph_type& G, WorkerPool* pWorkers):m_iNumNodes(G.getNumNodes()),
+                                                                        m_Costs((size_t)G.getNumNodes()*G.getNumNodes(), 0.0f)
+{
+    calculate(G, pWorkers);
+}
+
+//------------------------------- calculate -----------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+void PathCostTable_Dense<graph_type>::calculate(const graph_type& G, WorkerPool* pWorkers)
+{
+    assert (G.getNumNodes() == m_iNumNodes && "<PathCostTable_Dense::calculate>: graph size mismatch");
+
+    RowJob job(*this, G);
+
+    if (pWorkers)
+    {
+        pWorkers->run(job, m_iNumNodes, 1);
+    }
+    else
+    {
+        job.process(0, m_iNumNodes);
+    }
+}
+
+//--------------------------------- write -------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+bool PathCostTable_Dense<graph_type>::write(const std::string& fileName, unsigned long long mapHash)const
+{
+    std::ofstream out(fileName.c_str(), std::ios::binary);
+    if (!out) return false;
+
+    out.write((const char*)&PathCostFileTag, sizeof(PathCostFileTag));
+    out.write((const char*)&PathCostFileVersion, sizeof(PathCostFileVersion));
+    out.write((const char*)&mapHash, sizeof(mapHash));
+    out.write((const char*)&m_iNumNodes, sizeof(m_iNumNodes));
+
+    if (!m_Costs.empty())
+    {
+        out.write((const char*)&m_Costs[0], m_Costs.size() * sizeof(float));
+    }
+
+    return out.good();
+}
+
+//---------------------------------- read -------------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+bool PathCostTable_Dense<graph_type>::read(const std::string& fileName, unsigned long long mapHash)
+{
+    std::ifstream in(fileName.c_str(), std::ios::binary);
+    if (!in) return false;
+
+    unsigned int tag = 0;
+    unsigned int version = 0;
+    unsigned long long hash = 0;
+    int numNodes = 0;
+
+    in.read((char*)&tag, sizeof(tag));
+    in.read((char*)&version, sizeof(version));
+    in.read((char*)&hash, sizeof(hash));
+    in.read((char*)&numNodes, sizeof(numNodes));
+
+    if (!in || tag != PathCostFileTag || version != PathCostFileVersion ||
+        hash != mapHash || numNodes != m_iNumNodes)
+    {
+        return false;
+    }
+
+    //read straight into a new block so a short file leaves the table alone
+    std::vector<float> costs(m_Costs.size());
+    if (!costs.empty())
+    {
+        in.read((char*)&costs[0], costs.size() * sizeof(float));
+        if (in.gcount() != (std::streamsize)(costs.size() * sizeof(float))) return false;
+    }
+
+    m_Costs.swap(costs);
+
+    return true;
+}
+
+
+//------------------------- PathCostTable_LazyRows ----------------------------
+//
+//  calculates the rows on demand and keeps the most recently used ones.
+//  getCost may be called from more than one thread
+//-----------------------------------------------------------------------------
+template <class graph_type>
+class PathCostTable_LazyRows : public PathCostOracle
+{
+public:
+    inline PathCostTable_LazyRows(const graph_type& G, int maxRows);
+
+    inline float getCost(int nd1, int nd2);
+
+    bool isExact()const{return true;}
+    size_t getMemoryUsage()const{return m_Rows.size() * sizeof(float);}
+
+    //the number of rows that had to be calculated
+    int getNumRowsCalculated()const{return m_iNumRowsCalculated;}
+
+private:
+    enum {no_slot = -1};
+
+    const graph_type& m_Graph;
+    int m_iNumNodes;
+    int m_iMaxRows;
+
+    //the cached rows, one after the other
+    std::vector<float> m_Rows;
+
+    //the slot holding each node's row (or no_slot) and the node in each slot
+    std::vector<int> m_SlotOfNode;
+    std::vector<int> m_NodeOfSlot;
+
+    //the slots in use, most recently used first
+    std::list<int> m_LRU;
+    std::vector<std::list<int>::iterator> m_LRUPosOfSlot;
+
+    int m_iNumRowsCalculated;
+
+    std::mutex m_Mutex;
+
+    //returns the slot holding the row of source, calculating it if needed
+    inline int getSlot(int source);
+};
+
+template <class graph_type>
+PathCostTable_LazyRows<graph_type>::PathCostTable_LazyRows(const graph_type& G, int maxRows):m_Graph(G),
+                                                                          m_iNumNodes(G.getNumNodes()),
+                                                                          m_iMaxRows(std::max(1, std::min(maxRows, G.getNumNodes()))),
+                                                                          m_SlotOfNode(G.getNumNodes(), no_slot),
+                                                                          m_iNumRowsCalculated(0)
+{
+    m_NodeOfSlot.reserve(m_iMaxRows);
+    m_LRUPosOfSlot.reserve(m_iMaxRows);
+}
+
+//--------------------------------- getCost -----------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+float PathCostTable_LazyRows<graph_type>::getCost(int nd1, int nd2)
+{
+    assert (nd1>=0 && nd1<m_iNumNodes && nd2>=0 && nd2<m_iNumNodes);
+
+    if (nd1 == nd2) return 0.0f;
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    //the graph is not a digraph so a row of either node will do. nd2 is
+    //the item or target node, which is asked about again and again while
+    //nd1 moves with the bot, so its row is the one to calculate and keep
+    //unless only nd1's is cached already
+    if (!m_Graph.isDigraph() && (m_SlotOfNode[nd1] == no_slot || m_SlotOfNode[nd2] != no_slot))
+    {
+        std::swap(nd1, nd2);
+    }
+
+    return m_Rows[(size_t)getSlot(nd1)*m_iNumNodes + nd2];
+}
+
+//--------------------------------- getSlot -----------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+int PathCostTable_LazyRows<graph_type>::getSlot(int source)
+{
+    int slot = m_SlotOfNode[source];
+
+    //already cached, just move it to the front of the LRU list
+    if (slot != no_slot)
+    {
+        m_LRU.splice(m_LRU.begin(), m_LRU, m_LRUPosOfSlot[slot]);
+        return slot;
+    }
+
+    if ((int)m_NodeOfSlot.size() < m_iMaxRows)
+    {
+        //there is still room for another row
+        slot = (int)m_NodeOfSlot.size();
+        m_NodeOfSlot.push_back(source);
+        m_Rows.resize(m_NodeOfSlot.size() * m_iNumNodes);
+        m_LRU.push_front(slot);
+        m_LRUPosOfSlot.push_back(m_LRU.begin());
+    }
+    else
+    {
+        //reuse the slot of the least recently used row
+        slot = m_LRU.back();
+        m_SlotOfNode[m_NodeOfSlot[slot]] = no_slot;
+        m_NodeOfSlot[slot] = source;
+        m_LRU.splice(m_LRU.begin(), m_LRU, m_LRUPosOfSlot[slot]);
+    }
+
+    m_SlotOfNode[source] = slot;
+
+    Graph_SearchDijkstra<graph_type> search(m_Graph, source);
+
+    float* row = &m_Rows[(size_t)slot*m_iNumNodes];
+    for (int target=0; target<m_iNumNodes; ++target)
+    {
+        row[target] = (target == source) ? 0.0f : search.getCostToNode(target);
+    }
+
+    ++m_iNumRowsCalculated;
+
+    return slot;
+}
+
+
+//------------------------- PathCostTable_Landmarks ---------------------------
+//
+//  For any landmark L the triangle inequality gives
+//
+//      cost(a, b) >= |cost(L, b) - cost(L, a)|
+//
+//  so the largest of these over all the landmarks is a lower bound on the
+//  cost from a to b. The landmarks are picked one at a time as the node
+//  furthest from the ones already picked, which spreads them out to the
+//  edges of the graph where they give the tightest bounds.
+//-----------------------------------------------------------------------------
+template <class graph_type>
+class PathCostTable_Landmarks : public PathCostOracle
+{
+public:
+    inline PathCostTable_Landmarks(const graph_type& G, int numLandmarks);
+
+    inline float getCost(int nd1, int nd2);
+
+    bool isExact()const{return false;}
+    size_t getMemoryUsage()const{return m_Costs.size() * sizeof(float);}
+
+    int getNumLandmarks()const{return (int)m_Landmarks.size();}
+    int getLandmark(int i)const{return m_Landmarks[i];}
+
+private:
+    int m_iNumNodes;
+
+    std::vector<int> m_Landmarks;
+
+    //the costs from each node to all the landmarks, stored node by node so
+    //an estimate only reads two short runs of memory
+    std::vector<float> m_Costs;
+};
+
+template <class graph_type>
+PathCostTable_Landmarks<graph_type>::PathCostTable_Landmarks(const graph_type& G, int numLandmarks):m_iNumNodes(G.getNumNodes())
+{
+    assert (!G.isDigraph() && "<PathCostTable_Landmarks>: landmark bounds need a graph that is not a digraph");
+
+    //the smallest cost from each node to the landmarks picked so far
+    std::vector<float> closest(m_iNumNodes, FloatMax);
+
+    //start from the first node in the graph
+    int next = 0;
+    while (next < m_iNumNodes && !G.isNodePresent(next)) ++next;
+
+    std::vector<std::vector<float> > landmarkCosts;
+
+    while (next < m_iNumNodes && (int)m_Landmarks.size() < numLandmarks)
+    {
+        m_Landmarks.push_back(next);
+
+        Graph_SearchDijkstra<graph_type> search(G, next);
+
+        std::vector<float> costs(m_iNumNodes, 0.0f);
+        for (int nd=0; nd<m_iNumNodes; ++nd)
+        {
+            if (nd != next) costs[nd] = search.getCostToNode(nd);
+        }
+
+        //the next landmark is the node furthest from all of the landmarks
+        next = m_iNumNodes;
+        float furthest = 0.0f;
+        for (int nd=0; nd<m_iNumNodes; ++nd)
+        {
+            closest[nd] = std::min(closest[nd], costs[nd]);
+
+            if (closest[nd] > furthest)
+            {
+                furthest = closest[nd];
+                next = nd;
+            }
+        }
+
+        landmarkCosts.push_back(costs);
+    }
+
+    int numPicked = (int)m_Landmarks.size();
+    m_Costs.resize((size_t)m_iNumNodes * numPicked);
+    for (int nd=0; nd<m_iNumNodes; ++nd)
+    {
+        for (int l=0; l<numPicked; ++l)
+        {
+            m_Costs[nd*numPicked + l] = landmarkCosts[l][nd];
+        }
+    }
+}
+
+//--------------------------------- getCost -----------------------------------
+//-----------------------------------------------------------------------------
+template <class graph_type>
+float PathCostTable_Landmarks<graph_type>::getCost(int nd1, int nd2)
+{
+    assert (nd1>=0 && nd1<m_iNumNodes && nd2>=0 && nd2<m_iNumNodes);
+
+    int numLandmarks = (int)m_Landmarks.size();
+    if (numLandmarks == 0) return 0.0f;
+
+    const float* costs1 = &m_Costs[nd1*numLandmarks];
+    const float* costs2 = &m_Costs[nd2*numLandmarks];
+
+    float bound = 0.0f;
+    for (int l=0; l<numLandmarks; ++l)
+    {
+        bound = std::max(bound, std::fabs(costs2[l] - costs1[l]));
+    }
+
+    return bound;
+}
+
+
+#endif
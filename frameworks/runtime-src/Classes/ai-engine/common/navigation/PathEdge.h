@@ -38,7 +38,7 @@ public:
     Vector2D getDestination()const{return m_vDestination;}
     void setDestination(Vector2D NewDest){m_vDestination = NewDest;}
 
-    Vector2D geSource()const{return m_vSource;}
+    Vector2D getSource()const{return m_vSource;}
     void setSource(Vector2D NewSource){m_vSource = NewSource;}
 
     int getDoorID()const{return m_iDoorID;}
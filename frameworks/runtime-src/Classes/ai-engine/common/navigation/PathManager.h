@@ -6,49 +6,165 @@
 //  Name:   PathManager.h
 //
 //
-//  Desc:   a template class to manage a number of graph searches, and to 
+//  Desc:   a template class to manage a number of graph searches, and to
 //          distribute the calculation of each search over several update-steps
+//
+//          Each update-step the searches are given a budget of time (and
+//          an upper limit of search cycles). The requests are served in
+//          order of priority, each until it has finished or the budget has
+//          run out, so after a burst of requests the most urgent paths are
+//          found first and the rest wait for the following updates instead
+//          of making the update take longer. A request gains priority for
+//          every update it has waited, so none waits for ever.
+//
+//          A planner that registers again before its search has finished
+//          keeps its place in the queue, and the time it has waited, with
+//          the new search.
 //-----------------------------------------------------------------------------
 #include <list>
+#include <chrono>
+#include <algorithm>
 #include <cassert>
 
+#include "common/navigation/GraphAlgorithms_TimeSliced.h"
+
+
+//what the path manager has done so far, see PathManager::getStats
+struct PathManagerStats
+{
+    //the number of requests waiting after the last update, and the most
+    //there have been
+    int queueDepth;
+    int maxQueueDepth;
+
+    int numCompleted;
+
+    //requests unregistered before their search finished
+    int numCancelled;
+
+    //requests made again before the search of the last one finished
+    int numCoalesced;
+
+    //the search cycles and time taken by the last update, and the longest
+    //time an update has taken
+    int cyclesLastUpdate;
+    float lastUpdateUs;
+    float maxUpdateUs;
+
+    //the time from a request being registered to its search finishing, in
+    //milliseconds and in update-steps
+    float totalLatencyMs;
+    float maxLatencyMs;
+    int totalLatencyUpdates;
+    int maxLatencyUpdates;
+
+    float getMeanLatencyMs()const{return numCompleted ? totalLatencyMs / numCompleted : 0.0f;}
+    float getMeanLatencyUpdates()const{return numCompleted ? (float)totalLatencyUpdates / numCompleted : 0.0f;}
+};
 
 
 template <class path_planner>
 class PathManager
 {
 private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Request
+    {
+        path_planner* pPlanner;
+
+        float priority;
+
+        //when the request was first registered
+        unsigned int updateRegistered;
+        Clock::time_point timeRegistered;
+
+        //the priority plus what it has gained by waiting, set at the start of
+        //each update
+        float effectivePriority;
+    };
+
+    //orders the requests by effective priority, highest first
+    class HigherPriority
+    {
+    public:
+        bool operator()(const Request& a, const Request& b)const{return a.effectivePriority > b.effectivePriority;}
+    };
+
     //a container of all the active search requests
-    std::list<path_planner*> m_SearchRequests;
+    std::list<Request> m_SearchRequests;
 
-    //this is the total number of search cycles allocated to the manager. 
-    //Each update-step these are divided equally amongst all registered path requests
+    //the most search cycles made in one update-step
     unsigned int m_iNumSearchCyclesPerUpdate;
 
+    //the time the searches may take each update-step, in microseconds. If 0
+    //only the number of cycles is limited
+    float m_dMicrosecondsPerUpdate;
+
+    //the priority a request gains for each update-step it waits
+    float m_dPriorityPerUpdateWaited;
+
+    unsigned int m_iNumUpdates;
+
+    //the planner being cycled. The bot may be told its search has finished
+    //while it is, and register or unregister the planner again there and
+    //then. The request is only updated once the cycle is over
+    path_planner* m_pCurrentPlanner;
+    bool m_bCurrentReRegistered;
+    bool m_bCurrentCancelled;
+
+    PathManagerStats m_Stats;
+
+    //the clock is read after this many cycles, and after each search that
+    //finishes
+    enum {cycles_between_clock_reads = 16};
+
+    typename std::list<Request>::iterator findRequest(path_planner* pPathPlanner);
+
+    PathManager(const PathManager&);
+    PathManager& operator=(const PathManager&);
+
 public:
-    PathManager(unsigned int NumCyclesPerUpdate):m_iNumSearchCyclesPerUpdate(NumCyclesPerUpdate){}
+    PathManager(unsigned int NumCyclesPerUpdate,
+                float MicrosecondsPerUpdate = 0.0f,
+                float PriorityPerUpdateWaited = 1.0f):m_iNumSearchCyclesPerUpdate(NumCyclesPerUpdate),
+                                                      m_dMicrosecondsPerUpdate(MicrosecondsPerUpdate),
+                                                      m_dPriorityPerUpdateWaited(PriorityPerUpdateWaited),
+                                                      m_iNumUpdates(0),
+                                                      m_pCurrentPlanner(NULL),
+                                                      m_bCurrentReRegistered(false),
+                                                      m_bCurrentCancelled(false)
+    {
+        resetStats();
+    }
 
-    //every time this is called the total amount of search cycles available will
-    //be shared out equally between all the active path requests. If a search
-    //completes successfully or fails the method will notify the relevant bot
+    //every time this is called the requests are cycled in order of priority
+    //until the time budget or the cycles run out. If a search completes
+    //successfully or fails the method will notify the relevant bot
     void updateSearches();
 
-    //a path planner should call this method to register a search with the 
-    //manager. (The method checks to ensure the path planner is only registered once)
-    void registerPlan(path_planner* pPathPlanner);
+    //a path planner should call this method to register a search with the
+    //manager. The higher the priority the sooner the search is made. If the
+    //planner is already registered its request takes the new priority
+    void registerPlan(path_planner* pPathPlanner, float priority = 0.0f);
 
+    //cancels the request of a planner, if it has one
     void unRegisterPlan(path_planner* pPathPlanner);
 
     //returns the amount of path requests currently active.
     int  getNumActiveSearches()const{return m_SearchRequests.size();}
+
+    const PathManagerStats& getStats()const{return m_Stats;}
+    void resetStats();
 };
 
 ///////////////////////////////////////////////////////////////////////////////
 //------------------------- UpdateSearches ------------------------------------
 //
-//  This method iterates through all the active path planning requests 
-//  updating their searches until the user specified total number of search
-//  cycles has been satisfied.
+//  This method orders the active path planning requests by priority and
+//  cycles the searches of each in turn until it finishes, or until the
+//  time allowed for this update-step has been used or the total number of
+//  search cycles has been made.
 //
 //  If a path is found or the search is unsuccessful the relevant agent is
 //  notified accordingly by Telegram
@@ -56,35 +172,104 @@ public:
 template <class path_planner>
 inline void PathManager<path_planner>::updateSearches()
 {
-    int NumCyclesRemaining = m_iNumSearchCyclesPerUpdate;
+    Clock::time_point start = Clock::now();
+
+    ++m_iNumUpdates;
 
-    //iterate through the search requests until either all requests have been
-    //fulfilled or there are no search cycles remaining for this update-step.
-    std::list<path_planner*>::iterator curPath = m_SearchRequests.begin();
-    while (NumCyclesRemaining-- && !m_SearchRequests.empty())
+    //the longer a request has waited the sooner it is served
+    typename std::list<Request>::iterator curPath;
+    for (curPath = m_SearchRequests.begin(); curPath != m_SearchRequests.end(); ++curPath)
+    {
+        curPath->effectivePriority = curPath->priority +
+                                     m_dPriorityPerUpdateWaited * (m_iNumUpdates - curPath->updateRegistered);
+    }
+
+    //list::sort is stable, so requests of the same priority stay in the
+    //order they were made
+    m_SearchRequests.sort(HigherPriority());
+
+    unsigned int NumCycles = 0;
+    float elapsedUs = 0.0f;
+
+    curPath = m_SearchRequests.begin();
+    while (curPath != m_SearchRequests.end() && NumCycles < m_iNumSearchCyclesPerUpdate)
     {
         //make one search cycle of this path request
-        int result = (*curPath)->cycleOnce();
+        m_pCurrentPlanner = curPath->pPlanner;
+        m_bCurrentReRegistered = false;
+        m_bCurrentCancelled = false;
 
-        //if the search has terminated remove from the list
-        if ( (result == target_found) || (result == target_not_found) )
-        {
-            //remove this path from the path list
-            curPath = m_SearchRequests.erase(curPath);       
-        }
-        //move on to the next
-        else
+        int result = curPath->pPlanner->cycleOnce();
+
+        m_pCurrentPlanner = NULL;
+
+        ++NumCycles;
+
+        bool bFinished = (result == target_found) || (result == target_not_found);
+
+        if (m_bCurrentCancelled)
         {
-            ++curPath;
+            curPath = m_SearchRequests.erase(curPath);
+            continue;
         }
 
-        //the iterator may now be pointing to the end of the list. If this is so,
-        // it must be reset to the beginning.
-        if (curPath == m_SearchRequests.end())
+        if (bFinished || (NumCycles % cycles_between_clock_reads) == 0)
         {
-            curPath = m_SearchRequests.begin();
+            Clock::time_point now = Clock::now();
+
+            elapsedUs = std::chrono::duration<float, std::micro>(now - start).count();
+
+            //if the search has terminated remove from the list
+            if (bFinished)
+            {
+                float latencyMs = std::chrono::duration<float, std::milli>(now - curPath->timeRegistered).count();
+                int latencyUpdates = (int)(m_iNumUpdates - curPath->updateRegistered);
+
+                ++m_Stats.numCompleted;
+                m_Stats.totalLatencyMs += latencyMs;
+                m_Stats.maxLatencyMs = std::max(m_Stats.maxLatencyMs, latencyMs);
+                m_Stats.totalLatencyUpdates += latencyUpdates;
+                m_Stats.maxLatencyUpdates = std::max(m_Stats.maxLatencyUpdates, latencyUpdates);
+
+                //a new search made when the bot heard of this one finishing
+                //is a new request
+                if (m_bCurrentReRegistered)
+                {
+                    curPath->updateRegistered = m_iNumUpdates;
+                    curPath->timeRegistered = now;
+
+                    --m_Stats.numCoalesced;
+
+                    ++curPath;
+                }
+                else
+                {
+                    curPath = m_SearchRequests.erase(curPath);
+                }
+            }
+
+            if (m_dMicrosecondsPerUpdate > 0.0f && elapsedUs >= m_dMicrosecondsPerUpdate) break;
         }
     }//end while
+
+    elapsedUs = std::chrono::duration<float, std::micro>(Clock::now() - start).count();
+
+    m_Stats.cyclesLastUpdate = NumCycles;
+    m_Stats.lastUpdateUs = elapsedUs;
+    m_Stats.maxUpdateUs = std::max(m_Stats.maxUpdateUs, elapsedUs);
+    m_Stats.queueDepth = (int)m_SearchRequests.size();
+}
+
+//---------------------------- findRequest ------------------------------------
+//-----------------------------------------------------------------------------
+template <class path_planner>
+inline typename std::list<typename PathManager<path_planner>::Request>::iterator
+PathManager<path_planner>::findRequest(path_planner* pPathPlanner)
+{
+    typename std::list<Request>::iterator it = m_SearchRequests.begin();
+    while (it != m_SearchRequests.end() && it->pPlanner != pPathPlanner) ++it;
+
+    return it;
 }
 
 //--------------------------- Register ----------------------------------------
@@ -92,14 +277,37 @@ inline void PathManager<path_planner>::updateSearches()
 //  this is called to register a search with the manager.
 //-----------------------------------------------------------------------------
 template <class path_planner>
-inline void PathManager<path_planner>::registerPlan(path_planner* pPathPlanner)
+inline void PathManager<path_planner>::registerPlan(path_planner* pPathPlanner, float priority)
 {
-    //make sure the bot does not already have a current search in the queue
-    if(std::find(m_SearchRequests.begin(),m_SearchRequests.end(),pPathPlanner) == m_SearchRequests.end())
-    { 
-        //add to the list
-        m_SearchRequests.push_back(pPathPlanner);
+    typename std::list<Request>::iterator it = findRequest(pPathPlanner);
+
+    //if the bot already has a search in the queue the new one takes its place
+    if (it != m_SearchRequests.end())
+    {
+        it->priority = priority;
+
+        ++m_Stats.numCoalesced;
+
+        if (pPathPlanner == m_pCurrentPlanner)
+        {
+            m_bCurrentReRegistered = true;
+            m_bCurrentCancelled = false;
+        }
+
+        return;
     }
+
+    Request request;
+    request.pPlanner = pPathPlanner;
+    request.priority = priority;
+    request.updateRegistered = m_iNumUpdates;
+    request.timeRegistered = Clock::now();
+    request.effectivePriority = priority;
+
+    //add to the list
+    m_SearchRequests.push_back(request);
+
+    m_Stats.maxQueueDepth = std::max(m_Stats.maxQueueDepth, (int)m_SearchRequests.size());
 }
 
 //----------------------------- UnRegister ------------------------------------
@@ -107,8 +315,42 @@ inline void PathManager<path_planner>::registerPlan(path_planner* pPathPlanner)
 template <class path_planner>
 inline void PathManager<path_planner>::unRegisterPlan(path_planner* pPathPlanner)
 {
-    m_SearchRequests.remove(pPathPlanner);
+    typename std::list<Request>::iterator it = findRequest(pPathPlanner);
+
+    if (it != m_SearchRequests.end())
+    {
+        ++m_Stats.numCancelled;
+
+        if (pPathPlanner == m_pCurrentPlanner)
+        {
+            m_bCurrentCancelled = true;
+            m_bCurrentReRegistered = false;
+        }
+        else
+        {
+            m_SearchRequests.erase(it);
+        }
+    }
+}
+
+//----------------------------- resetStats ------------------------------------
+//-----------------------------------------------------------------------------
+template <class path_planner>
+inline void PathManager<path_planner>::resetStats()
+{
+    m_Stats.queueDepth = (int)m_SearchRequests.size();
+    m_Stats.maxQueueDepth = m_Stats.queueDepth;
+    m_Stats.numCompleted = 0;
+    m_Stats.numCancelled = 0;
+    m_Stats.numCoalesced = 0;
+    m_Stats.cyclesLastUpdate = 0;
+    m_Stats.lastUpdateUs = 0.0f;
+    m_Stats.maxUpdateUs = 0.0f;
+    m_Stats.totalLatencyMs = 0.0f;
+    m_Stats.maxLatencyMs = 0.0f;
+    m_Stats.totalLatencyUpdates = 0;
+    m_Stats.maxLatencyUpdates = 0;
 }
 
 
-#endif
\ No newline at end of file
+#endif
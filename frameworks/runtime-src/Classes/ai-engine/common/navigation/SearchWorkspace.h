@@ -0,0 +1,344 @@
+#ifndef SEARCH_WORKSPACE_H
+#define SEARCH_WORKSPACE_H
+#pragma warning (disable:4786)
+//------------------------------------------------------------------------
+//
+//  Name:   SearchWorkspace.h
+//
+//  Desc:   the per node state of a Dijkstra or A* search (the costs, the
+//          frontier and the shortest path tree) and its priority queue,
+//          kept between searches so a search doesn't allocate and clear
+//          arrays the size of the graph.
+//
+//          Each node has a stamp. A node is reached by the current search
+//          if its stamp is that of the search, so starting a new search
+//          only takes a new stamp and the state left by the last one is
+//          ignored. A node's state is set when the search first reaches
+//          it.
+//
+//          The workspaces are pooled per graph and per thread. The searches
+//          in GraphAlgorithms.h and GraphAlgorithms_TimeSliced.h acquire
+//          one when they are created and release it when they are
+//          destroyed, so once there are as many in the pool as searches
+//          running at once they stop allocating. The graph is only the key
+//          of the pool, a workspace doesn't point into it, and the pools of
+//          a thread are deleted when it exits.
+//
+//          A graph's address may be used by another graph once it has been
+//          destroyed, so SparseGraph and FrozenGraph retire their address
+//          with SearchWorkspaceRegistry when they are destroyed. Each thread
+//          then deletes its workspaces for the graph the next time it
+//          acquires one, and a workspace released for it is deleted rather
+//          than pooled.
+//
+//------------------------------------------------------------------------
+#include <vector>
+#include <map>
+#include <cassert>
+
+#include "common/misc/PriorityQueue.h"
+#include "common/navigation/SearchWorkspaceRegistry.h"
+
+
+//the open list the searches use unless they are given another one. Any
+//of the indexed queues in PriorityQueue.h will do. The 4-ary heap was the
+//fastest on the navgraphs of ai_engine_bench (search/open_list), a little
+//ahead of the binary heap; the pairing and radix heaps were slower
+typedef indexedDaryPriorityQLow<float> SearchOpenList;
+
+
+template <class edge_type, class open_list = SearchOpenList>
+class SearchWorkspace
+{
+public:
+    typedef open_list Queue;
+
+    //a workspace from the calling thread's pool for graph, ready for a
+    //search of numNodes nodes
+    static SearchWorkspace* acquire(const void* graph, int numNodes);
+
+    //puts a workspace back in the calling thread's pool
+    static void release(SearchWorkspace* pWorkspace);
+
+    //forgets the state left by the last search, in O(1) unless the graph
+    //has grown
+    void begin(int numNodes);
+
+    //true if the current search has reached nd
+    bool isReached(int nd)const{return m_Stamps[nd] == m_iStamp;}
+
+    //sets the state of a node the search reaches for the first time
+    void reach(int nd, float GCost, float FCost, const edge_type* pE)
+    {
+        m_Stamps[nd]   = m_iStamp;
+        m_GCosts[nd]   = GCost;
+        m_FCosts[nd]   = FCost;
+        m_Frontier[nd] = pE;
+        m_SPT[nd]      = NULL;
+    }
+
+    //a cheaper path to a node that has been reached
+    void improve(int nd, float GCost, float FCost, const edge_type* pE)
+    {
+        m_GCosts[nd]   = GCost;
+        m_FCosts[nd]   = FCost;
+        m_Frontier[nd] = pE;
+    }
+
+    //moves the frontier edge of nd to the shortest path tree
+    void addToTree(int nd){m_SPT[nd] = m_Frontier[nd];}
+
+    //these may only be called for reached nodes
+    float getGCost(int nd)const{return m_GCosts[nd];}
+    const edge_type* getTreeEdgeOfReached(int nd)const{return m_SPT[nd];}
+
+    //0 and NULL for nodes the search hasn't reached
+    float getCost(int nd)const{return isReached(nd) ? m_GCosts[nd] : 0.0f;}
+    const edge_type* getTreeEdge(int nd)const{return isReached(nd) ? m_SPT[nd] : NULL;}
+
+    //the shortest path tree, indexed by node
+    std::vector<const edge_type*> getSPT()const;
+
+    //the queue of the search, ordered by the F costs of the nodes
+    Queue& getQueue(){return m_PQ;}
+
+private:
+    //the graph the workspace is pooled for, and its generation when the
+    //workspace was acquired
+    const void* m_pGraph;
+    unsigned int m_iGeneration;
+
+    //the number of nodes of the current search, and how many there is room
+    //for
+    int m_iNumNodes;
+    int m_iCapacity;
+
+    unsigned int m_iStamp;
+    std::vector<unsigned int> m_Stamps;
+
+    std::vector<float> m_GCosts;
+
+    //the costs m_PQ is ordered by
+    std::vector<float> m_FCosts;
+
+    std::vector<const edge_type*> m_Frontier;
+    std::vector<const edge_type*> m_SPT;
+
+    Queue m_PQ;
+
+    explicit SearchWorkspace(const void* graph):m_pGraph(graph),
+                                                m_iGeneration(0),
+                                                m_iNumNodes(0),
+                                                m_iCapacity(0),
+                                                m_iStamp(0),
+                                                m_PQ(m_FCosts, 0)
+    {}
+
+    //the workspaces of a thread for one graph
+    struct Pool
+    {
+        unsigned int generation;
+        std::vector<SearchWorkspace*> workspaces;
+    };
+
+    //the pools of a thread, deleted with the thread
+    class Pools
+    {
+    public:
+        typedef std::map<const void*, Pool> Map;
+
+        Map pools;
+
+        //SearchWorkspaceRegistry::getNumRetiredSoFar when the pools were
+        //last checked for stale ones
+        unsigned int numRetiredSeen;
+
+        Pools():numRetiredSeen(SearchWorkspaceRegistry::getNumRetiredSoFar()){}
+        ~Pools();
+
+        //deletes the pools of retired graphs, if any have been retired
+        //since the last call
+        void dropRetired();
+
+    private:
+        Pools(const Pools&);
+        Pools& operator=(const Pools&);
+    };
+
+    static Pools& threadPools();
+
+    SearchWorkspace(const SearchWorkspace&);
+    SearchWorkspace& operator=(const SearchWorkspace&);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <class edge_type, class open_list>
+SearchWorkspace<edge_type, open_list>::Pools::~Pools()
+{
+    for (typename Map::iterator it = pools.begin(); it != pools.end(); ++it)
+    {
+        for (unsigned int w=0; w<it->second.workspaces.size(); ++w)
+        {
+            delete it->second.workspaces[w];
+        }
+    }
+}
+
+template <class edge_type, class open_list>
+void SearchWorkspace<edge_type, open_list>::Pools::dropRetired()
+{
+    unsigned int numRetired = SearchWorkspaceRegistry::getNumRetiredSoFar();
+
+    if (numRetired == numRetiredSeen) return;
+
+    numRetiredSeen = numRetired;
+
+    typename Map::iterator it = pools.begin();
+    while (it != pools.end())
+    {
+        if (SearchWorkspaceRegistry::getGeneration(it->first) != it->second.generation)
+        {
+            for (unsigned int w=0; w<it->second.workspaces.size(); ++w)
+            {
+                delete it->second.workspaces[w];
+            }
+
+            pools.erase(it++);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+template <class edge_type, class open_list>
+typename SearchWorkspace<edge_type, open_list>::Pools& SearchWorkspace<edge_type, open_list>::threadPools()
+{
+    static thread_local Pools pools;
+    return pools;
+}
+
+//------------------------------- acquire -------------------------------------
+//-----------------------------------------------------------------------------
+template <class edge_type, class open_list>
+SearchWorkspace<edge_type, open_list>* SearchWorkspace<edge_type, open_list>::acquire(const void* graph, int numNodes)
+{
+    Pools& pools = threadPools();
+
+    pools.dropRetired();
+
+    typename Pools::Map::iterator it = pools.pools.find(graph);
+
+    if (it == pools.pools.end())
+    {
+        Pool pool;
+        pool.generation = SearchWorkspaceRegistry::getGeneration(graph);
+
+        it = pools.pools.insert(std::make_pair(graph, pool)).first;
+    }
+
+    std::vector<SearchWorkspace*>& pool = it->second.workspaces;
+
+    SearchWorkspace* pWorkspace;
+    if (pool.empty())
+    {
+        pWorkspace = new SearchWorkspace(graph);
+    }
+    else
+    {
+        pWorkspace = pool.back();
+        pool.pop_back();
+    }
+
+    pWorkspace->m_iGeneration = it->second.generation;
+    pWorkspace->begin(numNodes);
+
+    return pWorkspace;
+}
+
+//------------------------------- release -------------------------------------
+//
+//  a workspace is only pooled again if its graph hasn't been retired since
+//  it was acquired, on this thread or another
+//-----------------------------------------------------------------------------
+template <class edge_type, class open_list>
+void SearchWorkspace<edge_type, open_list>::release(SearchWorkspace* pWorkspace)
+{
+    Pools& pools = threadPools();
+
+    pools.dropRetired();
+
+    typename Pools::Map::iterator it = pools.pools.find(pWorkspace->m_pGraph);
+
+    if (it == pools.pools.end())
+    {
+        if (SearchWorkspaceRegistry::getGeneration(pWorkspace->m_pGraph) != pWorkspace->m_iGeneration)
+        {
+            delete pWorkspace;
+            return;
+        }
+
+        Pool pool;
+        pool.generation = pWorkspace->m_iGeneration;
+
+        it = pools.pools.insert(std::make_pair(pWorkspace->m_pGraph, pool)).first;
+    }
+    else if (it->second.generation != pWorkspace->m_iGeneration)
+    {
+        delete pWorkspace;
+        return;
+    }
+
+    it->second.workspaces.push_back(pWorkspace);
+}
+
+//-------------------------------- begin --------------------------------------
+//-----------------------------------------------------------------------------
+template <class edge_type, class open_list>
+void SearchWorkspace<edge_type, open_list>::begin(int numNodes)
+{
+    m_iNumNodes = numNodes;
+
+    if (numNodes > m_iCapacity)
+    {
+        m_iCapacity = numNodes;
+
+        m_Stamps.resize(numNodes, 0);
+        m_GCosts.resize(numNodes, 0.0f);
+        m_FCosts.resize(numNodes, 0.0f);
+        m_Frontier.resize(numNodes, NULL);
+        m_SPT.resize(numNodes, NULL);
+
+        m_PQ.reserve(numNodes);
+    }
+
+    m_PQ.clear();
+
+    //when the stamp wraps round the stamps of the nodes have to be cleared
+    //for real, or a node stamped 2^32 searches ago would look reached
+    if (++m_iStamp == 0)
+    {
+        m_Stamps.assign(m_Stamps.size(), 0);
+        m_iStamp = 1;
+    }
+}
+
+//-------------------------------- getSPT -------------------------------------
+//-----------------------------------------------------------------------------
+template <class edge_type, class open_list>
+std::vector<const edge_type*> SearchWorkspace<edge_type, open_list>::getSPT()const
+{
+    std::vector<const edge_type*> spt(m_iNumNodes, NULL);
+
+    for (int nd=0; nd<m_iNumNodes; ++nd)
+    {
+        if (isReached(nd)) spt[nd] = m_SPT[nd];
+    }
+
+    return spt;
+}
+
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef SEARCH_WORKSPACE_REGISTRY_H
+#define SEARCH_WORKSPACE_REGISTRY_H
+//------------------------------------------------------------------------
+//
+//  Name:   SearchWorkspaceRegistry.h
+//
+//  Desc:   keeps track of the graphs that have been destroyed, so the
+//          search workspaces pooled for them (see SearchWorkspace.h) can
+//          be deleted, and aren't handed to a new graph that happens to
+//          have the same address.
+//
+//------------------------------------------------------------------------
+#include <map>
+#include <mutex>
+#include <atomic>
+
+
+//counts the times each graph address has been retired, for all the
+//workspace pools of all the threads
+class SearchWorkspaceRegistry
+{
+public:
+    //call when a graph that has been searched is destroyed. No search of it
+    //may be running
+    static void retire(const void* graph)
+    {
+        std::lock_guard<std::mutex> lock(getMutex());
+
+        ++getGenerations()[graph];
+        ++getNumRetired();
+    }
+
+    //how many times graph has been retired. A pool made for the graph in
+    //an earlier generation is stale
+    static unsigned int getGeneration(const void* graph)
+    {
+        std::lock_guard<std::mutex> lock(getMutex());
+
+        std::map<const void*, unsigned int>::const_iterator it = getGenerations().find(graph);
+
+        return it == getGenerations().end() ? 0 : it->second;
+    }
+
+    //goes up with every retire, so a thread only looks for stale pools
+    //after one
+    static unsigned int getNumRetiredSoFar(){return getNumRetired().load();}
+
+private:
+    static std::mutex& getMutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    static std::map<const void*, unsigned int>& getGenerations()
+    {
+        static std::map<const void*, unsigned int> generations;
+        return generations;
+    }
+
+    static std::atomic<unsigned int>& getNumRetired()
+    {
+        static std::atomic<unsigned int> numRetired(0);
+        return numRetired;
+    }
+};
+
+
+#endif
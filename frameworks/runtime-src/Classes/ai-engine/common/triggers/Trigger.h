@@ -87,7 +87,7 @@ public:
 
     //called each update-step of the game. This methods updates any internal
     //state the trigger may have
-    virtual void update(float dt) = 0;
+    virtual void update() = 0;
 
     int getGraphNodeIndex()const{return m_iGraphNodeIndex;}
     bool isToBeRemoved()const{return m_bRemoveFromGame;}
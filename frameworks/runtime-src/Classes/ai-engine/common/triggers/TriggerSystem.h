@@ -26,7 +26,7 @@ private:
     //have their m_bRemoveFromGame field set to true.
     void updateTriggers()
     {
-        TriggerList::iterator curTrg = m_Triggers.begin();
+        typename TriggerList::iterator curTrg = m_Triggers.begin();
         while (curTrg != m_Triggers.end())
         {
             //remove trigger if dead
@@ -51,14 +51,14 @@ private:
     void tryTriggers(ContainerOfEntities& entities)
     {
         //test each entity against the triggers
-        ContainerOfEntities::iterator curEnt = entities.begin();
+        typename ContainerOfEntities::iterator curEnt = entities.begin();
         for (curEnt; curEnt != entities.end(); ++curEnt)
         {
             //an entity must be ready for its next trigger update and it must be 
             //alive before it is tested against each trigger.
             if ((*curEnt)->isReadyForTriggerUpdate() && (*curEnt)->isAlive())
             {
-                TriggerList::const_iterator curTrg;
+                typename TriggerList::const_iterator curTrg;
                 for (curTrg = m_Triggers.begin(); curTrg != m_Triggers.end(); ++curTrg)
                 {
                     (*curTrg)->tryCheck(*curEnt);
@@ -77,7 +77,7 @@ public:
     //this deletes any current triggers and empties the trigger list
     void clear()
     {
-        TriggerList::iterator curTrg;
+        typename TriggerList::iterator curTrg;
         for (curTrg = m_Triggers.begin(); curTrg != m_Triggers.end(); ++curTrg)
         {
             delete *curTrg;
@@ -11,7 +11,7 @@
 //
 //-----------------------------------------------------------------------------
 #include "Trigger.h"
-#include <chrono>
+#include "common/misc/SimClock.h"
 
 template <class entity_type>
 class Trigger_LimitedLifetime : public Trigger<entity_type>
@@ -19,20 +19,20 @@ class Trigger_LimitedLifetime : public Trigger<entity_type>
 public:
     Trigger_LimitedLifetime(int lifetime)
     {
-        m_deadTime = std::chrono::steady_clock::now() + std::chrono::seconds(lifetime);
+        m_deadTime = SimClock::now() + std::chrono::seconds(lifetime);
     }
 
     virtual ~Trigger_LimitedLifetime(){}
 
     //children of this class should always make sure this is called from within
     //their own update method
-    virtual void update(float dt)
+    virtual void update()
     {
         //if the lifetime counter expires set this trigger to be removed from
         //the game
-        if (std::chrono::steady_clock::now() >= m_deadTime)
+        if (SimClock::now() >= m_deadTime)
         {
-            setToBeRemovedFromGame();
+            this->setToBeRemovedFromGame();
         }
     }
 
@@ -41,7 +41,7 @@ public:
 
 protected:
     //the lifetime of this trigger in seconds
-    std::chrono::steady_clock::time_point m_deadTime;
+    SimClock::time_point m_deadTime;
 };
 
 
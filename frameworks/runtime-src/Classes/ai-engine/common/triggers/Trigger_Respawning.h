@@ -10,7 +10,7 @@
 //
 //-----------------------------------------------------------------------------
 #include "Trigger.h"
-#include <chrono>
+#include "common/misc/SimClock.h"
 
 template <class entity_type>
 class Trigger_Respawning : public Trigger<entity_type>
@@ -18,21 +18,21 @@ class Trigger_Respawning : public Trigger<entity_type>
 protected:
     unsigned int activePeriodMs; //millisecond
     
-    std::chrono::steady_clock::time_point m_nextActiveTime;
+    SimClock::time_point m_nextActiveTime;
 
     //sets the trigger to be inactive for m_iNumUpdatesBetweenRespawns 
     //update-steps
     void deactivate()
     {
-        setActive(false);
-        m_nextActiveTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(activePeriodMs);
+        this->setActive(false);
+        m_nextActiveTime = SimClock::now() + std::chrono::milliseconds(activePeriodMs);
     }
 
 public:
     Trigger_Respawning()
     {
         activePeriodMs = 5000;
-        m_nextActiveTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(activePeriodMs);
+        m_nextActiveTime = SimClock::now() + std::chrono::milliseconds(activePeriodMs);
     }
 
     virtual ~Trigger_Respawning(){}
@@ -41,11 +41,11 @@ public:
     virtual void tryCheck(entity_type*) = 0;
 
     //this is called each game-tick to update the trigger's internal state
-    virtual void update(float dt)
+    virtual void update()
     {
-        if ( !isActive() && std::chrono::steady_clock::now() > m_nextActiveTime)
+        if ( !this->isActive() && SimClock::now() > m_nextActiveTime)
         {
-            setActive(true);
+            this->setActive(true);
         }
     }
 
@@ -20,18 +20,33 @@
 #include "common/2D/Geometry.h"
 #include "common/2D/WallIntersectionTests.h"
 #include "common/misc/LogDebug.h"
+#include "common/misc/Regulator.h"
+#include "common/misc/WorkerPool.h"
+#include "GameConfig.h"
 #include "misc/ParaConfigRaven.h"
 
 
 //----------------------------- ctor ------------------------------------------
 //-----------------------------------------------------------------------------
-GameWorldRaven::GameWorldRaven():m_pSelectedBot(NULL),
+GameWorldRaven::GameWorldRaven(unsigned int seed):m_Context(Sim_Time_Step, seed),
+                                                    m_Profiler(Profiler_History_Frames),
+                                                    m_pSelectedBot(NULL),
                                                     m_bPaused(false),
                                                     m_bRemoveABot(false),
                                                     m_pMap(NULL),
                                                     m_pPathManager(NULL),
-                                                    m_pGraveMarkers(NULL)
+                                                    m_pAsyncPathManager(NULL),
+                                                    m_pGraveMarkers(NULL),
+                                                    m_pVisionUpdateRegulator(NULL),
+                                                    m_pWorkers(new WorkerPool(Worker_Thread_Num)),
+                                                    m_ui(NULL)
 {
+    //everything the world creates is registered with this context, and the
+    //regulators and timers read its clock
+    m_Context.makeCurrent();
+
+    m_pVisionUpdateRegulator = new Regulator(Para_Bot_VisionUpdateFreq);
+
     //load in the default map
     //loadMap(Para_StartMap));
 }
@@ -41,10 +56,15 @@ GameWorldRaven::GameWorldRaven():m_pSelectedBot(NULL),
 //-----------------------------------------------------------------------------
 GameWorldRaven::~GameWorldRaven()
 {
+    m_Context.makeCurrent();
+
     clear();
     delete m_pPathManager;
+    delete m_pAsyncPathManager;
     delete m_pMap;
     delete m_pGraveMarkers;
+    delete m_pVisionUpdateRegulator;
+    delete m_pWorkers;
 }
 
 void GameWorldRaven::onEnter()
@@ -93,13 +113,35 @@ void GameWorldRaven::update()
     //don't update if the user has paused the game
     if (m_bPaused) return;
 
+    m_Context.makeCurrent();
+    m_Context.getClock().tick();
+
+    m_Profiler.makeCurrent();
+    m_Profiler.beginFrame();
+
+    //deliver any delayed messages that are now due
+    {
+        AIPROFILE("dispatchMsgDelay");
+        MessageDispatcher::instance()->dispatchMsgDelay();
+    }
+
     m_pGraveMarkers->update();
 
     //get any player keyboard input
     //getPlayerInput();
   
-    //update all the queued searches in the path manager
-    m_pPathManager->updateSearches();
+    //update all the queued searches in the path manager, or hand out the
+    //paths the threads have found since the last update
+    if (m_pAsyncPathManager)
+    {
+        AIPROFILE("AsyncPathManager::deliverResults");
+        m_pAsyncPathManager->deliverResults();
+    }
+    else
+    {
+        AIPROFILE("PathManager::updateSearches");
+        m_pPathManager->updateSearches();
+    }
 
     //update any doors
     std::vector<Raven_Door*>::iterator curDoor =m_pMap->getDoors().begin();
@@ -109,21 +151,32 @@ void GameWorldRaven::update()
     }
 
     //update any current projectiles
-    std::list<Projectile*>::iterator curW = m_Projectiles.begin();
-    while (curW != m_Projectiles.end())
     {
-        //test for any dead projectiles and remove them if necessary
-        if (!(*curW)->isDead())
+        AIPROFILE("Projectile::update");
+
+        std::list<Projectile*>::iterator curW = m_Projectiles.begin();
+        while (curW != m_Projectiles.end())
         {
-            (*curW)->update();
-            ++curW;
+            //test for any dead projectiles and remove them if necessary
+            if (!(*curW)->isDead())
+            {
+                (*curW)->update();
+                ++curW;
+            }
+            else
+            { 
+                delete *curW;
+                curW = m_Projectiles.erase(curW);
+            } 
         }
-        else
-        { 
-            delete *curW;
-            curW = m_Projectiles.erase(curW);
-        } 
-  }
+    }
+
+    //update the sensory memory of the bots with any visual stimulus
+    if (m_pVisionUpdateRegulator->isReady())
+    {
+        AIPROFILE("updateVision");
+        updateVision();
+    }
   
     //update the bots
     bool bSpawnPossible = true;
@@ -152,12 +205,16 @@ void GameWorldRaven::update()
         //if this bot is alive update it.
         else if ( (*curBot)->isAlive())
         {
+            AIPROFILE("Raven_Bot::update");
             (*curBot)->update();
         }  
     } 
 
     //update the triggers
-    m_pMap->updateTriggerSystem(m_Bots);
+    {
+        AIPROFILE("updateTriggerSystem");
+        m_pMap->updateTriggerSystem(m_Bots);
+    }
 
     //if the user has requested that the number of bots be decreased, remove one
     if (m_bRemoveABot)
@@ -180,7 +237,31 @@ void GameWorldRaven::update()
         m_bRemoveABot = false;
     }
 
-    render();
+    {
+        AIPROFILE("render");
+        render();
+    }
+
+    m_Profiler.endFrame();
+}
+
+//----------------------------- updateVision ----------------------------------
+//
+//  the LOS between every pair of bots is calculated once, rather than once
+//  by each bot of the pair, then each bot under AI control reads its row
+//-----------------------------------------------------------------------------
+void GameWorldRaven::updateVision()
+{
+    m_Visibility.update(m_Bots, m_pMap->getWallGrid(), Para_Bot_MaxVisionRange, m_pWorkers);
+
+    std::list<Raven_Bot*>::iterator curBot = m_Bots.begin();
+    for (curBot; curBot != m_Bots.end(); ++curBot)
+    {
+        if ((*curBot)->isAlive() && !(*curBot)->isPossessed())
+        {
+            (*curBot)->getSensoryMem()->updateVision(m_Visibility);
+        }
+    }
 }
 
 
@@ -233,6 +314,9 @@ bool GameWorldRaven::attemptToAddBot(Raven_Bot* pBot)
 //-----------------------------------------------------------------------------
 void GameWorldRaven::addBots(unsigned int NumBotsToAdd)
 { 
+    //the bots are registered with the context current when they are made
+    m_Context.makeCurrent();
+
     while (NumBotsToAdd--)
     {
         //create a bot. (its position is irrelevant at this point because it will
@@ -245,7 +329,7 @@ void GameWorldRaven::addBots(unsigned int NumBotsToAdd)
         m_Bots.push_back(rb);
 
         //register the bot with the entity manager
-        EntityManager::instance()->addEntity(rb);
+        m_Context.getEntityManager().addEntity(rb);
     }
 }
 
@@ -264,7 +348,7 @@ void GameWorldRaven::notifyAllBotsOfRemoval(Raven_Bot* pRemovedBot)const
                                                                             -1, 
                                                                             (*curBot)->getID(),
                                                                             Msg_UserHasRemovedBot, 
-                                                                            pRemovedBot);
+                                                                            EntityHandle(pRemovedBot->getID()));
     }
 }
 //-------------------------------removeBot ------------------------------------
@@ -273,6 +357,8 @@ void GameWorldRaven::notifyAllBotsOfRemoval(Raven_Bot* pRemovedBot)const
 //-----------------------------------------------------------------------------
 void GameWorldRaven::removeBot()
 {
+    m_Context.makeCurrent();
+
     m_bRemoveABot = true;
 }
 
@@ -280,6 +366,8 @@ void GameWorldRaven::removeBot()
 //-----------------------------------------------------------------------------
 void GameWorldRaven::addBolt(Raven_Bot* shooter, Vector2D target)
 {
+    m_Context.makeCurrent();
+
     Projectile* rp = new Bolt(shooter, target);
 
     m_Projectiles.push_back(rp);
@@ -288,6 +376,8 @@ void GameWorldRaven::addBolt(Raven_Bot* shooter, Vector2D target)
 //------------------------------ addRocket --------------------------------
 void GameWorldRaven::addRocket(Raven_Bot* shooter, Vector2D target)
 {
+    m_Context.makeCurrent();
+
     Projectile* rp = new Rocket(shooter, target);
 
     m_Projectiles.push_back(rp);
@@ -296,6 +386,8 @@ void GameWorldRaven::addRocket(Raven_Bot* shooter, Vector2D target)
 //------------------------- addRailGunSlug -----------------------------------
 void GameWorldRaven::addRailGunSlug(Raven_Bot* shooter, Vector2D target)
 {
+    m_Context.makeCurrent();
+
     Projectile* rp = new Slug(shooter, target);
 
     m_Projectiles.push_back(rp);
@@ -304,6 +396,8 @@ void GameWorldRaven::addRailGunSlug(Raven_Bot* shooter, Vector2D target)
 //------------------------- addShotGunPellet -----------------------------------
 void GameWorldRaven::addShotGunPellet(Raven_Bot* shooter, Vector2D target)
 {
+    m_Context.makeCurrent();
+
     Projectile* rp = new Pellet(shooter, target);
 
     m_Projectiles.push_back(rp);
@@ -340,24 +434,48 @@ Raven_Bot* GameWorldRaven::getBotAtPosition(Vector2D CursorPos)const
 //-----------------------------------------------------------------------------
 bool GameWorldRaven::loadMap(const std::string& filename)
 {  
+    //the old entities are deleted from, and the new ones registered with,
+    //the context current on the thread
+    m_Context.makeCurrent();
+
     //clear any current bots and projectiles
     clear();
 
     //out with the old
+    if (m_pPathManager)
+    {
+        const PathManagerStats& stats = m_pAsyncPathManager ? m_pAsyncPathManager->getStats() : m_pPathManager->getStats();
+        AILOG("Paths: %d found, %d cancelled, %d coalesced, queue depth max %d, latency mean %.1fms max %.1fms, update max %.0fus",
+              stats.numCompleted, stats.numCancelled, stats.numCoalesced, stats.maxQueueDepth,
+              stats.getMeanLatencyMs(), stats.maxLatencyMs, stats.maxUpdateUs);
+    }
+
+    //the threads must be done with the old map before it goes
+    delete m_pAsyncPathManager;
+    m_pAsyncPathManager = NULL;
+
     delete m_pMap;
     delete m_pGraveMarkers;
     delete m_pPathManager;
 
     //in with the new
     m_pGraveMarkers = new GraveMarkers(Para_GraveLifetime);
-    m_pPathManager = new PathManager<Raven_PathPlanner>(Para_MaxSearchCyclesPerUpdateStep);
+    m_pPathManager = new PathManager<Raven_PathPlanner>(Para_MaxSearchCyclesPerUpdateStep,
+                                                        Para_PathSearchMicrosecondsPerUpdate,
+                                                        Para_PathPriorityPerUpdateWaited);
+
+    if (Para_PathSearchThreads > 0)
+    {
+        m_pAsyncPathManager = new AsyncPathManager<Raven_PathPlanner>(Para_PathSearchThreads);
+    }
+
     m_pMap = new Raven_Map();
 
     //make sure the entity manager is reset
-    EntityManager::instance()->reset();
+    m_Context.getEntityManager().reset();
 
     //load the new map data
-    if (m_pMap->loadMap(filename))
+    if (m_pMap->loadMap(filename, m_pWorkers))
     { 
         addBots(Para_NumBots);
         return true;
@@ -496,7 +614,7 @@ void GameWorldRaven::changeWeaponOfPossessedBot(unsigned int weapon)const
 //------------------------------------------------------------------------------
 bool GameWorldRaven::isLOSOkay(Vector2D A, Vector2D B)const
 {
-    return !doWallsObstructLineSegment(A, B, m_pMap->getWalls());
+    return !doWallsObstructLineSegment(A, B, m_pMap->getWallGrid());
 }
 
 //------------------------- isPathObstructed ----------------------------------
@@ -517,7 +635,7 @@ bool GameWorldRaven::isPathObstructed(Vector2D A,Vector2D B,float BoundingRadius
         curPos += ToB * 0.5 * BoundingRadius;
 
         //test all walls against the new position
-        if (doWallsIntersectCircle(m_pMap->getWalls(), curPos, BoundingRadius))
+        if (doWallsIntersectCircle(m_pMap->getWallGrid(), curPos, BoundingRadius))
         {
             return true;
         }
@@ -548,7 +666,7 @@ GameWorldRaven::getAllBotsInFOV(const Raven_Bot* pBot)const
         {
             //cast a ray from between the bots to test visibility. If the bot is
             //visible add it to the vector
-            if (!doWallsObstructLineSegment(pBot->getPos(),(*curBot)->getPos(),m_pMap->getWalls()))
+            if (!doWallsObstructLineSegment(pBot->getPos(),(*curBot)->getPos(),m_pMap->getWallGrid()))
             {
                 VisibleBots.push_back(*curBot);
             }
@@ -570,7 +688,7 @@ bool GameWorldRaven::isSecondVisibleToFirst(const Raven_Bot* pFirst, const Raven
         {
             //test the line segment connecting the bot's positions against the walls.
             //If the bot is visible add it to the vector
-            if (!doWallsObstructLineSegment(pFirst->getPos(),pSecond->getPos(),m_pMap->getWalls()))
+            if (!doWallsObstructLineSegment(pFirst->getPos(),pSecond->getPos(),m_pMap->getWallGrid()))
             {
                 return true;
             }
@@ -609,6 +727,8 @@ Vector2D GameWorldRaven::getPosOfClosestSwitch(Vector2D botPos, unsigned int doo
     {
         BaseEntity* trig = EntityManager::instance()->getEntityByID(*it);
 
+        if (trig == NULL) continue;
+
         if (isLOSOkay(botPos, trig->getPos()))
         {
             float dist = Vec2DistanceSq(botPos, trig->getPos());
@@ -21,21 +21,28 @@
 #include "common/game/Wall.h"
 #include "common/game/CommonFunction.h"
 #include "common/navigation/PathManager.h"
+#include "common/navigation/AsyncPathManager.h"
+#include "common/game/WorldContext.h"
+#include "common/misc/Profiler.h"
 #include "navigation/Raven_PathPlanner.h"
 #include "misc/Raven_Bot.h"
+#include "sensor_memory/Raven_Visibility.h"
 
 
 class BaseEntity;
 class Projectile;
 class Raven_Map;
 class GraveMarkers;
+class Regulator;
+class WorkerPool;
 
 
 
 class GameWorldRaven :public BaseNode
 {
 public:
-    GameWorldRaven();
+    //seed seeds the random numbers of the game
+    GameWorldRaven(unsigned int seed = 0);
     
     ~GameWorldRaven();
 
@@ -109,6 +116,15 @@ public:
     const std::list<Raven_Bot*>& getAllBots()const{return m_Bots;}
     
     PathManager<Raven_PathPlanner>* const getPathManager(){return m_pPathManager;}
+
+    //NULL unless the paths are planned on threads of their own
+    //(Para_PathSearchThreads)
+    AsyncPathManager<Raven_PathPlanner>* const getAsyncPathManager(){return m_pAsyncPathManager;}
+
+    WorldContext& getContext(){return m_Context;}
+    const SimClock& getClock()const{return m_Context.getClock();}
+
+    Profiler& getProfiler(){return m_Profiler;}
     
     int getNumBots()const{return m_Bots.size();}
 
@@ -117,6 +133,13 @@ public:
 
 
 private:
+    //the entities, messages, clock and random numbers of the game. The
+    //clock is ticked once per update
+    WorldContext m_Context;
+
+    //times the parts of each update
+    Profiler m_Profiler;
+
     //the current game map
     Raven_Map* m_pMap;
 
@@ -133,6 +156,10 @@ private:
     //this class manages all the path planning requests
     PathManager<Raven_PathPlanner>* m_pPathManager;
 
+    //or this one, when they are planned off the game thread. The results
+    //are delivered at the point of the update the path manager would run
+    AsyncPathManager<Raven_PathPlanner>* m_pAsyncPathManager;
+
     //if true the game will be paused
     bool m_bPaused;
 
@@ -143,11 +170,23 @@ private:
     //class manages the graves
     GraveMarkers* m_pGraveMarkers;
 
+    //the LOS between every pair of bots, recalculated Para_Bot_VisionUpdateFreq
+    //times a second and used to update the bots' sensory memories
+    Raven_VisibilityMatrix m_Visibility;
+    Regulator* m_pVisionUpdateRegulator;
+
+    //the threads the visibility matrix is calculated on
+    WorkerPool* m_pWorkers;
+
     pNode m_ui;
     
     //this iterates through each trigger, testing each one against each bot
     void updateTriggers();
 
+    //recalculates the visibility matrix and updates the vision of every bot
+    //under AI control
+    void updateVision();
+
     //deletes all entities, empties all containers and creates a new navgraph 
     void clear();
 
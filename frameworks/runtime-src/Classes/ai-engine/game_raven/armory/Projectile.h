@@ -14,7 +14,7 @@
 #include "common/game/MovingEntity.h"
 #include "common/2D/Vector2D.h"
 #include <list>
-#include <chrono>
+#include "common/misc/SimClock.h"
 
 class GameWorldRaven;
 class Raven_Bot;
@@ -51,7 +51,7 @@ protected:
 
     //this is stamped with the time this projectile was instantiated. This is
     //to enable the shot to be rendered for a specific length of time
-    std::chrono::steady_clock::time_point m_dTimeOfCreation;
+    SimClock::time_point m_dTimeOfCreation;
 
     Raven_Bot* getClosestIntersectingBot(Vector2D From, Vector2D To) const;
 
@@ -83,7 +83,7 @@ public:
                 
 
     {
-        m_dTimeOfCreation = std::chrono::steady_clock::now();
+        m_dTimeOfCreation = SimClock::now();
     }
 
     //must be implemented
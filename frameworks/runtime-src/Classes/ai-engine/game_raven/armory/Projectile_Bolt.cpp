@@ -1,14 +1,12 @@
 #include "Projectile_Bolt.h"
-#include "../lua/Raven_Scriptor.h"
-#include "misc/cgdi.h"
-#include "../Raven_Bot.h"
+#include "../misc/Raven_Bot.h"
 #include "../GameWorldRaven.h"
-#include "../constants.h"
-#include "2d/WallIntersectionTests.h"
-#include "../Raven_Map.h"
+#include "common/2D/WallIntersectionTests.h"
+#include "../misc/Raven_Map.h"
 
-#include "../RavenMessages.h"
+#include "../misc/RavenMessages.h"
 #include "common/message/MessageDispatcher.h"
+#include "../misc/ParaConfigRaven.h"
 
 
 //-------------------------- ctor ---------------------------------------------
@@ -63,7 +61,7 @@ void Bolt::update()
                                                                                 m_iShooterID, 
                                                                                 hit->getID(),
                                                                                 Msg_TakeThatMF, 
-                                                                                (void*)&m_iDamageInflicted);
+                                                                                m_iDamageInflicted);
         }
 
         //test for impact with a wall
@@ -72,7 +70,7 @@ void Bolt::update()
                                                                          m_vPosition,
                                                                          dist,
                                                                          m_vImpactPoint,
-                                                                         m_pWorld->getMap()->getWalls()))
+                                                                         m_pWorld->getMap()->getWallGrid()))
         {
             m_bDead     = true;
             m_bImpacted = true;
@@ -1,16 +1,14 @@
 #include "Projectile_Pellet.h"
-#include "../lua/Raven_Scriptor.h"
-#include "misc/cgdi.h"
-#include "../Raven_Bot.h"
+#include "../misc/Raven_Bot.h"
 #include "../GameWorldRaven.h"
-#include "game/EntityFunctionTemplates.h"
-#include "../constants.h"
-#include "2d/WallIntersectionTests.h"
-#include "../Raven_Map.h"
+#include "common/game/CommonFunction.h"
+#include "common/2D/WallIntersectionTests.h"
+#include "../misc/Raven_Map.h"
 #include <list>
 
-#include "../Raven_Messages.h"
-#include "Messaging/MessageDispatcher.h"
+#include "../misc/RavenMessages.h"
+#include "common/message/MessageDispatcher.h"
+#include "../misc/ParaConfigRaven.h"
 
 
 
@@ -74,7 +72,7 @@ void Pellet::testForImpact()
                                                               m_vPosition,
                                                               DistToClosestImpact,
                                                               m_vImpactPoint,
-                                                              m_pWorld->getMap()->getWalls());
+                                                              m_pWorld->getMap()->getWallGrid());
 
     //test to see if the ray between the current position of the shell and 
     //the start position intersects with any bots.
@@ -98,5 +96,5 @@ void Pellet::testForImpact()
                                                                         m_iShooterID, 
                                                                         hit->getID(),
                                                                         Msg_TakeThatMF, 
-                                                                        (void*)&m_iDamageInflicted);  
+                                                                        m_iDamageInflicted);  
 }
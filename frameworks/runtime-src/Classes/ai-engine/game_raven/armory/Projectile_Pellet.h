@@ -11,7 +11,7 @@
 //-----------------------------------------------------------------------------
 
 #include "Projectile.h"
-#include <chrono>
+#include "common/misc/SimClock.h"
 
 class Raven_Bot;
 
@@ -28,7 +28,7 @@ private:
     //returns true if the shot is still to be rendered
     bool isVisibleToPlayer()const
     {
-        auto curTime = std::chrono::steady_clock::now();
+        auto curTime = SimClock::now();
         auto endTime = m_dTimeOfCreation + std::chrono::milliseconds((int)(m_dTimeShotIsVisible*1000));
         return curTime < endTime;
     }
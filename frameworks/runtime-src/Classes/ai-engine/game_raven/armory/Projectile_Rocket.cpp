@@ -1,14 +1,12 @@
 #include "Projectile_Rocket.h"
-#include "../lua/Raven_Scriptor.h"
-#include "misc/cgdi.h"
-#include "../Raven_Bot.h"
+#include "../misc/Raven_Bot.h"
 #include "../GameWorldRaven.h"
-#include "../constants.h"
-#include "2d/WallIntersectionTests.h"
-#include "../Raven_Map.h"
+#include "common/2D/WallIntersectionTests.h"
+#include "../misc/Raven_Map.h"
 
-#include "../Raven_Messages.h"
-#include "Messaging/MessageDispatcher.h"
+#include "../misc/RavenMessages.h"
+#include "common/message/MessageDispatcher.h"
+#include "../misc/ParaConfigRaven.h"
 
 
 //-------------------------- ctor ---------------------------------------------
@@ -39,7 +37,7 @@ void Rocket::update()
         m_vVelocity = getMaxSpeed() * getHeading();
 
         //make sure vehicle does not exceed maximum velocity
-        m_vVelocity.Truncate(m_dMaxSpeed);
+        m_vVelocity.truncate(m_dMaxSpeed);
 
         //update the position
         m_vPosition += m_vVelocity;
@@ -81,7 +79,7 @@ void Rocket::testForImpact()
                                                                             m_iShooterID, 
                                                                             hit->getID(),
                                                                             Msg_TakeThatMF, 
-                                                                            (void*)&m_iDamageInflicted);  
+                                                                            m_iDamageInflicted);  
 
         //test for bots within the blast radius and inflict damage
         inflictDamageOnBotsWithinBlastRadius();
@@ -93,7 +91,7 @@ void Rocket::testForImpact()
                                                                      m_vPosition,
                                                                      dist,
                                                                      m_vImpactPoint,
-                                                                     m_pWorld->getMap()->getWalls()))
+                                                                     m_pWorld->getMap()->getWallGrid()))
     {
         m_bImpacted = true;
         //test for bots within the blast radius and inflict damage
@@ -131,7 +129,7 @@ void Rocket::inflictDamageOnBotsWithinBlastRadius()
                                                                                 m_iShooterID, 
                                                                                 (*curBot)->getID(),
                                                                                 Msg_TakeThatMF, 
-                                                                                (void*)&m_iDamageInflicted);  
+                                                                                m_iDamageInflicted);  
         }
     }  
 }
@@ -1,14 +1,13 @@
 #include "Projectile_Slug.h"
-#include "../lua/Raven_Scriptor.h"
-#include "misc/cgdi.h"
-#include "../Raven_Bot.h"
+#include "../misc/Raven_Bot.h"
 #include "../GameWorldRaven.h"
-#include "game/EntityFunctionTemplates.h"
-#include "2d/WallIntersectionTests.h"
-#include "../Raven_Map.h"
+#include "common/game/CommonFunction.h"
+#include "common/2D/WallIntersectionTests.h"
+#include "../misc/Raven_Map.h"
 
-#include "../Raven_Messages.h"
-#include "Messaging/MessageDispatcher.h"
+#include "../misc/RavenMessages.h"
+#include "common/message/MessageDispatcher.h"
+#include "../misc/ParaConfigRaven.h"
 
 #include <list>
 
@@ -72,7 +71,7 @@ void Slug::testForImpact()
                                           m_vPosition,
                                           DistToClosestImpact,
                                           m_vImpactPoint,
-                                          m_pWorld->getMap()->getWalls());
+                                          m_pWorld->getMap()->getWallGrid());
 
     //test to see if the ray between the current position of the slug and 
     //the start position intersects with any bots.
@@ -91,7 +90,7 @@ void Slug::testForImpact()
                                                                         m_iShooterID, 
                                                                         (*it)->getID(),
                                                                         Msg_TakeThatMF, 
-                                                                        (void*)&m_iDamageInflicted);      
+                                                                        m_iDamageInflicted);      
     }
 }
 
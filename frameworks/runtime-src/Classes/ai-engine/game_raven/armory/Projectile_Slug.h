@@ -26,7 +26,7 @@ private:
     //returns true if the shot is still to be rendered
     bool isVisibleToPlayer()const
     {
-        auto curTime = std::chrono::steady_clock::now();
+        auto curTime = SimClock::now();
         auto endTime = m_dTimeOfCreation + std::chrono::milliseconds((int)(m_dTimeShotIsVisible*1000));
         return curTime < endTime;
     }
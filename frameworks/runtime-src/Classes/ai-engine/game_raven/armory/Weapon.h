@@ -11,9 +11,9 @@
 #include <vector>
 
 #include "common/2D/Vector2D.h"
-#include "../Raven_Bot.h"
-#include "Fuzzy/FuzzyModule.h"
-#include <chrono>
+#include "../misc/Raven_Bot.h"
+#include "common/fuzzy/FuzzyModule.h"
+#include "common/misc/SimClock.h"
 
 
 class  Raven_Bot;
@@ -42,7 +42,7 @@ protected:
     int m_dRateOfFire;
 
     //the earliest time the next shot can be taken
-    std::chrono::steady_clock::time_point m_dTimeNextAvailable;
+    SimClock::time_point m_dTimeNextAvailable;
 
     //this is used to keep a local copy of the previous desirability score
     //so that we can give some feedback for debugging
@@ -82,7 +82,7 @@ public:
                                                                  m_dIdealRange(IdealRange),
                                                                  m_dMaxProjectileSpeed(ProjectileSpeed)
     {  
-        m_dTimeNextAvailable = std::chrono::steady_clock::now();
+        m_dTimeNextAvailable = SimClock::now();
     }
 
     virtual ~Weapon(){}
@@ -125,7 +125,7 @@ public:
 //-----------------------------------------------------------------------------
 inline bool Weapon::isReadyForNextShot()
 {
-    if (std::chrono::steady_clock::now() > m_dTimeNextAvailable)
+    if (SimClock::now() > m_dTimeNextAvailable)
     {
         return true;
     }
@@ -136,7 +136,7 @@ inline bool Weapon::isReadyForNextShot()
 //-----------------------------------------------------------------------------
 inline void Weapon::updateTimeWeaponIsNextAvailable()
 {
-    m_dTimeNextAvailable = std::chrono::steady_clock::now() + std::chrono::milliseconds((int)(1000/m_dRateOfFire));
+    m_dTimeNextAvailable = SimClock::now() + std::chrono::milliseconds((int)(1000/m_dRateOfFire));
 }
 
 
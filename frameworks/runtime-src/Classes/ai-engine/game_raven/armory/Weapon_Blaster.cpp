@@ -1,8 +1,9 @@
 #include "Weapon_Blaster.h"
-#include "../Raven_Bot.h"
+#include "../misc/Raven_Bot.h"
 #include "../GameWorldRaven.h"
-#include "../Raven_Map.h"
-#include "fuzzy/FuzzyOperators.h"
+#include "../misc/Raven_Map.h"
+#include "common/fuzzy/FuzzyOperators.h"
+#include "../misc/ParaConfigRaven.h"
 
 
 //--------------------------- ctor --------------------------------------------
@@ -60,14 +61,14 @@ void Blaster::initializeFuzzyModule()
 {
     FuzzyVariable& DistToTarget = m_FuzzyModule.createFLV("DistToTarget");
 
-    FzSet& Target_Close = DistToTarget.addLeftShoulderSet("Target_Close",0,25,150);
-    FzSet& Target_Medium = DistToTarget.addTriangularSet("Target_Medium",25,150,300);
-    FzSet& Target_Far = DistToTarget.addRightShoulderSet("Target_Far",150,300,1000);
+    FzSet Target_Close = DistToTarget.addLeftShoulderSet("Target_Close",0,25,150);
+    FzSet Target_Medium = DistToTarget.addTriangularSet("Target_Medium",25,150,300);
+    FzSet Target_Far = DistToTarget.addRightShoulderSet("Target_Far",150,300,1000);
 
     FuzzyVariable& Desirability = m_FuzzyModule.createFLV("Desirability"); 
-    FzSet& VeryDesirable = Desirability.addRightShoulderSet("VeryDesirable", 50, 75, 100);
-    FzSet& Desirable = Desirability.addTriangularSet("Desirable", 25, 50, 75);
-    FzSet& Undesirable = Desirability.addLeftShoulderSet("Undesirable", 0, 25, 50);
+    FzSet VeryDesirable = Desirability.addRightShoulderSet("VeryDesirable", 50, 75, 100);
+    FzSet Desirable = Desirability.addTriangularSet("Desirable", 25, 50, 75);
+    FzSet Undesirable = Desirability.addLeftShoulderSet("Undesirable", 0, 25, 50);
 
     m_FuzzyModule.addRule(Target_Close, Desirable);
     m_FuzzyModule.addRule(Target_Medium, FzVery(Undesirable));
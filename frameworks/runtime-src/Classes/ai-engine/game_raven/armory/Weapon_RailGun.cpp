@@ -1,8 +1,9 @@
 #include "Weapon_RailGun.h"
-#include "../Raven_Bot.h"
+#include "../misc/Raven_Bot.h"
 #include "../GameWorldRaven.h"
-#include "../Raven_Map.h"
+#include "../misc/Raven_Map.h"
 #include "common/fuzzy/FuzzyOperators.h"
+#include "../misc/ParaConfigRaven.h"
 
 
 //--------------------------- ctor --------------------------------------------
@@ -35,7 +36,7 @@ inline void RailGun::shootAt(Vector2D pos)
 
         //add a trigger to the game so that the other bots can hear this shot
         //(provided they are within range)
-        m_pOwner->getWorld()->getMap()->addSoundTrigger(m_pOwner, script->GetDouble("RailGun_SoundRange"));
+        m_pOwner->getWorld()->getMap()->addSoundTrigger(m_pOwner, Para_RailGun_SoundRange);
     }
 }
 
@@ -68,20 +69,20 @@ void RailGun::initializeFuzzyModule()
 { 
     FuzzyVariable& DistanceToTarget = m_FuzzyModule.createFLV("DistanceToTarget");
 
-    FzSet& Target_Close = DistanceToTarget.addLeftShoulderSet("Target_Close", 0, 25, 150);
-    FzSet& Target_Medium = DistanceToTarget.addTriangularSet("Target_Medium", 25, 150, 300);
-    FzSet& Target_Far = DistanceToTarget.addRightShoulderSet("Target_Far", 150, 300, 1000);
+    FzSet Target_Close = DistanceToTarget.addLeftShoulderSet("Target_Close", 0, 25, 150);
+    FzSet Target_Medium = DistanceToTarget.addTriangularSet("Target_Medium", 25, 150, 300);
+    FzSet Target_Far = DistanceToTarget.addRightShoulderSet("Target_Far", 150, 300, 1000);
 
     FuzzyVariable& Desirability = m_FuzzyModule.createFLV("Desirability");
 
-    FzSet& VeryDesirable = Desirability.addRightShoulderSet("VeryDesirable", 50, 75, 100);
-    FzSet& Desirable = Desirability.addTriangularSet("Desirable", 25, 50, 75);
-    FzSet& Undesirable = Desirability.addLeftShoulderSet("Undesirable", 0, 25, 50);
+    FzSet VeryDesirable = Desirability.addRightShoulderSet("VeryDesirable", 50, 75, 100);
+    FzSet Desirable = Desirability.addTriangularSet("Desirable", 25, 50, 75);
+    FzSet Undesirable = Desirability.addLeftShoulderSet("Undesirable", 0, 25, 50);
 
     FuzzyVariable& AmmoStatus = m_FuzzyModule.createFLV("AmmoStatus");
-    FzSet& Ammo_Loads = AmmoStatus.addRightShoulderSet("Ammo_Loads", 15, 30, 100);
-    FzSet& Ammo_Okay = AmmoStatus.addTriangularSet("Ammo_Okay", 0, 15, 30);
-    FzSet& Ammo_Low = AmmoStatus.addTriangularSet("Ammo_Low", 0, 0, 15);
+    FzSet Ammo_Loads = AmmoStatus.addRightShoulderSet("Ammo_Loads", 15, 30, 100);
+    FzSet Ammo_Okay = AmmoStatus.addTriangularSet("Ammo_Okay", 0, 15, 30);
+    FzSet Ammo_Low = AmmoStatus.addTriangularSet("Ammo_Low", 0, 0, 15);
 
 
     m_FuzzyModule.addRule(FzAND(Target_Close, Ammo_Loads), FzFairly(Desirable));
@@ -22,7 +22,7 @@ public:
 
     void shootAt(Vector2D pos);
 
-    float getDesirability(double DistToTarget);
+    float getDesirability(float DistToTarget);
   
 private:
     void initializeFuzzyModule();  
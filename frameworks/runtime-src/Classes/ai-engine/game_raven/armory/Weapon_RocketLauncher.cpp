@@ -1,8 +1,9 @@
 #include "Weapon_RocketLauncher.h"
-#include "../Raven_Bot.h"
+#include "../misc/Raven_Bot.h"
 #include "../GameWorldRaven.h"
-#include "../Raven_Map.h"
+#include "../misc/Raven_Map.h"
 #include "common/fuzzy/FuzzyOperators.h"
+#include "../misc/ParaConfigRaven.h"
 
 
 //--------------------------- ctor --------------------------------------------
@@ -68,19 +69,19 @@ void RocketLauncher::initializeFuzzyModule()
 {
     FuzzyVariable& DistToTarget = m_FuzzyModule.createFLV("DistToTarget");
 
-    FzSet& Target_Close = DistToTarget.addLeftShoulderSet("Target_Close",0,25,150);
-    FzSet& Target_Medium = DistToTarget.addTriangularSet("Target_Medium",25,150,300);
-    FzSet& Target_Far = DistToTarget.addRightShoulderSet("Target_Far",150,300,1000);
+    FzSet Target_Close = DistToTarget.addLeftShoulderSet("Target_Close",0,25,150);
+    FzSet Target_Medium = DistToTarget.addTriangularSet("Target_Medium",25,150,300);
+    FzSet Target_Far = DistToTarget.addRightShoulderSet("Target_Far",150,300,1000);
 
     FuzzyVariable& Desirability = m_FuzzyModule.createFLV("Desirability"); 
-    FzSet& VeryDesirable = Desirability.addRightShoulderSet("VeryDesirable", 50, 75, 100);
-    FzSet& Desirable = Desirability.addTriangularSet("Desirable", 25, 50, 75);
-    FzSet& Undesirable = Desirability.addLeftShoulderSet("Undesirable", 0, 25, 50);
+    FzSet VeryDesirable = Desirability.addRightShoulderSet("VeryDesirable", 50, 75, 100);
+    FzSet Desirable = Desirability.addTriangularSet("Desirable", 25, 50, 75);
+    FzSet Undesirable = Desirability.addLeftShoulderSet("Undesirable", 0, 25, 50);
 
     FuzzyVariable& AmmoStatus = m_FuzzyModule.createFLV("AmmoStatus");
-    FzSet& Ammo_Loads = AmmoStatus.addRightShoulderSet("Ammo_Loads", 10, 30, 100);
-    FzSet& Ammo_Okay = AmmoStatus.addTriangularSet("Ammo_Okay", 0, 10, 30);
-    FzSet& Ammo_Low = AmmoStatus.addTriangularSet("Ammo_Low", 0, 0, 10);
+    FzSet Ammo_Loads = AmmoStatus.addRightShoulderSet("Ammo_Loads", 10, 30, 100);
+    FzSet Ammo_Okay = AmmoStatus.addTriangularSet("Ammo_Okay", 0, 10, 30);
+    FzSet Ammo_Low = AmmoStatus.addTriangularSet("Ammo_Low", 0, 0, 10);
 
 
     m_FuzzyModule.addRule(FzAND(Target_Close, Ammo_Loads), Undesirable);
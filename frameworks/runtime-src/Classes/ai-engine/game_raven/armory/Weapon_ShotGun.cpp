@@ -1,8 +1,9 @@
 #include "Weapon_ShotGun.h"
-#include "../Raven_Bot.h"
+#include "../misc/Raven_Bot.h"
 #include "../GameWorldRaven.h"
-#include "../Raven_Map.h"
-#include "fuzzy/FuzzyOperators.h"
+#include "../misc/Raven_Map.h"
+#include "common/fuzzy/FuzzyOperators.h"
+#include "../misc/ParaConfigRaven.h"
 
 
 //--------------------------- ctor --------------------------------------------
@@ -83,20 +84,20 @@ void ShotGun::initializeFuzzyModule()
 {  
     FuzzyVariable& DistanceToTarget = m_FuzzyModule.createFLV("DistanceToTarget");
 
-    FzSet& Target_Close = DistanceToTarget.addLeftShoulderSet("Target_Close", 0, 25, 150);
-    FzSet& Target_Medium = DistanceToTarget.addTriangularSet("Target_Medium", 25, 150, 300);
-    FzSet& Target_Far = DistanceToTarget.addRightShoulderSet("Target_Far", 150, 300, 1000);
+    FzSet Target_Close = DistanceToTarget.addLeftShoulderSet("Target_Close", 0, 25, 150);
+    FzSet Target_Medium = DistanceToTarget.addTriangularSet("Target_Medium", 25, 150, 300);
+    FzSet Target_Far = DistanceToTarget.addRightShoulderSet("Target_Far", 150, 300, 1000);
 
     FuzzyVariable& Desirability = m_FuzzyModule.createFLV("Desirability");
 
-    FzSet& VeryDesirable = Desirability.addRightShoulderSet("VeryDesirable", 50, 75, 100);
-    FzSet& Desirable = Desirability.addTriangularSet("Desirable", 25, 50, 75);
-    FzSet& Undesirable = Desirability.addLeftShoulderSet("Undesirable", 0, 25, 50);
+    FzSet VeryDesirable = Desirability.addRightShoulderSet("VeryDesirable", 50, 75, 100);
+    FzSet Desirable = Desirability.addTriangularSet("Desirable", 25, 50, 75);
+    FzSet Undesirable = Desirability.addLeftShoulderSet("Undesirable", 0, 25, 50);
 
     FuzzyVariable& AmmoStatus = m_FuzzyModule.createFLV("AmmoStatus");
-    FzSet& Ammo_Loads = AmmoStatus.addRightShoulderSet("Ammo_Loads", 30, 60, 100);
-    FzSet& Ammo_Okay = AmmoStatus.addTriangularSet("Ammo_Okay", 0, 30, 60);
-    FzSet& Ammo_Low = AmmoStatus.addTriangularSet("Ammo_Low", 0, 0, 30);
+    FzSet Ammo_Loads = AmmoStatus.addRightShoulderSet("Ammo_Loads", 30, 60, 100);
+    FzSet Ammo_Okay = AmmoStatus.addTriangularSet("Ammo_Okay", 0, 30, 60);
+    FzSet Ammo_Low = AmmoStatus.addTriangularSet("Ammo_Low", 0, 0, 30);
 
     m_FuzzyModule.addRule(FzAND(Target_Close, Ammo_Loads), VeryDesirable);
     m_FuzzyModule.addRule(FzAND(Target_Close, Ammo_Okay), VeryDesirable);
@@ -1,7 +1,7 @@
 #include "Evaluator_AttackTarget.h"
 #include "Goal_Think.h"
 #include "Raven_Goal_Types.h"
-#include "../Raven_WeaponSystem.h"
+#include "../weapon_handling/Raven_WeaponSystem.h"
 #include "Raven_Feature.h"
 
 
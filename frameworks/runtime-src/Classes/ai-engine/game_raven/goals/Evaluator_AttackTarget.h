@@ -11,7 +11,7 @@
 //-----------------------------------------------------------------------------
 
 #include "Evaluator.h"
-#include "../Raven_Bot.h"
+#include "../misc/Raven_Bot.h"
 
 
 class Evaluator_AttackTarget : public Evaluator
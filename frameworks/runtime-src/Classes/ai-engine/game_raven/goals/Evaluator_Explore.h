@@ -10,7 +10,7 @@
 //-----------------------------------------------------------------------------
 
 #include "Evaluator.h"
-#include "../Raven_Bot.h"
+#include "../misc/Raven_Bot.h"
 
 
 class Evaluator_Explore : public Evaluator
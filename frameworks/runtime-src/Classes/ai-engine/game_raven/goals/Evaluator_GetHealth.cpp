@@ -2,6 +2,7 @@
 #include "Goal_Think.h"
 #include "Raven_Goal_Types.h"
 #include "Raven_Feature.h"
+#include "../misc/ParaConfigRaven.h"
 
 
 //---------------------- calculateDesirability -------------------------------------
@@ -26,7 +27,7 @@ float Evaluator_GetHealth::calculateDesirability(Raven_Bot* pBot)
         //the desirability of finding a health item is proportional to the amount
         //of health remaining and inversely proportional to the distance from the
         //nearest instance of a health item.
-        float Desirability = Tweaker * (1-Raven_Feature::Health(pBot)) / 
+        float Desirability = Tweaker * (1-Raven_Feature::getHealth(pBot)) / 
                         (Raven_Feature::getDistanceToItem(pBot, type_health));
 
         //ensure the value is in the range 0 to 1
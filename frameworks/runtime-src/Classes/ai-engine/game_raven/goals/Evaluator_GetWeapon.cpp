@@ -1,6 +1,6 @@
 #include "Evaluator_GetWeapon.h"
 #include "../GameWorldRaven.h"
-#include "../Raven_Map.h"
+#include "../misc/Raven_Map.h"
 #include "Goal_Think.h"
 #include "Raven_Goal_Types.h"
 #include "Raven_Feature.h"
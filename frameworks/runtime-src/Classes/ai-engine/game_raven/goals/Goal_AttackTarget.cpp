@@ -2,7 +2,7 @@
 #include "Goal_SeekToPosition.h"
 #include "Goal_HuntTarget.h"
 #include "Goal_DodgeSideToSide.h"
-#include "../Raven_Bot.h"
+#include "../misc/Raven_Bot.h"
 
 
 
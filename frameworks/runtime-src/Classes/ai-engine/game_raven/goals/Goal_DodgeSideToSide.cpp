@@ -1,10 +1,10 @@
 #include "Goal_DodgeSideToSide.h"
 #include "Goal_SeekToPosition.h"
-#include "../Raven_Bot.h"
-#include "../Raven_SteeringBehaviors.h"
+#include "../misc/Raven_Bot.h"
+#include "../misc/Raven_SteeringBehaviors.h"
 #include "../GameWorldRaven.h"
 #include "common/message/Telegram.h"
-#include "../RavenMessages.h"
+#include "../misc/RavenMessages.h"
 
 
 
@@ -11,7 +11,7 @@
 #include "common/goals/Goal.h"
 #include "common/misc/UtilsEx.h"
 #include "Raven_Goal_Types.h"
-#include "../Raven_Bot.h"
+#include "../misc/Raven_Bot.h"
 
 
 
@@ -1,9 +1,9 @@
 #include "Goal_Explore.h"
-#include "../Raven_Bot.h"
+#include "../misc/Raven_Bot.h"
 #include "../navigation/Raven_PathPlanner.h"
 #include "../GameWorldRaven.h"
-#include "../Raven_Map.h"
-#include "../RavenMessages.h"
+#include "../misc/Raven_Map.h"
+#include "../misc/RavenMessages.h"
 #include "common/message/Telegram.h"
 #include "Goal_SeekToPosition.h"
 #include "Goal_FollowPath.h"
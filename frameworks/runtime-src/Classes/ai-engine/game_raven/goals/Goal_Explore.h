@@ -2,6 +2,7 @@
 #define GOAL_EXPLORE_H
 #pragma warning (disable:4786)
 
+#include "common/2D/Vector2D.h"
 #include "common/goals/GoalComposite.h"
 #include "Raven_Goal_Types.h"
 
@@ -5,10 +5,22 @@
 
 Goal_FollowPath::Goal_FollowPath(Raven_Bot* pBot,std::list<PathEdge> path):
                                                             GoalComposite<Raven_Bot>(pBot, goal_follow_path),
-                                                            m_Path(path)
+                                                            m_Path(path),
+                                                            m_iSearchID(pBot->getPathPlanner()->getSearchID())
 {
 }
 
+//---------------------------- isPathPartial ----------------------------------
+//
+//  the planner may have started another search since the path was handed
+//  over, in which case what it has to come is not part of this path
+//-----------------------------------------------------------------------------
+bool Goal_FollowPath::isPathPartial()const
+{
+    return m_pOwner->getPathPlanner()->getSearchID() == m_iSearchID &&
+           m_pOwner->getPathPlanner()->isPathPartial();
+}
+
 
 //------------------------------ activate -------------------------------------
 //-----------------------------------------------------------------------------
@@ -16,27 +28,45 @@ void Goal_FollowPath::activate()
 {
     m_iStatus = active;
 
+    //fetch the next part of a hierarchical path when this one runs out. A
+    //part may refine to no edges at all, so keep going until one has some
+    //or the whole path has been handed out
+    while (m_Path.empty() && isPathPartial())
+    {
+        m_Path = m_pOwner->getPathPlanner()->getNextPathSegment();
+    }
+
+    //nothing left to follow
+    if (m_Path.empty())
+    {
+        m_iStatus = completed;
+        return;
+    }
+
     //get a reference to the next edge
     PathEdge edge = m_Path.front();
 
     //remove the edge from the path
     m_Path.pop_front(); 
 
+    //the bot only comes to a stop at the end of the last edge of the whole path
+    bool bLastEdge = m_Path.empty() && !isPathPartial();
+
     //some edges specify that the bot should use a specific behavior when
     //following them. This switch statement queries the edge behavior flag and
     //adds the appropriate goals/s to the subgoal list.
-    switch(edge.Behavior())
+    switch(edge.getBehavior())
     {
         case NavGraphEdge::normal:
         {
-            addSubgoal(new Goal_TraverseEdge(m_pOwner, edge, m_Path.empty()));
+            addSubgoal(new Goal_TraverseEdge(m_pOwner, edge, bLastEdge));
             break;
         }
 
         case NavGraphEdge::goes_through_door:
         {
             //also add a goal that is able to handle opening the door
-            addSubgoal(new Goal_NegotiateDoor(m_pOwner, edge, m_Path.empty()));
+            addSubgoal(new Goal_NegotiateDoor(m_pOwner, edge, bLastEdge));
             break;
         }
         
@@ -69,7 +99,7 @@ int Goal_FollowPath::process()
 
     //if there are no subgoals present check to see if the path still has edges.
     //remaining. If it does then call activate to grab the next edge.
-    if (m_iStatus == completed && !m_Path.empty())
+    if (m_iStatus == completed && (!m_Path.empty() || isPathPartial()))
     {
         activate(); 
     }
@@ -10,8 +10,8 @@
 //-----------------------------------------------------------------------------
 #include "common/goals/GoalComposite.h"
 #include "Raven_Goal_Types.h"
-#include "game_raven/Raven_Bot.h"
-#include "common/navigation/Raven_PathPlanner.h"
+#include "../misc/Raven_Bot.h"
+#include "../navigation/Raven_PathPlanner.h"
 #include "common/navigation/PathEdge.h"
 
 
@@ -19,6 +19,8 @@
 class Goal_FollowPath : public GoalComposite<Raven_Bot>
 {
 public:
+    //if path is the first part of a hierarchical path the rest is fetched
+    //from the bot's path planner as the bot gets to the end of each part
     Goal_FollowPath(Raven_Bot* pBot, std::list<PathEdge> path);
     //the usual suspects
     void activate();
@@ -28,6 +30,12 @@ public:
 private:
     //a local copy of the path returned by the path planner
     std::list<PathEdge> m_Path;  
+
+    //the search of the path planner the path came from
+    unsigned int m_iSearchID;
+
+    //true if the planner has more of the path to come
+    bool isPathPartial()const;
 };
 
 #endif
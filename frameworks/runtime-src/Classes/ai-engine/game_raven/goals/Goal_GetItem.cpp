@@ -1,10 +1,12 @@
 #include "Goal_GetItem.h"
-#include "../Raven_Bot.h"
+#include "../misc/Raven_Bot.h"
 #include "../navigation/Raven_PathPlanner.h"
 #include "common/message/Telegram.h"
-#include "..\RavenMessages.h"
+#include "common/game/EntityManager.h"
+#include "../misc/RavenMessages.h"
 #include "Goal_Wander.h"
 #include "Goal_FollowPath.h"
+#include "../misc/ParaConfigRaven.h"
 
 
 int itemTypeToGoalType(int gt)
@@ -73,7 +75,7 @@ bool Goal_GetItem::handleMessage(const Telegram& msg)
     //if the msg was not handled, test to see if this goal can handle it
     if (bHandled == false)
     {
-        switch(msg.Msg)
+        switch(msg.m_msgId)
         {
             case Msg_PathReady:
             {
@@ -81,7 +83,8 @@ bool Goal_GetItem::handleMessage(const Telegram& msg)
                 removeAllSubgoals();
                 addSubgoal(new Goal_FollowPath(m_pOwner, m_pOwner->getPathPlanner()->getPath()));
                 //get the pointer to the item
-                m_pGiverTrigger = static_cast<Raven_Map::TriggerType*>(msg.m_extraInfo);
+                m_pGiverTrigger = static_cast<Raven_Map::TriggerType*>(
+                    EntityManager::instance()->getEntityByID(msg.m_extraInfo.get<EntityHandle>().id));
                 return true; //msg handled
             }
 
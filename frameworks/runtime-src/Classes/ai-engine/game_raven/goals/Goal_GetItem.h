@@ -2,9 +2,9 @@
 #define GOAL_GET_ITEM_H
 #pragma warning (disable:4786)
 
-#include "Goals/GoalComposite.h"
+#include "common/goals/GoalComposite.h"
 #include "Raven_Goal_Types.h"
-#include "../Raven_Bot.h"
+#include "../misc/Raven_Bot.h"
 #include "common/triggers/Trigger.h"
 
 
@@ -30,7 +30,7 @@ private:
 public:
 
     Goal_GetItem(Raven_Bot* pBot,int item):GoalComposite<Raven_Bot>(pBot,
-                                                                        ItemTypeToGoalType(item)),
+                                                                        itemTypeToGoalType(item)),
                                                                         m_iItemToGet(item),
                                                                         m_pGiverTrigger(0),
                                                                         m_bFollowingPath(false)
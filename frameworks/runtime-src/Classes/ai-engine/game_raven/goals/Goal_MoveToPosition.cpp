@@ -1,6 +1,6 @@
 #include "Goal_MoveToPosition.h"
-#include "Messaging/Telegram.h"
-#include "game_raven/RavenMessages.h"
+#include "common/message/Telegram.h"
+#include "../misc/RavenMessages.h"
 #include "Goal_SeekToPosition.h"
 #include "Goal_FollowPath.h"
 
@@ -4,7 +4,7 @@
 
 #include "common/goals/GoalComposite.h"
 #include "common/2D/Vector2D.h"
-#include "game_raven/Raven_Bot.h"
+#include "../misc/Raven_Bot.h"
 #include "Raven_Goal_Types.h"
 
 
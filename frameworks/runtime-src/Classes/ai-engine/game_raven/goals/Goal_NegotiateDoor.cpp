@@ -1,6 +1,6 @@
 #include "Goal_NegotiateDoor.h"
-#include "..\Raven_Bot.h"
-#include "..\GameWorldRaven.h"
+#include "../misc/Raven_Bot.h"
+#include "../GameWorldRaven.h"
 #include "../navigation/Raven_PathPlanner.h" 
 #include "Goal_MoveToPosition.h"
 #include "Goal_TraverseEdge.h"
@@ -4,8 +4,8 @@
 
 #include "common/goals/GoalComposite.h"
 #include "Raven_Goal_Types.h"
-#include "../Raven_Bot.h"
-#include "../navigation/PathEdge.h"
+#include "../misc/Raven_Bot.h"
+#include "common/navigation/PathEdge.h"
 
 
 class Goal_NegotiateDoor : public GoalComposite<Raven_Bot>
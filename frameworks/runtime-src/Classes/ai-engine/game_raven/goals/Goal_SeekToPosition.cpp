@@ -1,5 +1,5 @@
 #include "Goal_SeekToPosition.h"
-#include "Raven_SteeringBehaviors.h"
+#include "../misc/Raven_SteeringBehaviors.h"
 #include "game_raven/navigation/Raven_PathPlanner.h"
 #include "common/misc/LogDebug.h"
 
@@ -19,7 +19,7 @@ void Goal_SeekToPosition::activate()
     m_iStatus = active;
 
     //record the time the bot starts this goal
-    m_dStartTime = std::chrono::steady_clock::now();
+    m_dStartTime = SimClock::now();
 
      //factor in a margin of error for any reactive behavior
     static const float MarginOfError = 1.0f;
@@ -65,7 +65,7 @@ int Goal_SeekToPosition::process()
 //-----------------------------------------------------------------------------
 bool Goal_SeekToPosition::isStuck()const
 {  
-    if (std::chrono::steady_clock::now() > m_dTimeToReachPos)
+    if (SimClock::now() > m_dTimeToReachPos)
     {
         AILOG("BOT %d is stuck !!", m_pOwner->getID());
         return true;
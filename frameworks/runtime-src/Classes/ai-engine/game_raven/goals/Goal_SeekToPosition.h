@@ -5,8 +5,8 @@
 #include "common/goals/Goal.h"
 #include "common/2D/Vector2D.h"
 #include "Raven_Goal_Types.h"
-#include "game_raven/Raven_Bot.h"
-#include <chrono>
+#include "../misc/Raven_Bot.h"
+#include "common/misc/SimClock.h"
 
 
 class Goal_SeekToPosition : public Goal<Raven_Bot>
@@ -26,10 +26,10 @@ private:
     Vector2D m_vPosition;
 
     //this records the time this goal was activated
-    std::chrono::steady_clock::time_point m_dStartTime;
+    SimClock::time_point m_dStartTime;
 
     //the approximate time the bot should take to travel the target location
-    std::chrono::steady_clock::time_point m_dTimeToReachPos;
+    SimClock::time_point m_dTimeToReachPos;
     
     //returns true if a bot gets stuck
     bool isStuck()const;
@@ -1,9 +1,7 @@
 #include "Goal_Think.h"
 #include <list>
-#include "misc/Cgdi.h"
-#include "../Raven_ObjectEnumerations.h"
-#include "misc/utils.h"
-#include "../lua/Raven_Scriptor.h"
+#include "../misc/ParaConfigRaven.h"
+#include "common/misc/UtilsEx.h"
 
 #include "Goal_MoveToPosition.h"
 #include "Goal_Explore.h"
@@ -147,7 +145,7 @@ void Goal_Think::addGoal_Explore()
 
 void Goal_Think::addGoal_GetItem(unsigned int ItemType)
 {
-    if (notPresent(ItemTypeToGoalType(ItemType)))
+    if (notPresent(itemTypeToGoalType(ItemType)))
     {
         removeAllSubgoals();
         addSubgoal( new Goal_GetItem(m_pOwner, ItemType));
@@ -165,7 +163,7 @@ void Goal_Think::addGoal_AttackTarget()
 
 //-------------------------- Queue Goals --------------------------------------
 //-----------------------------------------------------------------------------
-void Goal_Think::QueueGoal_MoveToPosition(Vector2D pos)
+void Goal_Think::queueGoal_MoveToPosition(Vector2D pos)
 {
     m_SubGoals.push_back(new Goal_MoveToPosition(m_pOwner, pos));
 }
@@ -1,8 +1,9 @@
 #include "Goal_TraverseEdge.h"
 #include "Raven_Goal_Types.h"
-#include "../Raven_SteeringBehaviors.h"
+#include "../misc/Raven_SteeringBehaviors.h"
 #include "../navigation/Raven_PathPlanner.h"
 #include "common/misc/LogDebug.h"
+#include "../misc/ParaConfigRaven.h"
 
 
 
@@ -26,11 +27,11 @@ void Goal_TraverseEdge::activate()
 
     //the edge behavior flag may specify a type of movement that necessitates a 
     //change in the bot's max possible speed as it follows this edge
-    switch(m_Edge.Behavior())
+    switch(m_Edge.getBehavior())
     {
         case NavGraphEdge::swim:
         {
-            m_pOwner->setMaxSpeed(Para_Bot_MaxSwimmingSpeed));
+            m_pOwner->setMaxSpeed(Para_Bot_MaxSwimmingSpeed);
             //show animation...
         }
         break;
@@ -45,7 +46,7 @@ void Goal_TraverseEdge::activate()
   
 
     //record the time the bot starts this goal
-    m_dStartTime = std::chrono::steady_clock::now();
+    m_dStartTime = SimClock::now();
 
     //factor in a margin of error for any reactive behavior
     static const float MarginOfError = 2.0f;
@@ -103,7 +104,7 @@ int Goal_TraverseEdge::process()
 //-----------------------------------------------------------------------------
 bool Goal_TraverseEdge::isStuck()const
 {  
-    if (std::chrono::steady_clock::now() > m_dTimeExpected)
+    if (SimClock::now() > m_dTimeExpected)
     {
         AILOG("BOT %d is stuck !!", m_pOwner->getID());
         return true;
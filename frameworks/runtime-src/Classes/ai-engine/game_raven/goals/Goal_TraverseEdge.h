@@ -4,10 +4,10 @@
 
 #include "common/goals/Goal.h"
 #include "common/2D/Vector2D.h"
-#include "common/navigation/Raven_PathPlanner.h"
+#include "../navigation/Raven_PathPlanner.h"
 #include "common/navigation/PathEdge.h"
-#include "game_raven/Raven_Bot.h"
-#include <chrono>
+#include "../misc/Raven_Bot.h"
+#include "common/misc/SimClock.h"
 
 
 class Goal_TraverseEdge : public Goal<Raven_Bot>
@@ -30,10 +30,10 @@ private:
     bool m_bLastEdgeInPath;
 
     //the estimated time the bot should take to traverse the edge
-    std::chrono::steady_clock::time_point m_dTimeExpected;
+    SimClock::time_point m_dTimeExpected;
 
     //this records the time this goal was activated
-    std::chrono::steady_clock::time_point m_dStartTime;
+    SimClock::time_point m_dStartTime;
 
     //returns true if the bot gets stuck
     bool isStuck()const;    
@@ -1,6 +1,6 @@
 
 #include "Goal_Wander.h"
-#include "Raven_SteeringBehaviors.h"
+#include "../misc/Raven_SteeringBehaviors.h"
 
 
 void Goal_Wander::activate()
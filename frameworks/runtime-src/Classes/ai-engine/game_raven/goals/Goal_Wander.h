@@ -9,7 +9,7 @@
 //-----------------------------------------------------------------------------
 #include "common/goals/Goal.h"
 #include "Raven_Goal_Types.h"
-#include "game_raven/Raven_Bot.h"
+#include "../misc/Raven_Bot.h"
 
 
 class Goal_Wander : public Goal<Raven_Bot>
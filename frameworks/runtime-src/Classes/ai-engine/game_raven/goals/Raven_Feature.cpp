@@ -1,8 +1,9 @@
 #include "Raven_Feature.h"
-#include "../Raven_Bot.h"
+#include "../misc/Raven_Bot.h"
 #include "../navigation/Raven_PathPlanner.h"
 #include "../armory/Weapon.h"
-#include "../Raven_WeaponSystem.h"
+#include "../weapon_handling/Raven_WeaponSystem.h"
+#include "../misc/ParaConfigRaven.h"
 
 //-----------------------------------------------------------------------------
 float Raven_Feature::getDistanceToItem(Raven_Bot* pBot, int ItemType)
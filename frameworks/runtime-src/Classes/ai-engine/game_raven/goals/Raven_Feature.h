@@ -37,7 +37,7 @@ public:
     static float getTotalWeaponStrength(Raven_Bot* pBot);
 
 private:
-    float getMaxRoundsBotCanCarryForWeapon(int WeaponType);
+    static float getMaxRoundsBotCanCarryForWeapon(int WeaponType);
 };
 
 
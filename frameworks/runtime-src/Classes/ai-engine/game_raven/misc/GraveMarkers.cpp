@@ -12,7 +12,7 @@ GraveMarkers::GraveMarkers(float lifetime):m_dLifeTime(lifetime)
 void GraveMarkers::update()
 {
     GraveList::iterator it = m_GraveList.begin();
-    std::chrono::steady_clock::time_point curTime = std::chrono::steady_clock::now();
+    SimClock::time_point curTime = SimClock::now();
     while (it != m_GraveList.end())
     {
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(curTime - it->TimeCreated).count()/1000;
@@ -12,7 +12,7 @@
 #include <list>
 #include <vector>
 #include "common/2D/Vector2D.h"
-#include <chrono>
+#include "common/misc/SimClock.h"
 
 class GraveMarkers
 {
@@ -20,9 +20,9 @@ private:
     struct GraveRecord
     {
         Vector2D Position;
-        std::chrono::steady_clock::time_point TimeCreated;
+        SimClock::time_point TimeCreated;
 
-        GraveRecord(Vector2D pos):Position(pos),TimeCreated(std::chrono::steady_clock::now())
+        GraveRecord(Vector2D pos):Position(pos),TimeCreated(SimClock::now())
         {
         }
     };
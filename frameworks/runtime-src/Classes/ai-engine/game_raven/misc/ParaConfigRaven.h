@@ -37,6 +37,22 @@ typedef enum {
 //planning searches per update
 #define Para_MaxSearchCyclesPerUpdateStep  1000
 
+//and the time they may take per update, in microseconds
+#define Para_PathSearchMicrosecondsPerUpdate   500.0f
+
+//the priority of a path request rises by this much for every update it
+//waits, by Para_PathPriorityInCombat if the bot has a target, and falls by
+//Para_PathPriorityPerDistance for each unit the target is away
+#define Para_PathPriorityPerUpdateWaited   1.0f
+#define Para_PathPriorityInCombat   10.0f
+#define Para_PathPriorityPerDistance   0.01f
+
+//if not 0 the paths are planned on this many threads of their own (see
+//AsyncPathManager) instead of being time-sliced by the path manager, and
+//the paths to items lead to the closest active item at the time of the
+//request, by the path cost lookup
+#define Para_PathSearchThreads   0
+
 //the name of the default map
 #define Para_StartMap  "maps/Raven_DM1.map"
 
@@ -44,6 +60,20 @@ typedef enum {
 #define Para_NumCellsX  10
 #define Para_NumCellsY  10
 
+//how the cost of travelling between two navgraph nodes is looked up
+//  0 - a table of all the pairs, calculated when the map is loaded
+//  1 - a cost row is calculated when it is first needed and the most
+//      recently used Para_PathCostCacheRows rows are kept
+//  2 - a lower bound from Para_PathCostLandmarks landmark nodes
+#define Para_PathCostStorage   1
+#define Para_PathCostCacheRows   256
+#define Para_PathCostLandmarks   16
+
+//the table of all the pairs is saved next to the map in a file with the
+//map's name followed by this, and is read from there the next time the
+//map is loaded
+#define Para_PathCostFileExtension   ".costs"
+
 //how long the graves remain on screen
 #define Para_GraveLifetime   5
 
@@ -53,6 +83,11 @@ typedef enum {
 #define para_path_smooth_quick      1
 #define para_path_smooth_precise    0
 
+//if 1 the paths to positions are planned over the clusters of the navgraph
+//(the cells of the cell space partition) and refined a piece at a time as
+//the bot follows them. If 0 they are planned with A* over the whole navgraph
+#define Para_PathHierarchical   1
+
 
 
 //-------------------------[[ bot parameters ]]----------------------------------
@@ -65,6 +100,10 @@ typedef enum {
 #define Para_Bot_MaxHeadTurnRate   0.2f
 #define Para_Bot_Scale         0.8f
 
+//half the width of raven_bot.png. The bots don't take their size from the
+//sprite, which is never loaded without a renderer
+#define Para_Bot_BoundingRadius   16.0f
+
 //special movement speeds (unused)
 #define Para_Bot_MaxSwimmingSpeed   (Para_Bot_MaxSpeed * 0.2f)
 #define Para_Bot_MaxCrawlingSpeed   (Para_Bot_MaxSpeed * 0.6f)
@@ -84,6 +123,10 @@ typedef enum {
 //the number of times a second a bot updates its vision
 #define Para_Bot_VisionUpdateFreq   4
 
+//bots further apart than this can't see each other. 0 means there is no
+//limit other than the walls
+#define Para_Bot_MaxVisionRange   0
+
 //note that a frequency of -1 will disable the feature and a frequency of zero
 //will ensure the feature is updated every bot update
 
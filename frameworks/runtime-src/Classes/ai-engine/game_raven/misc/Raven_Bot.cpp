@@ -3,10 +3,12 @@
 #include "Raven_Bot.h"
 
 #include "common/misc/Regulator.h"
+#include "common/misc/Profiler.h"
 #include "common/misc/LogDebug.h"
 #include "common/misc/UtilsEx.h"
 #include "common/message/Telegram.h"
 #include "common/message/MessageDispatcher.h"
+#include "common/game/EntityManager.h"
 #include "../GameWorldRaven.h"
 #include "../navigation/Raven_PathPlanner.h"
 #include "../weapon_handling/Raven_WeaponSystem.h"
@@ -39,10 +41,13 @@ Raven_Bot::Raven_Bot(GameWorldRaven* world,Vector2D pos):
                                                         m_iScore(0),
                                                         m_Status(spawning),
                                                         m_bPossessed(false),
-                                                        m_dFieldOfView(degreeToRadians(Para_Bot_FOV))
+                                                        m_iVisibilityRow(-1),
+                                                        m_dFieldOfView(degreeToRadians(Para_Bot_FOV)),
+                                                        m_ui(NULL)
            
 {
     setEntityType(type_bot);
+    setBoundingRadius(Para_Bot_BoundingRadius);
 
     //a bot starts off facing in the direction it is heading
     m_vFacing = m_vHeading;
@@ -58,7 +63,6 @@ Raven_Bot::Raven_Bot(GameWorldRaven* world,Vector2D pos):
     m_pGoalArbitrationRegulator =  new Regulator(Para_Bot_GoalAppraisalUpdateFreq);
     m_pTargetSelectionRegulator = new Regulator(Para_Bot_TargetingUpdateFreq);
     m_pTriggerTestRegulator = new Regulator(Para_Bot_TriggerUpdateFreq);
-    m_pVisionUpdateRegulator = new Regulator(Para_Bot_VisionUpdateFreq);
 
     //create the goal queue
     m_pBrain = new Goal_Think(this);
@@ -88,7 +92,6 @@ Raven_Bot::~Raven_Bot()
     delete m_pGoalArbitrationRegulator;
     delete m_pTargetSelectionRegulator;
     delete m_pTriggerTestRegulator;
-    delete m_pVisionUpdateRegulator;
     delete m_pWeaponSys;
     delete m_pSensoryMem;
 }
@@ -114,10 +117,16 @@ void Raven_Bot::update()
     //process the currently active goal. Note this is required even if the bot
     //is under user control. This is because a goal is created whenever a user 
     //clicks on an area of the map that necessitates a path planning request.
-    m_pBrain->process();
+    {
+        AIPROFILE("Goal_Think::process");
+        m_pBrain->process();
+    }
   
     //Calculate the steering force and update the bot's velocity and position
-    updateMovement();
+    {
+        AIPROFILE("updateMovement");
+        updateMovement();
+    }
 
     //if the bot is under AI control but not scripted
     if (!isPossessed())
@@ -126,30 +135,28 @@ void Raven_Bot::update()
         //to be the current target
         if (m_pTargetSelectionRegulator->isReady())
         {      
+            AIPROFILE("Raven_TargetingSystem::update");
             m_pTargSys->update();
         }
 
         //appraise and arbitrate between all possible high level goals
         if (m_pGoalArbitrationRegulator->isReady())
         {
+            AIPROFILE("Goal_Think::arbitrate");
             m_pBrain->arbitrate(); 
         }
 
-        //update the sensory memory with any visual stimulus
-        if (m_pVisionUpdateRegulator->isReady())
-        {
-            m_pSensoryMem->updateVision();
-        }
-
         //select the appropriate weapon to use from the weapons currently in
         //the inventory
         if (m_pWeaponSelectionRegulator->isReady())
         {       
+            AIPROFILE("Raven_WeaponSystem::selectWeapon");
             m_pWeaponSys->selectWeapon();       
         }
 
         //this method aims the bot's current weapon at the current target
         //and takes a shot if a shot is possible
+        AIPROFILE("Raven_WeaponSystem::takeAimAndShoot");
         m_pWeaponSys->takeAimAndShoot();
     }
 }
@@ -223,7 +230,7 @@ bool Raven_Bot::handleMessage(const Telegram& msg)
             if (isDead() || isSpawning()) return true;
 
             //the extra info field of the telegram carries the amount of damage
-            reduceHealth(dereferenceToType<int>(msg.m_extraInfo));
+            reduceHealth(msg.m_extraInfo.get<int>());
 
             //if this bot is now dead let the shooter know
             if (isDead())
@@ -232,7 +239,7 @@ bool Raven_Bot::handleMessage(const Telegram& msg)
                                                                                     getID(), 
                                                                                     msg.m_sender,
                                                                                     Msg_YouGotMeYouSOB, 
-                                                                                    nullptr);
+                                                                                    NO_ADDITIONAL_INFO);
             
             }
             return true;
@@ -247,14 +254,24 @@ bool Raven_Bot::handleMessage(const Telegram& msg)
         
         case Msg_GunshotSound:
         {
-            //add the source of this sound to the bot's percepts
-            getSensoryMem()->updateWithSoundSource((Raven_Bot*)msg.m_extraInfo);
+            Raven_Bot* pSource = static_cast<Raven_Bot*>(
+                EntityManager::instance()->getEntityByID(msg.m_extraInfo.get<EntityHandle>().id));
+
+            //add the source of this sound to the bot's percepts, unless it
+            //has been removed since
+            if (pSource)
+            {
+                getSensoryMem()->updateWithSoundSource(pSource);
+            }
             return true;
         }
         
         case Msg_UserHasRemovedBot:
         {
-            Raven_Bot* pRemovedBot = (Raven_Bot*)msg.m_extraInfo;
+            //the message is sent before the bot is deleted, so it can still
+            //be looked up
+            Raven_Bot* pRemovedBot = static_cast<Raven_Bot*>(
+                EntityManager::instance()->getEntityByID(msg.m_extraInfo.get<EntityHandle>().id));
 
             getSensoryMem()->removeBotFromMemory(pRemovedBot);
 
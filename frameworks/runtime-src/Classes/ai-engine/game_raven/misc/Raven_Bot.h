@@ -65,6 +65,10 @@ public:
     void setDead(){m_Status = dead;}
     void setAlive(){m_Status = alive;}
 
+    //the bot's row in the world's visibility matrix, set by the matrix
+    int getVisibilityRow()const{return m_iVisibilityRow;}
+    void setVisibilityRow(int row){m_iVisibilityRow = row;}
+
     //returns a value indicating the time in seconds it will take the bot
     //to reach the given position at its current speed.
     float calculateTimeToReachPosition(Vector2D pos)const; 
@@ -153,7 +157,6 @@ private:
     Regulator* m_pGoalArbitrationRegulator;
     Regulator* m_pTargetSelectionRegulator;
     Regulator* m_pTriggerTestRegulator;
-    Regulator* m_pVisionUpdateRegulator;
 
     //the bot's health. Every time the bot is shot this value is decreased. If
     //it reaches zero then the bot dies (and respawns)
@@ -186,6 +189,10 @@ private:
     //set to true when a human player takes over control of the bot
     bool m_bPossessed;
 
+    //the row the visibility matrix gave the bot in its last update, -1 if
+    //it hasn't been in one
+    int m_iVisibilityRow;
+
     pNode m_ui;
     
     //bots shouldn't be copied, only created or respawned
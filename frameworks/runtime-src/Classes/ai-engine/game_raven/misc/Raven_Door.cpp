@@ -7,8 +7,11 @@
 
 //---------------------------- ctor -------------------------------------------
 //-----------------------------------------------------------------------------
-Raven_Door::Raven_Door(Raven_Map* pMap, Vector2D m_vP1, Vector2D m_vP2):m_Status(status_closed),
-                                  m_iNumTicksStayOpen(60)                   //MGC
+Raven_Door::Raven_Door(Raven_Map* pMap, Vector2D p1, Vector2D p2):m_Status(status_closed),
+                                  m_iNumTicksStayOpen(60),                   //MGC
+                                  m_iNumTicksCurrentlyOpen(0),
+                                  m_vP1(p1),
+                                  m_vP2(p2)
 {
     m_vtoP2Norm =  Vec2Normalize(m_vP2 - m_vP1);
     m_dCurrentSize = m_dSize = Vec2Distance(m_vP2, m_vP1);
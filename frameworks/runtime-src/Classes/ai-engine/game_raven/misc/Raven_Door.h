@@ -66,7 +66,8 @@ protected:
     void changePosition(Vector2D newP1, Vector2D newP2);
  
 public:
-    Raven_Door(Raven_Map* pMap, std::ifstream& is);
+    //the door is closed, from p1 to p2
+    Raven_Door(Raven_Map* pMap, Vector2D p1, Vector2D p2);
     ~Raven_Door();
 
     //the usual suspects
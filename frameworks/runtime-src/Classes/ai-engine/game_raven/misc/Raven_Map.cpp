@@ -2,6 +2,8 @@
 #include "Raven_Door.h"
 #include "common/game/EntityManager.h"
 #include "common/graph/HandyGraphFunctions.h"
+#include "common/misc/LogDebug.h"
+#include "ParaConfigRaven.h"
 #include "../triggers/Trigger_OnButtonSendMsg.h"
 #include "../triggers/Trigger_HealthGiver.h"
 #include "../triggers/Trigger_WeaponGiver.h"
@@ -10,6 +12,7 @@
 //----------------------------- ctor ------------------------------------------
 //-----------------------------------------------------------------------------
 Raven_Map::Raven_Map():m_pNavGraph(NULL),
+                                            m_pPathCosts(NULL),
                                             m_pSpacePartition(NULL),
                                             m_iSizeY(0),
                                             m_iSizeX(0),
@@ -48,9 +51,14 @@ void Raven_Map::clear()
         delete *curWall;
     }
     m_Walls.clear();
+    m_WallGrid.clear();
     
     m_SpawnPoints.clear();
 
+    //the path costs refer to the navgraph so they go first
+    delete m_pPathCosts;
+    m_pPathCosts = NULL;
+
     //delete the navgraph
     if (m_pNavGraph)
     {
@@ -74,14 +82,39 @@ Wall* Raven_Map::addWall(Vector2D from, Vector2D to)
     return w;
 }
 
+//--------------------------- addWall -----------------------------------------
+//-----------------------------------------------------------------------------
+void Raven_Map::addWall(std::ifstream& in)
+{
+    //the normal is recalculated from the ends so the one in the file is
+    //skipped
+    float x1, y1, x2, y2, nx, ny;
+    in >> x1 >> y1 >> x2 >> y2 >> nx >> ny;
+
+    addWall(Vector2D(x1,y1), Vector2D(x2,y2));
+}
+
 //--------------------------- addDoor -----------------------------------------
 //-----------------------------------------------------------------------------
-void Raven_Map::addDoor(Vector2D left, Vector2D right)
+void Raven_Map::addDoor(std::ifstream& in)
 {
-    Raven_Door* pDoor = new Raven_Door(this, left, right);
+    int id, numSwitches;
+    float x1, y1, x2, y2;
+    in >> id >> x1 >> y1 >> x2 >> y2 >> numSwitches;
+
+    Raven_Door* pDoor = new Raven_Door(this, Vector2D(x1,y1), Vector2D(x2,y2));
 
     m_Doors.push_back(pDoor);
 
+    //the switches are added once all the triggers have been read
+    for (int s=0; s<numSwitches; ++s)
+    {
+        int switchID;
+        in >> switchID;
+
+        m_DoorSwitchesOfMapIDs.push_back(std::make_pair(pDoor, switchID));
+    }
+
     //register the entity 
     EntityManager::instance()->addEntity(pDoor);
 }
@@ -90,19 +123,55 @@ void Raven_Map::addDoor(Vector2D left, Vector2D right)
 //-----------------------------------------------------------------------------
 void Raven_Map::addDoorTrigger(std::ifstream& in)
 {
-    Trigger_OnButtonSendMsg<Raven_Bot>* tr = new Trigger_OnButtonSendMsg<Raven_Bot>(in);
+    //the receiver is set by linkDoorsToSwitches
+    int id, receiver, msg;
+    float x, y, r;
+    in >> id >> receiver >> msg >> x >> y >> r;
+
+    Trigger_OnButtonSendMsg<Raven_Bot>* tr = new Trigger_OnButtonSendMsg<Raven_Bot>(Vector2D(x,y), msg, -1, r);
 
     m_TriggerSystem.registerTrigger(tr);
 
+    m_DoorTriggersOfMapIDs[id] = tr;
+
     //register the entity 
     EntityManager::instance()->addEntity(tr);
 }
 
+//------------------------- linkDoorsToSwitches -------------------------------
+//
+//  each door is given the IDs of the triggers that open it and each trigger
+//  the ID of its door
+//-----------------------------------------------------------------------------
+void Raven_Map::linkDoorsToSwitches()
+{
+    std::vector<std::pair<Raven_Door*, int> >::iterator curSwitch = m_DoorSwitchesOfMapIDs.begin();
+    for (curSwitch; curSwitch != m_DoorSwitchesOfMapIDs.end(); ++curSwitch)
+    {
+        std::map<int, Trigger_OnButtonSendMsg<Raven_Bot>*>::iterator trg = m_DoorTriggersOfMapIDs.find(curSwitch->second);
+
+        if (trg == m_DoorTriggersOfMapIDs.end())
+        {
+            throw std::runtime_error("<Map::load>: A door refers to a switch that isn't in the map");
+        }
+
+        trg->second->setReceiver(curSwitch->first->getID());
+        curSwitch->first->addSwitch(trg->second->getID());
+    }
+
+    m_DoorSwitchesOfMapIDs.clear();
+    m_DoorTriggersOfMapIDs.clear();
+}
+
 
 //---------------------------- addSpawnPoint ----------------------------------
 //-----------------------------------------------------------------------------
-void Raven_Map::addSpawnPoint(float x, float y)
+void Raven_Map::addSpawnPoint(std::ifstream& in)
 {
+    //the dummy values are left over from the map editor
+    float x, y, dummy;
+    in >> dummy >> x >> y >> dummy >> dummy;
+
     m_SpawnPoints.push_back(Vector2D(x,y));
 }
 
@@ -111,12 +180,18 @@ void Raven_Map::addSpawnPoint(float x, float y)
 //-----------------------------------------------------------------------------
 void Raven_Map::addHealth_Giver(std::ifstream& in)
 {
-    Trigger_HealthGiver* hg = new Trigger_HealthGiver(in);
+    //the amount of health given is Para_Health_Given rather than the one
+    //in the file
+    int id, healthGiven, graphNodeIndex;
+    float x, y, r;
+    in >> id >> x >> y >> r >> healthGiven >> graphNodeIndex;
+
+    Trigger_HealthGiver* hg = new Trigger_HealthGiver(Vector2D(x,y), graphNodeIndex);
 
     m_TriggerSystem.registerTrigger(hg);
 
     //let the corresponding navgraph node point to this object
-    NavGraph::NodeType& node = m_pNavGraph->getNode(hg->graphNodeIndex());
+    NavGraph::NodeType& node = m_pNavGraph->getNode(hg->getGraphNodeIndex());
 
     node.setExtraInfo(hg);
 
@@ -128,15 +203,17 @@ void Raven_Map::addHealth_Giver(std::ifstream& in)
 //-----------------------------------------------------------------------------
 void Raven_Map::addWeapon_Giver(int type_of_weapon, std::ifstream& in)
 {
-    Trigger_WeaponGiver* wg = new Trigger_WeaponGiver(in);
+    int id, graphNodeIndex;
+    float x, y, r;
+    in >> id >> x >> y >> r >> graphNodeIndex;
 
-    wg->setEntityType(type_of_weapon);
+    Trigger_WeaponGiver* wg = new Trigger_WeaponGiver(type_of_weapon, Vector2D(x,y), graphNodeIndex);
 
     //add it to the appropriate vectors
     m_TriggerSystem.registerTrigger(wg);
 
     //let the corresponding navgraph node point to this object
-    NavGraph::NodeType& node = m_pNavGraph->getNode(wg->graphNodeIndex());
+    NavGraph::NodeType& node = m_pNavGraph->getNode(wg->getGraphNodeIndex());
 
     node.setExtraInfo(wg);
 
@@ -147,9 +224,18 @@ void Raven_Map::addWeapon_Giver(int type_of_weapon, std::ifstream& in)
 
 //------------------------- loadMap ------------------------------------
 //
-//  sets up the game environment from map file
+//  sets up the game environment from map file. The file holds the navgraph
+//  (as written by SparseGraph::save), the size of the map and then one
+//  entity a line, each starting with its type:
+//
+//    type_wall             x1 y1 x2 y2 normalx normaly
+//    type_sliding_door     id x1 y1 x2 y2 numSwitches switchID...
+//    type_door_trigger     id receiverID msg x y radius
+//    type_spawn_point      dummy x y dummy dummy
+//    type_health           id x y radius health graphNode
+//    type_<weapon>         id x y radius graphNode
 //-----------------------------------------------------------------------------
-bool Raven_Map::loadMap(const std::string& filename)
+bool Raven_Map::loadMap(const std::string& filename, WorkerPool* pWorkers)
 {  
     std::ifstream in(filename.c_str());
     if (!in)
@@ -182,13 +268,9 @@ bool Raven_Map::loadMap(const std::string& filename)
     partitionNavGraph();
 
   //now create the environment entities
-  while (!in.eof())
+  int EntityType;
+  while (in >> EntityType)
   {   
-    //get type of next map object
-    int EntityType;
-    
-    in >> EntityType;
-    
     //create the object
     switch(EntityType)
     {
@@ -233,8 +315,20 @@ bool Raven_Map::loadMap(const std::string& filename)
     }//end switch
   }
 
-    //calculate the cost lookup table
-    m_PathCosts = createAllPairsCostsTable(*m_pNavGraph);
+    linkDoorsToSwitches();
+
+    //all the walls (doors included) are in place now, so they can be
+    //sorted into the grid used by the line of sight tests
+    m_WallGrid.build(m_Walls, Para_NumCellsX, Para_NumCellsY);
+
+    //the graph is complete now the items have been linked to their nodes,
+    //so freeze it for searching
+    m_SearchGraph.build(*m_pNavGraph);
+
+    createClusters();
+
+    //set up the cost lookup
+    createPathCosts(filename, pWorkers);
 
   return true;
 }
@@ -243,10 +337,54 @@ bool Raven_Map::loadMap(const std::string& filename)
 
 
 
+//--------------------------- createPathCosts ---------------------------------
+//
+//  the table of all the pairs is read from the file saved by an earlier load
+//  of the same map if there is one. Otherwise it is calculated and saved
+//-----------------------------------------------------------------------------
+void Raven_Map::createPathCosts(const std::string& FileName, WorkerPool* pWorkers)
+{
+    delete m_pPathCosts;
+
+    switch(Para_PathCostStorage)
+    {
+    case 0:
+        {
+            PathCostTable_Dense<SearchGraph>* pTable = new PathCostTable_Dense<SearchGraph>(m_SearchGraph.getNumNodes());
+
+            std::string costsFileName = FileName + Para_PathCostFileExtension;
+            unsigned long long mapHash = calculateFileHash(FileName);
+
+            if (!pTable->read(costsFileName, mapHash))
+            {
+                pTable->calculate(m_SearchGraph, pWorkers);
+
+                if (!pTable->write(costsFileName, mapHash))
+                {
+                    AILOG("Unable to save the path costs to %s", costsFileName.c_str());
+                }
+            }
+
+            m_pPathCosts = pTable;
+        }
+
+        break;
+
+    case 2:
+
+        m_pPathCosts = new PathCostTable_Landmarks<SearchGraph>(m_SearchGraph, Para_PathCostLandmarks); break;
+
+    default:
+
+        m_pPathCosts = new PathCostTable_LazyRows<SearchGraph>(m_SearchGraph, Para_PathCostCacheRows); break;
+    }
+}
+
+
 //------------- calculateCostToTravelBetweenNodes -----------------------------
 //
-//  Uses the pre-calculated lookup table to determine the cost of traveling
-//  from nd1 to nd2
+//  Uses the path cost lookup to determine the cost of traveling from nd1 to
+//  nd2
 //-----------------------------------------------------------------------------
 float Raven_Map::calculateCostToTravelBetweenNodes(int nd1, int nd2)const
 {
@@ -254,20 +392,40 @@ float Raven_Map::calculateCostToTravelBetweenNodes(int nd1, int nd2)const
                   nd2>=0 && nd2<m_pNavGraph->getNumNodes() &&
                   "<Raven_Map::CostBetweenNodes>: invalid index");
 
-    return m_PathCosts[nd1][nd2];
+    return m_pPathCosts->getCost(nd1, nd2);
 }
 
 
 
 
+//---------------------------- createClusters ---------------------------------
+//
+//  each node of the search graph goes in the cluster of the cell of the
+//  space partition it is in
+//-----------------------------------------------------------------------------
+void Raven_Map::createClusters()
+{
+    std::vector<int> clusterOfNode(m_SearchGraph.getNumNodes(), 0);
+
+    SearchGraph::ConstNodeIterator NodeItr(m_SearchGraph);
+    for (const SearchGraph::NodeType* pN=NodeItr.begin(); !NodeItr.end(); pN=NodeItr.next())
+    {
+        clusterOfNode[pN->getIndex()] = m_pSpacePartition->positionToIndex(pN->getPos());
+    }
+
+    m_Clusters.build(m_SearchGraph, clusterOfNode);
+}
+
+
 //-------------------------- PartitionEnvironment -----------------------------
 //-----------------------------------------------------------------------------
 void Raven_Map::partitionNavGraph()
 {
     if (m_pSpacePartition) delete m_pSpacePartition;
 
-    m_pSpacePartition = new CellSpacePartition<NavGraph::NodeType*>(m_iSizeX,
-                                                                                          m_iSizeY,
+    Vector2D size((float)m_iSizeX, (float)m_iSizeY);
+
+    m_pSpacePartition = new CellSpacePartition<NavGraph::NodeType*>(size,
                                                                                           Para_NumCellsX,
                                                                                           Para_NumCellsY,
                                                                                           m_pNavGraph->getNumNodes());
@@ -313,7 +471,7 @@ Vector2D Raven_Map::getRandomNodeLocation()const
         pN = NodeItr.next();
     }
 
-    return pN->pos();
+    return pN->getPos();
 }
 
 
@@ -15,34 +15,45 @@
 #include <vector>
 #include <string>
 #include <list>
+#include <map>
+#include <fstream>
 #include "common/game/Wall.h"
+#include "common/2D/WallGrid.h"
 #include "common/triggers/Trigger.h"
 #include "common/triggers/TriggerSystem.h"
 #include "common/graph/GraphEdgeTypes.h"
 #include "common/graph/GraphNodeTypes.h"
 #include "common/graph/SparseGraph.h"
-#include "common/misc/cellSpacePartition.h"
+#include "common/graph/FrozenGraph.h"
+#include "common/navigation/PathCostOracle.h"
+#include "common/navigation/ClusterGraph.h"
+#include "common/misc/CellSpacePartition.h"
 #include "Raven_Bot.h"
 
 class BaseEntity;
 class Raven_Door;
+class WorkerPool;
+template <class entity_type> class Trigger_OnButtonSendMsg;
 
 class Raven_Map
 {
 public:
     typedef NavGraphNode<Trigger<Raven_Bot>*> GraphNode;
     typedef SparseGraph<GraphNode, NavGraphEdge> NavGraph;
+    typedef FrozenGraph<GraphNode, NavGraphEdge> SearchGraph;
     typedef CellSpacePartition<NavGraph::NodeType*> CellSpace;
+    typedef ClusterGraph<SearchGraph> Clusters;
 
     typedef Trigger<Raven_Bot> TriggerType;
-    typedef TriggerSystem<TriggerType> TriggerSystem;
+    typedef ::TriggerSystem<TriggerType> TriggerSystem;
   
 public:
     Raven_Map();  
     ~Raven_Map();
 
-    //loads an environment from a file
-    bool loadMap(const std::string& FileName); 
+    //loads an environment from a file. Anything calculated for the map is
+    //shared out between the threads of pWorkers if it isn't NULL
+    bool loadMap(const std::string& FileName, WorkerPool* pWorkers = NULL); 
 
     //adds a wall and returns a pointer to that wall. (this method can be
     //used by objects such as doors to add walls to the environment)
@@ -59,7 +70,10 @@ public:
 
     const Raven_Map::TriggerSystem::TriggerList& getTriggers()const{return m_TriggerSystem.getTriggers();}
     const std::vector<Wall*>& getWalls()const{return m_Walls;}
+    const WallGrid& getWallGrid()const{return m_WallGrid;}
     NavGraph& getNavGraph()const{return *m_pNavGraph;}
+    const SearchGraph& getSearchGraph()const{return m_SearchGraph;}
+    const Clusters& getClusters()const{return m_Clusters;}
     std::vector<Raven_Door*>& getDoors(){return m_Doors;}
     const std::vector<Vector2D>& getSpawnPoints()const{return m_SpawnPoints;}
     CellSpace* const getCellSpace()const{return m_pSpacePartition;}
@@ -75,6 +89,10 @@ private:
   //the walls that comprise the current map's architecture. 
   std::vector<Wall*> m_Walls;
 
+  //the walls above sorted into a grid for the line of sight and ray tests.
+  //Built at the end of loadMap
+  WallGrid m_WallGrid;
+
   //trigger are objects that define a region of space. When a raven bot
   //enters that area, it 'triggers' an event. That event may be anything
   //from increasing a bot's health to opening a door or requesting a lift.
@@ -90,6 +108,13 @@ private:
   //this map's accompanying navigation graph
   NavGraph* m_pNavGraph;  
 
+  //the navgraph frozen at the end of loadMap, for the path searches
+  SearchGraph m_SearchGraph;
+
+  //the search graph divided into the cells of m_pSpacePartition, for
+  //planning paths hierarchically
+  Clusters m_Clusters;
+
   //the graph nodes will be partitioned enabling fast lookup
   CellSpace* m_pSpacePartition;
 
@@ -102,16 +127,33 @@ private:
   
   void partitionNavGraph();
 
-    //this will hold a pre-calculated lookup table of the cost to travel from
-    //one node to any other.
-    std::vector<std::vector<float>> m_PathCosts;
+    //builds m_Clusters from the search graph and the space partition
+    void createClusters();
+
+    //looks up the cost to travel from one node to any other. How the costs
+    //are stored is set by Para_PathCostStorage
+    PathCostOracle* m_pPathCosts;
 
-    //stream constructors for loading from a file
-    void addSpawnPoint(float x, float y);
+    //creates m_pPathCosts for the navgraph of the map in FileName
+    void createPathCosts(const std::string& FileName, WorkerPool* pWorkers);
+
+    //these read an entity of each type from the map file
+    void addWall(std::ifstream& in);
+    void addSpawnPoint(std::ifstream& in);
     void addHealth_Giver(std::ifstream& in);
     void addWeapon_Giver(int type_of_weapon, std::ifstream& in);
     void addDoor(std::ifstream& in);
     void addDoorTrigger(std::ifstream& in);
+
+    //in the map file the doors and the door triggers refer to each other by
+    //the IDs they had in the map editor, not by the IDs the entity manager
+    //gives them. These are kept while the file is read so the doors can be
+    //given their switches at the end of loadMap
+    std::map<int, Trigger_OnButtonSendMsg<Raven_Bot>*> m_DoorTriggersOfMapIDs;
+    std::vector<std::pair<Raven_Door*, int> > m_DoorSwitchesOfMapIDs;
+
+    void linkDoorsToSwitches();
+
     void clear();
     
 };
@@ -3,8 +3,9 @@
 #include "common/game/Wall.h"
 #include "common/2D/Transformations.h"
 #include "common/2D/Geometry.h"
-#include "GameWorldRaven.h"
+#include "../GameWorldRaven.h"
 #include "Raven_Map.h"
+#include "ParaConfigRaven.h"
 #include <cassert>
 
 
@@ -58,7 +59,7 @@ Raven_SteeringBehaviors::~Raven_SteeringBehaviors(){}
 Vector2D Raven_SteeringBehaviors::calculate()
 { 
     //reset the steering force
-    m_vSteeringForce.Zero();
+    m_vSteeringForce.zero();
 
     //tag neighbors if any of the following 3 group behaviors are switched on
     if (On(behavior_separation))
@@ -142,7 +143,7 @@ Vector2D Raven_SteeringBehaviors::calculatePrioritized()
 
     if (On(behavior_wall_avoidance))
     {
-        force = wallAvoidance(m_pWorld->GetMap()->GetWalls()) * m_dWeightWallAvoidance;
+        force = wallAvoidance(m_pWorld->getMap()->getWalls()) * m_dWeightWallAvoidance;
 
         if (!accumulateForce(m_vSteeringForce, force)) return m_vSteeringForce;
     }
@@ -153,7 +154,7 @@ Vector2D Raven_SteeringBehaviors::calculatePrioritized()
 
     if (On(behavior_separation))
     {
-        force = separation(m_pWorld->GetAllBots()) * m_dWeightSeparation;
+        force = separation(m_pWorld->getAllBots()) * m_dWeightSeparation;
 
         if (!accumulateForce(m_vSteeringForce, force)) return m_vSteeringForce;
     }
@@ -275,7 +276,7 @@ Vector2D Raven_SteeringBehaviors::wander()
 //  This returns a steering force that will keep the agent away from any
 //  walls it may encounter
 //------------------------------------------------------------------------
-Vector2D Raven_SteeringBehaviors::wallAvoidance(const vector<Wall2D*> &walls)
+Vector2D Raven_SteeringBehaviors::wallAvoidance(const vector<Wall*> &walls)
 {
     //the feelers are contained in a std::vector, m_Feelers
     createFeelers();
@@ -298,8 +299,8 @@ Vector2D Raven_SteeringBehaviors::wallAvoidance(const vector<Wall2D*> &walls)
         {
             if (lineIntersection2D(m_pRaven_Bot->getPos(),
                                                  m_Feelers[flr],
-                                                 walls[w]->From(),
-                                                 walls[w]->To(),
+                                                 walls[w]->from(),
+                                                 walls[w]->to(),
                                                  DistToThisIP,
                                                  point))
             {
@@ -371,7 +372,7 @@ Vector2D Raven_SteeringBehaviors::separation(const std::list<Raven_Bot*>& neighb
         //make sure this agent isn't included in the calculations and that
         //the agent being examined is close enough. ***also make sure it doesn't
         //include the evade target ***
-        if((*it != m_pRaven_Bot) && (*it)->isTagged() &&(*it != m_pTargetAgent1))
+        if((*it != m_pRaven_Bot) && (*it)->isTag() &&(*it != m_pTargetAgent1))
         {
             Vector2D ToAgent = m_pRaven_Bot->getPos() - (*it)->getPos();
 
@@ -3,39 +3,102 @@
 #include "common/misc/CellSpacePartition.h"
 #include "common/misc/UtilsEx.h"
 #include "common/misc/LogDebug.h"
-#include "game_raven/ParaConfigRaven.h"
-#include "game_raven/Raven_Messages.h"
+#include "../misc/ParaConfigRaven.h"
+#include "../misc/RavenMessages.h"
+#include "../GameWorldRaven.h"
+#include "../misc/Raven_Map.h"
 #include "common/navigation/PathManager.h"
+#include "common/navigation/AsyncPathManager.h"
+#include "common/navigation/AStarHeuristicPolicies.h"
 #include <cassert>
 
 
 Raven_PathPlanner::Raven_PathPlanner(Raven_Bot* owner):m_pOwner(owner),
-                                                                    m_NavGraph(m_pOwner->getWorld()->getMap()->getNavGraph()),
-                                                                    m_pCurrentSearch(NULL)
+                                                                    m_NavGraph(m_pOwner->getWorld()->getMap()->getSearchGraph()),
+                                                                    m_pCurrentSearch(NULL),
+                                                                    m_pHierarchicalSearch(NULL),
+                                                                    m_iSearchID(0),
+                                                                    m_bToPosition(false)
 {
 }
 
 Raven_PathPlanner::~Raven_PathPlanner()
 {
+    cancelRequest();
+
     getReadyForNewSearch();
 }
 
 //------------------------------ getReadyForNewSearch -----------------------------------
 //
 //  called by the search manager when a search has been terminated to free
-//  up the memory used when an instance of the search was created
+//  up the memory used when an instance of the search was created. The planner
+//  stays registered with the path manager, so a new search takes the place
+//  of the old one in the queue. If no new search is made the request must
+//  be cancelled
+//
+//  a search the asynchronous path manager still has is left to it to delete
 //-----------------------------------------------------------------------------
 void Raven_PathPlanner::getReadyForNewSearch()
 {
-    //unregister any existing search with the path manager
-    m_pOwner->getWorld()->getPathManager()->unRegisterPlan(this);
+    AsyncPathManager<Raven_PathPlanner>* pAsync = m_pOwner->getWorld()->getAsyncPathManager();
 
     //clean up memory used by any existing search
     if (m_pCurrentSearch)
     {
-        delete m_pCurrentSearch;  
+        if (!pAsync || !pAsync->unRegisterPlan(this))
+        {
+            delete m_pCurrentSearch;
+        }
+
         m_pCurrentSearch = nullptr;
+        m_pHierarchicalSearch = nullptr;
     }
+
+    ++m_iSearchID;
+}
+
+//------------------------------ cancelRequest --------------------------------
+//-----------------------------------------------------------------------------
+void Raven_PathPlanner::cancelRequest()
+{
+    m_pOwner->getWorld()->getPathManager()->unRegisterPlan(this);
+}
+
+//----------------------------- registerSearch --------------------------------
+//-----------------------------------------------------------------------------
+void Raven_PathPlanner::registerSearch(float priority)
+{
+    AsyncPathManager<Raven_PathPlanner>* pAsync = m_pOwner->getWorld()->getAsyncPathManager();
+
+    //the threads take the searches in the order they are made, so the
+    //priority only matters to the path manager
+    if (pAsync)
+    {
+        pAsync->registerPlan(this, m_pCurrentSearch);
+    }
+    else
+    {
+        m_pOwner->getWorld()->getPathManager()->registerPlan(this, priority);
+    }
+}
+
+//--------------------------- getSearchPriority -------------------------------
+//
+//  a bot in a fight needs its path first, and a short path is worth more
+//  than a long one as the bot will be following it sooner. How long the
+//  request waits is taken into account by the path manager
+//-----------------------------------------------------------------------------
+float Raven_PathPlanner::getSearchPriority(float distance)
+{
+    float priority = -Para_PathPriorityPerDistance * distance;
+
+    if (m_pOwner->getTargetSys()->isTargetPresent())
+    {
+        priority += Para_PathPriorityInCombat;
+    }
+
+    return priority;
 }
 
 //---------------------------- getCostToNode ----------------------------------
@@ -69,7 +132,23 @@ float Raven_PathPlanner::getCostToClosestItem(unsigned int GiverType)const
     //if no closest node found return failure
     if (nd < 0) return -1;
 
+    float ClosestSoFar;
+
+    //return a negative value if no active trigger of the type found
+    if (getClosestItemNode(nd, GiverType, ClosestSoFar) == no_closest_node_found)
+    {
+        return -1;
+    }
+
+    return ClosestSoFar;
+}
+
+//------------------------- getClosestItemNode --------------------------------
+//-----------------------------------------------------------------------------
+int Raven_PathPlanner::getClosestItemNode(int nd, unsigned int GiverType, float& cost)const
+{
     float ClosestSoFar = FloatMax;
+    int ClosestNode = no_closest_node_found;
 
     //iterate through all the triggers to find the closest *active* trigger of type GiverType
     const Raven_Map::TriggerSystem::TriggerList& triggers = m_pOwner->getWorld()->getMap()->getTriggers();
@@ -79,22 +158,19 @@ float Raven_PathPlanner::getCostToClosestItem(unsigned int GiverType)const
     {
         if ( ((*it)->getEntityType() == GiverType) && (*it)->isActive())
         {
-            float cost = m_pOwner->getWorld()->getMap()->calculateCostToTravelBetweenNodes(nd,(*it)->graphNodeIndex());
+            float c = m_pOwner->getWorld()->getMap()->calculateCostToTravelBetweenNodes(nd,(*it)->getGraphNodeIndex());
 
-            if (cost < ClosestSoFar)
+            if (c < ClosestSoFar)
             {
-                ClosestSoFar = cost;
+                ClosestSoFar = c;
+                ClosestNode = (*it)->getGraphNodeIndex();
             }
         }
     }
 
-    //return a negative value if no active trigger of the type found
-    if (isEqual(ClosestSoFar, FloatMax))
-    {
-        return -1;
-    }
+    cost = ClosestSoFar;
 
-    return ClosestSoFar;
+    return ClosestNode;
 }
 
 
@@ -109,15 +185,42 @@ Raven_PathPlanner::Path Raven_PathPlanner::getPath()
 {
     assert (m_pCurrentSearch && "<Raven_PathPlanner::GetPathAsNodes>: no current search");
 
-    Path path =  m_pCurrentSearch->getPathAsPathEdges();
+    //a hierarchical search hands out its path a part at a time
+    Path path = m_pHierarchicalSearch ? m_pHierarchicalSearch->getNextPathSegment()
+                                      : m_pCurrentSearch->getPathAsPathEdges();
 
     int closest = getClosestNodeToPosition(m_pOwner->getPos());
 
     path.push_front(PathEdge(m_pOwner->getPos(),getNodePosition(closest),NavGraphEdge::normal));
-    
+
+    finishPath(path);
+
+    return path;
+}
+
+//------------------------- getNextPathSegment --------------------------------
+//
+//  refines the next part of a hierarchical path. The bot calls this as it
+//  comes to the end of the part it is following
+//-----------------------------------------------------------------------------
+Raven_PathPlanner::Path Raven_PathPlanner::getNextPathSegment()
+{
+    assert (isPathPartial() && "<Raven_PathPlanner::getNextPathSegment>: no more path to refine");
+
+    Path path = m_pHierarchicalSearch->getNextPathSegment();
+
+    finishPath(path);
+
+    return path;
+}
+
+//----------------------------- finishPath ------------------------------------
+//-----------------------------------------------------------------------------
+void Raven_PathPlanner::finishPath(Path& path)
+{
     //if the bot requested a path to a location then an edge leading to the
-    //destination must be added
-    if (m_pCurrentSearch->getType() == Graph_SearchTimeSliced<EdgeType>::AStar)
+    //destination must be added, once the path reaches its last node
+    if (m_bToPosition && !isPathPartial() && !path.empty())
     {   
         path.push_back(PathEdge(path.back().getDestination(),m_vDestinationPos,NavGraphEdge::normal));
     }
@@ -132,8 +235,6 @@ Raven_PathPlanner::Path Raven_PathPlanner::getPath()
     {
         smoothPathEdgesPrecise(path);
     }
-
-    return path;
 }
 
 //--------------------------- SmoothPathEdgesQuick ----------------------------
@@ -155,10 +256,10 @@ void Raven_PathPlanner::smoothPathEdgesQuick(Path& path)
     while (e2 != path.end())
     {
         //check for obstruction, adjust and remove the edges accordingly
-        if ( (e2->Behavior() == EdgeType::normal) &&
-                    m_pOwner->canWalkBetween(e1->Source(), e2->Destination()) )
+        if ( (e2->getBehavior() == EdgeType::normal) &&
+                    m_pOwner->canWalkBetween(e1->getSource(), e2->getDestination()) )
         {
-            e1->SetDestination(e2->Destination());
+            e1->setDestination(e2->getDestination());
             e2 = path.erase(e2);
         }
         else
@@ -196,7 +297,7 @@ void Raven_PathPlanner::smoothPathEdgesPrecise(Path& path)
         while (e2 != path.end())
         {
             //check for obstruction, adjust and remove the edges accordingly
-            if ( (e2->Behavior() == EdgeType::normal) &&
+            if ( (e2->getBehavior() == EdgeType::normal) &&
                             m_pOwner->canWalkBetween(e1->getSource(), e2->getDestination()))
             {
                 e1->setDestination(e2->getDestination());
@@ -227,6 +328,15 @@ int Raven_PathPlanner::cycleOnce()const
 
     int result = m_pCurrentSearch->cycleOnce();
 
+    notifyOwner(result);
+
+    return result;
+}
+
+//---------------------------- notifyOwner ------------------------------------
+//-----------------------------------------------------------------------------
+void Raven_PathPlanner::notifyOwner(int result)const
+{
     //let the bot know of the failure to find a path
     if (result == target_not_found)
     {
@@ -234,24 +344,22 @@ int Raven_PathPlanner::cycleOnce()const
                                                                             -1, 
                                                                             m_pOwner->getID(),
                                                                             Msg_NoPathAvailable, 
-                                                                            NULL);
+                                                                            NO_ADDITIONAL_INFO);
     }
     //let the bot know a path has been found
     else if (result == target_found)
     {
         //if the search was for an item type then the final node in the path will
-        //represent a giver trigger. Consequently, it's worth passing the pointer
-        //to the trigger in the extra info field of the message. (The pointer
-        //will just be NULL if no trigger)
-        void* pTrigger = m_NavGraph.getNode(m_pCurrentSearch->getPathToTarget().back()).getExtraInfo();
+        //represent a giver trigger. Consequently, it's worth passing the
+        //trigger in the extra info field of the message. (The handle will
+        //just be empty if no trigger)
+        Raven_Map::TriggerType* pTrigger = m_NavGraph.getNode(m_pCurrentSearch->getPathToTarget().back()).getExtraInfo();
         MessageDispatcher::instance()->dispatchMsg( 0, 
                                                                             -1, 
                                                                             m_pOwner->getID(),
                                                                             Msg_PathReady, 
-                                                                            pTrigger);        
+                                                                            pTrigger ? EntityHandle(pTrigger->getID()) : EntityHandle());        
     }
-
-    return result;
 }
 
 //------------------------ getClosestNodeToPosition ---------------------------
@@ -268,14 +376,16 @@ int Raven_PathPlanner::getClosestNodeToPosition(Vector2D pos)const
     //navigation graph (less dense = bigger values)
     const float range = m_pOwner->getWorld()->getMap()->getCellSpaceNeighborhoodRange();
 
-    //calculate the graph nodes that are neighboring this position
-    m_pOwner->getWorld()->getMap()->getCellSpace()->calculateNeighbors(pos, range);
+    //calculate the graph nodes that are neighboring this position. A local
+    //vector is used so the shared cell space isn't written by the query
+    std::vector<NodeType*> neighbors;
+    m_pOwner->getWorld()->getMap()->getCellSpace()->calculateNeighbors(pos, range, neighbors);
 
     //iterate through the neighbors and sum up all the position vectors
-    for (NodeType* pN = m_pOwner->getWorld()->getMap()->getCellSpace()->begin();
-                 !m_pOwner->getWorld()->getMap()->getCellSpace()->end();     
-                 pN = m_pOwner->getWorld()->getMap()->getCellSpace()->next())
+    for (unsigned int i=0; i<neighbors.size(); ++i)
     {
+        NodeType* pN = neighbors[i];
+
         //if the path between this node and pos is unobstructed calculate the
         //distance
         if (m_pOwner->canWalkBetween(pos, pN->getPos()))
@@ -300,8 +410,9 @@ int Raven_PathPlanner::getClosestNodeToPosition(Vector2D pos)const
 //  is unreachable the method returns false. 
 //
 //  If nodes are reachable from both positions then an instance of the time-
-//  sliced A* search is created and registered with the search manager. the
-//  method then returns true.
+//  sliced A* search (or the hierarchical search if Para_PathHierarchical is
+//  set) is created and registered with the search manager. the method then
+//  returns true.
 //        
 //-----------------------------------------------------------------------------
 bool Raven_PathPlanner::requestPathToPosition(Vector2D TargetPos)
@@ -310,12 +421,14 @@ bool Raven_PathPlanner::requestPathToPosition(Vector2D TargetPos)
 
     //make a note of the target position.
     m_vDestinationPos = TargetPos;
+    m_bToPosition = true;
 
     //if the target is walkable from the bot's position a path does not need to
     //be calculated, the bot can go straight to the position by ARRIVING at
     //the current waypoint
     if (m_pOwner->canWalkTo(TargetPos))
     { 
+        cancelRequest();
         return true;
     }
   
@@ -329,6 +442,7 @@ bool Raven_PathPlanner::requestPathToPosition(Vector2D TargetPos)
     if (ClosestNodeToBot == no_closest_node_found)
     { 
         AILOG("No closest node to bot found!");
+        cancelRequest();
         return false; 
     }
 
@@ -344,18 +458,32 @@ bool Raven_PathPlanner::requestPathToPosition(Vector2D TargetPos)
     if (ClosestNodeToTarget == no_closest_node_found)
     { 
         AILOG("No closest node to target (%d)", ClosestNodeToTarget);
+        cancelRequest();
         return false; 
     }
 
     AILOG("Closest node to target is  %d", ClosestNodeToTarget);
 
-    //create an instance of a the distributed A* search class
-    typedef Graph_SearchAStar_TS<Raven_Map::NavGraph, Heuristic_Euclid> AStar;
+    if (Para_PathHierarchical)
+    {
+        //plan over the clusters of the map, the path is refined as the bot
+        //follows it
+        m_pHierarchicalSearch = new HierarchicalSearch(m_pOwner->getWorld()->getMap()->getClusters(),
+                                                       ClosestNodeToBot,
+                                                       ClosestNodeToTarget);
+
+        m_pCurrentSearch = m_pHierarchicalSearch;
+    }
+    else
+    {
+        //create an instance of a the distributed A* search class
+        typedef Graph_SearchAStar_TS<Raven_Map::SearchGraph, Heuristic_Euclid> AStar;
    
-    m_pCurrentSearch = new AStar(m_NavGraph, ClosestNodeToBot, ClosestNodeToTarget);
+        m_pCurrentSearch = new AStar(m_NavGraph, ClosestNodeToBot, ClosestNodeToTarget);
+    }
 
     //and register the search with the path manager
-    m_pOwner->getWorld()->getPathManager()->registerPlan(this);
+    registerSearch(getSearchPriority(Vec2Distance(m_pOwner->getPos(), TargetPos)));
     
     return true;
 }
@@ -367,12 +495,19 @@ bool Raven_PathPlanner::requestPathToPosition(Vector2D TargetPos)
 // to the bot's position and then creates a instance of the time-sliced 
 // Dijkstra's algorithm, which it registers with the search manager
 //
+// Dijkstra's search looks at whether the triggers are active as it goes,
+// which changes as the game is played, so it can't be run on another thread.
+// With the asynchronous path manager the closest active item by the cost
+// lookup table is chosen instead, and a search made to its node that only
+// reads the navgraph
 //-----------------------------------------------------------------------------
 bool Raven_PathPlanner::requestPathToItem(unsigned int ItemType)
 {    
     //clear the waypoint list and delete any active search
     getReadyForNewSearch();
 
+    m_bToPosition = false;
+
     //find the closest visible node to the bots position
     int ClosestNodeToBot = getClosestNodeToPosition(m_pOwner->getPos());
 
@@ -383,17 +518,51 @@ bool Raven_PathPlanner::requestPathToItem(unsigned int ItemType)
     if (ClosestNodeToBot == no_closest_node_found)
     { 
         AILOG("No closest node to bot found!");
+        cancelRequest();
         return false; 
     }
 
+    if (m_pOwner->getWorld()->getAsyncPathManager())
+    {
+        float cost;
+        int ItemNode = getClosestItemNode(ClosestNodeToBot, ItemType, cost);
+
+        if (ItemNode == no_closest_node_found)
+        {
+            AILOG("No active item of type %d found", ItemType);
+            cancelRequest();
+            return false;
+        }
+
+        if (Para_PathHierarchical)
+        {
+            m_pHierarchicalSearch = new HierarchicalSearch(m_pOwner->getWorld()->getMap()->getClusters(),
+                                                           ClosestNodeToBot,
+                                                           ItemNode);
+
+            m_pCurrentSearch = m_pHierarchicalSearch;
+        }
+        else
+        {
+            typedef Graph_SearchAStar_TS<Raven_Map::SearchGraph, Heuristic_Euclid> AStar;
+
+            m_pCurrentSearch = new AStar(m_NavGraph, ClosestNodeToBot, ItemNode);
+        }
+
+        registerSearch(getSearchPriority(cost));
+
+        return true;
+    }
+
     //create an instance of the search algorithm
     typedef FindActiveTrigger<Trigger<Raven_Bot> > t_con; 
-    typedef Graph_SearchDijkstras_TS<Raven_Map::NavGraph, t_con> DijSearch;
+    typedef Graph_SearchDijkstras_TS<Raven_Map::SearchGraph, t_con> DijSearch;
   
     m_pCurrentSearch = new DijSearch(m_NavGraph, ClosestNodeToBot, ItemType);  
 
-    //register the search with the path manager
-    m_pOwner->getWorld()->getPathManager()->registerPlan(this);
+    //register the search with the path manager. How far the item is isn't
+    //known until the search finds it
+    registerSearch(getSearchPriority(0.0f));
     
     return true;
 }
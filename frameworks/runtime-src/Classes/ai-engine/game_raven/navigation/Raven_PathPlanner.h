@@ -7,9 +7,16 @@
 //
 //
 //  Desc:   class to handle the creation of paths through a navigation graph
+//
+//          The searches are run by the world's PathManager or, if it has
+//          one, by its AsyncPathManager. In the second case a search
+//          belongs to the manager from when it is registered until it is
+//          handed back by searchFinished, and the planner mustn't touch it
+//          in between.
 //-----------------------------------------------------------------------------
 #include <list>
 #include "common/navigation/GraphAlgorithms_TimeSliced.h"
+#include "common/navigation/ClusterGraph.h"
 #include "common/navigation/PathEdge.h"
 #include "../misc/Raven_Map.h"
 
@@ -25,23 +32,36 @@ private:
 public:
 
     //for ease of use typdef the graph edge/node types used by the navgraph
-    typedef Raven_Map::NavGraph::EdgeType EdgeType;
-    typedef Raven_Map::NavGraph::NodeType NodeType;
+    typedef Raven_Map::SearchGraph::EdgeType EdgeType;
+    typedef Raven_Map::SearchGraph::NodeType NodeType;
     typedef std::list<PathEdge> Path;
-  
+
 private:
+    typedef Graph_SearchHierarchical_TS<Raven_Map::SearchGraph> HierarchicalSearch;
+
     //A pointer to the owner of this class
     Raven_Bot* m_pOwner;
 
-    //a reference to the navgraph
-    const Raven_Map::NavGraph& m_NavGraph;
+    //a reference to the navgraph, frozen for searching
+    const Raven_Map::SearchGraph& m_NavGraph;
 
     //a pointer to an instance of the current graph search algorithm.
     Graph_SearchTimeSliced<EdgeType>* m_pCurrentSearch;
 
+    //the same search if it is hierarchical, else NULL
+    HierarchicalSearch* m_pHierarchicalSearch;
+
+    //counts the searches, so the path of one can't be mistaken for that of
+    //the next
+    unsigned int m_iSearchID;
+
     //this is the position the bot wishes to plan a path to reach
     Vector2D m_vDestinationPos;
 
+    //true if the current search is for a path to m_vDestinationPos rather
+    //than to an item
+    bool m_bToPosition;
+
 
     //returns the index of the closest visible and unobstructed graph node to
     //the given position
@@ -55,10 +75,32 @@ private:
     //edges)
     void smoothPathEdgesPrecise(Path& path);
 
+    //adds the edge to the destination if the path ends at the last node of
+    //a search to a position, and smooths the path
+    void finishPath(Path& path);
+
     //called at the commencement of a new search request. It clears up the 
     //appropriate lists and memory in preparation for a new search request
     void getReadyForNewSearch();
 
+    //hands m_pCurrentSearch to the path manager, or to the asynchronous
+    //one if the world has it
+    void registerSearch(float priority);
+
+    //takes the planner off the path manager's queue
+    void cancelRequest();
+
+    //messages the owner with the result of a search that has terminated
+    void notifyOwner(int result)const;
+
+    //returns the node of the closest active trigger of GiverType to node nd
+    //and sets cost to the cost of getting there, or returns
+    //no_closest_node_found. Uses the pre-calculated lookup table
+    int getClosestItemNode(int nd, unsigned int GiverType, float& cost)const;
+
+    //the priority of a search for a path of about distance
+    float getSearchPriority(float distance);
+
 
 public:
 
@@ -66,20 +108,32 @@ public:
 
     Raven_PathPlanner(Raven_Bot* owner);
 
-    //creates an instance of the A* time-sliced search and registers it with
-    //the path manager
+    //creates an instance of the Dijkstra's time-sliced search and registers
+    //it with the path manager. With the asynchronous path manager the
+    //closest active item is chosen now, and an A* search made to it
     bool requestPathToItem(unsigned int ItemType);
 
-    //creates an instance of the Dijkstra's time-sliced search and registers 
-    //it with the path manager
+    //creates an instance of the A* time-sliced search and registers it with
+    //the path manager
     bool requestPathToPosition(Vector2D TargetPos);
 
     //called by an agent after it has been notified that a search has terminated
     //successfully. The method extracts the path from m_pCurrentSearch, adds
     //additional edges appropriate to the search type and returns it as a list of
-    //PathEdges.
+    //PathEdges. A hierarchical search only returns the first part of the path,
+    //see getNextPathSegment
     Path getPath();
 
+    //true while there is more of the path returned by getPath to come
+    bool isPathPartial()const{return m_pHierarchicalSearch && m_pHierarchicalSearch->isPathPartial();}
+
+    //the next part of a path returned by getPath. It carries on from where
+    //the last part ended
+    Path getNextPathSegment();
+
+    //changes with every new search
+    unsigned int getSearchID()const{return m_iSearchID;}
+
     //returns the cost to travel from the bot's current position to a specific 
     //graph node. This method makes use of the pre-calculated lookup table
     //created by GameWorldRaven
@@ -96,6 +150,10 @@ public:
     //msg_PathReady messages
     int cycleOnce()const;
 
+    //the asynchronous path manager calls this when it hands a search back.
+    //The owner is messaged just as by cycleOnce
+    void searchFinished(int result){notifyOwner(result);}
+
     Vector2D getDestination()const{return m_vDestinationPos;}
     void setDestination(Vector2D NewPos){m_vDestinationPos = NewPos;}
 
@@ -1,6 +1,9 @@
 #include "Raven_SensoryMemory.h"
+#include "Raven_Visibility.h"
+#include "../misc/Raven_Bot.h"
+#include "../GameWorldRaven.h"
 #include "common/misc/UtilsEx.h"
-#include <chrono>
+#include "common/misc/SimClock.h"
 
 //------------------------------- ctor ----------------------------------------
 //-----------------------------------------------------------------------------
@@ -68,44 +71,50 @@ void Raven_SensoryMemory::updateWithSoundSource(Raven_Bot* pNoiseMaker)
         }
 
         //record the time it was sensed
-        info.fTimeLastSensed = std::chrono::steady_clock::now();
+        info.fTimeLastSensed = SimClock::now();
     }
 }
 
 //----------------------------- UpdateVision ----------------------------------
 //
-//  this method iterates through all the bots in the game world to test if
-//  they are in the field of view. Each bot's memory record is updated
-//  accordingly
+//  this method iterates through all the bots in the visibility matrix to test
+//  if they are in the field of view. Each bot's memory record is updated
+//  accordingly. The LOS tests are read from the matrix, which the world
+//  calculates once for every pair of bots
 //-----------------------------------------------------------------------------
-void Raven_SensoryMemory::updateVision()
+void Raven_SensoryMemory::updateVision(const Raven_VisibilityMatrix& visibility)
 {
+    int ownerIdx = visibility.getIndex(m_pOwner);
+
+    //the owner joined the game after the matrix was calculated
+    if (ownerIdx < 0) return;
+
     //for each bot in the world test to see if it is visible to the owner of this class
-    const std::list<Raven_Bot*>& bots = m_pOwner->getWorld()->getAllBots();
-    std::list<Raven_Bot*>::const_iterator curBot;
-    for (curBot = bots.begin(); curBot!=bots.end(); ++curBot)
+    for (int i=0; i<visibility.getNumBots(); ++i)
     {
+        Raven_Bot* pBot = visibility.getBot(i);
+
         //make sure the bot being examined is not this bot
-        if (m_pOwner != *curBot)
+        if (i != ownerIdx)
         {
             //make sure it is part of the memory map
-            makeNewRecordIfNotAlreadyPresent(*curBot);
+            makeNewRecordIfNotAlreadyPresent(pBot);
 
             //get a reference to this bot's data
-            MemoryRecord& info = m_MemoryMap[*curBot];
+            MemoryRecord& info = m_MemoryMap[pBot];
 
             //test if there is LOS between bots 
-            if (m_pOwner->getWorld()->isLOSOkay(m_pOwner->getPos(), (*curBot)->getPos()))
+            if (visibility.isLOSOkay(ownerIdx, i))
             {
                 info.bShootable = true;
                 
                 //test if the bot is within FOV
                 if (isSecondInFOVOfFirst(m_pOwner->getPos(),m_pOwner->getFacing(), 
-                                                    (*curBot)->getPos(), m_pOwner->getFieldOfView()))
+                                                    pBot->getPos(), m_pOwner->getFieldOfView()))
                 {
-                    auto curTime = std::chrono::steady_clock::now();
+                    auto curTime = SimClock::now();
                     info.fTimeLastSensed = curTime;
-                    info.vLastSensedPosition = (*curBot)->getPos();
+                    info.vLastSensedPosition = pBot->getPos();
                     info.fTimeLastVisible = curTime;
 
                     if (info.bWithinFOV == false)
@@ -139,7 +148,7 @@ Raven_SensoryMemory::getListOfRecentlySensedOpponents()const
     //this will store all the opponents the bot can remember
     std::list<Raven_Bot*> opponents;
 
-    float CurTime = std::chrono::steady_clock::now();
+    SimClock::time_point CurTime = SimClock::now();
 
     MemoryMap::const_iterator curRecord = m_MemoryMap.begin();
     for (curRecord; curRecord!=m_MemoryMap.end(); ++curRecord)
@@ -214,7 +223,7 @@ float  Raven_SensoryMemory::getTimeOpponentHasBeenVisible(Raven_Bot* pOpponent)c
 
     if (it != m_MemoryMap.end() && it->second.bWithinFOV)
     {
-        return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - 
+        return std::chrono::duration_cast<std::chrono::seconds>(SimClock::now() - 
                                                                                               it->second.fTimeBecameVisible).count();
     }
 
@@ -232,7 +241,7 @@ float Raven_SensoryMemory::getTimeOpponentHasBeenOutOfView(Raven_Bot* pOpponent)
 
     if (it != m_MemoryMap.end())
     {
-        return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - 
+        return std::chrono::duration_cast<std::chrono::seconds>(SimClock::now() - 
                                                                                               it->second.fTimeLastVisible).count();    
     }
 
@@ -243,36 +252,15 @@ float Raven_SensoryMemory::getTimeOpponentHasBeenOutOfView(Raven_Bot* pOpponent)
 //
 //  returns the amount of time the given bot has been visible
 //-----------------------------------------------------------------------------
-float  Raven_SensoryMemory::GetTimeSinceLastSensed(Raven_Bot* pOpponent)const
+float  Raven_SensoryMemory::getTimeSinceLastSensed(Raven_Bot* pOpponent)const
 {
   MemoryMap::const_iterator it = m_MemoryMap.find(pOpponent);
  
   if (it != m_MemoryMap.end() && it->second.bWithinFOV)
   {
-    return Clock->GetCurrentTime() - it->second.fTimeLastSensed;
+    return std::chrono::duration_cast<std::chrono::seconds>(SimClock::now() - 
+                                                                                          it->second.fTimeLastSensed).count();
   }
 
   return 0;
 }
-
-//---------------------- RenderBoxesAroundRecentlySensed ----------------------
-//
-//  renders boxes around the opponents it has sensed recently.
-//-----------------------------------------------------------------------------
-void  Raven_SensoryMemory::RenderBoxesAroundRecentlySensed()const
-{
-  std::list<Raven_Bot*> opponents = GetListOfRecentlySensedOpponents();
-  std::list<Raven_Bot*>::const_iterator it;
-  for (it = opponents.begin(); it != opponents.end(); ++it)
-  {
-    gdi->OrangePen();
-    Vector2D p = (*it)->getPos();
-    float   b = (*it)->getBoundingRadius();
-      
-    gdi->Line(p.x-b, p.y-b, p.x+b, p.y-b);
-    gdi->Line(p.x+b, p.y-b, p.x+b, p.y+b);
-    gdi->Line(p.x+b, p.y+b, p.x-b, p.y+b);
-    gdi->Line(p.x-b, p.y+b, p.x-b, p.y-b);
-  }
-
-}
\ No newline at end of file
@@ -12,10 +12,11 @@
 #include <map>
 #include <list>
 #include "common/2D/Vector2D.h"
-#include <chrono>
+#include "common/misc/SimClock.h"
 
 
 class Raven_Bot;
+class Raven_VisibilityMatrix;
 
 class MemoryRecord
 {
@@ -24,16 +25,16 @@ public:
     //is used to determine if a bot can 'remember' this record or not. 
     //(if CurrentTime() - m_dTimeLastSensed is greater than the bot's
     //memory span, the data in this record is made unavailable to clients)
-    std::chrono::steady_clock::time_point fTimeLastSensed;
+    SimClock::time_point fTimeLastSensed;
 
     //it can be useful to know how long an opponent has been visible. This 
     //variable is tagged with the current time whenever an opponent first becomes
     //visible. It's then a simple matter to calculate how long the opponent has
     //been in view (CurrentTime - fTimeBecameVisible)
-    std::chrono::steady_clock::time_point fTimeBecameVisible;
+    SimClock::time_point fTimeBecameVisible;
 
     //it can also be useful to know the last time an opponent was seen
-    std::chrono::steady_clock::time_point fTimeLastVisible;
+    SimClock::time_point fTimeLastVisible;
 
     //a vector marking the position where the opponent was last sensed. This can
     // be used to help hunt down an opponent if it goes out of view
@@ -49,7 +50,7 @@ public:
 
     MemoryRecord():bWithinFOV(false), bShootable(false)
     {
-        auto tt = std::chrono::steady_clock::now() - std::chrono::seconds(999);
+        auto tt = SimClock::now() - std::chrono::seconds(999);
         fTimeLastSensed = tt;
         fTimeBecameVisible = tt;
         fTimeLastVisible = tt;
@@ -93,9 +94,9 @@ public:
   //this removes a bot's record from memory
   void removeBotFromMemory(Raven_Bot* pBot);
 
-  //this method iterates through all the opponents in the game world and 
-  //updates the records of those that are in the owner's FOV
-  void updateVision();
+  //this method iterates through all the opponents in the visibility matrix
+  //and updates the records of those that are in the owner's FOV
+  void updateVision(const Raven_VisibilityMatrix& visibility);
 
   bool isOpponentShootable(Raven_Bot* pOpponent)const;
   bool isOpponentWithinFOV(Raven_Bot* pOpponent)const;
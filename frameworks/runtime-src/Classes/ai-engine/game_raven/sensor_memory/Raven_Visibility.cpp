@@ -0,0 +1,98 @@
+#include "Raven_Visibility.h"
+#include "common/2D/WallGrid.h"
+#include "common/misc/WorkerPool.h"
+#include "../misc/Raven_Bot.h"
+
+
+//------------------------------------------------------------------------
+//
+//  calculates a range of rows of the matrix
+//------------------------------------------------------------------------
+class Raven_VisibilityMatrix::RowJob : public ParallelJob
+{
+public:
+    RowJob(Raven_VisibilityMatrix& matrix, const WallGrid& walls):m_Matrix(matrix), m_Walls(walls){}
+
+    void process(int begin, int end)
+    {
+        for (int i=begin; i<end; ++i)
+        {
+            m_Matrix.calculateRow(i, m_Walls);
+        }
+    }
+
+private:
+    Raven_VisibilityMatrix& m_Matrix;
+    const WallGrid& m_Walls;
+};
+
+//------------------------------- update --------------------------------------
+//-----------------------------------------------------------------------------
+void Raven_VisibilityMatrix::update(const std::list<Raven_Bot*>& bots,
+                                    const WallGrid& walls,
+                                    float maxRange,
+                                    WorkerPool* pWorkers)
+{
+    m_Bots.assign(bots.begin(), bots.end());
+
+    int numBots = (int)m_Bots.size();
+
+    m_Positions.resize(numBots);
+    for (int i=0; i<numBots; ++i)
+    {
+        m_Positions[i] = m_Bots[i]->getPos();
+        m_Bots[i]->setVisibilityRow(i);
+    }
+
+    m_dMaxRangeSq = maxRange * maxRange;
+
+    m_iWordsPerRow = (numBots + 31) / 32;
+    m_Bits.assign(numBots * m_iWordsPerRow, 0);
+
+    RowJob job(*this, walls);
+
+    //the first rows are the longest, so they are handed out one at a time
+    if (pWorkers)
+    {
+        pWorkers->run(job, numBots, 1);
+    }
+    else
+    {
+        job.process(0, numBots);
+    }
+}
+
+//----------------------------- calculateRow ----------------------------------
+//-----------------------------------------------------------------------------
+void Raven_VisibilityMatrix::calculateRow(int i, const WallGrid& walls)
+{
+    unsigned int* row = &m_Bits[i*m_iWordsPerRow];
+
+    for (int j=i+1; j<(int)m_Positions.size(); ++j)
+    {
+        //too far away to be seen, no need to cast the ray
+        if (m_dMaxRangeSq > 0 && Vec2DistanceSq(m_Positions[i], m_Positions[j]) > m_dMaxRangeSq)
+        {
+            continue;
+        }
+
+        if (!walls.doWallsObstructLineSegment(m_Positions[i], m_Positions[j]))
+        {
+            row[j/32] |= 1u << (j%32);
+        }
+    }
+}
+
+//------------------------------ getIndex -------------------------------------
+//
+//  the row is kept on the bot by update. A bot added since, or one whose
+//  row is left over from an earlier update, isn't at that row
+//-----------------------------------------------------------------------------
+int Raven_VisibilityMatrix::getIndex(const Raven_Bot* pBot)const
+{
+    int row = pBot->getVisibilityRow();
+
+    if (row < 0 || row >= (int)m_Bots.size() || m_Bots[row] != pBot) return -1;
+
+    return row;
+}
@@ -0,0 +1,70 @@
+#ifndef RAVEN_VISIBILITY_H
+#define RAVEN_VISIBILITY_H
+#pragma warning (disable:4786)
+//-----------------------------------------------------------------------------
+//
+//  Name:   Raven_Visibility.h
+//
+//  Desc:   line of sight between every pair of bots, calculated in one pass
+//          by the world and read by the bots' sensory memories.
+//
+//          LOS is symmetric so only the pairs (i, j) with i < j are cast.
+//          Row i of the bit matrix holds the results for j > i, so the rows
+//          can be calculated on different threads without sharing any
+//          words.
+//
+//-----------------------------------------------------------------------------
+#include <vector>
+#include <list>
+#include <algorithm>
+#include "common/2D/Vector2D.h"
+
+class Raven_Bot;
+class WallGrid;
+class WorkerPool;
+
+
+class Raven_VisibilityMatrix
+{
+public:
+    Raven_VisibilityMatrix():m_iWordsPerRow(0), m_dMaxRangeSq(0){}
+
+    //recalculates the LOS between all the bots. Pairs further apart than
+    //maxRange are not visible (0 means no limit). If pWorkers isn't NULL
+    //the rows are shared out between its threads
+    void update(const std::list<Raven_Bot*>& bots,
+                const WallGrid& walls,
+                float maxRange,
+                WorkerPool* pWorkers);
+
+    int getNumBots()const{return (int)m_Bots.size();}
+    Raven_Bot* getBot(int i)const{return m_Bots[i];}
+
+    //returns the row of the bot or -1 if it wasn't in the last update
+    int getIndex(const Raven_Bot* pBot)const;
+
+    //returns true if the ray between bots a and b is unobstructed
+    bool isLOSOkay(int a, int b)const
+    {
+        if (a > b) std::swap(a, b);
+        return (m_Bits[a*m_iWordsPerRow + b/32] & (1u << (b%32))) != 0;
+    }
+
+private:
+    class RowJob;
+
+    //casts the rays from bot i to the bots after it
+    void calculateRow(int i, const WallGrid& walls);
+
+    //the bots and their positions at the time of the update
+    std::vector<Raven_Bot*> m_Bots;
+    std::vector<Vector2D> m_Positions;
+
+    std::vector<unsigned int> m_Bits;
+    int m_iWordsPerRow;
+
+    float m_dMaxRangeSq;
+};
+
+
+#endif
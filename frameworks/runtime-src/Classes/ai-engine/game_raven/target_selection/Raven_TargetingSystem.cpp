@@ -1,6 +1,7 @@
 #include "Raven_TargetingSystem.h"
-#include "Raven_Bot.h"
-#include "Raven_SensoryMemory.h"
+#include "../misc/Raven_Bot.h"
+#include "../sensor_memory/Raven_SensoryMemory.h"
+#include "common/misc/UtilsEx.h"
 
 
 
@@ -18,7 +19,7 @@ Raven_TargetingSystem::Raven_TargetingSystem(Raven_Bot* owner):m_pOwner(owner),
 //-----------------------------------------------------------------------------
 void Raven_TargetingSystem::update()
 {
-    float ClosestDistSoFar = MaxDouble;
+    float ClosestDistSoFar = FloatMax;
     m_pCurrentTarget = nullptr;
 
     //grab a list of all the opponents the owner can sense
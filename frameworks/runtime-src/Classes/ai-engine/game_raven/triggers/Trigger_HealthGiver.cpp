@@ -1,12 +1,15 @@
 
 #include "Trigger_HealthGiver.h"
+#include "../misc/ParaConfigRaven.h"
 
 
 
 ///////////////////////////////////////////////////////////////////////////////
-Trigger_HealthGiver::Trigger_HealthGiver(Vector2D pos):m_iHealthGiven(Para_Health_Given)
+Trigger_HealthGiver::Trigger_HealthGiver(Vector2D pos, int graphNodeIndex):m_iHealthGiven(Para_Health_Given)
 {
     setPos(pos);
+    setGraphNodeIndex(graphNodeIndex);
+    setEntityType(type_health);
     
     //create this trigger's region of fluence
     addCircularTriggerRegion(pos, Para_DefaultGiverTriggerRange);
@@ -18,7 +18,8 @@
 class Trigger_HealthGiver : public Trigger_Respawning<Raven_Bot>
 {
 public:
-    Trigger_HealthGiver(Vector2D pos);
+    //the health pack is at the graph node of index graphNodeIndex
+    Trigger_HealthGiver(Vector2D pos, int graphNodeIndex);
 
     //if triggered, the bot's health will be incremented
     void tryCheck(Raven_Bot* pBot);
@@ -18,12 +18,12 @@ public:
     Trigger_OnButtonSendMsg(Vector2D pos, int msgId, int entityId, float r):m_iReceiver(entityId),
                                                                                                                                 m_msgId(msgId)
     {
-        setPos(pos);
-        setBoundingRadius(r);
+        this->setPos(pos);
+        this->setBoundingRadius(r);
         
         //create and set this trigger's region of fluence
-        addRectangularTriggerRegion(getPos()-Vector2D(r, r),   //top left corner
-                                                    getPos()+Vector2D(r, r));  //bottom right corner
+        this->addRectangularTriggerRegion(this->getPos()-Vector2D(r, r),   //top left corner
+                                                    this->getPos()+Vector2D(r, r));  //bottom right corner
     }
 
     ~Trigger_OnButtonSendMsg()
@@ -39,14 +39,14 @@ public:
 
     bool handleMessage(const Telegram& msg);
 
+    void setReceiver(int entityId){m_iReceiver = entityId;}
+
 private:
     //when triggered a message is sent to the entity with the following ID
     int m_iReceiver;
 
     //the message that is sent
     int m_msgId;
-
-    float m_radius;    
 };
 
 
@@ -57,13 +57,13 @@ private:
 template <class entity_type>
 void Trigger_OnButtonSendMsg<entity_type>::tryCheck(entity_type* pEnt)
 {
-    if (isTouchingTrigger(pEnt->getPos(), pEnt->getBoundingRadius()))
+    if (this->isTouchingTrigger(pEnt->getPos(), pEnt->getBoundingRadius()))
     {
         MessageDispatcher::instance()->dispatchMsg( 0, 
                                                                             this->getID(),
                                                                             m_iReceiver,
                                                                             m_msgId, 
-                                                                            NULL);
+                                                                            NO_ADDITIONAL_INFO);
     }
 }
 
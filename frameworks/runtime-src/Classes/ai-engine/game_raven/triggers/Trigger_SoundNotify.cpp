@@ -1,5 +1,7 @@
 #include "Trigger_SoundNotify.h"
-#include "game_raven/RavenMessages.h"
+#include "../misc/RavenMessages.h"
+#include "../misc/ParaConfigRaven.h"
+#include "common/message/MessageDispatcher.h"
 
 //------------------------------ ctor -----------------------------------------
 //-----------------------------------------------------------------------------
@@ -29,7 +31,7 @@ void Trigger_SoundNotify::tryCheck(Raven_Bot* pBot)
                                                                             -1, 
                                                                             pBot->getID(),
                                                                             Msg_GunshotSound, 
-                                                                            m_pSoundSource);
+                                                                            EntityHandle(m_pSoundSource->getID()));
     }   
 }
 
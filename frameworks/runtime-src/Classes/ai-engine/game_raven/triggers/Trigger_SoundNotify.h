@@ -12,7 +12,7 @@
 //            of 1 update-step
 //
 //-----------------------------------------------------------------------------
-#include "common/triggers/Trigger_LimitedLifetime.h"
+#include "common/triggers/Trigger_LimitedLifeTime.h"
 #include "../misc/Raven_Bot.h"
 
 
@@ -1,12 +1,15 @@
 
 #include "Trigger_WeaponGiver.h"
+#include "../misc/ParaConfigRaven.h"
+#include "../weapon_handling/Raven_WeaponSystem.h"
 
 ///////////////////////////////////////////////////////////////////////////////
 
-Trigger_WeaponGiver::Trigger_WeaponGiver(int entityType, Vector2D pos)
+Trigger_WeaponGiver::Trigger_WeaponGiver(int entityType, Vector2D pos, int graphNodeIndex)
 {
     setEntityType(entityType);
     setPos(pos);
+    setGraphNodeIndex(graphNodeIndex);
     
     addCircularTriggerRegion(getPos(), Para_DefaultGiverTriggerRange);
     setRespawnDelay(Para_Weapon_RespawnDelay);
@@ -18,7 +18,7 @@ class Trigger_WeaponGiver : public Trigger_Respawning<Raven_Bot>
 {
 public:
     //this type of trigger is created when reading a map file
-    Trigger_WeaponGiver(int entityType, Vector2D pos);
+    Trigger_WeaponGiver(int entityType, Vector2D pos, int graphNodeIndex);
 
     //if triggered, this trigger will call the PickupWeapon method of the
     //bot. PickupWeapon will instantiate a weapon of the appropriate type.
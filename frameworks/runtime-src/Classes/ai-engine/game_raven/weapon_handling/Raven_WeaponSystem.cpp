@@ -1,12 +1,13 @@
 
 #include "Raven_WeaponSystem.h"
-#include "ParaConfigRaven.h"
-#include "game_raven/armory/Weapon_RocketLauncher.h"
-#include "game_raven/armory/Weapon_RailGun.h"
-#include "game_raven/armory/Weapon_ShotGun.h"
-#include "game_raven/armory/Weapon_Blaster.h"
-#include "Raven_Bot.h"
+#include "../misc/ParaConfigRaven.h"
+#include "../armory/Weapon_RocketLauncher.h"
+#include "../armory/Weapon_RailGun.h"
+#include "../armory/Weapon_ShotGun.h"
+#include "../armory/Weapon_Blaster.h"
+#include "../misc/Raven_Bot.h"
 #include "common/misc/UtilsEx.h"
+#include "common/2D/Transformations.h"
 
 
 //------------------------- ctor ----------------------------------------------
@@ -8,6 +8,7 @@
 #include "common/misc/UtilsEx.h"
 #include "common/game/Region.h"
 #include "common/game/CommonFunction.h"
+#include "SoccerPitch.h"
 #include "common/misc/LogDebug.h"
 #include <limits>
 
@@ -121,7 +122,7 @@ void FieldPlayer::update(float dt)
     //enforce a non-penetration constraint if desired
     if(Invoid_Not_Overlap) 
     {
-        invoidOverlap(this, AutoList<PlayerBase>::getAllMembers());
+        invoidOverlap(this, getPitch()->getAllPlayers());
     }
 
     //update UI
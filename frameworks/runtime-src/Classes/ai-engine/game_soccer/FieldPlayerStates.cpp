@@ -12,6 +12,7 @@
 #include "common/misc/LogDebug.h"
 #include "common/message/Telegram.h"
 #include "common/message/MessageDispatcher.h"
+#include "common/game/EntityManager.h"
 #include "SoccerMessages.h"
 #include "ParaConfigSoccer.h"
 
@@ -47,7 +48,7 @@ bool GlobalPlayerState::onMessage(FieldPlayer* player, const Telegram& telegram)
         case Msg_ReceiveBall:
         {
             //set the target
-            player->getSteering()->setTarget(*(static_cast<Vector2D*>(telegram.m_extraInfo)));
+            player->getSteering()->setTarget(telegram.m_extraInfo.get<Vector2D>());
 
             //change state 
             player->getFSM()->changeState(ReceiveBall::instance());
@@ -100,8 +101,9 @@ bool GlobalPlayerState::onMessage(FieldPlayer* player, const Telegram& telegram)
         case Msg_PassToMe:
         {  
 
-            //get the position of the player requesting the pass 
-            FieldPlayer* receiver = static_cast<FieldPlayer*>(telegram.m_extraInfo);
+            //get the player requesting the pass 
+            FieldPlayer* receiver = static_cast<FieldPlayer*>(
+                EntityManager::instance()->getEntityByID(telegram.m_extraInfo.get<EntityHandle>().id));
 
             AILOG("Player %d received request from %d to make pass", player->getID(), receiver->getID());
 
@@ -118,12 +120,13 @@ bool GlobalPlayerState::onMessage(FieldPlayer* player, const Telegram& telegram)
 
             AILOG("Player %d  Passed ball to requesting player", player->getID());
             
-            //let the receiver know a pass is coming 
+            //let the receiver know a pass is coming
+            Vector2D passTarget = receiver->getPos();
             MessageDispatcher::instance()->dispatchMsg( 0, 
                                                                                 player->getID(), 
                                                                                 receiver->getID(),
                                                                                 Msg_ReceiveBall, 
-                                                                                &receiver->getPos());
+                                                                                passTarget);
             
             //change state   
             player->getFSM()->changeState(Wait::instance());
@@ -501,7 +504,7 @@ void KickBall::onExecute(FieldPlayer* player)
                                                                             player->getID(), 
                                                                             receiver->getID(),
                                                                             Msg_ReceiveBall, 
-                                                                            &BallTarget);
+                                                                            BallTarget);
 
         //the player should wait at his current position unless instruced
         //otherwise  
@@ -2,7 +2,7 @@
 #include "GoalKeeperStates.h"
 #include "SoccerPitch.h"
 #include "PlayerBase.h"
-#include "GoalKeeper.h"
+#include "Goalkeeper.h"
 #include "SteeringBehaviors_Soccer.h"
 #include "SoccerTeam.h"
 #include "SoccerGoal.h"
@@ -257,7 +257,7 @@ void PutBallBackInPlay::onExecute(GoalKeeper* keeper)
                                                                             keeper->getID(), 
                                                                             receiver->getID(),
                                                                             Msg_ReceiveBall, 
-                                                                            &BallTarget);
+                                                                            BallTarget);
             
         //go back to tending the goal   
         keeper->getFSM()->changeState(TendGoal::instance());
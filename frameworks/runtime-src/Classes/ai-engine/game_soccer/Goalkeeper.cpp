@@ -1,7 +1,7 @@
 
 #include "ParaConfigSoccer.h"
 #include "ParaConfigSoccer.h"
-#include "GoalKeeper.h"
+#include "Goalkeeper.h"
 #include "SteeringBehaviors_Soccer.h"
 #include "SoccerTeam.h"
 #include "SoccerPitch.h"
@@ -82,7 +82,7 @@ void GoalKeeper::update(float dt)
     //enforce a non-penetration constraint if desired
     if(Invoid_Not_Overlap)
     {
-        invoidOverlap(this, AutoList<PlayerBase>::getAllMembers());
+        invoidOverlap(this, getPitch()->getAllPlayers());
     }
 
     //update the heading if the player has a non zero velocity
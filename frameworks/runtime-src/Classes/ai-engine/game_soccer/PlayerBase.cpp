@@ -14,6 +14,8 @@
 
 PlayerBase::~PlayerBase()
 {
+    getPitch()->removePlayer(this);
+
     delete m_pSteering;
 }
 
@@ -39,6 +41,8 @@ PlayerBase::PlayerBase( SoccerTeam* team,
                                                                        m_defaultRegion(home_region),
                                                                        m_PlayerRole(role)
 {
+    team->getPitch()->addPlayer(this);
+
     //set up the steering behavior class
     m_pSteering = new SteeringBehaviors_Soccer(this, m_pTeam->getPitch(), getBall());  
 
@@ -131,7 +135,7 @@ void PlayerBase::findSupport()const
                                                                             getID(), 
                                                                             getTeam()->getSupportingPlayer()->getID(),
                                                                             Msg_SupportAttacker, 
-                                                                            NULL);
+                                                                            NO_ADDITIONAL_INFO);
     }
     
     //if the best player available to support the attacker changes, update
@@ -144,7 +148,7 @@ void PlayerBase::findSupport()const
                                                                                 getID(), 
                                                                                 getTeam()->getSupportingPlayer()->getID(),
                                                                                 Msg_GoHome, 
-                                                                                NULL);
+                                                                                NO_ADDITIONAL_INFO);
         }
 
         getTeam()->setSupportingPlayer(BestSupportPly);
@@ -152,7 +156,7 @@ void PlayerBase::findSupport()const
                                                                             getID(), 
                                                                             getTeam()->getSupportingPlayer()->getID(),
                                                                             Msg_SupportAttacker, 
-                                                                            NULL);
+                                                                            NO_ADDITIONAL_INFO);
     }
 }
 
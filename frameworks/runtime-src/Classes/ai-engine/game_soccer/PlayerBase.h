@@ -15,7 +15,6 @@
 #include <vector>
 #include <string>
 #include <cassert>
-#include "common/misc/AutoList.h"
 #include "common/2D/Vector2D.h"
 #include "common/game/MovingEntity.h"
 
@@ -25,7 +24,7 @@ class SoccerBall;
 class SteeringBehaviors_Soccer;
 class Region;
 
-class PlayerBase : public MovingEntity, public AutoList<PlayerBase>
+class PlayerBase : public MovingEntity
 {
 public:
     enum player_role
@@ -15,7 +15,7 @@
 #include "SoccerBall.h"
 #include "common/2D/Vector2D.h"
 #include "common/2D/Geometry.h"
-#include "common/game/EngineInterface.h"
+#include "common/game/engineinterface.h"
 
 
 class SoccerGoal :public BaseEntity
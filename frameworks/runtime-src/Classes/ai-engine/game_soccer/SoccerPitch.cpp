@@ -1,4 +1,6 @@
 
+#include <algorithm>
+
 #include "GameConfig.h"
 #include "ParaConfigSoccer.h"
 #include "SoccerPitch.h"
@@ -12,6 +14,7 @@
 #include "common/2D/Transformations.h"
 #include "common/2D/Geometry.h"
 #include "common/misc/LogDebug.h"
+#include "common/message/MessageDispatcher.h"
 
 
 
@@ -19,7 +22,9 @@ const int NumRegionsHorizontal = 6;
 const int NumRegionsVertical   = 3; 
 
 
-SoccerPitch::SoccerPitch(int cx, int cy):m_cxClient(cx),
+SoccerPitch::SoccerPitch(int cx, int cy, unsigned int seed):m_Context(Sim_Time_Step, seed),
+                                                                 m_Profiler(Profiler_History_Frames),
+                                                                 m_cxClient(cx),
                                                                  m_cyClient(cy),
                                                                  m_bPaused(false),
                                                                  m_bGoalKeeperHasBall(false),
@@ -28,6 +33,10 @@ SoccerPitch::SoccerPitch(int cx, int cy):m_cxClient(cx),
                                                                  m_ui(nullptr)
 {
     AILOG("SoccerPitch");
+
+    //the entities created below are registered with this context, and
+    //their regulators and timers read its clock
+    m_Context.makeCurrent();
     
     //define the playing area
     m_pPlayingArea = new Region(20, 20, cx-20, cy-20);
@@ -80,6 +89,8 @@ SoccerPitch::SoccerPitch(int cx, int cy):m_cxClient(cx),
 //------------------------------------------------------------------------
 SoccerPitch::~SoccerPitch()
 {
+    m_Context.makeCurrent();
+
     delete m_pPlayingArea;
     
     delete m_pRedGoal;
@@ -106,12 +117,17 @@ SoccerPitch::~SoccerPitch()
     }
 }
 
-SoccerPitch* SoccerPitch::create(int width, int height)
+SoccerPitch* SoccerPitch::create(int width, int height, unsigned int seed)
 {
-    SoccerPitch *ret = new (std::nothrow)SoccerPitch(width, height);
+    SoccerPitch *ret = new (std::nothrow)SoccerPitch(width, height, seed);
     return ret;
 }
 
+void SoccerPitch::removePlayer(PlayerBase* pPlayer)
+{
+    m_AllPlayers.erase(std::remove(m_AllPlayers.begin(), m_AllPlayers.end(), pPlayer), m_AllPlayers.end());
+}
+
 void SoccerPitch::onEnter()
 {
     BaseNode::onEnter();
@@ -120,13 +136,29 @@ void SoccerPitch::onEnter()
 
 //----------------------------- Update -----------------------------------
 //
-//  this demo works on a fixed frame rate (60 by default) so we don't need
-//  to pass a time_elapsed as a parameter to the game entities
+//  this demo works on a fixed frame rate (60 by default). Each update moves
+//  the simulation clock on by Sim_Time_Step, which is also the time passed
+//  to the entities, so the match plays out the same however fast the
+//  updates are called. If the clock follows the real time dt is used
 //------------------------------------------------------------------------
 void SoccerPitch::update(float dt)
 {
     if (m_bPaused) return;
 
+    m_Context.makeCurrent();
+    m_Context.getClock().tick();
+
+    if (getClock().getTimeStep() > 0) dt = getClock().getTimeStep();
+
+    m_Profiler.makeCurrent();
+    m_Profiler.beginFrame();
+
+    //deliver any delayed messages that are now due
+    {
+        AIPROFILE("dispatchMsgDelay");
+        MessageDispatcher::instance()->dispatchMsgDelay();
+    }
+
     m_pRedGoal->update();
     m_pBlueGoal->update();
 
@@ -137,11 +169,17 @@ void SoccerPitch::update(float dt)
 
 #if 1
     //update the balls
-    m_pBall->update(dt);
+    {
+        AIPROFILE("SoccerBall::update");
+        m_pBall->update(dt);
+    }
 
     //update the teams
-    m_pRedTeam->update(dt);
-    m_pBlueTeam->update(dt);
+    {
+        AIPROFILE("SoccerTeam::update");
+        m_pRedTeam->update(dt);
+        m_pBlueTeam->update(dt);
+    }
 
     //if a goal has been detected reset the pitch ready for kickoff
     if (m_pBlueGoal->isScored(m_pBall) || m_pRedGoal->isScored(m_pBall))
@@ -157,7 +195,12 @@ void SoccerPitch::update(float dt)
     }
 #endif
 
-    render();
+    {
+        AIPROFILE("render");
+        render();
+    }
+
+    m_Profiler.endFrame();
 }
 
 //------------------------- CreateRegions --------------------------------
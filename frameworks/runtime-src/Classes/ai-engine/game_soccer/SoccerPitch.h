@@ -18,6 +18,8 @@
 #include "common/game/Wall.h"
 #include "common/2D/Vector2D.h"
 #include "common/game/BaseNode.h"
+#include "common/game/WorldContext.h"
+#include "common/misc/Profiler.h"
 
 class Region;
 class SoccerGoal;
@@ -30,10 +32,11 @@ class PlayerBase;
 class SoccerPitch :public BaseNode
 { 
 public:
-    SoccerPitch(int cxClient, int cyClient);
+    //seed seeds the random numbers of the match
+    SoccerPitch(int cxClient, int cyClient, unsigned int seed = 0);
     ~SoccerPitch();
 
-    static SoccerPitch* create(int width, int height);
+    static SoccerPitch* create(int width, int height, unsigned int seed = 0);
 
     void onEnter();
     
@@ -58,17 +61,35 @@ public:
         return m_Regions[idx];
     }
     
+    //the players of both teams
+    const std::vector<PlayerBase*>& getAllPlayers()const{return m_AllPlayers;}
+    void addPlayer(PlayerBase* pPlayer){m_AllPlayers.push_back(pPlayer);}
+    void removePlayer(PlayerBase* pPlayer);
+
+    WorldContext& getContext(){return m_Context;}
+    const SimClock& getClock()const{return m_Context.getClock();}
+    Profiler& getProfiler(){return m_Profiler;}
+
     bool  isGameOn()const{return m_bGameOn;}
     void  setGameOn(){m_bGameOn = true;}
     void  setGameOff(){m_bGameOn = false;}
 
 
 private:
+    //the entities, messages, clock and random numbers of the match. The
+    //clock is ticked once per update
+    WorldContext m_Context;
+
+    //times the parts of each update
+    Profiler m_Profiler;
+
     SoccerBall* m_pBall;
     
     SoccerTeam* m_pRedTeam;
     SoccerTeam* m_pBlueTeam;
 
+    std::vector<PlayerBase*> m_AllPlayers;
+
     SoccerGoal* m_pRedGoal;
     SoccerGoal* m_pBlueGoal;
    
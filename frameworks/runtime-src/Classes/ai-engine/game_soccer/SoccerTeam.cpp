@@ -3,7 +3,7 @@
 #include "SoccerPitch.h"
 #include "SoccerGoal.h"
 #include "PlayerBase.h"
-#include "GoalKeeper.h"
+#include "Goalkeeper.h"
 #include "FieldPlayer.h"
 #include "SteeringBehaviors_Soccer.h"
 #include "GoalKeeperStates.h"
@@ -13,6 +13,7 @@
 #include "SoccerMessages.h"
 #include "TeamStates.h"
 #include "ParaConfigSoccer.h"
+#include "common/misc/Profiler.h"
 
 using std::vector;
 
@@ -84,9 +85,14 @@ void SoccerTeam::update(float dt)
     //the team state machine switches between attack/defense behavior. It
     //also handles the 'kick off' state where a team must return to their
     //kick off positions before the whistle is blown
-    m_pStateMachine->update(dt);
+    {
+        AIPROFILE("team state");
+        m_pStateMachine->update(dt);
+    }
   
     //now update each player
+    AIPROFILE("PlayerBase::update");
+
     std::vector<PlayerBase*>::iterator it = m_Players.begin();
     for (it; it != m_Players.end(); ++it)
     {
@@ -440,7 +446,7 @@ void SoccerTeam::returnAllFieldPlayersToHome()const
                                                                                 1, 
                                                                                 (*it)->getID(),
                                                                                 Msg_GoHome,
-                                                                                NULL);
+                                                                                NO_ADDITIONAL_INFO);
         }
     }
 }
@@ -666,7 +672,7 @@ void SoccerTeam::requestPass(FieldPlayer* requester)const
                                                                             requester->getID(),
                                                                             getControllingPlayer()->getID(),
                                                                             Msg_PassToMe,
-                                                                            requester); 
+                                                                            EntityHandle(requester->getID()));
     }
 }
 
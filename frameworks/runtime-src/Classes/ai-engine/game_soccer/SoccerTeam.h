@@ -96,7 +96,14 @@ public:
     //returns true if player has a clean shot at the goal and sets ShotTarget
     //to a normalized vector pointing in the direction the shot should be
     //made. Else returns false and sets heading to a zero vector
-    bool canShoot(Vector2D BallPos, float power, Vector2D& ShotTarget = Vector2D()) const;
+    bool canShoot(Vector2D BallPos, float power, Vector2D& ShotTarget) const;
+
+    //as above, for when the shot target is not needed
+    bool canShoot(Vector2D BallPos, float power) const
+    {
+        Vector2D ShotTarget;
+        return canShoot(BallPos, power, ShotTarget);
+    }
 
     //The best pass is considered to be the pass that cannot be intercepted 
     //by an opponent and that is as far forward of the receiver as possible  
@@ -2,7 +2,7 @@
 #include "SteeringBehaviors_Soccer.h"
 #include "PlayerBase.h"
 #include "SoccerTeam.h"
-#include "common/misc/Autolist.h"
+#include "SoccerPitch.h"
 #include "SoccerBall.h"
 #include <algorithm> //max , min 
 
@@ -229,8 +229,8 @@ Vector2D SteeringBehaviors_Soccer::pursuit(const SoccerBall* ball)
 //------------------------------------------------------------------------
 void SteeringBehaviors_Soccer::findNeighbours()
 {
-    std::list<PlayerBase*>& AllPlayers = AutoList<PlayerBase>::getAllMembers();
-    std::list<PlayerBase*>::iterator curPlyr;
+    const std::vector<PlayerBase*>& AllPlayers = m_pPlayer->getPitch()->getAllPlayers();
+    std::vector<PlayerBase*>::const_iterator curPlyr;
     for (curPlyr = AllPlayers.begin(); curPlyr!=AllPlayers.end(); ++curPlyr)
     {
         //first clear any current tag
@@ -256,8 +256,8 @@ Vector2D SteeringBehaviors_Soccer::separation()
     //iterate through all the neighbors and calculate the vector from the
     Vector2D SteeringForce;
 
-    std::list<PlayerBase*>& AllPlayers = AutoList<PlayerBase>::getAllMembers();
-    std::list<PlayerBase*>::iterator curPlyr;
+    const std::vector<PlayerBase*>& AllPlayers = m_pPlayer->getPitch()->getAllPlayers();
+    std::vector<PlayerBase*>::const_iterator curPlyr;
     for (curPlyr = AllPlayers.begin(); curPlyr!=AllPlayers.end(); ++curPlyr)
     {
         //make sure this agent isn't included in the calculations and that
@@ -4,7 +4,7 @@
 #include "common/misc/UtilsEx.h"
 #include "common/misc/LogDebug.h"
 #include "common/game/CommonFunction.h"
-#include "common/game/EngineInterface.h"
+#include "common/game/engineinterface.h"
 #include "common/game/Wall.h"
 #include "VehicleSteeringConfig.h"
 #include "SteeringBehaviors.h"
@@ -15,18 +15,25 @@
 #include "common/message/Telegram.h"
 
 
-GameWorldVehicle::GameWorldVehicle(Vector2D winSize, bool isCellSpaceOn):
+GameWorldVehicle::GameWorldVehicle(Vector2D winSize, bool isCellSpaceOn, unsigned int seed):
+                                                m_Context(Sim_Time_Step, seed),
                                                 m_WinSize(winSize),
                                                 m_bCellSpaceOn(isCellSpaceOn),
                                                 m_pCellSpace(nullptr),
+                                                m_pWorkers(new WorkerPool(Worker_Thread_Num)),
+                                                m_Profiler(Profiler_History_Frames),
                                                 m_vCrosshair(Vector2D(winSize.x/2.0, winSize.y/2.0))
 {
     int totalNum = 100;
 
+    //the vehicles created below are registered with this context and
+    //placed with its random numbers
+    m_Context.makeCurrent();
+
 
     if (isCellSpaceOn)
     {
-        m_pCellSpace = new CellSpacePartition<Vehicle*>(winSize, Cell_Num_X, Cell_Num_Y, 200);
+        m_pCellSpace = new CellSpace(winSize, Cell_Num_X, Cell_Num_Y, 200);
     }
 
     for (int i=0; i<totalNum; ++i)
@@ -113,9 +120,12 @@ GameWorldVehicle::GameWorldVehicle(Vector2D winSize, bool isCellSpaceOn):
 
 GameWorldVehicle::~GameWorldVehicle()
 {
-    for (unsigned int a=0; a<m_Vehicles.size(); ++a)
+    m_Context.makeCurrent();
+
+    //a vehicle removes itself from m_Vehicles when it is deleted
+    while (!m_Vehicles.empty())
     {
-        delete m_Vehicles[a];
+        delete m_Vehicles.back();
     }
     
     for (unsigned int ob=0; ob<m_Obstacles.size(); ++ob)
@@ -133,6 +143,8 @@ GameWorldVehicle::~GameWorldVehicle()
     {
         delete m_pCellSpace;
     }
+
+    delete m_pWorkers;
 }
 
 void GameWorldVehicle::onEnter()
@@ -147,19 +159,111 @@ void GameWorldVehicle::onEnter()
     */
 }
 
+//vehicles are handed to the worker threads in chunks of this size
+const int VehiclesPerChunk = 64;
+
+//------------------------------------------------------------------------
+//
+//  the two parallel steps of the update. Each vehicle only writes its own
+//  data in either of them
+//------------------------------------------------------------------------
+class SteeringJob : public ParallelJob
+{
+public:
+    SteeringJob(const std::vector<Vehicle*>& vehicles, float dt):m_Vehicles(vehicles), m_dt(dt){}
+
+    void process(int begin, int end)
+    {
+        for (int i=begin; i<end; ++i)
+        {
+            m_Vehicles[i]->calculateSteering(m_dt);
+        }
+    }
+
+private:
+    const std::vector<Vehicle*>& m_Vehicles;
+    float m_dt;
+};
+
+class IntegrateJob : public ParallelJob
+{
+public:
+    IntegrateJob(const std::vector<Vehicle*>& vehicles, 
+                 VehicleKinematics& kinematics, 
+                 float dt):m_Vehicles(vehicles), m_Kinematics(kinematics), m_dt(dt){}
+
+    void process(int begin, int end)
+    {
+        m_Kinematics.load(m_Vehicles, begin, end);
+        m_Kinematics.integrate(begin, end, m_dt, Win_Width, Win_Height);
+        m_Kinematics.store(m_Vehicles, begin, end);
+    }
+
+private:
+    const std::vector<Vehicle*>& m_Vehicles;
+    VehicleKinematics& m_Kinematics;
+    float m_dt;
+};
+
+//------------------------------ update ----------------------------------
+//
+//  every vehicle first calculates its steering force while nobody moves,
+//  so they all see the same positions of this frame. Then they all move,
+//  integrated in batches by m_Kinematics, and at last the cell space and
+//  the UI are updated on this thread. The result is the same for any
+//  number of worker threads
+//------------------------------------------------------------------------
 void GameWorldVehicle::update(float dt)
 {
     //AILOG("GameWorldVehicle::update %f", dt);
-    for (unsigned int i = 0; i < m_Vehicles.size(); ++i)
+    m_Context.makeCurrent();
+    m_Context.getClock().tick();
+
+    m_Profiler.makeCurrent();
+    m_Profiler.beginFrame();
+
+    int numVehicles = (int)m_Vehicles.size();
+
+    //without the cell space neighbors are found by tagging, and obstacle
+    //avoidance tags the obstacles. Tags are shared so that has to be serial
+    {
+        AIPROFILE("steering");
+
+        SteeringJob steering(m_Vehicles, dt);
+        if (m_bCellSpaceOn && m_Obstacles.empty())
+        {
+            m_pWorkers->run(steering, numVehicles, VehiclesPerChunk);
+        }
+        else
+        {
+            steering.process(0, numVehicles);
+        }
+    }
+
     {
-        m_Vehicles[i]->update(dt);
+        AIPROFILE("integrate");
+
+        m_Kinematics.resize(numVehicles);
+        IntegrateJob integrate(m_Vehicles, m_Kinematics, dt);
+        m_pWorkers->run(integrate, numVehicles, VehiclesPerChunk);
     }
+
+    {
+        AIPROFILE("postUpdate");
+
+        for (int i=0; i<numVehicles; ++i)
+        {
+            m_Vehicles[i]->postUpdate();
+        }
+    }
+
+    m_Profiler.endFrame();
 }
 
-GameWorldVehicle* GameWorldVehicle::create(int width, int height, bool isCellSpaceOn)
+GameWorldVehicle* GameWorldVehicle::create(int width, int height, bool isCellSpaceOn, unsigned int seed)
 {
     AILOG("GameWorldVehicle::create");
-    GameWorldVehicle* ret = new (std::nothrow)GameWorldVehicle(Vector2D(width, height), isCellSpaceOn);
+    GameWorldVehicle* ret = new (std::nothrow)GameWorldVehicle(Vector2D(width, height), isCellSpaceOn, seed);
 
     return ret;    
 }
@@ -3,8 +3,12 @@
 #define GAMEWORLD_H 
 
 #include "common/misc/CellSpacePartition.h"
+#include "common/misc/WorkerPool.h"
+#include "common/misc/Profiler.h"
 #include "common/game/BaseNode.h"
+#include "common/game/WorldContext.h"
 #include "Vehicle.h"
+#include "VehicleKinematics.h"
 
 //#include "2d/CCNode.h"
 //using namespace cocos2d;
@@ -15,18 +19,25 @@ class Obstacle;
 class GameWorldVehicle:public BaseNode
 {
 public:
-    GameWorldVehicle(Vector2D winSize, bool isCellSpaceOn);
+    //vehicles cross cell borders all the time, so the cells keep their
+    //members in vectors to avoid allocating on every crossing
+    typedef CellSpacePartition<Vehicle*, CellStorage_Vector> CellSpace;
+
+    //seed seeds the random numbers of the world
+    GameWorldVehicle(Vector2D winSize, bool isCellSpaceOn, unsigned int seed = 0);
     ~GameWorldVehicle();
     void onEnter();
     void update(float dt);
 
-    static GameWorldVehicle* create(int width, int height, bool isCellSpaceOn);
+    static GameWorldVehicle* create(int width, int height, bool isCellSpaceOn, unsigned int seed = 0);
     
     void createWalls();
     const std::vector<Wall *>& getWalls() {return m_Walls;}                          
-    CellSpacePartition<Vehicle *> *getCellSpace() {return m_pCellSpace;}
+    CellSpace* getCellSpace() {return m_pCellSpace;}
     const std::vector<Obstacle *>& getObstacles() {return m_Obstacles;}
     const std::vector<Vehicle*>& getVehicles() {return m_Vehicles;}
+    Profiler& getProfiler(){return m_Profiler;}
+    WorldContext& getContext(){return m_Context;}
     
     void spacePartitioningOn() {m_bCellSpaceOn = true;};
     void spacePartitioningOff() {m_bCellSpaceOn = false;};
@@ -45,6 +56,9 @@ public:
     Vector2D getCrosshair() const {return m_vCrosshair;}
     
 private:    
+    //the entities, clock and random numbers of the world
+    WorldContext m_Context;
+
     //a container of all the moving entities
     std::vector<Vehicle*> m_Vehicles;
     
@@ -54,7 +68,16 @@ private:
     //container containing any walls in the environment
     std::vector<Wall *> m_Walls;
     
-    CellSpacePartition<Vehicle *>* m_pCellSpace;
+    CellSpace* m_pCellSpace;
+
+    //threads sharing the steering and integration work of update
+    WorkerPool* m_pWorkers;
+
+    //the vehicles' motion data laid out for integrating them all at once
+    VehicleKinematics m_Kinematics;
+
+    //times the parts of each update
+    Profiler m_Profiler;
   
     //flags to turn aids and obstacles etc on/off
     bool  m_bShowWalls;
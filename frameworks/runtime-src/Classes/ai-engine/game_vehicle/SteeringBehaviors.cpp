@@ -7,6 +7,7 @@
 #include "common/2D/Geometry.h"
 #include "common/misc/UtilsEx.h"
 #include "common/misc/CellSpacePartition.h"
+#include "common/misc/Simd.h"
 #include "VehicleSteeringConfig.h"
 #include "GameWorldVehicle.h"
 #include "Obstacle.h"
@@ -49,10 +50,11 @@ SteeringBehavior::SteeringBehavior(Vehicle* agent):
                                                     m_dWanderJitter(Para_WanderJitterPerSec),
                                                     m_dWanderRadius(Para_WanderRadius),
                                                     m_dWaypointSeekDistSq(Para_WaypointSeekDist*Para_WaypointSeekDist),
-                                                    m_SummingMethod(prioritized)
+                                                    m_SummingMethod(prioritized),
+                                                    m_iRandState(RandState(agent->getContext()->getSeed(), agent->getID()))
 {
     //stuff for the wander behavior
-    float theta = RandFloat_0_1() * _PI_*2;
+    float theta = RandFloat_0_1(m_iRandState) * _PI_*2;
 
     //create a vector to a target position on the wander circle
     m_vWanderTarget = Vector2D(m_dWanderRadius * std::cos(theta), m_dWanderRadius * std::sin(theta));
@@ -96,7 +98,9 @@ Vector2D SteeringBehavior::calculate()
         //behaviors are switched on
         if (On(behavior_separation) || On(behavior_allignment) || On(behavior_cohesion))
         {
-            m_pVehicle->getWorld()->getCellSpace()->calculateNeighbors(m_pVehicle->getPos(), m_dViewDistance);
+            //the neighbors go into this behavior's own vector so the query
+            //doesn't depend on the partition's shared neighbor buffer
+            m_pVehicle->getWorld()->getCellSpace()->calculateNeighbors(m_pVehicle->getPos(), m_dViewDistance, m_Neighbors);
         }
     }
 
@@ -107,6 +111,7 @@ Vector2D SteeringBehavior::calculate()
             break;
 
         case prioritized:
+        case prioritized_fused:
             m_vSteeringForce = calculatePrioritized(); 
             break;
 
@@ -223,7 +228,44 @@ Vector2D SteeringBehavior::calculatePrioritized()
 
     //these next three can be combined for flocking behavior (wander is
     //also a good behavior to add into this mix)
-    if (!m_pVehicle->getWorld()->isSpacePartitioningOn())
+    if (m_SummingMethod == prioritized_fused)
+    {
+        if (On(behavior_separation) || On(behavior_allignment) || On(behavior_cohesion))
+        {
+            Vector2D separationForce, alignmentForce, cohesionForce;
+
+            if (!m_pVehicle->getWorld()->isSpacePartitioningOn())
+            {
+                flocking(m_pVehicle->getWorld()->getVehicles(), true, separationForce, alignmentForce, cohesionForce);
+            }
+            else
+            {
+                flocking(m_Neighbors, false, separationForce, alignmentForce, cohesionForce);
+            }
+
+            if (On(behavior_separation))
+            {
+                force = separationForce * m_dWeightSeparation;
+
+                if (!accumulateForce(m_vSteeringForce, force)) return m_vSteeringForce;
+            }
+
+            if (On(behavior_allignment))
+            {
+                force = alignmentForce * m_dWeightAlignment;
+
+                if (!accumulateForce(m_vSteeringForce, force)) return m_vSteeringForce;
+            }
+
+            if (On(behavior_cohesion))
+            {
+                force = cohesionForce * m_dWeightCohesion;
+
+                if (!accumulateForce(m_vSteeringForce, force)) return m_vSteeringForce;
+            }
+        }
+    }
+    else if (!m_pVehicle->getWorld()->isSpacePartitioningOn())
     {
         if (On(behavior_separation))
         {
@@ -251,21 +293,21 @@ Vector2D SteeringBehavior::calculatePrioritized()
 
         if (On(behavior_separation))
         {
-            force = separationEx(m_pVehicle->getWorld()->getVehicles()) * m_dWeightSeparation;
+            force = separationEx(m_Neighbors) * m_dWeightSeparation;
 
             if (!accumulateForce(m_vSteeringForce, force)) return m_vSteeringForce;
         }
 
         if (On(behavior_allignment))
         {
-            force = alignmentEx(m_pVehicle->getWorld()->getVehicles()) * m_dWeightAlignment;
+            force = alignmentEx(m_Neighbors) * m_dWeightAlignment;
 
             if (!accumulateForce(m_vSteeringForce, force)) return m_vSteeringForce;
         }
 
         if (On(behavior_cohesion))
         {
-            force = cohesionEx(m_pVehicle->getWorld()->getVehicles()) * m_dWeightCohesion;
+            force = cohesionEx(m_Neighbors) * m_dWeightCohesion;
 
             if (!accumulateForce(m_vSteeringForce, force)) return m_vSteeringForce;
         }
@@ -390,17 +432,17 @@ Vector2D SteeringBehavior::calculateWeightedSum()
     {
         if (On(behavior_separation))
         {
-            m_vSteeringForce += separationEx(m_pVehicle->getWorld()->getVehicles()) * m_dWeightSeparation;
+            m_vSteeringForce += separationEx(m_Neighbors) * m_dWeightSeparation;
         }
 
         if (On(behavior_allignment))
         {
-            m_vSteeringForce += alignmentEx(m_pVehicle->getWorld()->getVehicles()) * m_dWeightAlignment;
+            m_vSteeringForce += alignmentEx(m_Neighbors) * m_dWeightAlignment;
         }
 
         if (On(behavior_cohesion))
         {
-            m_vSteeringForce += cohesionEx(m_pVehicle->getWorld()->getVehicles()) * m_dWeightCohesion;
+            m_vSteeringForce += cohesionEx(m_Neighbors) * m_dWeightCohesion;
         }
     }
 
@@ -482,7 +524,7 @@ Vector2D SteeringBehavior::calculateDithered()
     //reset the steering force
     m_vSteeringForce.zero();
 
-    if (On(behavior_wall_avoidance) && RandFloat_0_1() < Para_Dither_WallAvoidance)
+    if (On(behavior_wall_avoidance) && RandFloat_0_1(m_iRandState) < Para_Dither_WallAvoidance)
     {
         m_vSteeringForce = wallAvoidance(m_pVehicle->getWorld()->getWalls()) *
             m_dWeightWallAvoidance /Para_Dither_WallAvoidance;
@@ -494,7 +536,7 @@ Vector2D SteeringBehavior::calculateDithered()
         }
     }
    
-    if (On(behavior_obstacle_avoidance) && RandFloat_0_1() < Para_Dither_ObstacleAvoidance)
+    if (On(behavior_obstacle_avoidance) && RandFloat_0_1(m_iRandState) < Para_Dither_ObstacleAvoidance)
     {
         m_vSteeringForce += obstacleAvoidance(m_pVehicle->getWorld()->getObstacles()) * 
         m_dWeightObstacleAvoidance / Para_Dither_ObstacleAvoidance;
@@ -508,7 +550,7 @@ Vector2D SteeringBehavior::calculateDithered()
 
     if (!m_pVehicle->getWorld()->isSpacePartitioningOn())
     {
-        if (On(behavior_separation) && RandFloat_0_1() < Para_Dither_Separation)
+        if (On(behavior_separation) && RandFloat_0_1(m_iRandState) < Para_Dither_Separation)
         {
             m_vSteeringForce += separation(m_pVehicle->getWorld()->getVehicles()) * 
                       m_dWeightSeparation / Para_Dither_Separation;
@@ -522,9 +564,9 @@ Vector2D SteeringBehavior::calculateDithered()
     }
     else
     {
-        if (On(behavior_separation) && RandFloat_0_1() < Para_Dither_Separation)
+        if (On(behavior_separation) && RandFloat_0_1(m_iRandState) < Para_Dither_Separation)
         {
-            m_vSteeringForce += separationEx(m_pVehicle->getWorld()->getVehicles()) * 
+            m_vSteeringForce += separationEx(m_Neighbors) * 
                         m_dWeightSeparation / Para_Dither_Separation;
 
             if (!m_vSteeringForce.isZero())
@@ -536,7 +578,7 @@ Vector2D SteeringBehavior::calculateDithered()
     }
 
 
-    if (On(behavior_flee) && RandFloat_0_1() < Para_Dither_Flee)
+    if (On(behavior_flee) && RandFloat_0_1(m_iRandState) < Para_Dither_Flee)
     {
         m_vSteeringForce += flee(m_pVehicle->getWorld()->getCrosshair()) * m_dWeightFlee / Para_Dither_Flee;
 
@@ -548,7 +590,7 @@ Vector2D SteeringBehavior::calculateDithered()
         }
     }
 
-    if (On(behavior_evade) && RandFloat_0_1() < Para_Dither_Evade)
+    if (On(behavior_evade) && RandFloat_0_1(m_iRandState) < Para_Dither_Evade)
     {
         assert(m_pTargetAgent1 && "Evade target not assigned");
 
@@ -564,7 +606,7 @@ Vector2D SteeringBehavior::calculateDithered()
 
     if (!m_pVehicle->getWorld()->isSpacePartitioningOn())
     {
-        if (On(behavior_allignment) && RandFloat_0_1() < Para_Dither_Alignment)
+        if (On(behavior_allignment) && RandFloat_0_1(m_iRandState) < Para_Dither_Alignment)
         {
             m_vSteeringForce += alignment(m_pVehicle->getWorld()->getVehicles()) *
                                              m_dWeightAlignment / Para_Dither_Alignment;
@@ -577,7 +619,7 @@ Vector2D SteeringBehavior::calculateDithered()
             }
         }
 
-        if (On(behavior_cohesion) && RandFloat_0_1() < Para_Dither_Cohesion)
+        if (On(behavior_cohesion) && RandFloat_0_1(m_iRandState) < Para_Dither_Cohesion)
         {
             m_vSteeringForce += cohesion(m_pVehicle->getWorld()->getVehicles()) * 
                           m_dWeightCohesion / Para_Dither_Cohesion;
@@ -591,9 +633,9 @@ Vector2D SteeringBehavior::calculateDithered()
     }
     else
     {
-        if (On(behavior_allignment) && RandFloat_0_1() < Para_Dither_Alignment)
+        if (On(behavior_allignment) && RandFloat_0_1(m_iRandState) < Para_Dither_Alignment)
         {
-            m_vSteeringForce += alignmentEx(m_pVehicle->getWorld()->getVehicles()) *
+            m_vSteeringForce += alignmentEx(m_Neighbors) *
                           m_dWeightAlignment / Para_Dither_Alignment;
 
             if (!m_vSteeringForce.isZero())
@@ -603,9 +645,9 @@ Vector2D SteeringBehavior::calculateDithered()
             }
         }
 
-        if (On(behavior_cohesion) && RandFloat_0_1() < Para_Dither_Cohesion)
+        if (On(behavior_cohesion) && RandFloat_0_1(m_iRandState) < Para_Dither_Cohesion)
         {
-            m_vSteeringForce += cohesionEx(m_pVehicle->getWorld()->getVehicles()) *
+            m_vSteeringForce += cohesionEx(m_Neighbors) *
                           m_dWeightCohesion / Para_Dither_Cohesion;
 
             if (!m_vSteeringForce.isZero())
@@ -616,7 +658,7 @@ Vector2D SteeringBehavior::calculateDithered()
         }
     }
 
-    if (On(behavior_wander) && RandFloat_0_1() < Para_Dither_Wander)
+    if (On(behavior_wander) && RandFloat_0_1(m_iRandState) < Para_Dither_Wander)
     {
         m_vSteeringForce += wander() * m_dWeightWander / Para_Dither_Wander;
         
@@ -627,7 +669,7 @@ Vector2D SteeringBehavior::calculateDithered()
         }
     }
 
-    if (On(behavior_seek) && RandFloat_0_1() < Para_Dither_Seek)
+    if (On(behavior_seek) && RandFloat_0_1(m_iRandState) < Para_Dither_Seek)
     {
         m_vSteeringForce += seek(m_pVehicle->getWorld()->getCrosshair()) * m_dWeightSeek / Para_Dither_Seek;
         
@@ -638,7 +680,7 @@ Vector2D SteeringBehavior::calculateDithered()
         }
     }
 
-    if (On(behavior_arrive) && RandFloat_0_1() < Para_Dither_Arrive)
+    if (On(behavior_arrive) && RandFloat_0_1(m_iRandState) < Para_Dither_Arrive)
     {
         m_vSteeringForce += arrive(m_pVehicle->getWorld()->getCrosshair(), m_Deceleration) * 
                         m_dWeightArrive / Para_Dither_Arrive;
@@ -788,8 +830,8 @@ Vector2D SteeringBehavior::wander()
     float JitterThisTimeSlice = m_dWanderJitter * m_pVehicle->getTimeElapsed();
 
     //first, add a small random vector to the target's position
-    m_vWanderTarget += Vector2D(RandFloat_minus1_1() * JitterThisTimeSlice,
-                                                    RandFloat_minus1_1() * JitterThisTimeSlice);
+    m_vWanderTarget += Vector2D(RandFloat_minus1_1(m_iRandState) * JitterThisTimeSlice,
+                                                    RandFloat_minus1_1(m_iRandState) * JitterThisTimeSlice);
 
     //reproject this new vector back on to a unit circle
     m_vWanderTarget.normalize();
@@ -1116,10 +1158,10 @@ Vector2D SteeringBehavior::separationEx(const vector<Vehicle*> &neighbors)
     Vector2D SteeringForce;
 
     //iterate through the neighbors and sum up all the position vectors
-    for (BaseEntity* pV = m_pVehicle->getWorld()->getCellSpace()->begin();
-                     !m_pVehicle->getWorld()->getCellSpace()->end();     
-                   pV = m_pVehicle->getWorld()->getCellSpace()->next())
+    for (unsigned int a=0; a<neighbors.size(); ++a)
     {    
+        Vehicle* pV = neighbors[a];
+
         //make sure this agent isn't included in the calculations and that
         //the agent being examined is close enough
         if(pV != m_pVehicle)
@@ -1149,10 +1191,10 @@ Vector2D SteeringBehavior::alignmentEx(const vector<Vehicle*> &neighbors)
     float NeighborCount = 0.0;
 
     //iterate through the neighbors and sum up all the position vectors
-    for (MovingEntity* pV = m_pVehicle->getWorld()->getCellSpace()->begin();
-                         !m_pVehicle->getWorld()->getCellSpace()->end();     
-                        pV = m_pVehicle->getWorld()->getCellSpace()->next())
+    for (unsigned int a=0; a<neighbors.size(); ++a)
     {
+        Vehicle* pV = neighbors[a];
+
         //make sure *this* agent isn't included in the calculations and that
         //the agent being examined  is close enough
         if(pV != m_pVehicle)
@@ -1188,10 +1230,10 @@ Vector2D SteeringBehavior::cohesionEx(const vector<Vehicle*> &neighbors)
     int NeighborCount = 0;
 
     //iterate through the neighbors and sum up all the position vectors
-    for (BaseEntity* pV = m_pVehicle->getWorld()->getCellSpace()->begin();
-                        !m_pVehicle->getWorld()->getCellSpace()->end();     
-                        pV = m_pVehicle->getWorld()->getCellSpace()->next())
+    for (unsigned int a=0; a<neighbors.size(); ++a)
     {
+        Vehicle* pV = neighbors[a];
+
         //make sure *this* agent isn't included in the calculations and that
         //the agent being examined is close enough
         if(pV != m_pVehicle)
@@ -1216,6 +1258,123 @@ Vector2D SteeringBehavior::cohesionEx(const vector<Vehicle*> &neighbors)
 }
 
 
+//------------------------------- Flocking -------------------------------
+//
+//  calculates the separation, alignment and cohesion forces in one go.
+//  The result is the same as calling the three behaviors one after the
+//  other, but the neighbors are only read once
+//------------------------------------------------------------------------
+void SteeringBehavior::flocking(const vector<Vehicle*> &neighbors,
+                                bool tagged,
+                                Vector2D& separationForce,
+                                Vector2D& alignmentForce,
+                                Vector2D& cohesionForce)
+{
+    //pack the neighbors which take part
+    m_BatchPosX.clear();
+    m_BatchPosY.clear();
+    m_BatchHeadingX.clear();
+    m_BatchHeadingY.clear();
+
+    for (unsigned int a=0; a<neighbors.size(); ++a)
+    {
+        Vehicle* pV = neighbors[a];
+
+        //make sure this agent isn't included in the calculations. The tagged
+        //versions also skip the evade target
+        if (pV == m_pVehicle) continue;
+        if (tagged && (!pV->isTag() || pV == m_pTargetAgent1)) continue;
+
+        Vector2D pos = pV->getPos();
+        Vector2D heading = pV->getHeading();
+        m_BatchPosX.push_back(pos.x);
+        m_BatchPosY.push_back(pos.y);
+        m_BatchHeadingX.push_back(heading.x);
+        m_BatchHeadingY.push_back(heading.y);
+    }
+
+    int count = (int)m_BatchPosX.size();
+
+    Vector2D myPos = m_pVehicle->getPos();
+    float sepX = 0, sepY = 0;
+    float headingX = 0, headingY = 0;
+    float centerX = 0, centerY = 0;
+
+    int i = 0;
+
+#ifdef AI_SIMD_SSE2
+    const __m128 vMyX = _mm_set1_ps(myPos.x);
+    const __m128 vMyY = _mm_set1_ps(myPos.y);
+    const __m128 vZero = _mm_setzero_ps();
+    const __m128 vOne = _mm_set1_ps(1.0f);
+    const __m128 vBias = _mm_set1_ps(0.1f);
+    __m128 vSepX = vZero, vSepY = vZero;
+    __m128 vHeadingX = vZero, vHeadingY = vZero;
+    __m128 vCenterX = vZero, vCenterY = vZero;
+
+    for (; i+4 <= count; i += 4)
+    {
+        __m128 posX = _mm_loadu_ps(&m_BatchPosX[i]);
+        __m128 posY = _mm_loadu_ps(&m_BatchPosY[i]);
+
+        //separation: the normalized vector from the neighbor scaled
+        //inversely proportional to the distance
+        __m128 toX = _mm_sub_ps(vMyX, posX);
+        __m128 toY = _mm_sub_ps(vMyY, posY);
+        __m128 dist = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(toX, toX), _mm_mul_ps(toY, toY)));
+        __m128 scale = _mm_div_ps(vOne, _mm_mul_ps(dist, _mm_add_ps(dist, vBias)));
+        scale = _mm_and_ps(_mm_cmpgt_ps(dist, vZero), scale);
+        vSepX = _mm_add_ps(vSepX, _mm_mul_ps(toX, scale));
+        vSepY = _mm_add_ps(vSepY, _mm_mul_ps(toY, scale));
+
+        //alignment and cohesion only need the sums
+        vHeadingX = _mm_add_ps(vHeadingX, _mm_loadu_ps(&m_BatchHeadingX[i]));
+        vHeadingY = _mm_add_ps(vHeadingY, _mm_loadu_ps(&m_BatchHeadingY[i]));
+        vCenterX = _mm_add_ps(vCenterX, posX);
+        vCenterY = _mm_add_ps(vCenterY, posY);
+    }
+
+    sepX = SimdHorizontalSum(vSepX);
+    sepY = SimdHorizontalSum(vSepY);
+    headingX = SimdHorizontalSum(vHeadingX);
+    headingY = SimdHorizontalSum(vHeadingY);
+    centerX = SimdHorizontalSum(vCenterX);
+    centerY = SimdHorizontalSum(vCenterY);
+#endif
+
+    for (; i<count; ++i)
+    {
+        float toX = myPos.x - m_BatchPosX[i];
+        float toY = myPos.y - m_BatchPosY[i];
+        float dist = std::sqrt(toX*toX + toY*toY);
+        if (dist > 0)
+        {
+            float scale = 1.0f / (dist * (dist + 0.1f));
+            sepX += toX * scale;
+            sepY += toY * scale;
+        }
+
+        headingX += m_BatchHeadingX[i];
+        headingY += m_BatchHeadingY[i];
+        centerX += m_BatchPosX[i];
+        centerY += m_BatchPosY[i];
+    }
+
+    separationForce = Vector2D(sepX, sepY);
+    alignmentForce = Vector2D(0, 0);
+    cohesionForce = Vector2D(0, 0);
+
+    if (count > 0)
+    {
+        //the average heading of the neighbors minus our own
+        alignmentForce = Vector2D(headingX, headingY) / (float)count - m_pVehicle->getHeading();
+
+        //seek towards the center of mass, normalized like cohesion does
+        cohesionForce = Vec2Normalize(seek(Vector2D(centerX, centerY) / (float)count));
+    }
+}
+
+
 //--------------------------- Interpose ----------------------------------
 //
 //  Given two agents, this method returns a force that attempts to 
@@ -27,7 +27,11 @@ public:
     {
         weighted_average, 
         prioritized, 
-        dithered
+        dithered,
+
+        //same as prioritized, but separation, alignment and cohesion are
+        //calculated together in one pass over the neighbors (see flocking)
+        prioritized_fused
     };
     
     enum behavior_type
@@ -159,6 +163,22 @@ private:
 
     //a vertex buffer to contain the feelers rqd for wall avoidance  
     std::vector<Vector2D> m_Feelers;
+
+    //the neighbors found in cell space by the last call to calculate. Each
+    //behavior owns its buffer so vehicles can query the partition at once
+    std::vector<Vehicle*> m_Neighbors;
+
+    //positions and headings of the neighbors packed by flocking. Kept
+    //between calls so they only allocate when the neighborhood grows
+    std::vector<float> m_BatchPosX;
+    std::vector<float> m_BatchPosY;
+    std::vector<float> m_BatchHeadingX;
+    std::vector<float> m_BatchHeadingY;
+
+    //random state for wander and dithering. Every vehicle draws from its own
+    //sequence so the result doesn't depend on the order vehicles are updated in,
+    //made from the world's seed and the vehicle's ID
+    unsigned int m_iRandState;
   
     //the length of the 'feeler/s' used in wall detection
     float m_dWallDetectionFeelerLength;
@@ -293,6 +313,17 @@ private:
     Vector2D separationEx(const std::vector<Vehicle*> &agents);
     Vector2D alignmentEx(const std::vector<Vehicle*> &agents);
 
+    //calculates separation, alignment and cohesion in one pass. The
+    //neighbors taking part are first packed into the m_Batch arrays, which
+    //are then processed four at a time with SSE where it is available. If
+    //tagged is true only the tagged agents are used, like the versions
+    //without cell space partitioning do
+    void flocking(const std::vector<Vehicle*> &agents,
+                  bool tagged,
+                  Vector2D& separationForce,
+                  Vector2D& alignmentForce,
+                  Vector2D& cohesionForce);
+
    /* ......................................................................................................................
 
                                     END BEHAVIOR DECLARATIONS
@@ -1,9 +1,10 @@
 
 #include "GameConfig.h"
-#include "common/game/EngineInterface.h"
+#include "common/game/engineinterface.h"
 #include "common/game/CommonFunction.h"
 #include "VehicleSteeringConfig.h"
 #include "Vehicle.h"
+#include "VehicleKinematics.h"
 #include "SteeringBehaviors.h"
 #include "GameWorldVehicle.h"
 
@@ -24,9 +25,11 @@ Vehicle::Vehicle(GameWorldVehicle* world,
                                                                         m_vSmoothedHeading(Vector2D(0,0)),
                                                                         m_bSmoothingOn(false),
                                                                         m_dTimeElapsed(0.0f),
+                                                                        m_iCellSlot(-1),
                                                                         m_ui(nullptr)
 { 
     m_vPosition = position;
+    m_vOldPos = position;
     
     //set up the steering behavior class
     m_pSteering = new SteeringBehavior(this); 
@@ -55,52 +58,85 @@ Vehicle::~Vehicle()
 //------------------------------------------------------------------------
 void Vehicle::update(float time_elapsed)
 {
-    Vector2D SteeringForce;
+    calculateSteering(time_elapsed);
 
-    Vector2D oldPos = getPos();
-    
+    integrate(time_elapsed);
+
+    postUpdate();
+}
+
+//------------------------- calculateSteering ----------------------------
+//
+//  calculates the combined force from each steering behavior in the
+//  vehicle's list. Only this vehicle's own data is written
+//------------------------------------------------------------------------
+void Vehicle::calculateSteering(float time_elapsed)
+{
     //update the time elapsed
     m_dTimeElapsed = time_elapsed;
 
-    //calculate the combined force from each steering behavior in the vehicle's list
-    SteeringForce = m_pSteering->calculate();
-    
-    //Acceleration = Force/Mass
-    Vector2D acceleration = SteeringForce /m_dMass;
-    
-    //update velocity
-    m_vVelocity += acceleration * time_elapsed; 
+    m_pSteering->calculate();
+}
 
-    //make sure vehicle does not exceed maximum velocity
-    m_vVelocity.truncate(m_dMaxSpeed);
-    
-    //update the heading if the vehicle has a non zero velocity
-    if (m_vVelocity.lengthSq() > 0.00000001)
+//----------------------------- integrate --------------------------------
+//
+//  moves the vehicle using the force from the last calculateSteering.
+//  Doesn't touch anything shared with the other vehicles. The world moves
+//  its vehicles with VehicleKinematics, this uses the same integrator
+//------------------------------------------------------------------------
+void Vehicle::integrate(float time_elapsed)
+{
+    Vector2D pos = getPos();
+    Vector2D velocity = m_vVelocity;
+    Vector2D heading = m_vHeading;
+    Vector2D force = m_pSteering->force();
+
+    VehicleKinematics::integrateOne(pos.x, pos.y,
+                                    velocity.x, velocity.y,
+                                    heading.x, heading.y,
+                                    force.x, force.y,
+                                    1.0f / m_dMass, m_dMaxSpeed,
+                                    time_elapsed, Win_Width, Win_Height);
+
+    setKinematics(pos, velocity, heading);
+}
+
+//---------------------------- setKinematics -----------------------------
+//------------------------------------------------------------------------
+void Vehicle::setKinematics(Vector2D pos, Vector2D velocity, Vector2D heading)
+{
+    m_vOldPos = getPos();
+
+    m_vPosition = pos;
+    m_vVelocity = velocity;
+    m_vHeading = heading;
+    m_vSide = m_vHeading.getPerp();
+
+    smoothHeading();
+}
+
+void Vehicle::smoothHeading()
+{
+    if (isSmoothingOn())
     {
-        m_vHeading = Vec2Normalize(m_vVelocity);
-        m_vSide = m_vHeading.getPerp();
+        m_vSmoothedHeading = m_pHeadingSmoother->update(getHeading());
     }
-    
-    //update the position
-    m_vPosition += m_vVelocity * time_elapsed;
-    wrapAround(m_vPosition, Win_Width, Win_Height);
+}
 
-    //invoidOverlap(this, this->getWorld()->getVehicles());
-    
+//----------------------------- postUpdate -------------------------------
+//
+//  the part of the update which touches shared data (the cell space and
+//  the UI), so it has to run on the main thread
+//------------------------------------------------------------------------
+void Vehicle::postUpdate()
+{
     //update the vehicle's current cell if space partitioning is turned on
     if (getWorld()->isSpacePartitioningOn())
     {
-        getWorld()->getCellSpace()->updateEntity(this, oldPos);
-    }
-    
-    if (isSmoothingOn())
-    {
-        m_vSmoothedHeading = m_pHeadingSmoother->update(getHeading());
+        getWorld()->getCellSpace()->updateEntity(this, m_vOldPos);
     }
-
     
     render();
-    
 }
 
 void Vehicle::render()
@@ -29,6 +29,19 @@ public:
     
     //updates the vehicle's position and orientation
     void update(float dt);
+
+    //update split in three steps so a world can run the first two for all
+    //its vehicles in parallel. calculateSteering reads the other vehicles
+    //and must be done for everyone before anyone integrates. postUpdate
+    //touches the cell space and the UI and must be called serially
+    void calculateSteering(float dt);
+    void integrate(float dt);
+    void postUpdate();
+
+    //used instead of integrate when the motion is integrated outside the
+    //vehicle (see VehicleKinematics). Sets the new motion data and then
+    //updates the smoothed heading
+    void setKinematics(Vector2D pos, Vector2D velocity, Vector2D heading);
     
     SteeringBehavior* const getSteering()const{return m_pSteering;}
     
@@ -42,11 +55,17 @@ public:
     
     float getTimeElapsed()const{return m_dTimeElapsed;}
 
+    //the vehicle's slot in the members of its cell (see CellStorage_Vector)
+    int getCellSlot()const{return m_iCellSlot;}
+    void setCellSlot(int slot){m_iCellSlot = slot;}
+
 
 
 
 private:
     void render();
+
+    void smoothHeading();
     
     //a pointer to the world data. So a vehicle can access any obstacle, path, wall or agent data
     GameWorldVehicle* m_pWorld;
@@ -66,6 +85,12 @@ private:
 
     //keeps a track of the most recent update time. (some of the steering behaviors make use of this - see Wander)
     float m_dTimeElapsed;
+
+    //the position before the last integrate, used to move the vehicle between cells
+    Vector2D m_vOldPos;
+
+    //the slot in the members of the cell the vehicle is in, -1 if in none
+    int m_iCellSlot;
     
     Vehicle& operator=(const Vehicle&);
     
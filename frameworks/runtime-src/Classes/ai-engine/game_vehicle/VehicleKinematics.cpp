@@ -0,0 +1,181 @@
+#include "VehicleKinematics.h"
+#include "Vehicle.h"
+#include "SteeringBehaviors.h"
+#include "common/misc/Simd.h"
+#include <cmath>
+
+//the heading is only changed when the squared speed is above this
+const float MinSpeedSqForHeading = 0.00000001f;
+
+
+void VehicleKinematics::resize(int numVehicles)
+{
+    m_PosX.resize(numVehicles);
+    m_PosY.resize(numVehicles);
+    m_VelX.resize(numVehicles);
+    m_VelY.resize(numVehicles);
+    m_HeadingX.resize(numVehicles);
+    m_HeadingY.resize(numVehicles);
+    m_ForceX.resize(numVehicles);
+    m_ForceY.resize(numVehicles);
+    m_InvMass.resize(numVehicles);
+    m_MaxSpeed.resize(numVehicles);
+}
+
+//-------------------------------- load ----------------------------------
+//------------------------------------------------------------------------
+void VehicleKinematics::load(const std::vector<Vehicle*>& vehicles, int begin, int end)
+{
+    for (int i=begin; i<end; ++i)
+    {
+        Vehicle* pV = vehicles[i];
+
+        Vector2D pos = pV->getPos();
+        Vector2D vel = pV->getVelocity();
+        Vector2D heading = pV->getHeading();
+        Vector2D force = pV->getSteering()->force();
+
+        m_PosX[i] = pos.x;
+        m_PosY[i] = pos.y;
+        m_VelX[i] = vel.x;
+        m_VelY[i] = vel.y;
+        m_HeadingX[i] = heading.x;
+        m_HeadingY[i] = heading.y;
+        m_ForceX[i] = force.x;
+        m_ForceY[i] = force.y;
+        m_InvMass[i] = 1.0f / pV->getMass();
+        m_MaxSpeed[i] = pV->getMaxSpeed();
+    }
+}
+
+//-------------------------------- store ---------------------------------
+//------------------------------------------------------------------------
+void VehicleKinematics::store(const std::vector<Vehicle*>& vehicles, int begin, int end)const
+{
+    for (int i=begin; i<end; ++i)
+    {
+        vehicles[i]->setKinematics(Vector2D(m_PosX[i], m_PosY[i]),
+                                   Vector2D(m_VelX[i], m_VelY[i]),
+                                   Vector2D(m_HeadingX[i], m_HeadingY[i]));
+    }
+}
+
+//------------------------------ integrate -------------------------------
+//------------------------------------------------------------------------
+void VehicleKinematics::integrate(int begin, int end, float dt, float worldWidth, float worldHeight)
+{
+#ifdef AI_SIMD_SSE2
+    const __m128 vDt = _mm_set1_ps(dt);
+    const __m128 vZero = _mm_setzero_ps();
+    const __m128 vOne = _mm_set1_ps(1.0f);
+    const __m128 vWidth = _mm_set1_ps(worldWidth);
+    const __m128 vHeight = _mm_set1_ps(worldHeight);
+    const __m128 vMinSpeedSq = _mm_set1_ps(MinSpeedSqForHeading);
+
+    for (; begin+4 <= end; begin += 4)
+    {
+        //velocity += force/mass * dt
+        __m128 invMass = _mm_loadu_ps(&m_InvMass[begin]);
+        __m128 velX = _mm_add_ps(_mm_loadu_ps(&m_VelX[begin]),
+                                 _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(&m_ForceX[begin]), invMass), vDt));
+        __m128 velY = _mm_add_ps(_mm_loadu_ps(&m_VelY[begin]),
+                                 _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(&m_ForceY[begin]), invMass), vDt));
+
+        //truncate to max speed
+        __m128 maxSpeed = _mm_loadu_ps(&m_MaxSpeed[begin]);
+        __m128 speedSq = _mm_add_ps(_mm_mul_ps(velX, velX), _mm_mul_ps(velY, velY));
+        __m128 speed = _mm_sqrt_ps(speedSq);
+        __m128 tooFast = _mm_cmpgt_ps(speed, maxSpeed);
+        __m128 scale = _mm_mul_ps(_mm_div_ps(vOne, speed), maxSpeed);
+        scale = _mm_or_ps(_mm_and_ps(tooFast, scale), _mm_andnot_ps(tooFast, vOne));
+        velX = _mm_mul_ps(velX, scale);
+        velY = _mm_mul_ps(velY, scale);
+
+        //heading follows the velocity unless the vehicle has stopped
+        speedSq = _mm_add_ps(_mm_mul_ps(velX, velX), _mm_mul_ps(velY, velY));
+        __m128 moving = _mm_cmpgt_ps(speedSq, vMinSpeedSq);
+        __m128 invSpeed = _mm_div_ps(vOne, _mm_sqrt_ps(speedSq));
+        __m128 headingX = _mm_loadu_ps(&m_HeadingX[begin]);
+        __m128 headingY = _mm_loadu_ps(&m_HeadingY[begin]);
+        headingX = _mm_or_ps(_mm_and_ps(moving, _mm_mul_ps(velX, invSpeed)), _mm_andnot_ps(moving, headingX));
+        headingY = _mm_or_ps(_mm_and_ps(moving, _mm_mul_ps(velY, invSpeed)), _mm_andnot_ps(moving, headingY));
+
+        //position += velocity * dt, then wrap around the world
+        __m128 posX = _mm_add_ps(_mm_loadu_ps(&m_PosX[begin]), _mm_mul_ps(velX, vDt));
+        __m128 posY = _mm_add_ps(_mm_loadu_ps(&m_PosY[begin]), _mm_mul_ps(velY, vDt));
+
+        posX = _mm_andnot_ps(_mm_cmpgt_ps(posX, vWidth), posX);
+        __m128 under = _mm_cmplt_ps(posX, vZero);
+        posX = _mm_or_ps(_mm_and_ps(under, vWidth), _mm_andnot_ps(under, posX));
+
+        under = _mm_cmplt_ps(posY, vZero);
+        posY = _mm_or_ps(_mm_and_ps(under, vHeight), _mm_andnot_ps(under, posY));
+        posY = _mm_andnot_ps(_mm_cmpgt_ps(posY, vHeight), posY);
+
+        _mm_storeu_ps(&m_VelX[begin], velX);
+        _mm_storeu_ps(&m_VelY[begin], velY);
+        _mm_storeu_ps(&m_HeadingX[begin], headingX);
+        _mm_storeu_ps(&m_HeadingY[begin], headingY);
+        _mm_storeu_ps(&m_PosX[begin], posX);
+        _mm_storeu_ps(&m_PosY[begin], posY);
+    }
+#endif
+
+    integrateScalar(begin, end, dt, worldWidth, worldHeight);
+}
+
+//--------------------------- integrateScalar ----------------------------
+//------------------------------------------------------------------------
+void VehicleKinematics::integrateScalar(int begin, int end, float dt, float worldWidth, float worldHeight)
+{
+    for (int i=begin; i<end; ++i)
+    {
+        integrateOne(m_PosX[i], m_PosY[i],
+                     m_VelX[i], m_VelY[i],
+                     m_HeadingX[i], m_HeadingY[i],
+                     m_ForceX[i], m_ForceY[i],
+                     m_InvMass[i], m_MaxSpeed[i],
+                     dt, worldWidth, worldHeight);
+    }
+}
+
+//----------------------------- integrateOne -----------------------------
+//------------------------------------------------------------------------
+void VehicleKinematics::integrateOne(float& posX, float& posY,
+                                     float& velX, float& velY,
+                                     float& headingX, float& headingY,
+                                     float forceX, float forceY,
+                                     float invMass, float maxSpeed,
+                                     float dt, float worldWidth, float worldHeight)
+{
+    //velocity += force/mass * dt
+    velX = velX + forceX * invMass * dt;
+    velY = velY + forceY * invMass * dt;
+
+    //truncate to max speed
+    float speed = std::sqrt(velX*velX + velY*velY);
+    if (speed > maxSpeed)
+    {
+        float scale = (1.0f / speed) * maxSpeed;
+        velX *= scale;
+        velY *= scale;
+    }
+
+    //heading follows the velocity unless the vehicle has stopped
+    float speedSq = velX*velX + velY*velY;
+    if (speedSq > MinSpeedSqForHeading)
+    {
+        float invSpeed = 1.0f / std::sqrt(speedSq);
+        headingX = velX * invSpeed;
+        headingY = velY * invSpeed;
+    }
+
+    //position += velocity * dt, then wrap around the world
+    posX = posX + velX * dt;
+    posY = posY + velY * dt;
+
+    if (posX > worldWidth) {posX = 0.0f;}
+    if (posX < 0)          {posX = worldWidth;}
+    if (posY < 0)          {posY = worldHeight;}
+    if (posY > worldHeight){posY = 0.0f;}
+}
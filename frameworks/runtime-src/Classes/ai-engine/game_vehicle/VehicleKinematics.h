@@ -0,0 +1,79 @@
+#ifndef VEHICLE_KINEMATICS_H
+#define VEHICLE_KINEMATICS_H
+//------------------------------------------------------------------------
+//
+//  Name:   VehicleKinematics.h
+//
+//  Desc:   structure of arrays copy of the vehicles' motion data, used by
+//          GameWorldVehicle to integrate all the vehicles in one go.
+//
+//          The arrays are only scratch space for one frame's integration.
+//          The Vehicle objects hold the real state, which the steering
+//          behaviours, the cell space and the UI read, and anything may
+//          change it between frames. So every frame load copies the data
+//          of a range of vehicles into the arrays, integrate moves them
+//          (force/mass, truncate to max speed, heading and wrap around)
+//          four at a time with SSE where it is available, and store writes
+//          the result back to the vehicles.
+//
+//          The SSE and the plain version do the same float operations in
+//          the same order, so they give the same results. A vehicle
+//          updated on its own (Vehicle::update) is moved by integrateOne,
+//          the plain version, so there is one integrator to keep right.
+//
+//          The ranges are independent, so different ranges can be worked
+//          on from different threads.
+//
+//------------------------------------------------------------------------
+#include <vector>
+
+
+class Vehicle;
+
+
+class VehicleKinematics
+{
+public:
+    //sets the number of vehicles the arrays hold
+    void resize(int numVehicles);
+
+    int size()const{return (int)m_PosX.size();}
+
+    //copies the motion data and the current steering force of the
+    //vehicles begin to end-1 into the arrays
+    void load(const std::vector<Vehicle*>& vehicles, int begin, int end);
+
+    //integrates the vehicles begin to end-1 over dt. Positions are
+    //wrapped around the world size
+    void integrate(int begin, int end, float dt, float worldWidth, float worldHeight);
+
+    //writes position, velocity and heading back to the vehicles
+    void store(const std::vector<Vehicle*>& vehicles, int begin, int end)const;
+
+    //integrates the motion of one vehicle over dt, as integrate does
+    static void integrateOne(float& posX, float& posY,
+                             float& velX, float& velY,
+                             float& headingX, float& headingY,
+                             float forceX, float forceY,
+                             float invMass, float maxSpeed,
+                             float dt, float worldWidth, float worldHeight);
+
+private:
+    //the scalar version of integrate, used for whatever doesn't fill a
+    //group of four and when SSE isn't available
+    void integrateScalar(int begin, int end, float dt, float worldWidth, float worldHeight);
+
+    std::vector<float> m_PosX;
+    std::vector<float> m_PosY;
+    std::vector<float> m_VelX;
+    std::vector<float> m_VelY;
+    std::vector<float> m_HeadingX;
+    std::vector<float> m_HeadingY;
+    std::vector<float> m_ForceX;
+    std::vector<float> m_ForceY;
+    std::vector<float> m_InvMass;
+    std::vector<float> m_MaxSpeed;
+};
+
+
+#endif
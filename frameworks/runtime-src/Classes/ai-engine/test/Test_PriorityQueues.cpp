@@ -0,0 +1,375 @@
+//-----------------------------------------------------------------------------
+//
+//  Name:   Test_PriorityQueues.cpp
+//
+//  Desc:   checks the indexed open lists of PriorityQueue.h that the
+//          searches can be given in place of the binary heap:
+//
+//          - indexedDaryPriorityQLow, indexedPairingPriorityQLow and
+//            radixPriorityQLow against a plain reference queue, over runs
+//            of random inserts, key changes (up and down) and pops. Each
+//            pop must return an item with the lowest key in the queue.
+//            The radix heap only gets keys no lower than the last one
+//            popped, as it requires
+//          - that the radix heap treats a key a little below the last one
+//            popped as equal to it, and starts again from 0 when cleared
+//          - that A* and Dijkstra find paths of the same cost with every
+//            open list, the same as Dijkstra with the binary heap, on a
+//            grid navgraph with blocks taken out
+//
+//          ctest --test-dir build, or run build/ai_engine_test_priority_queues
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include "common/misc/UtilsEx.h"
+#include "common/misc/PriorityQueue.h"
+#include "common/graph/SparseGraph.h"
+#include "common/graph/FrozenGraph.h"
+#include "common/graph/GraphNodeTypes.h"
+#include "common/graph/GraphEdgeTypes.h"
+#include "common/graph/HandyGraphFunctions.h"
+#include "common/navigation/GraphAlgorithms.h"
+#include "common/navigation/AStarHeuristicPolicies.h"
+
+
+static int g_NumFailed = 0;
+
+static void check(bool bOK, const char* what)
+{
+    if (!bOK)
+    {
+        std::printf("FAILED: %s\n", what);
+        ++g_NumFailed;
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  the queues against a reference
+//
+///////////////////////////////////////////////////////////////////////////////
+
+//the items in the queue, and the lowest key by looking at all of them
+class ReferenceQueue
+{
+public:
+    ReferenceQueue(const std::vector<float>& keys):m_Keys(keys), m_bIn(keys.size(), false), m_iSize(0){}
+
+    void insert(int idx){m_bIn[idx] = true; ++m_iSize;}
+    void remove(int idx){m_bIn[idx] = false; --m_iSize;}
+    void clear(){m_bIn.assign(m_bIn.size(), false); m_iSize = 0;}
+
+    bool contains(int idx)const{return m_bIn[idx];}
+    bool isEmpty()const{return m_iSize == 0;}
+
+    float lowestKey()const
+    {
+        float lowest = FloatMax;
+        for (unsigned int i=0; i<m_bIn.size(); ++i)
+        {
+            if (m_bIn[i] && m_Keys[i] < lowest) lowest = m_Keys[i];
+        }
+        return lowest;
+    }
+
+private:
+    const std::vector<float>& m_Keys;
+    std::vector<bool> m_bIn;
+    int m_iSize;
+};
+
+//a random key no lower than floor. A quarter of them are whole numbers
+//so there are plenty of equal keys
+static float randomKey(float floor)
+{
+    float key = floor + RandFloatInRange(0, 200);
+    if (RandIntInRange(0, 3) == 0) key = std::ceil(key);
+    return key;
+}
+
+//runs numOps random operations on a queue of numItems items. If
+//bMonotone no key is set below the last one popped
+template <class queue_type>
+static void checkAgainstReference(const char* name, bool bMonotone)
+{
+    const int numItems = 300;
+    const int numOps   = 200000;
+
+    std::vector<float> keys(numItems, 0.0f);
+
+    queue_type queue(keys, numItems);
+    ReferenceQueue reference(keys);
+
+    float lastPopped = 0;
+    int numWrong = 0;
+    int numPops = 0;
+
+    for (int op=0; op<numOps; ++op)
+    {
+        int idx = RandIntInRange(0, numItems-1);
+        float floor = bMonotone ? lastPopped : 0;
+
+        //now and then start again, to check clear
+        if (op % 50000 == 49999)
+        {
+            queue.clear();
+            reference.clear();
+            lastPopped = 0;
+            continue;
+        }
+
+        switch (RandIntInRange(0, 2))
+        {
+        case 0:
+
+            if (!reference.contains(idx))
+            {
+                keys[idx] = randomKey(floor);
+                queue.insert(idx);
+                reference.insert(idx);
+            }
+            break;
+
+        case 1:
+
+            if (reference.contains(idx))
+            {
+                //down as often as up, but never below the floor
+                keys[idx] = RandBool() ? RandFloatInRange(floor, keys[idx]) : randomKey(keys[idx]);
+                queue.changePriority(idx);
+            }
+            break;
+
+        case 2:
+
+            if (!reference.isEmpty())
+            {
+                float lowest = reference.lowestKey();
+                int popped = queue.pop();
+
+                if (!reference.contains(popped) || keys[popped] != lowest) ++numWrong;
+                else reference.remove(popped);
+
+                lastPopped = keys[popped];
+                ++numPops;
+            }
+            break;
+        }
+    }
+
+    //and empty it
+    while (!reference.isEmpty())
+    {
+        float lowest = reference.lowestKey();
+        int popped = queue.pop();
+
+        if (!reference.contains(popped) || keys[popped] != lowest)
+        {
+            ++numWrong;
+            break;
+        }
+
+        reference.remove(popped);
+        ++numPops;
+    }
+
+    if (numWrong)
+    {
+        std::printf("%s: %d of %d pops were not of a lowest key\n", name, numWrong, numPops);
+    }
+
+    check(numWrong == 0, name);
+    check(queue.isEmpty(), name);
+}
+
+//------------------------------ checkRadixClamp ------------------------------
+//
+//  a key a little below the last one popped, as rounding can give, goes
+//  in with the keys equal to the last one and so comes out next
+//-----------------------------------------------------------------------------
+static void checkRadixClamp()
+{
+    std::vector<float> keys(6, 0.0f);
+    radixPriorityQLow queue(keys, (int)keys.size());
+
+    keys[0] = 10; keys[1] = 20; keys[2] = 30;
+    queue.insert(0);
+    queue.insert(1);
+    queue.insert(2);
+
+    check(queue.pop() == 0, "radix: the lowest key comes out first");
+
+    //rounds a little below the last one popped
+    keys[3] = 10.0f - 10.0f * 1e-6f;
+    queue.insert(3);
+    check(queue.pop() == 3, "radix: a key just below the last one popped comes out next");
+
+    //so does one lowered below it by changePriority
+    keys[4] = 25;
+    queue.insert(4);
+    keys[4] = 9.9999f;
+    queue.changePriority(4);
+    check(queue.pop() == 4, "radix: a key lowered just below the last one popped comes out next");
+
+    //and 0 and -0, which have no bits set in the key to test
+    keys[5] = -0.0f;
+    queue.insert(5);
+    check(queue.pop() == 5, "radix: -0 comes out as 0");
+
+    //the rest are in order
+    check(queue.pop() == 1, "radix: the order is kept after a clamped key (1)");
+    check(queue.pop() == 2, "radix: the order is kept after a clamped key (2)");
+    check(queue.isEmpty(), "radix: empty after popping everything");
+
+    //once cleared, keys lower than the last one popped are in order again
+    queue.clear();
+    keys[0] = 3; keys[1] = 1; keys[2] = 2;
+    queue.insert(0);
+    queue.insert(1);
+    queue.insert(2);
+
+    check(queue.pop() == 1 && queue.pop() == 2 && queue.pop() == 0, "radix: clear starts again from 0");
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  the searches with each open list
+//
+///////////////////////////////////////////////////////////////////////////////
+typedef SparseGraph<NavGraphNode<>, NavGraphEdge> TestGraph;
+typedef FrozenGraph<NavGraphNode<>, NavGraphEdge> TestFrozenGraph;
+
+typedef std::vector<std::pair<int, int> > NodePairs;
+
+//a grid over 500x500 with rectangular blocks of nodes taken out, like the
+//walls of a map
+static void createNavGraph(TestGraph& graph, int cellsPerSide)
+{
+    createGrid(graph, 500, 500, cellsPerSide, cellsPerSide);
+
+    for (int block=0; block<cellsPerSide; ++block)
+    {
+        int w = RandIntInRange(1, cellsPerSide/6);
+        int h = RandIntInRange(1, cellsPerSide/6);
+        int x = RandIntInRange(0, cellsPerSide - w);
+        int y = RandIntInRange(0, cellsPerSide - h);
+
+        for (int row=y; row<y+h; ++row)
+        {
+            for (int col=x; col<x+w; ++col)
+            {
+                int node = row*cellsPerSide + col;
+                if (graph.isNodePresent(node)) graph.removeNode(node);
+            }
+        }
+    }
+}
+
+static NodePairs createSearchPairs(const TestGraph& graph, int numPairs)
+{
+    std::vector<int> nodes;
+    for (int n=0; n<graph.getNumNodes(); ++n)
+    {
+        if (graph.isNodePresent(n)) nodes.push_back(n);
+    }
+
+    NodePairs pairs;
+    for (int p=0; p<numPairs; ++p)
+    {
+        pairs.push_back(std::make_pair(nodes[RandIntInRange(0, (int)nodes.size()-1)],
+                                       nodes[RandIntInRange(0, (int)nodes.size()-1)]));
+    }
+
+    return pairs;
+}
+
+//the paths found by different searches may add up the same edges in a
+//different order
+static bool isSameCost(float a, float b)
+{
+    return std::fabs(a - b) <= 1e-5f * std::max(a, b) + 1e-4f;
+}
+
+//A* and Dijkstra with open_list must find the paths at the expected costs
+template <class open_list>
+static void checkSearches(const char* name,
+                          const TestFrozenGraph& graph,
+                          const NodePairs& pairs,
+                          const std::vector<float>& expected)
+{
+    int numAStarWrong = 0;
+    int numDijkstraWrong = 0;
+
+    for (unsigned int p=0; p<pairs.size(); ++p)
+    {
+        Graph_SearchAStar<TestFrozenGraph, Heuristic_Euclid, open_list> aStar(graph, pairs[p].first, pairs[p].second);
+        Graph_SearchDijkstra<TestFrozenGraph, open_list> dijkstra(graph, pairs[p].first, pairs[p].second);
+
+        if (!isSameCost(aStar.getCostToTarget(), expected[p])) ++numAStarWrong;
+        if (!isSameCost(dijkstra.getCostToTarget(), expected[p])) ++numDijkstraWrong;
+    }
+
+    if (numAStarWrong || numDijkstraWrong)
+    {
+        std::printf("%s: A* wrong on %d and Dijkstra on %d of %d paths\n",
+                    name, numAStarWrong, numDijkstraWrong, (int)pairs.size());
+    }
+
+    check(numAStarWrong == 0 && numDijkstraWrong == 0, name);
+}
+
+static void checkSearchesWithEachOpenList()
+{
+    TestGraph sparse(false);
+    createNavGraph(sparse, 40);
+
+    TestFrozenGraph graph(sparse);
+
+    NodePairs pairs = createSearchPairs(sparse, 300);
+
+    //the costs found by Dijkstra with the binary heap the searches had to
+    //begin with
+    std::vector<float> expected;
+    int numUnreachable = 0;
+    for (unsigned int p=0; p<pairs.size(); ++p)
+    {
+        Graph_SearchDijkstra<TestFrozenGraph, indexedPriorityQLow<float> > search(graph, pairs[p].first, pairs[p].second);
+        expected.push_back(search.getCostToTarget());
+
+        if (expected.back() == 0 && pairs[p].first != pairs[p].second) ++numUnreachable;
+    }
+
+    check(numUnreachable < (int)pairs.size() / 2, "most of the searched nodes are connected");
+
+    checkSearches<indexedPriorityQLow<float> >("A* and Dijkstra with the binary heap", graph, pairs, expected);
+    checkSearches<indexedDaryPriorityQLow<float> >("A* and Dijkstra with the 4-ary heap", graph, pairs, expected);
+    checkSearches<indexedDaryPriorityQLow<float, 2> >("A* and Dijkstra with the 2-ary heap", graph, pairs, expected);
+    checkSearches<indexedPairingPriorityQLow<float> >("A* and Dijkstra with the pairing heap", graph, pairs, expected);
+    checkSearches<radixPriorityQLow>("A* and Dijkstra with the radix heap", graph, pairs, expected);
+}
+
+
+int main()
+{
+    RandSeed(17);
+
+    checkAgainstReference<indexedDaryPriorityQLow<float> >("indexedDaryPriorityQLow<4> against the reference", false);
+    checkAgainstReference<indexedDaryPriorityQLow<float, 2> >("indexedDaryPriorityQLow<2> against the reference", false);
+    checkAgainstReference<indexedDaryPriorityQLow<float, 8> >("indexedDaryPriorityQLow<8> against the reference", false);
+    checkAgainstReference<indexedPairingPriorityQLow<float> >("indexedPairingPriorityQLow against the reference", false);
+    checkAgainstReference<radixPriorityQLow>("radixPriorityQLow against the reference", true);
+
+    checkRadixClamp();
+
+    checkSearchesWithEachOpenList();
+
+    if (g_NumFailed) return 1;
+
+    std::printf("passed\n");
+    return 0;
+}
@@ -0,0 +1,240 @@
+//-----------------------------------------------------------------------------
+//
+//  Name:   Test_TimingWheel.cpp
+//
+//  Desc:   checks the TimingWheel the delayed messages are kept in:
+//
+//          - items due either side of the ends of level 0 and level 1
+//            (ticks 63/64 and 4095/4096 from the tick they are scheduled
+//            on) and items far enough off for level 2 and 3, which have to
+//            be cascaded down, are each handed out on exactly their tick,
+//            whether the wheel is advanced one tick at a time or all at
+//            once, and from a tick that isn't a multiple of 64
+//          - cancel fails once an item has been handed out, also after its
+//            node has been reused for another item
+//          - find with two equal items due on the same tick, as the
+//            dispatcher relies on it to drop repeated messages
+//
+//          ctest --test-dir build, or run build/ai_engine_test_timing_wheel
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <vector>
+
+#include "common/misc/TimingWheel.h"
+
+
+static int g_NumFailed = 0;
+
+static void check(bool bOK, const char* what)
+{
+    if (!bOK)
+    {
+        std::printf("FAILED: %s\n", what);
+        ++g_NumFailed;
+    }
+}
+
+//the items. Equal ids are equal items
+struct Item
+{
+    int id;
+
+    explicit Item(int i = 0):id(i){}
+
+    bool operator==(const Item& rhs)const{return id == rhs.id;}
+};
+
+inline unsigned int hashValue(const Item& item)
+{
+    return (unsigned int)item.id * 2246822519u;
+}
+
+typedef TimingWheel<Item> Wheel;
+
+
+//------------------------------ checkBoundaries ------------------------------
+//
+//  schedules an item on each of the ticks start+delays[i], with id i, and
+//  advances the wheel past them, by one tick at a time or in one go. Each
+//  item must be handed out once, on its tick
+//-----------------------------------------------------------------------------
+static void checkBoundaries(const char* name, unsigned int start, bool bOneTickAtATime)
+{
+    static const unsigned int delays[] =
+    {
+        1, 2,
+        63, 64, 65,                     //the end of level 0
+        127, 128,
+        4095, 4096, 4097,               //the end of level 1
+        3*4096 + 100,                   //level 2, cascaded twice
+        262143, 262144, 262145          //the end of level 2
+    };
+
+    const int numItems = sizeof(delays) / sizeof(delays[0]);
+
+    Wheel wheel(start);
+
+    for (int i=0; i<numItems; ++i)
+    {
+        wheel.schedule(start + delays[i], Item(i));
+    }
+
+    check(wheel.getNumPending() == numItems, name);
+
+    std::vector<int> timesHanded(numItems, 0);
+    int numEarlyOrLate = 0;
+
+    std::vector<Wheel::Due> due;
+    unsigned int end = start + delays[numItems-1] + 10;
+
+    if (bOneTickAtATime)
+    {
+        for (unsigned int tick=start+1; tick!=end+1; ++tick)
+        {
+            due.clear();
+            wheel.advance(tick, due);
+
+            for (unsigned int d=0; d<due.size(); ++d)
+            {
+                int i = due[d].item.id;
+                ++timesHanded[i];
+
+                if (due[d].tick != tick || start + delays[i] != tick) ++numEarlyOrLate;
+            }
+        }
+    }
+    else
+    {
+        wheel.advance(end, due);
+
+        unsigned int lastTick = start;
+        for (unsigned int d=0; d<due.size(); ++d)
+        {
+            int i = due[d].item.id;
+            ++timesHanded[i];
+
+            //in the order they fall due
+            if (due[d].tick != start + delays[i] || due[d].tick < lastTick) ++numEarlyOrLate;
+            lastTick = due[d].tick;
+        }
+    }
+
+    int numNotOnce = 0;
+    for (int i=0; i<numItems; ++i)
+    {
+        if (timesHanded[i] != 1) ++numNotOnce;
+    }
+
+    if (numNotOnce || numEarlyOrLate)
+    {
+        std::printf("%s: %d items not handed out once, %d not on their tick\n", name, numNotOnce, numEarlyOrLate);
+    }
+
+    check(numNotOnce == 0 && numEarlyOrLate == 0, name);
+    check(wheel.getNumPending() == 0, name);
+    check(wheel.getTick() == end, name);
+}
+
+//------------------------------ checkCancel ----------------------------------
+//-----------------------------------------------------------------------------
+static void checkCancel()
+{
+    Wheel wheel;
+    std::vector<Wheel::Due> due;
+
+    int cancelled = wheel.schedule(5, Item(1));
+    int delivered = wheel.schedule(5, Item(2));
+
+    check(wheel.cancel(cancelled), "cancel: a pending item can be cancelled");
+    check(!wheel.cancel(cancelled), "cancel: an item can only be cancelled once");
+
+    wheel.advance(5, due);
+
+    check(due.size() == 1 && due[0].item.id == 2, "cancel: a cancelled item isn't handed out");
+    check(!wheel.cancel(delivered), "cancel: fails once the item has been handed out");
+    check(wheel.getNumPending() == 0, "cancel: nothing is left pending");
+
+    //the nodes of the two are reused by these
+    int reused1 = wheel.schedule(100, Item(3));
+    int reused2 = wheel.schedule(4200, Item(4));
+
+    check(!wheel.cancel(delivered), "cancel: fails once the node has been reused");
+    check(!wheel.cancel(cancelled), "cancel: fails for a cancelled item once the node has been reused");
+    check(wheel.getNumPending() == 2, "cancel: the items on the reused nodes are still pending");
+
+    //and an item that has been cascaded down a level
+    due.clear();
+    wheel.advance(4100, due);
+    check(wheel.cancel(reused2), "cancel: an item can be cancelled after it has been cascaded");
+
+    due.clear();
+    wheel.advance(5000, due);
+    check(due.empty(), "cancel: the cascaded item isn't handed out");
+    check(!wheel.cancel(reused1), "cancel: fails for an item handed out by a jump");
+    check(!wheel.cancel(-1), "cancel: fails for -1");
+}
+
+//------------------------------- checkFind -----------------------------------
+//-----------------------------------------------------------------------------
+static void checkFind()
+{
+    Wheel wheel;
+    std::vector<Wheel::Due> due;
+
+    check(wheel.find(10, Item(1)) == -1, "find: nothing in an empty wheel");
+
+    //enough others to make the wheel rehash in between
+    for (int i=100; i<400; ++i)
+    {
+        wheel.schedule(1 + i % 50, Item(i));
+    }
+
+    int first  = wheel.schedule(10, Item(1));
+    int second = wheel.schedule(10, Item(1));
+
+    for (int i=400; i<700; ++i)
+    {
+        wheel.schedule(1 + i % 50, Item(i));
+    }
+
+    int found = wheel.find(10, Item(1));
+    check(found == first || found == second, "find: finds one of two equal items");
+    check(wheel.find(11, Item(1)) == -1, "find: not on another tick");
+    check(wheel.find(10, Item(2)) == -1, "find: not an item that isn't equal");
+
+    check(wheel.cancel(found), "find: the handle found can cancel the item");
+    int other = (found == first) ? second : first;
+    check(wheel.find(10, Item(1)) == other, "find: finds the other once one is cancelled");
+
+    wheel.advance(10, due);
+
+    int numHanded = 0;
+    for (unsigned int d=0; d<due.size(); ++d)
+    {
+        if (due[d].item.id == 1) ++numHanded;
+    }
+
+    check(numHanded == 1, "find: the item not cancelled is handed out");
+    check(wheel.find(10, Item(1)) == -1, "find: not once it has been handed out");
+    check(wheel.find(50, Item(699)) != -1, "find: still finds the items not yet due");
+}
+
+
+int main()
+{
+    checkBoundaries("boundaries, one tick at a time from 0", 0, true);
+    checkBoundaries("boundaries, one tick at a time from 4000", 4000, true);
+    checkBoundaries("boundaries, in one go from 0", 0, false);
+    checkBoundaries("boundaries, in one go from 4000", 4000, false);
+
+    //where the tick wraps round
+    checkBoundaries("boundaries, one tick at a time across the wrap", 0xFFFFFFFFu - 5000, true);
+
+    checkCancel();
+    checkFind();
+
+    if (g_NumFailed) return 1;
+
+    std::printf("passed\n");
+    return 0;
+}
@@ -0,0 +1,175 @@
+//-----------------------------------------------------------------------------
+//
+//  Name:   Test_VehicleKinematics.cpp
+//
+//  Desc:   checks that moving the vehicles through the VehicleKinematics
+//          arrays, four at a time with SSE where it is available, gives
+//          bit for bit the same positions, velocities and headings as
+//          moving each one with VehicleKinematics::integrateOne, the plain
+//          version Vehicle::update uses.
+//
+//          The vehicles are those of a flocking world, checked over a few
+//          hundred frames. Every so often some of them are pushed past the
+//          edges of the world, past their maximum speed or to a standstill,
+//          so the wrap around, the truncation and the kept heading are
+//          covered in every lane of the SSE groups.
+//
+//          ctest --test-dir build, or run build/ai_engine_test_vehicle_kinematics
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "GameConfig.h"
+#include "common/misc/UtilsEx.h"
+#include "game_vehicle/GameWorldVehicle.h"
+#include "game_vehicle/Vehicle.h"
+#include "game_vehicle/SteeringBehaviors.h"
+#include "game_vehicle/VehicleKinematics.h"
+
+
+static int g_NumFailed = 0;
+
+static void check(bool bOK, const char* what)
+{
+    if (!bOK)
+    {
+        std::printf("FAILED: %s\n", what);
+        ++g_NumFailed;
+    }
+}
+
+//compares the bits, so -0 and 0 differ and NaNs are equal to themselves
+static bool isSameBits(float a, float b)
+{
+    return std::memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+static bool isSameBits(Vector2D a, Vector2D b)
+{
+    return isSameBits(a.x, b.x) && isSameBits(a.y, b.y);
+}
+
+//the motion of a vehicle, moved by integrateOne
+struct Motion
+{
+    Vector2D pos;
+    Vector2D velocity;
+    Vector2D heading;
+
+    Motion(Vehicle* pV, float dt):pos(pV->getPos()), velocity(pV->getVelocity()), heading(pV->getHeading())
+    {
+        Vector2D force = pV->getSteering()->force();
+
+        VehicleKinematics::integrateOne(pos.x, pos.y,
+                                        velocity.x, velocity.y,
+                                        heading.x, heading.y,
+                                        force.x, force.y,
+                                        1.0f / pV->getMass(), pV->getMaxSpeed(),
+                                        dt, Win_Width, Win_Height);
+    }
+};
+
+//pushes the vehicle to a case the integrator treats specially
+static void pushToEdgeCase(Vehicle* pV, int which)
+{
+    Vector2D pos = pV->getPos();
+    Vector2D velocity = pV->getVelocity();
+
+    switch (which % 4)
+    {
+    case 0:
+        //just past a corner, moving out of the world
+        pos = Vector2D(Win_Width + 0.5f, -0.5f);
+        velocity = Vector2D(pV->getMaxSpeed(), -pV->getMaxSpeed()) * 0.5f;
+        break;
+
+    case 1:
+        //just inside the other corner, moving out of the world
+        pos = Vector2D(0.01f, Win_Height - 0.01f);
+        velocity = Vector2D(-pV->getMaxSpeed(), pV->getMaxSpeed()) * 0.7f;
+        break;
+
+    case 2:
+        //far above the maximum speed
+        velocity = Vector2D(pV->getMaxSpeed() * 10, -pV->getMaxSpeed() * 3);
+        break;
+
+    case 3:
+        //standing still
+        velocity = Vector2D(0, 0);
+        break;
+    }
+
+    pV->setKinematics(pos, velocity, pV->getHeading());
+}
+
+int main()
+{
+    const int numFrames = 300;
+
+    GameWorldVehicle* pWorld = GameWorldVehicle::create(Win_Width, Win_Height, true, 11);
+
+    const std::vector<Vehicle*>& vehicles = pWorld->getVehicles();
+    int numVehicles = (int)vehicles.size();
+
+    //different maximum speeds in the lanes of a group
+    for (int v=0; v<numVehicles; ++v)
+    {
+        vehicles[v]->setMaxSpeed(vehicles[v]->getMaxSpeed() * (0.5f + 0.25f * (v % 4)));
+    }
+
+    VehicleKinematics kinematics;
+    kinematics.resize(numVehicles);
+
+    int numMismatches = 0;
+    int numFirstMismatch = -1;
+
+    for (int frame=0; frame<numFrames; ++frame)
+    {
+        //calculates this frame's steering forces
+        pWorld->update(Sim_Time_Step);
+
+        if (frame % 10 == 0)
+        {
+            for (int v=frame % 7; v<numVehicles; v+=7)
+            {
+                pushToEdgeCase(vehicles[v], v + frame/10);
+            }
+        }
+
+        std::vector<Motion> expected;
+        for (int v=0; v<numVehicles; ++v)
+        {
+            expected.push_back(Motion(vehicles[v], Sim_Time_Step));
+        }
+
+        kinematics.load(vehicles, 0, numVehicles);
+        kinematics.integrate(0, numVehicles, Sim_Time_Step, Win_Width, Win_Height);
+        kinematics.store(vehicles, 0, numVehicles);
+
+        for (int v=0; v<numVehicles; ++v)
+        {
+            if (!isSameBits(vehicles[v]->getPos(), expected[v].pos) ||
+                !isSameBits(vehicles[v]->getVelocity(), expected[v].velocity) ||
+                !isSameBits(vehicles[v]->getHeading(), expected[v].heading))
+            {
+                if (numMismatches++ == 0) numFirstMismatch = frame;
+            }
+        }
+    }
+
+    if (numMismatches)
+    {
+        std::printf("%d vehicle frames differ, the first in frame %d\n", numMismatches, numFirstMismatch);
+    }
+
+    check(numMismatches == 0, "the kinematics arrays move the vehicles exactly as integrateOne does");
+
+    delete pWorld;
+
+    if (g_NumFailed) return 1;
+
+    std::printf("passed\n");
+    return 0;
+}
@@ -0,0 +1,201 @@
+//-----------------------------------------------------------------------------
+//
+//  Name:   Test_WorldIsolation.cpp
+//
+//  Desc:   checks that worlds built and run on one thread keep their
+//          entities apart. Each world's EntityManager must hold exactly
+//          the entities the world made, whichever world was made current
+//          on the thread last, and deleting a world must not touch the
+//          entities of the world that is current.
+//
+//          The worlds here are the vehicle world and the soccer pitch.
+//
+//          Then that a world only depends on its seed: soccer matches run
+//          four at a time on four threads must end with the ball in
+//          exactly the same place as the same matches run one after the
+//          other on this thread.
+//
+//          ctest --test-dir build, or run build/ai_engine_test_world_isolation
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "GameConfig.h"
+#include "common/game/WorldContext.h"
+#include "common/game/EntityManager.h"
+#include "game_vehicle/GameWorldVehicle.h"
+#include "game_vehicle/Vehicle.h"
+#include "game_soccer/SoccerPitch.h"
+#include "game_soccer/SoccerBall.h"
+
+
+static int g_NumFailed = 0;
+
+static void check(bool bOK, const char* what)
+{
+    if (!bOK)
+    {
+        std::printf("FAILED: %s\n", what);
+        ++g_NumFailed;
+    }
+}
+
+//true if every entity in the context's manager was made in that context
+static bool holdsOnlyItsOwn(WorldContext& context)
+{
+    const std::vector<BaseEntity*>& entities = context.getEntityManager().getEntities();
+
+    for (unsigned int e=0; e<entities.size(); ++e)
+    {
+        if (entities[e]->getContext() != &context) return false;
+    }
+
+    return true;
+}
+
+//true if every vehicle of the world is registered with the world's manager
+static bool holdsAllVehicles(GameWorldVehicle* pWorld)
+{
+    const std::vector<Vehicle*>& vehicles = pWorld->getVehicles();
+    const EntityManager& manager = pWorld->getContext().getEntityManager();
+
+    for (unsigned int v=0; v<vehicles.size(); ++v)
+    {
+        if (manager.getEntityByID(vehicles[v]->getID()) != vehicles[v]) return false;
+    }
+
+    return true;
+}
+
+//plays a match with the seed for a number of updates and keeps where
+//the ball ends up. Run on a thread of its own or on the calling one
+class PlayMatch
+{
+public:
+    PlayMatch(unsigned int seed, int numUpdates, Vector2D* pBallPos):m_iSeed(seed),
+                                                                     m_iNumUpdates(numUpdates),
+                                                                     m_pBallPos(pBallPos)
+    {}
+
+    void operator()()const
+    {
+        SoccerPitch* pPitch = SoccerPitch::create(Win_Width, Win_Height, m_iSeed);
+
+        for (int i=0; i<m_iNumUpdates; ++i) pPitch->update(Sim_Time_Step);
+
+        *m_pBallPos = pPitch->getBall()->getPos();
+
+        delete pPitch;
+    }
+
+private:
+    unsigned int m_iSeed;
+    int m_iNumUpdates;
+    Vector2D* m_pBallPos;
+};
+
+//compares the bits, so the positions must be exactly the same
+static bool isSameBits(const Vector2D& a, const Vector2D& b)
+{
+    return std::memcmp(&a.x, &b.x, sizeof(float)) == 0 &&
+           std::memcmp(&a.y, &b.y, sizeof(float)) == 0;
+}
+
+//------------------------- checkThreadedMatches ------------------------------
+//
+//  two seeds, each played twice, so the threads run matches that are the
+//  same and matches that differ at once
+//-----------------------------------------------------------------------------
+static void checkThreadedMatches()
+{
+    const int numThreads = 4;
+    const int numUpdates = 1000;
+    const unsigned int seeds[numThreads] = {7, 8, 7, 8};
+
+    std::vector<Vector2D> serial(numThreads);
+    std::vector<Vector2D> threaded(numThreads);
+
+    for (int m=0; m<numThreads; ++m)
+    {
+        PlayMatch(seeds[m], numUpdates, &serial[m])();
+    }
+
+    std::vector<std::thread> threads;
+    for (int m=0; m<numThreads; ++m)
+    {
+        threads.push_back(std::thread(PlayMatch(seeds[m], numUpdates, &threaded[m])));
+    }
+
+    for (int m=0; m<numThreads; ++m)
+    {
+        threads[m].join();
+    }
+
+    SoccerPitch* pPitch = SoccerPitch::create(Win_Width, Win_Height, seeds[0]);
+    Vector2D kickOff = pPitch->getBall()->getPos();
+    delete pPitch;
+
+    check(!isSameBits(serial[0], kickOff), "the ball has moved from the kick off");
+    check(isSameBits(serial[0], serial[2]) && isSameBits(serial[1], serial[3]), "a seed gives the same match twice on one thread");
+
+    for (int m=0; m<numThreads; ++m)
+    {
+        if (!isSameBits(serial[m], threaded[m]))
+        {
+            std::printf("seed %u: the ball is at (%f, %f) on one thread and (%f, %f) on %d\n",
+                        seeds[m], serial[m].x, serial[m].y, threaded[m].x, threaded[m].y, numThreads);
+        }
+
+        check(isSameBits(serial[m], threaded[m]), "a seed gives the same match on one thread and on four");
+    }
+}
+
+int main()
+{
+    //the second world is current once it has been built
+    GameWorldVehicle* pFirst = GameWorldVehicle::create(Win_Width, Win_Height, true, 1);
+    GameWorldVehicle* pSecond = GameWorldVehicle::create(Win_Width, Win_Height, true, 2);
+
+    int numFirst = pFirst->getContext().getEntityManager().getNumEntities();
+    int numSecond = pSecond->getContext().getEntityManager().getNumEntities();
+
+    check(numFirst == (int)pFirst->getVehicles().size(), "first world's manager holds its vehicles only");
+    check(numSecond == (int)pSecond->getVehicles().size(), "second world's manager holds its vehicles only");
+    check(holdsOnlyItsOwn(pFirst->getContext()) && holdsAllVehicles(pFirst), "first world's entities are its own");
+    check(holdsOnlyItsOwn(pSecond->getContext()) && holdsAllVehicles(pSecond), "second world's entities are its own");
+
+    //updating the first makes it current, the second must be left alone
+    for (int i=0; i<10; ++i) pFirst->update(Sim_Time_Step);
+
+    check(pSecond->getContext().getEntityManager().getNumEntities() == numSecond, "updating the first world leaves the second's entities");
+
+    //a pitch built after the first world was made current
+    SoccerPitch* pPitch = SoccerPitch::create(Win_Width, Win_Height, 3);
+
+    int numPitch = pPitch->getContext().getEntityManager().getNumEntities();
+
+    check(numPitch > 0 && holdsOnlyItsOwn(pPitch->getContext()), "the pitch's entities are its own");
+    check(pFirst->getContext().getEntityManager().getNumEntities() == numFirst, "building the pitch leaves the first world's entities");
+
+    //deleting the first world while the pitch is current
+    delete pFirst;
+
+    check(pPitch->getContext().getEntityManager().getNumEntities() == numPitch, "deleting the first world leaves the pitch's entities");
+    check(pSecond->getContext().getEntityManager().getNumEntities() == numSecond, "deleting the first world leaves the second's entities");
+
+    for (int i=0; i<10; ++i) pSecond->update(Sim_Time_Step);
+
+    check(holdsOnlyItsOwn(pSecond->getContext()) && holdsAllVehicles(pSecond), "the second world's entities are its own after updates");
+
+    delete pPitch;
+    delete pSecond;
+
+    checkThreadedMatches();
+
+    if (g_NumFailed) return 1;
+
+    std::printf("passed\n");
+    return 0;
+}